@@ -0,0 +1,275 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fmt/format.h>
+#include <simdjson.h>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "Core/Types.hpp"
+#include "OS/File.hpp"
+#include "Utils/JsonWriter.hpp"
+
+namespace ox::bench {
+struct Result {
+  std::string name = {};
+  usize iterations = 0;
+  f64 mean_us = 0.0;
+  f64 median_us = 0.0;
+  f64 min_us = 0.0;
+  f64 max_us = 0.0;
+  std::vector<std::pair<std::string, f64>> counters = {};
+
+  auto counter(this Result& self, std::string_view name, f64 value) -> Result& {
+    self.counters.emplace_back(name, value);
+    return self;
+  }
+};
+
+// Fills in everything but the name and counters from per iteration times.
+inline auto summarize(std::string_view name, std::vector<f64> samples_us) -> Result {
+  auto result = Result{.name = std::string(name), .iterations = samples_us.size()};
+  if (samples_us.empty()) {
+    return result;
+  }
+
+  std::ranges::sort(samples_us);
+  auto total_us = 0.0;
+  for (const auto sample : samples_us) {
+    total_us += sample;
+  }
+
+  result.mean_us = total_us / static_cast<f64>(samples_us.size());
+  result.median_us = samples_us[samples_us.size() / 2];
+  result.min_us = samples_us.front();
+  result.max_us = samples_us.back();
+  return result;
+}
+
+// Times every call of `fn` separately, after a few untimed warmup calls.
+template <typename Fn>
+auto run(std::string_view name, usize iterations, Fn&& fn) -> Result {
+  using Clock = std::chrono::steady_clock;
+
+  for (auto i = 0_sz; i < std::max(iterations / 10, 1_sz); i++) {
+    fn();
+  }
+
+  auto samples_us = std::vector<f64>();
+  samples_us.reserve(iterations);
+  for (auto i = 0_sz; i < iterations; i++) {
+    const auto start = Clock::now();
+    fn();
+    samples_us.push_back(std::chrono::duration<f64, std::micro>(Clock::now() - start).count());
+  }
+
+  return summarize(name, std::move(samples_us));
+}
+
+inline auto print(const Result& result) -> void {
+  fmt::print(
+    "{:<48} {:>8} iters  mean {:>10.2f}us  median {:>10.2f}us  min {:>10.2f}us  max {:>10.2f}us",
+    result.name,
+    result.iterations,
+    result.mean_us,
+    result.median_us,
+    result.min_us,
+    result.max_us
+  );
+  for (const auto& [name, value] : result.counters) {
+    fmt::print("  {} {:.2f}", name, value);
+  }
+  fmt::print("\n");
+}
+
+// Keeps the optimizer from throwing away a result nobody reads.
+template <typename T>
+inline auto do_not_optimize(const T& value) -> void {
+#if defined(OX_COMPILER_MSVC)
+  static volatile const T* sink = nullptr;
+  sink = &value;
+#else
+  asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+struct Options {
+  // `--json <path>`, results as JSON. A directory gets `<suite>.json` in it.
+  std::filesystem::path json_path = {};
+  // `--baseline <path>`, an earlier `--json` output, file or directory the same way.
+  std::filesystem::path baseline_path = {};
+  // `--threshold <percent>`, a median this much slower than the baseline's is a regression.
+  f64 threshold_pct = 10.0;
+  // `--noise-floor <us>`, differences smaller than this never count.
+  f64 noise_floor_us = 1.0;
+  // `--filter <text>`, only scenarios with it in their name run.
+  std::string filter = {};
+};
+
+inline auto parse_options(i32 argc, char** argv) -> Options {
+  auto options = Options{};
+  for (auto i = 1; i + 1 < argc; i += 2) {
+    const auto arg = std::string_view(argv[i]);
+    const auto* value = argv[i + 1];
+    if (arg == "--json") {
+      options.json_path = value;
+    } else if (arg == "--baseline") {
+      options.baseline_path = value;
+    } else if (arg == "--threshold") {
+      options.threshold_pct = std::strtod(value, nullptr);
+    } else if (arg == "--noise-floor") {
+      options.noise_floor_us = std::strtod(value, nullptr);
+    } else if (arg == "--filter") {
+      options.filter = value;
+    } else {
+      fmt::print(stderr, "Unknown argument {}\n", arg);
+      i -= 1;
+    }
+  }
+
+  return options;
+}
+
+// Results of one benchmark binary. Every result is printed as it comes in, `finish` writes them out and
+// compares them against the baseline, its return value is the exit code.
+class Suite {
+public:
+  std::string name = {};
+  Options options = {};
+  std::vector<Result> results = {};
+
+  Suite(i32 argc, char** argv)
+      : name(std::filesystem::path(argv[0]).stem().string()),
+        options(parse_options(argc, argv)) {}
+
+  auto should_run(this const Suite& self, std::string_view scenario) -> bool {
+    return self.options.filter.empty() || scenario.find(self.options.filter) != std::string_view::npos;
+  }
+
+  auto add(this Suite& self, Result result) -> void {
+    print(result);
+    self.results.push_back(std::move(result));
+  }
+
+  auto finish(this Suite& self) -> i32 {
+    if (!self.options.json_path.empty() && !self.write_json(self.resolve(self.options.json_path))) {
+      return 1;
+    }
+
+    if (!self.options.baseline_path.empty()) {
+      return self.compare(self.resolve(self.options.baseline_path)) ? 0 : 1;
+    }
+
+    return 0;
+  }
+
+private:
+  auto resolve(this const Suite& self, const std::filesystem::path& path) -> std::filesystem::path {
+    if (path.extension() == ".json") {
+      return path;
+    }
+
+    return path / (self.name + ".json");
+  }
+
+  auto write_json(this const Suite& self, const std::filesystem::path& path) -> bool {
+    auto writer = JsonWriter{};
+    writer.begin_obj();
+    writer["suite"] = std::string_view(self.name);
+    writer["results"].begin_array();
+    for (const auto& result : self.results) {
+      writer.begin_obj();
+      writer["name"] = std::string_view(result.name);
+      writer["iterations"] = static_cast<u64>(result.iterations);
+      writer["mean_us"] = result.mean_us;
+      writer["median_us"] = result.median_us;
+      writer["min_us"] = result.min_us;
+      writer["max_us"] = result.max_us;
+      writer["counters"].begin_obj();
+      for (const auto& [counter_name, value] : result.counters) {
+        writer[counter_name] = value;
+      }
+      writer.end_obj();
+      writer.end_obj();
+    }
+    writer.end_array();
+    writer.end_obj();
+
+    if (path.has_parent_path()) {
+      std::filesystem::create_directories(path.parent_path());
+    }
+
+    const auto contents = writer.stream.view();
+    auto file = File(path, FileAccess::Write);
+    if (!file || file.write(contents) != contents.size()) {
+      fmt::print(stderr, "Failed to write results to {}\n", path.string());
+      return false;
+    }
+
+    return true;
+  }
+
+  // False when something regressed or the baseline can't be read.
+  auto compare(this const Suite& self, const std::filesystem::path& path) -> bool {
+    auto content = simdjson::padded_string::load(path.string());
+    if (content.error()) {
+      fmt::print(stderr, "Failed to read baseline {}: {}\n", path.string(), simdjson::error_message(content.error()));
+      return false;
+    }
+
+    auto baseline = std::vector<std::pair<std::string, f64>>();
+    auto parser = simdjson::ondemand::parser{};
+    auto doc = parser.iterate(content.value_unsafe());
+    auto results_json = doc["results"].get_array();
+    if (results_json.error()) {
+      fmt::print(stderr, "Baseline {} has no results.\n", path.string());
+      return false;
+    }
+
+    for (auto result_json : results_json.value_unsafe()) {
+      auto result_name = std::string_view{};
+      auto median_us = 0.0;
+      if (result_json["name"].get_string().get(result_name) || result_json["median_us"].get_double().get(median_us)) {
+        continue;
+      }
+      baseline.emplace_back(std::string(result_name), median_us);
+    }
+
+    fmt::print("\nAgainst {} (threshold {:.1f}%)\n", path.string(), self.options.threshold_pct);
+    auto regressions = 0_sz;
+    for (const auto& result : self.results) {
+      auto it = std::ranges::find(baseline, result.name, &std::pair<std::string, f64>::first);
+      if (it == baseline.end()) {
+        fmt::print("{:<48} {:>12} {:>10.2f}us  new\n", result.name, "", result.median_us);
+        continue;
+      }
+
+      const auto before_us = it->second;
+      const auto change_pct = before_us > 0.0 ? (result.median_us - before_us) / before_us * 100.0 : 0.0;
+      const auto regressed = change_pct > self.options.threshold_pct &&
+                             result.median_us - before_us > self.options.noise_floor_us;
+      regressions += regressed ? 1 : 0;
+      fmt::print(
+        "{:<48} {:>10.2f}us {:>10.2f}us  {:+7.1f}%{}\n",
+        result.name,
+        before_us,
+        result.median_us,
+        change_pct,
+        regressed ? "  REGRESSED" : ""
+      );
+    }
+
+    if (regressions != 0) {
+      fmt::print("{} of {} results regressed.\n", regressions, self.results.size());
+      return false;
+    }
+
+    return true;
+  }
+};
+} // namespace ox::bench
@@ -0,0 +1,63 @@
+#include <atomic>
+#include <cmath>
+#include <vector>
+
+#include "BenchHelpers.hpp"
+#include "Core/JobManager.hpp"
+
+// Scheduling overhead of the job manager: tiny jobs submitted one by one, and a parallel for over an array
+// big enough that the work itself shows up next to the chunking.
+
+namespace {
+constexpr auto SMALL_JOBS = 1'000_sz;
+constexpr auto FOR_EACH_ELEMENTS = 1'000'000_sz;
+constexpr auto ITERATIONS = 100_sz;
+} // namespace
+
+auto main(i32 argc, char** argv) -> i32 {
+  auto suite = ox::bench::Suite(argc, argv);
+
+  auto job_man = ox::JobManager{};
+  if (auto result = job_man.init(); !result) {
+    fmt::print(stderr, "{}\n", result.error());
+    return 1;
+  }
+
+  fmt::print("{} worker threads\n", job_man.get_thread_count());
+
+  if (suite.should_run("jobs/submit_wait")) {
+    auto executed = std::atomic<usize>(0);
+    auto result = ox::bench::run("jobs/submit_wait", ITERATIONS, [&] {
+      for (auto i = 0_sz; i < SMALL_JOBS; i++) {
+        job_man.submit(ox::Job::create([&executed] { executed.fetch_add(1, std::memory_order_relaxed); }));
+      }
+      job_man.wait();
+    });
+    suite.add(result.counter("ns/job", result.median_us * 1000.0 / static_cast<f64>(SMALL_JOBS)));
+  }
+
+  if (suite.should_run("jobs/for_each")) {
+    auto values = std::vector<f32>(FOR_EACH_ELEMENTS, 2.0f);
+    auto result = ox::bench::run("jobs/for_each", ITERATIONS, [&] {
+      job_man.for_each(values, [](f32& value, usize) { value = std::sqrt(value * value + 1.0f); });
+      job_man.wait();
+    });
+    ox::bench::do_not_optimize(values[FOR_EACH_ELEMENTS / 2]);
+    suite.add(result.counter("ns/element", result.median_us * 1000.0 / static_cast<f64>(FOR_EACH_ELEMENTS)));
+  }
+
+  if (suite.should_run("jobs/for_each_serial")) {
+    // What `jobs/for_each` is up against.
+    auto values = std::vector<f32>(FOR_EACH_ELEMENTS, 2.0f);
+    auto result = ox::bench::run("jobs/for_each_serial", ITERATIONS, [&] {
+      for (auto& value : values) {
+        value = std::sqrt(value * value + 1.0f);
+      }
+      ox::bench::do_not_optimize(values);
+    });
+    suite.add(result.counter("ns/element", result.median_us * 1000.0 / static_cast<f64>(FOR_EACH_ELEMENTS)));
+  }
+
+  std::ignore = job_man.deinit();
+  return suite.finish();
+}
@@ -0,0 +1,78 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "BenchHelpers.hpp"
+#include "Memory/SlotMap.hpp"
+
+// Every call takes the slot map's shared mutex, lookups take it twice (`is_valid` and `slot`).
+
+namespace {
+enum class BenchSlotID : u64 { Invalid = ~0_u64 };
+
+struct Payload {
+  f32 values[16] = {};
+};
+
+constexpr auto SLOTS = 100'000_sz;
+constexpr auto ITERATIONS = 50_sz;
+} // namespace
+
+auto main(i32 argc, char** argv) -> i32 {
+  auto suite = ox::bench::Suite(argc, argv);
+
+  auto slots = ox::SlotMap<Payload, BenchSlotID>{};
+  auto ids = std::vector<BenchSlotID>();
+  ids.reserve(SLOTS);
+
+  if (suite.should_run("slot_map/create")) {
+    suite.add(ox::bench::run("slot_map/create", ITERATIONS, [&] {
+      slots.reset();
+      ids.clear();
+      for (auto i = 0_sz; i < SLOTS; i++) {
+        ids.push_back(slots.create_slot());
+      }
+    }));
+  }
+
+  if (ids.empty()) {
+    for (auto i = 0_sz; i < SLOTS; i++) {
+      ids.push_back(slots.create_slot());
+    }
+  }
+
+  auto shuffled = ids;
+  std::ranges::shuffle(shuffled, std::mt19937(1337));
+
+  if (suite.should_run("slot_map/lookup_random")) {
+    suite.add(ox::bench::run("slot_map/lookup_random", ITERATIONS, [&] {
+      auto sum = 0.0f;
+      for (const auto id : shuffled) {
+        sum += slots.slot(id)->values[0];
+      }
+      ox::bench::do_not_optimize(sum);
+    }));
+  }
+
+  if (suite.should_run("slot_map/for_each_active")) {
+    suite.add(ox::bench::run("slot_map/for_each_active", ITERATIONS, [&] {
+      auto sum = 0.0f;
+      slots.for_each_active([&sum](usize, Payload& payload) { sum += payload.values[0]; });
+      ox::bench::do_not_optimize(sum);
+    }));
+  }
+
+  // Half of the slots are freed and taken again, in random order.
+  if (suite.should_run("slot_map/churn")) {
+    suite.add(ox::bench::run("slot_map/churn", ITERATIONS, [&] {
+      for (auto i = 0_sz; i < SLOTS / 2; i++) {
+        slots.destroy_slot(shuffled[i]);
+      }
+      for (auto i = 0_sz; i < SLOTS / 2; i++) {
+        shuffled[i] = slots.create_slot();
+      }
+    }));
+  }
+
+  return suite.finish();
+}
@@ -0,0 +1,179 @@
+#include <array>
+#include <enet.h>
+
+#include "BenchHelpers.hpp"
+#include "Networking/NetPacket.hpp"
+
+// RPC throughput over a real ENet connection on the loopback interface. The client queues calls like
+// NetClient::call does and sends a packet every `calls_per_packet` calls, the server decodes and
+// dispatches them. One call per packet is how RPCs went out before batching.
+
+namespace {
+constexpr auto PORT = 37'471_u16;
+constexpr auto CALLS = 100'000_sz;
+constexpr auto ITERATIONS = 5_sz;
+
+struct Loopback {
+  ENetHost* server = nullptr;
+  ENetHost* client = nullptr;
+  ENetPeer* peer = nullptr;
+
+  auto connect(this Loopback& self) -> bool {
+    auto address = ENetAddress{};
+    enet_address_set_host(&address, "127.0.0.1");
+    address.port = PORT;
+
+    self.server = enet_host_create(&address, 1, ox::NET_CHANNEL_COUNT, 0, 0);
+    self.client = enet_host_create(nullptr, 1, ox::NET_CHANNEL_COUNT, 0, 0);
+    if (!self.server || !self.client) {
+      return false;
+    }
+
+    self.peer = enet_host_connect(self.client, &address, ox::NET_CHANNEL_COUNT, 0);
+    if (!self.peer) {
+      return false;
+    }
+
+    auto event = ENetEvent{};
+    for (auto attempt = 0; attempt < 1000; attempt++) {
+      enet_host_service(self.server, &event, 1);
+      if (enet_host_service(self.client, &event, 1) > 0 && event.type == ENET_EVENT_TYPE_CONNECT) {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  auto destroy(this Loopback& self) -> void {
+    if (self.peer) {
+      enet_peer_disconnect_now(self.peer, 0);
+    }
+    if (self.client) {
+      enet_host_destroy(self.client);
+    }
+    if (self.server) {
+      enet_host_destroy(self.server);
+    }
+  }
+};
+
+struct Scenario {
+  std::string_view name = {};
+  usize calls_per_packet = 1;
+};
+
+auto run_scenario(
+  ox::bench::Suite& suite,
+  Loopback& loopback,
+  const ox::NetProcTable& procs,
+  usize& received,
+  const Scenario& scenario
+) -> void {
+  if (!suite.should_run(scenario.name)) {
+    return;
+  }
+
+  const auto params = std::array{
+    ox::RPCParameter{.value = 1.0f},
+    ox::RPCParameter{.value = 2.0f},
+    ox::RPCParameter{.value = 3.0f},
+    ox::RPCParameter{.value = std::string("player_move")},
+  };
+
+  auto batch = ox::NetRPCBatch{};
+  auto packets = 0_sz;
+  auto bytes = 0_sz;
+
+  auto drain_server = [&] {
+    auto event = ENetEvent{};
+    while (enet_host_service(loopback.server, &event, 0) > 0) {
+      if (event.type != ENET_EVENT_TYPE_RECEIVE) {
+        continue;
+      }
+
+      if (auto packet = ox::NetPacket::from_packet(event.packet)) {
+        if (auto reader = packet->get_rpcs()) {
+          procs.dispatch(static_cast<ox::NetClientID>(0), reader.value());
+        }
+      }
+      enet_packet_destroy(event.packet);
+    }
+  };
+
+  auto flush = [&] {
+    auto packet = ox::NetPacket::rpc(batch);
+    batch.clear();
+    if (!packet.has_value()) {
+      return;
+    }
+
+    packets += 1;
+    bytes += packet->inner->dataLength;
+    packet->inner->flags = ENET_PACKET_FLAG_RELIABLE;
+    if (enet_peer_send(loopback.peer, ox::NET_CHANNEL_RELIABLE, packet.value()) < 0) {
+      packet->destroy();
+    }
+
+    enet_host_service(loopback.client, nullptr, 0);
+    drain_server();
+  };
+
+  auto result = ox::bench::run(scenario.name, ITERATIONS, [&] {
+    received = 0;
+    for (auto i = 0_sz; i < CALLS; i++) {
+      std::ignore = batch.add(0, params);
+      if (batch.call_count >= scenario.calls_per_packet || batch.should_flush()) {
+        flush();
+      }
+    }
+    flush();
+
+    // Whatever ENet is still holding on to.
+    while (received < CALLS) {
+      enet_host_service(loopback.client, nullptr, 0);
+      drain_server();
+    }
+  });
+
+  const auto runs = static_cast<f64>(ITERATIONS + std::max(ITERATIONS / 10, 1_sz));
+  const auto calls_per_sec = static_cast<f64>(CALLS) / (result.mean_us / 1'000'000.0);
+  suite.add(
+    result.counter("calls/s", calls_per_sec)
+      .counter("packets/run", static_cast<f64>(packets) / runs)
+      .counter("bytes/call", static_cast<f64>(bytes) / (runs * static_cast<f64>(CALLS)))
+  );
+}
+} // namespace
+
+auto main(i32 argc, char** argv) -> i32 {
+  auto suite = ox::bench::Suite(argc, argv);
+  if (enet_initialize() != 0) {
+    return 1;
+  }
+
+  auto received = 0_sz;
+  auto procs = ox::NetProcTable{};
+  procs.add("player_move", [&](ox::NetClientID, std::span<const ox::RPCArg> args) {
+    ox::bench::do_not_optimize(args[3].as_str());
+    received += 1;
+  });
+
+  auto loopback = Loopback{};
+  if (!loopback.connect()) {
+    fmt::print("Could not connect over loopback on port {}.\n", PORT);
+    loopback.destroy();
+    enet_deinitialize();
+    return 1;
+  }
+
+  fmt::print("{} calls per run, 3 floats and a string each\n", CALLS);
+  run_scenario(suite, loopback, procs, received, {.name = "rpc/one_packet_per_call", .calls_per_packet = 1});
+  run_scenario(suite, loopback, procs, received, {.name = "rpc/batched_16", .calls_per_packet = 16});
+  // Everything queued in a tick, only split where NetRPCBatch::FLUSH_BYTES would split it.
+  run_scenario(suite, loopback, procs, received, {.name = "rpc/batched_per_tick", .calls_per_packet = CALLS});
+
+  loopback.destroy();
+  enet_deinitialize();
+  return suite.finish();
+}
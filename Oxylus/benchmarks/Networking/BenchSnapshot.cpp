@@ -0,0 +1,156 @@
+#include <enet.h>
+#include <random>
+
+#include "BenchHelpers.hpp"
+#include "Networking/NetPacket.hpp"
+#include "Scene/Components.hpp"
+
+// Server side capture and delta, then the snapshot packet is handed straight to the client side decoder
+// (in process loopback, no sockets involved).
+
+namespace {
+constexpr auto ENTITY_COUNT = 10'000_sz;
+constexpr auto MOVING_RATIO = 0.1;
+constexpr auto ITERATIONS = 200_sz;
+constexpr auto CLIENT = static_cast<ox::NetClientID>(1);
+
+auto register_components(flecs::world& world) -> void {
+  world.component<glm::vec3>().member<f32>("x").member<f32>("y").member<f32>("z");
+  world.component<glm::quat>().member<f32>("x").member<f32>("y").member<f32>("z").member<f32>("w");
+
+  auto transform = world.component<ox::TransformComponent>()
+                     .member("position", &ox::TransformComponent::position)
+                     .member("rotation", &ox::TransformComponent::rotation)
+                     .member("scale", &ox::TransformComponent::scale)
+                     .add<ox::Networked>();
+  transform.lookup("position").set<ox::NetQuantize>({.precision = 1.0f / 1024.0f});
+  transform.lookup("scale").set<ox::NetQuantize>({.precision = 1.0f / 1024.0f});
+}
+
+struct Scenario {
+  std::string_view name = {};
+  bool schema = false;
+  bool compress = false;
+  bool dictionary = false;
+};
+
+auto run_scenario(ox::bench::Suite& suite, const Scenario& scenario) -> void {
+  if (!suite.should_run(scenario.name)) {
+    return;
+  }
+
+  auto world = flecs::world{};
+  register_components(world);
+
+  auto rng = std::mt19937(1337);
+  auto position_dist = std::uniform_real_distribution(-500.0f, 500.0f);
+  auto entities = std::vector<flecs::entity>{};
+  entities.reserve(ENTITY_COUNT);
+  for (auto i = 0_sz; i < ENTITY_COUNT; i++) {
+    auto position = glm::vec3(position_dist(rng), 0.0f, position_dist(rng));
+    entities.push_back(world.entity().set<ox::TransformComponent>({.position = position}));
+  }
+
+  auto server = ox::SnapshotCodec{};
+  auto client = ox::SnapshotCodec{};
+  if (scenario.schema) {
+    server.schema.build(world);
+    client.schema.build(world);
+  }
+  server.compress = scenario.compress;
+
+  auto builder = ox::SceneSnapshotBuilder{};
+  auto move_some = [&] {
+    const auto moving = static_cast<usize>(static_cast<f64>(entities.size()) * MOVING_RATIO);
+    for (auto i = 0_sz; i < moving; i++) {
+      auto& transform = entities[rng() % entities.size()].get_mut<ox::TransformComponent>();
+      transform.position.x += 0.1f;
+      transform.rotation = glm::normalize(transform.rotation * glm::angleAxis(0.01f, glm::vec3(0.0f, 1.0f, 0.0f)));
+    }
+  };
+
+  if (scenario.dictionary) {
+    auto samples = std::vector<std::vector<u8>>{};
+    for (auto i = 0; i < 64; i++) {
+      move_some();
+      builder.capture(world);
+      auto& sample = samples.emplace_back();
+      std::ignore = server.encode(builder.flat_delta(ox::nullopt), builder.current_sequence, ox::nullopt, sample);
+      builder.advance();
+    }
+
+    auto dictionary = ox::SnapshotCodec::train_dictionary(samples, 16 * 1024);
+    server.set_dictionary(dictionary);
+    client.set_dictionary(dictionary);
+  }
+
+  auto full_bytes = 0_sz;
+  auto delta_bytes = 0_sz;
+  auto delta_samples = 0_sz;
+
+  auto capture = ox::bench::run(fmt::format("{}/capture", scenario.name), ITERATIONS, [&] {
+    move_some();
+    builder.capture(world);
+  });
+
+  const ox::SnapshotDelta* delta_records = nullptr;
+  auto delta = ox::bench::run(fmt::format("{}/delta", scenario.name), ITERATIONS, [&] {
+    delta_records = &builder.flat_delta(builder.baseline(CLIENT));
+  });
+
+  auto packet = ox::option<ox::NetPacket>{};
+  auto encode = ox::bench::run(fmt::format("{}/encode", scenario.name), ITERATIONS, [&] {
+    if (packet.has_value()) {
+      packet->destroy();
+    }
+    packet = ox::NetPacket::scene_snapshot(*delta_records, builder.current_sequence, builder.baseline(CLIENT), &server);
+  });
+
+  auto decode = ox::bench::run(fmt::format("{}/decode", scenario.name), ITERATIONS, [&] {
+    auto received = ox::NetPacket::from_packet(packet->inner);
+    auto snapshot = received->get_scene_snapshot(&client);
+    ox::bench::do_not_optimize(snapshot);
+  });
+  full_bytes = packet->inner->dataLength;
+  packet->destroy();
+
+  // Steady state, every tick acked before the next one.
+  for (auto i = 0_sz; i < ITERATIONS; i++) {
+    builder.advance();
+    move_some();
+    builder.capture(world);
+    const auto baseline = builder.baseline(CLIENT);
+    const auto& tick_delta = builder.flat_delta(baseline);
+    if (auto tick_packet = ox::NetPacket::scene_snapshot(tick_delta, builder.current_sequence, baseline, &server)) {
+      if (baseline.has_value()) {
+        delta_bytes += tick_packet->inner->dataLength;
+        delta_samples += 1;
+      }
+      tick_packet->destroy();
+    }
+    builder.ack(CLIENT, builder.current_sequence);
+  }
+
+  const auto delta_avg = delta_samples ? static_cast<f64>(delta_bytes) / static_cast<f64>(delta_samples) : 0.0;
+  suite.add(capture);
+  suite.add(delta);
+  suite.add(encode.counter("full_bytes", static_cast<f64>(full_bytes)).counter("delta_bytes", delta_avg));
+  suite.add(decode);
+}
+} // namespace
+
+auto main(i32 argc, char** argv) -> i32 {
+  auto suite = ox::bench::Suite(argc, argv);
+  if (enet_initialize() != 0) {
+    return 1;
+  }
+
+  fmt::print("{} entities, {:.0f}% moving per tick\n", ENTITY_COUNT, MOVING_RATIO * 100.0);
+  run_scenario(suite, {.name = "snapshot/raw"});
+  run_scenario(suite, {.name = "snapshot/quantized", .schema = true});
+  run_scenario(suite, {.name = "snapshot/quantized+zstd", .schema = true, .compress = true});
+  run_scenario(suite, {.name = "snapshot/quantized+zstd_dict", .schema = true, .compress = true, .dictionary = true});
+
+  enet_deinitialize();
+  return suite.finish();
+}
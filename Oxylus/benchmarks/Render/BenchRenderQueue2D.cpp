@@ -0,0 +1,92 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "BenchHelpers.hpp"
+#include "Core/JobManager.hpp"
+#include "Scene/SceneGPU.hpp"
+
+// Sorting a frame's sprites back to front: the comparison sort the queue used to do, which rebuilds both keys on
+// every comparison, against the radix sort over keys made once per sprite, serial and on the job manager. Every
+// iteration starts from the same unsorted queue, copying it in is part of each scenario.
+
+namespace {
+constexpr auto ITERATIONS = 20_sz;
+
+// Sprites spread over a few depth layers, a third of them y sorted, the way a 2D scene looks.
+auto fill(ox::GPU::RenderQueue2D& queue, usize count) -> void {
+  auto rng = std::mt19937(42);
+  auto layer = std::uniform_int_distribution<i32>(0, 15);
+  auto y = std::uniform_real_distribution<f32>(-500.0f, 500.0f);
+
+  queue.init();
+  for (auto i = 0_sz; i < count; i++) {
+    const auto flags = static_cast<u16>(i % 3 == 0 ? ox::GPU::RENDER_FLAGS_2D_SORT_Y : 0);
+    queue.add(flags, y(rng), static_cast<u32>(i), static_cast<u32>(i % 64), static_cast<f32>(layer(rng)));
+  }
+  queue.update();
+}
+} // namespace
+
+auto main(i32 argc, char** argv) -> i32 {
+  auto suite = ox::bench::Suite(argc, argv);
+
+  auto job_man = ox::JobManager{};
+  if (auto result = job_man.init(); !result) {
+    fmt::print(stderr, "{}\n", result.error());
+    return 1;
+  }
+
+  fmt::print("{} worker threads\n", job_man.get_thread_count());
+
+  auto failed = false;
+  for (const auto& [label, count] : {std::pair("100k", 100'000_sz), std::pair("1m", 1'000'000_sz)}) {
+    auto source = ox::GPU::RenderQueue2D();
+    fill(source, count);
+
+    const auto per_sprite = [count](ox::bench::Result& result) -> ox::bench::Result& {
+      return result.counter("ns/sprite", result.median_us * 1000.0 / static_cast<f64>(count));
+    };
+
+    auto name = fmt::format("render_queue_2d/std_sort_{}", label);
+    if (suite.should_run(name)) {
+      auto sprites = std::vector<ox::GPU::SpriteGPUData>();
+      auto result = ox::bench::run(name, ITERATIONS, [&] {
+        sprites = source.sprite_data;
+        std::ranges::sort(sprites, std::greater<ox::GPU::SpriteGPUData>());
+        ox::bench::do_not_optimize(sprites.front());
+      });
+      suite.add(per_sprite(result));
+    }
+
+    const auto radix = [&](std::string_view scenario, ox::JobManager* job_manager) {
+      name = fmt::format("render_queue_2d/{}_{}", scenario, label);
+      if (!suite.should_run(name)) {
+        return;
+      }
+
+      auto queue = source;
+      auto result = ox::bench::run(name, ITERATIONS, [&] {
+        queue.sprite_data = source.sprite_data;
+        queue.sort_keys = source.sort_keys;
+        queue.sort(job_manager);
+        ox::bench::do_not_optimize(queue.sprite_data.front());
+      });
+      suite.add(per_sprite(result));
+
+      failed |= !std::ranges::is_sorted(queue.sprite_data, std::greater<ox::GPU::SpriteGPUData>());
+    };
+
+    radix("radix", nullptr);
+    radix("radix_parallel", &job_man);
+  }
+
+  job_man.shutdown();
+
+  if (failed) {
+    fmt::print(stderr, "The radix sorted queue is out of order.\n");
+    return 1;
+  }
+
+  return suite.finish();
+}
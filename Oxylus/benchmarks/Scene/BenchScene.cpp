@@ -0,0 +1,274 @@
+#include <chrono>
+#include <filesystem>
+#include <random>
+#include <span>
+#include <vector>
+
+#include "Asset/AssetManager.hpp"
+#include "BenchHelpers.hpp"
+#include "Core/App.hpp"
+#include "Physics/Physics.hpp"
+#include "Scene/Scene.hpp"
+
+// Whole engine scenarios on a headless app, no window and no GPU. Meshes of an imported glTF aren't
+// processed without a render context, so the glTF numbers are parsing, hierarchy and metadata.
+
+namespace {
+constexpr auto ROOTS = 100_sz;
+constexpr auto CHILDREN_PER_ROOT = 99_sz;
+constexpr auto ENTITY_COUNT = ROOTS * (CHILDREN_PER_ROOT + 1);
+constexpr auto SIMULATED_FRAMES = 1'000_sz;
+constexpr auto MOVING_RATIO = 0.1;
+
+constexpr auto GLTF_GRID = 64_u32;
+constexpr auto GLTF_MESHES = 256_u32;
+constexpr auto GLTF_NODES = 4'096_u32;
+constexpr auto GLTF_MATERIALS = 16_u32;
+
+// `ROOTS` entities with `CHILDREN_PER_ROOT` children each, children are what gets moved around.
+auto populate(ox::Scene& scene, std::vector<flecs::entity>& children) -> void {
+  children.clear();
+  for (auto root_index = 0_sz; root_index < ROOTS; root_index++) {
+    auto root = scene.create_entity(fmt::format("root_{}", root_index));
+    for (auto child_index = 0_sz; child_index < CHILDREN_PER_ROOT; child_index++) {
+      // Names are looked up at the root first, a repeated one would hand back the same entity.
+      auto child = scene.create_entity(fmt::format("child_{}_{}", root_index, child_index));
+      child.child_of(root);
+      children.push_back(child);
+    }
+  }
+}
+
+// A grid mesh shared by all meshes, `GLTF_NODES` nodes in two levels and some untextured materials.
+auto write_gltf(const std::filesystem::path& path) -> bool {
+  const auto vertex_count = GLTF_GRID * GLTF_GRID;
+  const auto index_count = (GLTF_GRID - 1) * (GLTF_GRID - 1) * 6;
+
+  auto positions = std::vector<f32>();
+  auto normals = std::vector<f32>();
+  auto uvs = std::vector<f32>();
+  auto indices = std::vector<u32>();
+  for (auto y = 0_u32; y < GLTF_GRID; y++) {
+    for (auto x = 0_u32; x < GLTF_GRID; x++) {
+      const auto u = static_cast<f32>(x) / static_cast<f32>(GLTF_GRID - 1);
+      const auto v = static_cast<f32>(y) / static_cast<f32>(GLTF_GRID - 1);
+      positions.insert(positions.end(), {u, 0.0f, v});
+      normals.insert(normals.end(), {0.0f, 1.0f, 0.0f});
+      uvs.insert(uvs.end(), {u, v});
+    }
+  }
+  for (auto y = 0_u32; y + 1 < GLTF_GRID; y++) {
+    for (auto x = 0_u32; x + 1 < GLTF_GRID; x++) {
+      const auto i = y * GLTF_GRID + x;
+      indices.insert(indices.end(), {i, i + GLTF_GRID, i + 1, i + 1, i + GLTF_GRID, i + GLTF_GRID + 1});
+    }
+  }
+
+  auto bin = std::vector<u8>();
+  auto append = [&bin](const auto& values) {
+    const auto offset = bin.size();
+    const auto* bytes = reinterpret_cast<const u8*>(values.data());
+    bin.insert(bin.end(), bytes, bytes + ox::size_bytes(values));
+    return offset;
+  };
+  const auto positions_offset = append(positions);
+  const auto normals_offset = append(normals);
+  const auto uvs_offset = append(uvs);
+  const auto indices_offset = append(indices);
+
+  auto bin_path = path;
+  bin_path.replace_extension(".bin");
+  auto bin_file = ox::File(bin_path, ox::FileAccess::Write);
+  if (!bin_file || bin_file.write(bin) != bin.size()) {
+    return false;
+  }
+
+  auto json = fmt::memory_buffer();
+  auto out = fmt::appender(json);
+  fmt::format_to(out, R"({{"asset":{{"version":"2.0"}},"scene":0,"scenes":[{{"nodes":[)");
+  const auto roots = GLTF_NODES / 64;
+  for (auto i = 0_u32; i < roots; i++) {
+    fmt::format_to(out, "{}{}", i ? "," : "", i * 64);
+  }
+  fmt::format_to(out, "]}}],");
+
+  fmt::format_to(out, R"("nodes":[)");
+  for (auto i = 0_u32; i < GLTF_NODES; i++) {
+    fmt::format_to(
+      out, R"({}{{"name":"node_{}","mesh":{},"translation":[{},0,0])", i ? "," : "", i, i % GLTF_MESHES, i
+    );
+    if (i % 64 == 0) {
+      fmt::format_to(out, R"(,"children":[)");
+      for (auto child = i + 1; child < i + 64; child++) {
+        fmt::format_to(out, "{}{}", child != i + 1 ? "," : "", child);
+      }
+      fmt::format_to(out, "]");
+    }
+    fmt::format_to(out, "}}");
+  }
+  fmt::format_to(out, "],");
+
+  fmt::format_to(out, R"("meshes":[)");
+  for (auto i = 0_u32; i < GLTF_MESHES; i++) {
+    fmt::format_to(
+      out,
+      R"({}{{"name":"mesh_{}","primitives":[{{"attributes":{{"POSITION":0,"NORMAL":1,"TEXCOORD_0":2}},)"
+      R"("indices":3,"material":{}}}]}})",
+      i ? "," : "",
+      i,
+      i % GLTF_MATERIALS
+    );
+  }
+  fmt::format_to(out, "],");
+
+  fmt::format_to(out, R"("materials":[)");
+  for (auto i = 0_u32; i < GLTF_MATERIALS; i++) {
+    fmt::format_to(
+      out,
+      R"({}{{"name":"material_{}","pbrMetallicRoughness":{{"baseColorFactor":[1,1,1,1],"roughnessFactor":{}}}}})",
+      i ? "," : "",
+      i,
+      static_cast<f32>(i) / static_cast<f32>(GLTF_MATERIALS)
+    );
+  }
+  fmt::format_to(out, "],");
+
+  fmt::format_to(
+    out,
+    R"("accessors":[)"
+    R"({{"bufferView":0,"componentType":5126,"count":{},"type":"VEC3","min":[0,0,0],"max":[1,0,1]}},)"
+    R"({{"bufferView":1,"componentType":5126,"count":{},"type":"VEC3"}},)"
+    R"({{"bufferView":2,"componentType":5126,"count":{},"type":"VEC2"}},)"
+    R"({{"bufferView":3,"componentType":5125,"count":{},"type":"SCALAR"}}],)",
+    vertex_count,
+    vertex_count,
+    vertex_count,
+    index_count
+  );
+  fmt::format_to(
+    out,
+    R"("bufferViews":[)"
+    R"({{"buffer":0,"byteOffset":{},"byteLength":{}}},)"
+    R"({{"buffer":0,"byteOffset":{},"byteLength":{}}},)"
+    R"({{"buffer":0,"byteOffset":{},"byteLength":{}}},)"
+    R"({{"buffer":0,"byteOffset":{},"byteLength":{}}}],)",
+    positions_offset,
+    ox::size_bytes(positions),
+    normals_offset,
+    ox::size_bytes(normals),
+    uvs_offset,
+    ox::size_bytes(uvs),
+    indices_offset,
+    ox::size_bytes(indices)
+  );
+  fmt::format_to(out, R"("buffers":[{{"uri":"{}","byteLength":{}}}]}})", bin_path.filename().string(), bin.size());
+
+  auto gltf_file = ox::File(path, ox::FileAccess::Write);
+  return gltf_file && gltf_file.write(std::span(json.data(), json.size())) == json.size();
+}
+} // namespace
+
+auto main(i32 argc, char** argv) -> i32 {
+  auto suite = ox::bench::Suite(argc, argv);
+
+  static char name[] = "BenchScene";
+  static char* app_argv[] = {name};
+  auto app = ox::App(1, app_argv);
+  loguru::g_stderr_verbosity = loguru::Verbosity_WARNING;
+  app.with_headless(60.0).with<ox::AssetManager>().with<ox::Physics>().init();
+
+  const auto temp_dir = std::filesystem::temp_directory_path() / "oxylus_bench_scene";
+  std::filesystem::create_directories(temp_dir);
+
+  fmt::print("{} entities, {} roots\n", ENTITY_COUNT, ROOTS);
+  auto children = std::vector<flecs::entity>();
+
+  if (suite.should_run("scene/create_entities")) {
+    suite.add(ox::bench::run("scene/create_entities", 10, [&] {
+      auto scene = ox::Scene("BenchScene");
+      populate(scene, children);
+    }));
+  }
+
+  auto scene = std::make_unique<ox::Scene>("BenchScene");
+  populate(*scene, children);
+
+  if (suite.should_run("scene/set_dirty")) {
+    suite.add(ox::bench::run("scene/set_dirty", 50, [&] {
+      for (auto child : children) {
+        scene->set_dirty(child);
+      }
+    }));
+  }
+
+  const auto scene_path = temp_dir / "bench.oxscene";
+  if (suite.should_run("scene/save")) {
+    suite.add(ox::bench::run("scene/save", 10, [&] { scene->save_to_file(scene_path); }));
+  } else {
+    scene->save_to_file(scene_path);
+  }
+
+  if (suite.should_run("scene/load")) {
+    // Includes setting up the empty scene it loads into.
+    suite.add(ox::bench::run("scene/load", 10, [&] {
+      auto loaded = ox::Scene("Loaded");
+      loaded.load_from_file(scene_path);
+    }));
+  }
+
+  if (suite.should_run("scene/simulate")) {
+    auto rng = std::mt19937(1337);
+    scene->runtime_start();
+    auto result = ox::bench::run("scene/simulate", 3, [&] {
+      for (auto frame = 0_sz; frame < SIMULATED_FRAMES; frame++) {
+        const auto moving = static_cast<usize>(static_cast<f64>(children.size()) * MOVING_RATIO);
+        for (auto i = 0_sz; i < moving; i++) {
+          auto child = children[rng() % children.size()];
+          auto transform = child.get<ox::TransformComponent>();
+          transform.position.x += 0.1f;
+          child.set<ox::TransformComponent>(transform);
+        }
+
+        app.step();
+        scene->runtime_update(ox::App::get_timestep());
+      }
+    });
+    scene->runtime_stop();
+    suite.add(result.counter("ms/frame", result.median_us / 1000.0 / static_cast<f64>(SIMULATED_FRAMES)));
+  }
+  scene.reset();
+
+  const auto gltf_path = temp_dir / "bench_model.gltf";
+  const auto gltf_meta_path = std::filesystem::path(gltf_path.string() + ".oxasset");
+  if ((suite.should_run("gltf/import") || suite.should_run("gltf/load")) && write_gltf(gltf_path)) {
+    using Clock = std::chrono::steady_clock;
+    auto& asset_man = ox::App::mod<ox::AssetManager>();
+
+    // Every import starts without a meta file, so it's the first import of the file each time.
+    auto import_samples = std::vector<f64>();
+    auto load_samples = std::vector<f64>();
+    for (auto i = 0; i < 10; i++) {
+      std::filesystem::remove(gltf_meta_path);
+
+      auto start = Clock::now();
+      auto uuid = asset_man.import_asset(gltf_path);
+      import_samples.push_back(std::chrono::duration<f64, std::micro>(Clock::now() - start).count());
+
+      start = Clock::now();
+      asset_man.load_asset(uuid);
+      load_samples.push_back(std::chrono::duration<f64, std::micro>(Clock::now() - start).count());
+
+      asset_man.delete_asset(uuid);
+    }
+
+    auto import = ox::bench::summarize("gltf/import", std::move(import_samples));
+    auto load = ox::bench::summarize("gltf/load", std::move(load_samples));
+    suite.add(import.counter("nodes", GLTF_NODES).counter("meshes", GLTF_MESHES));
+    suite.add(load.counter("nodes", GLTF_NODES).counter("meshes", GLTF_MESHES));
+  }
+
+  app.stop();
+  std::filesystem::remove_all(temp_dir);
+
+  return suite.finish();
+}
@@ -0,0 +1,175 @@
+#include <cstdlib>
+#include <flecs.h>
+#include <glm/vec3.hpp>
+#include <sol/state.hpp>
+
+#include "BenchHelpers.hpp"
+#include "Scripting/LuaComponentView.hpp"
+#include "Scripting/LuaMathBindings.hpp"
+
+// A particle update, velocity pulled by gravity and position moved by velocity, written with vector
+// operators, which make a new userdata per result, and with the in-place and unpacked forms. Besides time
+// each scenario reports what Lua's allocator was asked for during one run.
+
+namespace {
+struct BenchParticle {
+  glm::vec3 position = {};
+  glm::vec3 velocity = {};
+};
+
+// Every allocation and growing realloc Lua makes, frees don't take anything off.
+struct AllocCounter {
+  u64 bytes = 0;
+  u64 allocations = 0;
+};
+
+auto counting_alloc(void* user, void* ptr, size_t old_size, size_t new_size) -> void* {
+  if (new_size == 0) {
+    std::free(ptr);
+    return nullptr;
+  }
+
+  // Without a block `old_size` is the kind of object being made, not a size.
+  const auto previous = ptr ? old_size : 0;
+  if (new_size > previous) {
+    auto* counter = static_cast<AllocCounter*>(user);
+    counter->bytes += new_size - previous;
+    counter->allocations += 1;
+  }
+
+  return std::realloc(ptr, new_size);
+}
+
+constexpr auto PARTICLES = 10'000_sz;
+constexpr auto DT = 1.0f / 60.0f;
+
+constexpr auto SCRIPT = R"(
+gravity = vec3.new(0, -9.81, 0)
+positions = {}
+velocities = {}
+for i = 1, PARTICLES do
+  positions[i] = vec3.new(i, 0, 0)
+  velocities[i] = vec3.new(1, i * 0.01, -1)
+end
+
+function operators(dt)
+  for i = 1, PARTICLES do
+    local velocity = velocities[i] + gravity * dt
+    velocities[i] = velocity
+    positions[i] = positions[i] + velocity * dt
+  end
+end
+
+function in_place(dt)
+  for i = 1, PARTICLES do
+    local velocity = velocities[i]
+    velocity:add_scaled_(gravity, dt)
+    positions[i]:add_scaled_(velocity, dt)
+  end
+end
+
+function view_fields(dt)
+  for i = 1, PARTICLES do
+    local p = particles[i]
+    local velocity = p.velocity + gravity * dt
+    p.velocity = velocity
+    p.position = p.position + velocity * dt
+  end
+end
+
+function view_unpacked(dt)
+  local gy = -9.81 * dt
+  for i = 1, PARTICLES do
+    local p = particles[i]
+    local vx, vy, vz = p:velocity_xyz()
+    vy = vy + gy
+    p:set_velocity_xyz(vx, vy, vz)
+    local x, y, z = p:position_xyz()
+    p:set_position_xyz(x + vx * dt, y + vy * dt, z + vz * dt)
+  end
+end
+)";
+} // namespace
+
+auto main(i32 argc, char** argv) -> i32 {
+  auto suite = ox::bench::Suite(argc, argv);
+
+  auto world = flecs::world();
+  world.component<glm::vec3>("glm::vec3")
+    .member("x", &glm::vec3::x)
+    .member("y", &glm::vec3::y)
+    .member("z", &glm::vec3::z);
+  world.component<BenchParticle>("BenchParticle")
+    .member("position", &BenchParticle::position)
+    .member("velocity", &BenchParticle::velocity);
+
+  auto allocated = AllocCounter{};
+  auto state = sol::state(sol::default_at_panic, counting_alloc, &allocated);
+  state.open_libraries(sol::lib::base);
+  ox::MathBinding().bind(&state);
+  ox::LuaComponentView::bind(&state);
+  state["PARTICLES"] = PARTICLES;
+
+  auto particles = std::vector<BenchParticle>(PARTICLES);
+  const auto* layout = ox::LuaComponentLayout::get(world, world.component<BenchParticle>());
+  auto views = state.create_table(static_cast<i32>(PARTICLES));
+  for (auto i = 0_sz; i < PARTICLES; i++) {
+    views[i + 1] = ox::LuaComponentView{.ptr = &particles[i], .layout = layout, .is_mutable = true};
+  }
+  state["particles"] = views;
+
+  auto loaded = state.safe_script(SCRIPT, sol::script_pass_on_error);
+  if (!loaded.valid()) {
+    const sol::error err = loaded;
+    fmt::print(stderr, "Failed to load the benchmark script: {}\n", err.what());
+    return 1;
+  }
+
+  auto failed = false;
+  auto call = [&](const sol::protected_function& fn) {
+    auto result = fn(DT);
+    if (!result.valid() && !failed) {
+      const sol::error err = result;
+      fmt::print(stderr, "{}\n", err.what());
+      failed = true;
+    }
+  };
+
+  // Allocated during one run, whether or not it was collected before the run ended.
+  auto allocated_by = [&](const sol::protected_function& fn) {
+    state.collect_garbage();
+    allocated = {};
+    call(fn);
+    return allocated;
+  };
+
+  auto add = [&](std::string_view name, usize iterations, const sol::protected_function& fn) {
+    if (!suite.should_run(name)) {
+      return;
+    }
+
+    const auto run_allocated = allocated_by(fn);
+    const auto count = static_cast<f64>(PARTICLES);
+    auto result = ox::bench::run(name, iterations, [&] { call(fn); });
+    result.counter("ns/particle", result.median_us * 1000.0 / count);
+    result.counter("alloc bytes/particle", static_cast<f64>(run_allocated.bytes) / count);
+    suite.add(result.counter("allocs/particle", static_cast<f64>(run_allocated.allocations) / count));
+  };
+
+  add("lua_math/operators", 20, state["operators"]);
+  add("lua_math/in_place", 20, state["in_place"]);
+  add("lua_math/view_fields", 20, state["view_fields"]);
+  add("lua_math/view_unpacked", 20, state["view_unpacked"]);
+
+  auto checksum = 0.0f;
+  for (const auto& particle : particles) {
+    checksum += particle.position.x;
+  }
+  ox::bench::do_not_optimize(checksum);
+
+  if (failed) {
+    return 1;
+  }
+
+  return suite.finish();
+}
@@ -0,0 +1,121 @@
+#include <flecs.h>
+#include <glm/vec3.hpp>
+#include <sol/state.hpp>
+
+#include "BenchHelpers.hpp"
+#include "Scripting/LuaFlecsBindings.hpp"
+#include "Scripting/LuaMathBindings.hpp"
+
+// The same system, `position += velocity * dt`, written against the per-entity API, against field arrays
+// indexed per element, and as one batched helper call per table. Native is the C++ loop for reference.
+
+namespace {
+struct BenchPosition {
+  glm::vec3 value = {};
+};
+
+struct BenchVelocity {
+  glm::vec3 value = {};
+};
+
+constexpr auto ENTITIES = 100'000_sz;
+constexpr auto DT = 1.0f / 60.0f;
+
+constexpr auto SCRIPT = R"(
+function per_entity(it, dt)
+  local positions = it:field(0, BenchPosition)
+  local velocities = it:field(1, BenchVelocity)
+  for i = 0, it:count() - 1 do
+    local position = positions:at(i)
+    position.value = position.value + velocities:at(i).value * dt
+  end
+end
+
+function per_element(it, dt)
+  local positions = it:column(0, BenchPosition):field("value")
+  local velocities = it:column(1, BenchVelocity):field("value")
+  for i = 0, #positions - 1 do
+    positions[i] = positions[i] + velocities[i] * dt
+  end
+end
+
+function batched(it, dt)
+  it:column(0, BenchPosition):field("value"):add_scaled(it:column(1, BenchVelocity):field("value"), dt)
+end
+)";
+} // namespace
+
+auto main(i32 argc, char** argv) -> i32 {
+  auto suite = ox::bench::Suite(argc, argv);
+
+  auto world = flecs::world();
+  world.component<glm::vec3>("glm::vec3")
+    .member("x", &glm::vec3::x)
+    .member("y", &glm::vec3::y)
+    .member("z", &glm::vec3::z);
+  world.component<BenchPosition>("BenchPosition").member("value", &BenchPosition::value);
+  world.component<BenchVelocity>("BenchVelocity").member("value", &BenchVelocity::value);
+
+  for (auto i = 0_sz; i < ENTITIES; i++) {
+    const auto f = static_cast<f32>(i);
+    world.entity().set<BenchPosition>({{f, 0.0f, 0.0f}}).set<BenchVelocity>({{1.0f, f * 0.01f, -1.0f}});
+  }
+  auto query = world.query<BenchPosition, BenchVelocity>();
+
+  auto state = sol::state();
+  state.open_libraries(sol::lib::base);
+  ox::MathBinding().bind(&state);
+  ox::FlecsBinding().bind(&state);
+  state["BenchPosition"] = state.create_table_with("component_id", world.component<BenchPosition>().id());
+  state["BenchVelocity"] = state.create_table_with("component_id", world.component<BenchVelocity>().id());
+
+  auto loaded = state.safe_script(SCRIPT, sol::script_pass_on_error);
+  if (!loaded.valid()) {
+    const sol::error err = loaded;
+    fmt::print(stderr, "Failed to load the benchmark script: {}\n", err.what());
+    return 1;
+  }
+
+  auto failed = false;
+  auto run_system = [&](const sol::protected_function& system) {
+    auto it = ecs_query_iter(world, query.c_ptr());
+    while (ecs_query_next(&it)) {
+      auto result = system(&it, DT);
+      if (!result.valid() && !failed) {
+        const sol::error err = result;
+        fmt::print(stderr, "{}\n", err.what());
+        failed = true;
+      }
+    }
+  };
+
+  auto add = [&](std::string_view name, usize iterations, auto&& fn) {
+    if (!suite.should_run(name)) {
+      return;
+    }
+
+    auto result = ox::bench::run(name, iterations, fn);
+    suite.add(result.counter("ns/entity", result.median_us * 1000.0 / static_cast<f64>(ENTITIES)));
+  };
+
+  add("lua_system/native", 50, [&] {
+    query.each([](BenchPosition& position, const BenchVelocity& velocity) { position.value += velocity.value * DT; });
+  });
+
+  const sol::protected_function per_entity = state["per_entity"];
+  const sol::protected_function per_element = state["per_element"];
+  const sol::protected_function batched = state["batched"];
+  add("lua_system/per_entity", 5, [&] { run_system(per_entity); });
+  add("lua_system/per_element", 10, [&] { run_system(per_element); });
+  add("lua_system/batched", 50, [&] { run_system(batched); });
+
+  auto checksum = 0.0f;
+  query.each([&](const BenchPosition& position, const BenchVelocity&) { checksum += position.value.x; });
+  ox::bench::do_not_optimize(checksum);
+
+  if (failed) {
+    return 1;
+  }
+
+  return suite.finish();
+}
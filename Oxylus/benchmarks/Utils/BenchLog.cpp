@@ -0,0 +1,77 @@
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "BenchHelpers.hpp"
+#include "Utils/Log.hpp"
+
+// Cost of a log call on the calling thread. Every round logs a burst that fits in the thread's ring and
+// then waits for the log thread outside the timed part, so this is what a frame pays for its messages.
+// Plain loguru formats and writes the file under its mutex right there, which is how OX_LOG_* used to work.
+
+namespace {
+constexpr auto BURST = 512_sz;
+constexpr auto ROUNDS = 200_sz;
+
+template <typename Fn>
+auto time_bursts(std::string_view name, Fn&& fn) -> ox::bench::Result {
+  using Clock = std::chrono::steady_clock;
+
+  auto samples_us = std::vector<f64>();
+  samples_us.reserve(ROUNDS);
+  for (auto round = 0_sz; round < ROUNDS; round++) {
+    const auto start = Clock::now();
+    for (auto i = 0_sz; i < BURST; i++) {
+      fn(i);
+    }
+    samples_us.push_back(std::chrono::duration<f64, std::micro>(Clock::now() - start).count());
+    ox::Log::flush();
+    loguru::flush();
+  }
+
+  auto result = ox::bench::summarize(name, std::move(samples_us));
+  return result.counter("ns/call", result.mean_us * 1000.0 / static_cast<f64>(BURST));
+}
+} // namespace
+
+auto main(i32 argc, char** argv) -> i32 {
+  auto suite = ox::bench::Suite(argc, argv);
+  std::filesystem::create_directories("logs");
+  loguru::g_stderr_verbosity = loguru::Verbosity_OFF;
+  loguru::g_preamble_thread = false;
+  loguru::add_file("logs/bench_log.log", loguru::Truncate, loguru::Verbosity_INFO);
+  ox::Log::set_rate_limit(0, 0);
+
+  const auto texture = std::string("textures/terrain/grass_albedo.ktx2");
+  const auto width = 2048_u32;
+  const auto height = 2048_u32;
+  const auto ms = 3.75;
+
+  fmt::print("{} calls per round, file sink only\n", BURST);
+  suite.add(time_bursts("log/loguru_sync", [&](usize i) {
+    LOG_F(INFO, "Loaded texture {} ({}x{}, mip {}) in {:.2f}ms", texture, width, height, i, ms);
+  }));
+
+  ox::Log::start_backend();
+  suite.add(time_bursts("log/async", [&](usize i) {
+    OX_LOG_INFO("Loaded texture {} ({}x{}, mip {}) in {:.2f}ms", texture, width, height, i, ms);
+  }));
+
+  // Paths aren't copied as they are, the caller formats and only the writing is deferred.
+  const auto path = std::filesystem::path(texture);
+  suite.add(time_bursts("log/async_preformatted", [&](usize i) {
+    OX_LOG_INFO("Loaded texture {} ({}x{}, mip {}) in {:.2f}ms", path, width, height, i, ms);
+  }));
+
+  // Everything past the first message of the window only bumps a counter.
+  ox::Log::set_rate_limit(1, 60'000);
+  suite.add(time_bursts("log/async_rate_limited", [&](usize i) {
+    OX_LOG_INFO("Loaded texture {} ({}x{}, mip {}) in {:.2f}ms", texture, width, height, i, ms);
+  }));
+
+  suite.add(time_bursts("log/below_cutoff", [&](usize i) { OX_LOG_TRACE("Mip {} uploaded", i); }));
+  ox::Log::stop_backend();
+
+  return suite.finish();
+}
@@ -0,0 +1,63 @@
+local benchmark_targets = {}
+
+for _, file in ipairs(os.files("./**/Bench*.cpp")) do
+    local name = path.basename(file)
+
+    -- Script benchmarks drive the Lua bindings, which aren't built without them.
+    if has_config("lua_bindings") or not file:find("Scripting") then
+        table.insert(benchmark_targets, name)
+
+        target(name)
+            set_kind("binary")
+            set_default(false)
+            set_languages("cxx23")
+            set_group("benchmarks")
+
+            add_deps("Oxylus")
+
+            add_includedirs(".")
+            add_files(file)
+
+            if is_plat("windows") then
+                add_ldflags("/subsystem:console")
+            end
+    end
+end
+
+-- Builds and runs every benchmark, arguments are handed to each of them:
+--   xmake run OxylusBenchmarks --json build/bench
+--   xmake run OxylusBenchmarks --baseline build/bench --threshold 10
+-- Fails when any of them fails, a regression against the baseline included.
+target("OxylusBenchmarks")
+    set_kind("phony")
+    set_default(false)
+    set_group("benchmarks")
+
+    add_deps(table.unpack(benchmark_targets))
+
+    on_run(function (target)
+        import("core.base.option")
+
+        local args = option.get("arguments") or {}
+        local failed = {}
+        for _, dep in ipairs(target:orderdeps()) do
+            if dep:kind() == "binary" and dep:get("group") == "benchmarks" then
+                cprint("${bright}%s", dep:name())
+                try {
+                    function ()
+                        os.execv(dep:targetfile(), args)
+                    end,
+                    catch {
+                        function ()
+                            table.insert(failed, dep:name())
+                        end
+                    }
+                }
+            end
+        end
+
+        if #failed > 0 then
+            raise("benchmarks failed: %s", table.concat(failed, ", "))
+        end
+    end)
+target_end()
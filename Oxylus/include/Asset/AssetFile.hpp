@@ -19,6 +19,7 @@ enum class AssetType : u32 {
   Scene,
   Audio,
   Script,
+  PhysicsShape,
 };
 
 // List of file extensions supported by Engine.
@@ -54,9 +55,28 @@ struct ShaderPipelineData {
   bool bindless = false;
 };
 
+// Baked collision shape for one mesh of a model, in Jolt's binary shape format.
+struct PhysicsShapeData {
+  using serialize_id = zpp::bits::serialization_id<AssetType::PhysicsShape>;
+
+  u32 mesh_index = 0;
+  u64 source_hash = 0;
+  std::vector<u8> shape_data = {};
+};
+
+// Precompiled Lua chunk of a script, see `compile_script_bytecode`.
+struct ScriptBytecodeData {
+  using serialize_id = zpp::bits::serialization_id<AssetType::Script>;
+
+  u64 source_hash = 0;
+  // Source had the `--!parallel` directive, see `is_parallel_script`.
+  bool parallel = false;
+  std::vector<u8> bytecode = {};
+};
+
 struct AssetFileEntry {
   AssetType type = AssetType::None;
-  std::variant<NoneAsset, ShaderPipelineData> data;
+  std::variant<NoneAsset, ShaderPipelineData, PhysicsShapeData, ScriptBytecodeData> data;
 
   constexpr static auto serialize(auto& archive, auto& self)
     requires(std::remove_cvref_t<decltype(archive)>::kind() == zpp::bits::kind::in)
@@ -81,7 +101,9 @@ consteval void enable_bitmask(AssetFileFlags);
 
 struct AssetFileHeader {
   static constexpr auto SIGNATURE = 0x4352584F_u32;
-  static constexpr auto VERSION = 1_u16;
+  // Bump whenever an entry's layout changes, packs of another version are rejected as a whole.
+  // 2: `ScriptBytecodeData::parallel`.
+  static constexpr auto VERSION = 2_u16;
 
   u32 magic = SIGNATURE; // "OXRC"
   u16 version = VERSION;
@@ -95,5 +117,7 @@ struct AssetFile {
   static auto unpack(const std::filesystem::path& path) -> option<AssetFile>;
   auto pack(this AssetFile& self, const std::filesystem::path& path) -> bool;
   auto add_entry(this AssetFile& self, ShaderPipelineData&& entry) -> void;
+  auto add_entry(this AssetFile& self, PhysicsShapeData&& entry) -> void;
+  auto add_entry(this AssetFile& self, ScriptBytecodeData&& entry) -> void;
 };
 } // namespace ox
@@ -98,6 +98,10 @@ public:
   auto get_null_material(this AssetManager& self) -> ReadGuard<Asset>;
   auto get_material(this AssetManager& self, const UUID& uuid) -> ReadGuard<Material>;
   auto get_material(this AssetManager& self, MaterialID material_id) -> ReadGuard<Material>;
+  // False once the material was unloaded, even if its slot is in use again.
+  auto is_material_loaded(this const AssetManager& self, MaterialID material_id) -> bool {
+    return self.material_map.is_valid(material_id);
+  }
   auto set_material_dirty(this AssetManager& self, MaterialID material_id) -> void;
   auto set_material_dirty(this AssetManager& self, const UUID& uuid) -> void;
   auto set_all_materials_dirty(this AssetManager& self) -> void;
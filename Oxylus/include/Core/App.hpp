@@ -2,6 +2,7 @@
 
 #include "Core/AppCommandLineArgs.hpp"
 #include "Core/EventSystem.hpp"
+#include "Core/InputRecording.hpp"
 #include "Core/JobManager.hpp"
 #include "Core/ModuleRegistry.hpp"
 #include "Core/VFS.hpp"
@@ -83,10 +84,27 @@ public:
     return self;
   }
 
+  // No window, no RenderContext and nothing uploaded to a GPU. Steps at a fixed `tick_rate` per second,
+  // sleeping in between. Only meant for modules that don't render, see `ServerModules`.
+  auto with_headless(this App& self, f64 tick_rate) -> App&;
+
+  auto is_headless(this const App& self) -> bool { return self.headless; }
+
+  // Every input event and frame time goes to `path` when the app stops. `--record-input <path>` does the same.
+  auto with_input_recording(this App& self, const std::filesystem::path& path) -> App&;
+  // Input comes from the recording instead of the window, every frame steps by exactly the recorded time
+  // without waiting for it and the app stops after the last one. With a headless app this makes the same
+  // gameplay frames every run. `--replay-input <path>` does the same.
+  auto with_input_replay(this App& self, const std::filesystem::path& path) -> App&;
+  // Frame time percentiles, metrics and the frame history go to `path` when the app stops, as CSV if it ends
+  // in .csv and JSON otherwise. `--profile-output <path>` does the same.
+  auto with_profile_output(this App& self, const std::filesystem::path& path) -> App&;
+
   auto get_command_line_args(this const App& self) -> const AppCommandLineArgs&;
 
   static auto get_window() -> const Window&;
   static auto get_rendercontext() -> RenderContext&;
+  static auto has_rendercontext() -> bool;
   static auto get_timestep() -> const Timestep&;
   static auto get_vfs() -> VFS&;
   static auto get_job_manager() -> JobManager&;
@@ -115,10 +133,18 @@ private:
 
   Timestep timestep = {};
   i32 frame_limit = 0;
+  bool headless = false;
+  f64 tick_rate = 0.0;
+
+  std::filesystem::path input_recording_path = {};
+  std::filesystem::path input_replay_path = {};
+  option<InputReplay> input_replay = nullopt;
+  std::filesystem::path profile_output_path = {};
 
   bool is_running = true;
 
   auto run_deferred_tasks(this App& self) -> void;
+  auto init_input_replay(this App& self) -> void;
 };
 
 App* create_application(const AppCommandLineArgs& args);
@@ -25,4 +25,7 @@ using DefaultModules = std::tuple<
   DebugRenderer,
   ImGuiRenderer,
   RmlUI>;
+
+// Everything a dedicated server needs, nothing here opens a window or touches the GPU.
+using ServerModules = std::tuple<LuaManager, AssetManager, Physics, NetworkManager>;
 }
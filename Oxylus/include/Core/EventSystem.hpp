@@ -1,6 +1,7 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <expected>
@@ -9,12 +10,13 @@
 #include <memory>
 #include <mutex>
 #include <shared_mutex>
+#include <string_view>
 #include <tracy/Tracy.hpp>
-#include <typeindex>
 #include <unordered_map>
 #include <vector>
 
 #include "Core/Option.hpp"
+#include "Memory/Hasher.hpp"
 #include "Utils/Log.hpp"
 
 namespace ox {
@@ -33,119 +35,189 @@ struct EventError {
 template <typename T>
 concept Event = std::is_object_v<T> && std::copyable<T>;
 
+template <typename T>
+consteval auto event_type_name() -> std::string_view {
+#if defined(_MSC_VER) && !defined(__clang__)
+  return __FUNCSIG__;
+#else
+  return __PRETTY_FUNCTION__;
+#endif
+}
+
+// Hash of the type's name as the compiler spells it, 0 is kept free for empty registry slots.
+template <Event EventType>
+constexpr u64 event_type_id = fnv64_c(event_type_name<EventType>()) | 1_u64;
+
 class RegistryBase {
 public:
   virtual ~RegistryBase();
+
+  virtual void dispatch_queued() = 0;
 };
 
+// Handlers live in an immutable array that emit reads through an atomic pointer. Subscribing or
+// unsubscribing publishes a modified copy, the old array is freed once no emit is reading anymore.
+// Emitting takes no lock and allocates nothing.
 template <Event EventType>
 class HandlerRegistry : public RegistryBase {
 public:
-  HandlerId subscribe(std::function<void(const EventType&)> handler) {
+  using Callback = std::function<void(const EventType&)>;
+
+  HandlerRegistry() = default;
+  HandlerRegistry(const HandlerRegistry&) = delete;
+  HandlerRegistry& operator=(const HandlerRegistry&) = delete;
+
+  ~HandlerRegistry() override {
+    delete handlers_.load();
+    for (const auto* list : retired_) {
+      delete list;
+    }
+  }
+
+  HandlerId subscribe(Callback handler) {
     ZoneScoped;
     auto id = next_id_.fetch_add(1);
-    auto h = std::make_shared<Handler>(std::move(handler), id);
 
-    std::unique_lock lock(mutex_);
-    handlers_.push_back(h);
+    std::unique_lock lock(write_mutex_);
+    const auto* current = handlers_.load();
+    auto* next = current ? new HandlerList(*current) : new HandlerList();
+    next->push_back({.callback = std::move(handler), .id = id});
+    publish(next);
+
     return id;
   }
 
   bool unsubscribe(HandlerId id) {
     ZoneScoped;
-    std::shared_lock lock(mutex_);
-
-    auto it = std::ranges::find_if(handlers_, [id](const auto& h) { return h->id == id; });
-
-    if (it != handlers_.end()) {
-      (*it)->active.store(false);
-      lock.unlock();
-
-      cleanup_inactive_handlers();
+    std::unique_lock lock(write_mutex_);
 
-      return true;
+    const auto* current = handlers_.load();
+    if (!current || std::ranges::none_of(*current, [id](const auto& h) { return h.id == id; })) {
+      return false;
     }
 
-    return false;
+    auto* next = new HandlerList();
+    next->reserve(current->size() - 1);
+    std::ranges::copy_if(*current, std::back_inserter(*next), [id](const auto& h) { return h.id != id; });
+    publish(next);
+
+    return true;
   }
 
   std::expected<void, EventError> emit(const EventType& event) {
     ZoneScoped;
-    std::shared_lock lock(mutex_);
+    auto guard = ReadGuard(readers_);
 
-    if (handlers_.empty()) {
+    const auto* handlers = handlers_.load();
+    if (!handlers || handlers->empty()) {
       return std::unexpected(EventError::NoHandlers);
     }
 
-    std::vector<std::shared_ptr<Handler>> active_handlers;
-    active_handlers.reserve(handlers_.size());
+    // Handlers unsubscribed from in here still run this time, the array they're in stays alive until
+    // the emit is done.
+    for (const auto& handler : *handlers) {
+      handler.callback(event);
+    }
 
-    std::ranges::copy_if(handlers_, std::back_inserter(active_handlers), [](const auto& h) {
-      return h->active.load();
-    });
+    return {};
+  }
 
-    lock.unlock();
+  void enqueue(const EventType& event) {
+    ZoneScoped;
+    std::unique_lock lock(queue_mutex_);
+    queued_.push_back(event);
+    has_queued_.store(true, std::memory_order_release);
+  }
 
-    for (const auto& handler : active_handlers) {
-      if (handler->active.load()) {
-        handler->callback(event);
+  // Emits everything queued so far in order. Events queued by the handlers wait for the next call.
+  void dispatch_queued() override {
+    ZoneScoped;
+    if (has_queued_.exchange(false, std::memory_order_acq_rel)) {
+      {
+        std::unique_lock lock(queue_mutex_);
+        std::swap(queued_, dispatching_);
       }
-    }
 
-    cleanup_inactive_handlers();
+      for (const auto& event : dispatching_) {
+        std::ignore = emit(event);
+      }
 
-    return {};
+      // Keeps the capacity, steady state queueing doesn't allocate either.
+      dispatching_.clear();
+    }
+
+    std::unique_lock lock(write_mutex_, std::try_to_lock);
+    if (lock.owns_lock()) {
+      reclaim();
+    }
   }
 
   void clear() {
     ZoneScoped;
-    std::unique_lock lock(mutex_);
-    for (auto& handler : handlers_) {
-      handler->active.store(false);
-    }
-    handlers_.clear();
+    std::unique_lock lock(write_mutex_);
+    publish(nullptr);
   }
 
   std::size_t handler_count() const {
     ZoneScoped;
-    std::shared_lock lock(mutex_);
-    return std::ranges::count_if(handlers_, [](const auto& h) { return h->active.load(); });
+    auto guard = ReadGuard(readers_);
+    const auto* handlers = handlers_.load();
+    return handlers ? handlers->size() : 0;
   }
 
 private:
-  void cleanup_inactive_handlers() {
-    ZoneScoped;
-    auto now = std::chrono::steady_clock::now();
-    auto last_cleanup = last_cleanup_time_.load(std::memory_order_relaxed);
+  struct Handler {
+    Callback callback;
+    HandlerId id;
+  };
 
-    if (now - last_cleanup < std::chrono::milliseconds(100)) {
-      return;
-    }
+  using HandlerList = std::vector<Handler>;
 
-    if (!last_cleanup_time_.compare_exchange_strong(last_cleanup, now, std::memory_order_relaxed)) {
-      return;
+  struct ReadGuard {
+    std::atomic<u32>& readers;
+
+    explicit ReadGuard(std::atomic<u32>& counter) : readers(counter) { readers.fetch_add(1); }
+    ~ReadGuard() { readers.fetch_sub(1); }
+  };
+
+  // Caller holds `write_mutex_`.
+  void publish(HandlerList* next) {
+    if (const auto* previous = handlers_.exchange(next)) {
+      retired_.push_back(previous);
     }
 
-    std::unique_lock lock(mutex_);
-    std::erase_if(handlers_, [](const auto& h) { return !h->active.load(); });
+    reclaim();
   }
 
-  struct Handler {
-    std::function<void(const EventType&)> callback;
-    std::atomic<bool> active = {true};
-    HandlerId id;
+  // Readers announce themselves before loading the pointer, so once there are none every retired
+  // array is unreachable. All of it is seq_cst for that to hold.
+  void reclaim() {
+    if (retired_.empty() || readers_.load() != 0) {
+      return;
+    }
 
-    Handler(std::function<void(const EventType&)> cb, HandlerId handler_id) : callback(std::move(cb)), id(handler_id) {}
-  };
+    for (const auto* list : retired_) {
+      delete list;
+    }
+    retired_.clear();
+  }
 
-  mutable std::shared_mutex mutex_;
-  std::vector<std::shared_ptr<Handler>> handlers_;
+  std::atomic<const HandlerList*> handlers_ = {nullptr};
+  mutable std::atomic<u32> readers_ = {0};
+  std::mutex write_mutex_;
+  std::vector<const HandlerList*> retired_;
   std::atomic<HandlerId> next_id_ = {1};
-  std::atomic<std::chrono::steady_clock::time_point> last_cleanup_time_{};
+
+  std::mutex queue_mutex_;
+  std::vector<EventType> queued_;
+  std::vector<EventType> dispatching_;
+  std::atomic<bool> has_queued_ = {false};
 };
 
 class EventSystem {
 public:
+  constexpr static std::size_t MAX_EVENT_TYPES = 512;
+
   auto init() -> std::expected<void, std::string>;
   auto deinit() -> std::expected<void, std::string>;
 
@@ -177,11 +249,7 @@ public:
       return std::unexpected(EventError::EventSystemShutdown);
     }
 
-    std::shared_lock lock(registries_mutex_);
-    auto type_idx = std::type_index(typeid(EventType));
-
-    if (auto it = registries_.find(type_idx); it != registries_.end()) {
-      auto* registry = static_cast<HandlerRegistry<EventType>*>(it->second.get());
+    if (auto* registry = find_registry<EventType>()) {
       if (registry->unsubscribe(id)) {
         return {};
       }
@@ -190,6 +258,7 @@ public:
     return std::unexpected(EventError::HandlerNotFound);
   }
 
+  // Runs every handler right away, on the calling thread.
   template <Event EventType>
   std::expected<void, EventError> emit(const EventType& event) {
     ZoneScoped;
@@ -206,16 +275,29 @@ public:
     return emit<EventType>(static_cast<const EventType&>(event));
   }
 
+  // Queued until `dispatch_queued`, which App runs once per frame on the main thread. Events of one
+  // type come out in the order they were queued, there is no order between types.
   template <Event EventType>
-  std::size_t handler_count() const {
+  std::expected<void, EventError> enqueue(const EventType& event) {
     ZoneScoped;
-    std::shared_lock lock(registries_mutex_);
-    auto type_idx = std::type_index(typeid(EventType));
+    if (shutdown_.load()) {
+      return std::unexpected(EventError::EventSystemShutdown);
+    }
+
+    auto* registry = get_registry<EventType>();
+    registry->enqueue(event);
+    return {};
+  }
+
+  void dispatch_queued();
 
-    if (auto it = registries_.find(type_idx); it != registries_.end()) {
-      auto* registry = static_cast<HandlerRegistry<EventType>*>(it->second.get());
+  template <Event EventType>
+  std::size_t handler_count() const {
+    ZoneScoped;
+    if (const auto* registry = find_registry<EventType>()) {
       return registry->handler_count();
     }
+
     return 0;
   }
 
@@ -224,33 +306,67 @@ public:
   bool is_shutdown() const;
 
 private:
-  mutable std::shared_mutex registries_mutex_;
-  std::unordered_map<std::type_index, std::unique_ptr<RegistryBase>> registries_;
+  struct RegistrySlot {
+    std::atomic<u64> type_id = {0};
+    std::atomic<RegistryBase*> registry = {nullptr};
+  };
+  static_assert((MAX_EVENT_TYPES & (MAX_EVENT_TYPES - 1)) == 0);
+
+  // Open addressed by type id and never shrunk while running, lookups don't need the lock.
+  std::array<RegistrySlot, MAX_EVENT_TYPES> registry_slots_ = {};
+  std::mutex registries_mutex_;
+  std::vector<std::unique_ptr<RegistryBase>> registries_;
   std::atomic<bool> shutdown_ = {false};
 
   template <Event EventType>
-  HandlerRegistry<EventType>* get_registry() {
-    ZoneScoped;
-    std::shared_lock lock(registries_mutex_);
-    auto type_idx = std::type_index(typeid(EventType));
+  HandlerRegistry<EventType>* find_registry() const {
+    constexpr auto type_id = event_type_id<EventType>;
+    for (std::size_t probe = 0; probe < MAX_EVENT_TYPES; probe++) {
+      const auto& slot = registry_slots_[(type_id + probe) & (MAX_EVENT_TYPES - 1)];
+      const auto slot_type_id = slot.type_id.load(std::memory_order_acquire);
+      if (slot_type_id == type_id) {
+        return static_cast<HandlerRegistry<EventType>*>(slot.registry.load(std::memory_order_acquire));
+      }
 
-    if (auto it = registries_.find(type_idx); it != registries_.end()) {
-      return static_cast<HandlerRegistry<EventType>*>(it->second.get());
+      if (slot_type_id == 0) {
+        break;
+      }
     }
 
-    lock.unlock();
-    std::unique_lock write_lock(registries_mutex_);
+    return nullptr;
+  }
 
-    if (auto it = registries_.find(type_idx); it != registries_.end()) {
-      return static_cast<HandlerRegistry<EventType>*>(it->second.get());
+  template <Event EventType>
+  HandlerRegistry<EventType>* get_registry() {
+    ZoneScoped;
+    if (auto* registry = find_registry<EventType>()) {
+      return registry;
     }
 
-    auto registry = std::make_unique<HandlerRegistry<EventType>>();
-    auto* ptr = registry.get();
+    std::unique_lock lock(registries_mutex_);
+    if (auto* registry = find_registry<EventType>()) {
+      return registry;
+    }
 
-    registries_[type_idx] = std::move(registry);
+    constexpr auto type_id = event_type_id<EventType>;
+    for (std::size_t probe = 0; probe < MAX_EVENT_TYPES; probe++) {
+      auto& slot = registry_slots_[(type_id + probe) & (MAX_EVENT_TYPES - 1)];
+      if (slot.type_id.load(std::memory_order_relaxed) != 0) {
+        continue;
+      }
+
+      auto registry = std::make_unique<HandlerRegistry<EventType>>();
+      auto* ptr = registry.get();
+      registries_.push_back(std::move(registry));
+
+      // Readers check the id first, the registry has to be there by the time they see it.
+      slot.registry.store(ptr, std::memory_order_release);
+      slot.type_id.store(type_id, std::memory_order_release);
+      return ptr;
+    }
 
-    return ptr;
+    OX_ASSERT(false, "Too many event types, raise EventSystem::MAX_EVENT_TYPES.");
+    return nullptr;
   }
 };
 
@@ -1,12 +1,16 @@
 #pragma once
 
+#include <algorithm>
 #include <ankerl/unordered_dense.h>
+#include <array>
+#include <bitset>
 #include <expected>
 #include <glm/ext/vector_float2.hpp>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "Core/InputRecording.hpp"
 #include "Core/Keycodes.hpp"
 #include "Core/Option.hpp"
 
@@ -15,6 +19,9 @@ struct Window;
 
 enum class BindingError { ActionNotFound, InvalidInput, ContextNotFound };
 
+// Resolved once from an action's name, stays valid for as long as the Input lives, even across unbinding.
+enum class ActionID : u32 { Invalid = ~0_u32 };
+
 enum class InputType : u8 { Any, Keyboard, MouseButton, MouseAxis, GamepadButton, GamepadAxis };
 
 struct InputCode {
@@ -134,6 +141,11 @@ public:
     std::vector<InputCode> new_secondary = {}
   ) -> std::expected<void, BindingError>;
 
+  // Name to handle, the action doesn't have to be bound yet. Queries through handles are plain bit tests,
+  // the string versions look the handle up first.
+  auto resolve_action(this Input& self, std::string_view action_id) -> ActionID;
+  auto find_action(this const Input& self, std::string_view action_id) -> ActionID;
+
   auto set_context(this Input& self, std::string_view context) -> void;
   auto push_context(this Input& self, std::string_view context) -> void;
   auto pop_context(this Input& self) -> void;
@@ -144,6 +156,27 @@ public:
   auto get_action_held(this const Input& self, std::string_view action_id, u32 instance_id = 0) -> bool;
   auto get_action_axis(this const Input& self, std::string_view action_id, u32 instance_id = 0) -> glm::vec2;
 
+  auto get_action_pressed(this const Input& self, ActionID action, u32 instance_id = 0) -> bool;
+  auto get_action_released(this const Input& self, ActionID action, u32 instance_id = 0) -> bool;
+  auto get_action_held(this const Input& self, ActionID action, u32 instance_id = 0) -> bool;
+  auto get_action_axis(this const Input& self, ActionID action, u32 instance_id = 0) -> glm::vec2;
+
+  /// Events, recording and replay
+  // Everything the window sees comes in through here. Recorded while recording, dropped while a replay
+  // is feeding the events instead.
+  auto push_event(this Input& self, const InputEvent& event) -> void;
+
+  auto start_recording(this Input& self) -> void;
+  // Closes the frame the events since the last call belong to.
+  auto end_recorded_frame(this Input& self, f64 delta_ms) -> void;
+  auto stop_recording(this Input& self) -> InputRecording;
+  auto is_recording(this const Input& self) -> bool { return self.recording.has_value(); }
+
+  auto set_replaying(this Input& self, bool replaying) -> void { self.replaying = replaying; }
+  auto is_replaying(this const Input& self) -> bool { return self.replaying; }
+  // Applies one recorded frame's events and updates the action states like a window frame would.
+  auto replay_frame(this Input& self, std::span<const InputEvent> events) -> void;
+
   /// Keyboard
   auto get_key_pressed(this const Input& self, const ScanCode key) -> bool;
   auto get_key_released(this const Input& self, const ScanCode key) -> bool;
@@ -186,21 +219,26 @@ public:
 private:
   friend struct Window;
 
+  constexpr static auto SCAN_CODE_COUNT = static_cast<usize>(ScanCode::Count);
+  constexpr static auto MOUSE_BUTTON_COUNT = 8_sz;
+  constexpr static auto GAMEPAD_BUTTON_COUNT = 32_sz;
+  constexpr static auto GAMEPAD_AXIS_COUNT = 6_sz;
+
   struct InputData {
     ModCode mod_code = {};
 
     struct KeyboardData {
-      ankerl::unordered_dense::map<ScanCode, bool> scancode_pressed = {};
-      ankerl::unordered_dense::map<ScanCode, bool> scancode_released = {};
-      ankerl::unordered_dense::map<ScanCode, bool> scancode_held = {};
+      std::bitset<SCAN_CODE_COUNT> scancode_pressed = {};
+      std::bitset<SCAN_CODE_COUNT> scancode_released = {};
+      std::bitset<SCAN_CODE_COUNT> scancode_held = {};
     };
 
     KeyboardData keyboard_data = {};
 
     struct MouseData {
-      ankerl::unordered_dense::map<MouseCode, bool> mouse_pressed = {};
-      ankerl::unordered_dense::map<MouseCode, bool> mouse_released = {};
-      ankerl::unordered_dense::map<MouseCode, bool> mouse_held = {};
+      std::bitset<MOUSE_BUTTON_COUNT> mouse_pressed = {};
+      std::bitset<MOUSE_BUTTON_COUNT> mouse_released = {};
+      std::bitset<MOUSE_BUTTON_COUNT> mouse_held = {};
 
       glm::vec2 mouse_pos = {};
       glm::vec2 mouse_pos_rel = {};
@@ -213,11 +251,11 @@ private:
     MouseData mouse_data = {};
 
     struct GamepadData {
-      ankerl::unordered_dense::map<GamepadButtonCode, bool> gamepad_pressed = {};
-      ankerl::unordered_dense::map<GamepadButtonCode, bool> gamepad_released = {};
-      ankerl::unordered_dense::map<GamepadButtonCode, bool> gamepad_held = {};
+      std::bitset<GAMEPAD_BUTTON_COUNT> gamepad_pressed = {};
+      std::bitset<GAMEPAD_BUTTON_COUNT> gamepad_released = {};
+      std::bitset<GAMEPAD_BUTTON_COUNT> gamepad_held = {};
 
-      ankerl::unordered_dense::map<GamepadAxisCode, f32> gamepad_axises = {};
+      std::array<f32, GAMEPAD_AXIS_COUNT> gamepad_axises = {};
 
       u64 next_repeat_time = 0;
     };
@@ -228,8 +266,60 @@ private:
 
   InputData input_data = {};
 
+  // One bit per ActionID.
+  struct ActionMask {
+    std::vector<u64> words = {};
+
+    auto set(this ActionMask& self, ActionID action) -> void {
+      const auto index = static_cast<usize>(action);
+      if (index / 64 >= self.words.size()) {
+        self.words.resize(index / 64 + 1);
+      }
+      self.words[index / 64] |= 1_u64 << (index % 64);
+    }
+
+    auto test(this const ActionMask& self, ActionID action) -> bool {
+      const auto index = static_cast<usize>(action);
+      return index / 64 < self.words.size() && (self.words[index / 64] & (1_u64 << (index % 64))) != 0;
+    }
+
+    auto clear(this ActionMask& self) -> void { std::ranges::fill(self.words, 0_u64); }
+  };
+
+  struct ActionStates {
+    ActionMask pressed = {};
+    ActionMask released = {};
+    ActionMask held = {};
+  };
+
+  struct CompiledAction {
+    std::string name = {};
+    // The binding for the active context, if there is one.
+    const ActionBinding* binding = nullptr;
+  };
+
+  struct StringHash {
+    using is_transparent = void;
+    using is_avalanching = void;
+
+    auto operator()(std::string_view str) const noexcept -> u64 {
+      return ankerl::unordered_dense::hash<std::string_view>{}(str);
+    }
+  };
+
+  ankerl::unordered_dense::map<std::string, ActionID, StringHash, std::equal_to<>> action_ids = {};
+  std::vector<CompiledAction> compiled_actions = {};
+  // Keyboard and mouse inputs, the same for every instance.
+  ActionStates action_states = {};
+  // Gamepad inputs, by gamepad instance ID.
+  ankerl::unordered_dense::map<u32, ActionStates> gamepad_action_states = {};
+
   CursorState cursor_state = CursorState::Normal;
 
+  option<InputRecording> recording = nullopt;
+  u32 recorded_frame_events = 0;
+  bool replaying = false;
+
   std::string active_context = "default";
   std::vector<std::string> context_stack = {};
   std::unordered_multimap<std::string, ActionBinding> action_bindings = {};
@@ -237,6 +327,8 @@ private:
   std::chrono::nanoseconds gamepad_repeat_delay = std::chrono::nanoseconds(500);
   std::chrono::nanoseconds gamepad_interval = std::chrono::nanoseconds(50);
 
+  auto apply_event(this Input& self, const InputEvent& event) -> void;
+
   auto set_mod(const ModCode mod) -> void;
 
   auto set_key_pressed(const ScanCode scan_code, const bool state) -> void;
@@ -268,6 +360,9 @@ private:
   auto check_input_axis(this const Input& self, const InputCode& input, const u32 instance_id, InputType check_type)
     -> option<glm::vec2>;
 
+  auto compile_actions(this Input& self) -> void;
+  auto update_action_states(this Input& self) -> void;
+
   auto find_conflicts(this const Input& self, const ActionBinding& binding) -> std::vector<std::string>;
   auto add_to_reverse_map(this Input& self, const ActionBinding& binding) -> void;
   auto remove_from_reverse_map(this Input& self, const ActionBinding& binding) -> void;
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <expected>
+#include <filesystem>
+#include <glm/ext/vector_float2.hpp>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "Core/Keycodes.hpp"
+#include "Core/Types.hpp"
+
+namespace ox {
+enum class InputEventType : u8 {
+  Key = 0,
+  MouseButton,
+  MouseMotion,
+  MouseScroll,
+  GamepadButton,
+  GamepadAxis,
+};
+
+// One event the way the window hands it to Input, everything Input knows comes in as these.
+struct InputEvent {
+  InputEventType type = InputEventType::Key;
+  bool down = false;
+  bool repeat = false;
+  ModCode mod = ModCode::None;
+  // ScanCode, MouseCode, GamepadButtonCode or GamepadAxisCode depending on `type`.
+  u32 code = 0;
+  u32 instance_id = 0;
+  // Motion: position, scroll: offset (only y is used), gamepad axis: value in x.
+  glm::vec2 value = {};
+  // Motion only.
+  glm::vec2 relative = {};
+
+  bool operator==(const InputEvent&) const = default;
+};
+
+// Input events and frame times of a run, enough to play the same frames back later.
+struct InputRecording {
+  constexpr static u32 MAGIC = 0x5249'584f; // "OXIR"
+  constexpr static u32 VERSION = 1;
+
+  struct Frame {
+    f64 delta_ms = 0.0;
+    u32 event_count = 0;
+
+    bool operator==(const Frame&) const = default;
+  };
+
+  std::vector<Frame> frames = {};
+  // Every frame's events back to back.
+  std::vector<InputEvent> events = {};
+
+  auto encode(this const InputRecording& self) -> std::vector<u8>;
+  static auto decode(std::span<const u8> bytes) -> std::expected<InputRecording, std::string>;
+
+  auto save(this const InputRecording& self, const std::filesystem::path& path) -> std::expected<void, std::string>;
+  static auto load(const std::filesystem::path& path) -> std::expected<InputRecording, std::string>;
+};
+
+// Hands out a recording one frame at a time.
+struct InputReplay {
+  InputRecording recording = {};
+  usize next_frame = 0;
+  usize next_event = 0;
+
+  auto done(this const InputReplay& self) -> bool { return self.next_frame >= self.recording.frames.size(); }
+  auto next_delta_ms(this const InputReplay& self) -> f64 { return self.recording.frames[self.next_frame].delta_ms; }
+  // Events of the next frame, moves past it.
+  auto advance(this InputReplay& self) -> std::span<const InputEvent>;
+};
+} // namespace ox
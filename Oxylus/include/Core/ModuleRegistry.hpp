@@ -8,6 +8,7 @@
 #include <vuk/Types.hpp>
 
 #include "Core/Option.hpp"
+#include "Utils/FrameProfiler.hpp"
 #include "Utils/Log.hpp"
 #include "Utils/Timestep.hpp"
 
@@ -91,6 +92,7 @@ struct ModuleRegistry {
     deinit_callbacks.emplace_back([m = static_cast<T*>(module.get())]() { return m->deinit(); });
     if constexpr (ModuleHasUpdate<T>) {
       update_callbacks.emplace_back([m = static_cast<T*>(module.get())](const Timestep& timestep) {
+        OX_PROFILE_SCOPE(T::MODULE_NAME);
         m->update(timestep);
       });
     }
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <utility>
+
+#include "Core/Types.hpp"
+
+namespace ox {
+constexpr static usize QUEUE_CACHE_LINE = 64;
+
+// Bounded ring for exactly one producer thread and one consumer thread.
+template <typename T, usize Capacity>
+struct SPSCQueue {
+  static_assert(std::has_single_bit(Capacity), "Capacity must be a power of two.");
+  constexpr static usize MASK = Capacity - 1;
+
+  // Producer side.
+  auto try_push(this SPSCQueue& self, T value) -> bool {
+    const auto head = self.head.load(std::memory_order_relaxed);
+    if (head - self.tail_cache >= Capacity) {
+      self.tail_cache = self.tail.load(std::memory_order_acquire);
+      if (head - self.tail_cache >= Capacity) {
+        return false;
+      }
+    }
+
+    self.slots[head & MASK] = std::move(value);
+    self.head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Producer side, slot the next element can be written into in place. It only becomes visible to the
+  // consumer with `commit`, there can't be more than one reserved slot at a time.
+  auto try_reserve(this SPSCQueue& self) -> T* {
+    const auto head = self.head.load(std::memory_order_relaxed);
+    if (head - self.tail_cache >= Capacity) {
+      self.tail_cache = self.tail.load(std::memory_order_acquire);
+      if (head - self.tail_cache >= Capacity) {
+        return nullptr;
+      }
+    }
+
+    return &self.slots[head & MASK];
+  }
+
+  auto commit(this SPSCQueue& self) -> void {
+    self.head.store(self.head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+  auto free_space(this SPSCQueue& self) -> usize {
+    self.tail_cache = self.tail.load(std::memory_order_acquire);
+    return Capacity - (self.head.load(std::memory_order_relaxed) - self.tail_cache);
+  }
+
+  // Consumer side.
+  auto try_pop(this SPSCQueue& self, T& out) -> bool {
+    const auto tail = self.tail.load(std::memory_order_relaxed);
+    if (tail == self.head_cache) {
+      self.head_cache = self.head.load(std::memory_order_acquire);
+      if (tail == self.head_cache) {
+        return false;
+      }
+    }
+
+    out = std::move(self.slots[tail & MASK]);
+    self.tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Only exact when called from one of the two sides with the other one idle.
+  auto size(this const SPSCQueue& self) -> usize {
+    return self.head.load(std::memory_order_acquire) - self.tail.load(std::memory_order_acquire);
+  }
+
+private:
+  alignas(QUEUE_CACHE_LINE) std::atomic<usize> head = 0;
+  usize tail_cache = 0;
+  alignas(QUEUE_CACHE_LINE) std::atomic<usize> tail = 0;
+  usize head_cache = 0;
+  alignas(QUEUE_CACHE_LINE) std::array<T, Capacity> slots = {};
+};
+
+// Bounded ring for any number of producer threads and a single consumer, every cell carries a sequence
+// number so producers only contend on the enqueue position.
+template <typename T, usize Capacity>
+struct MPSCQueue {
+  static_assert(std::has_single_bit(Capacity), "Capacity must be a power of two.");
+  constexpr static usize MASK = Capacity - 1;
+
+  MPSCQueue() {
+    for (auto i = 0_sz; i < Capacity; i++) {
+      cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  MPSCQueue(const MPSCQueue&) = delete;
+  MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+  // Any thread.
+  auto try_push(this MPSCQueue& self, T value) -> bool {
+    auto position = self.enqueue_position.load(std::memory_order_relaxed);
+    Cell* cell = nullptr;
+    while (true) {
+      cell = &self.cells[position & MASK];
+      const auto sequence = cell->sequence.load(std::memory_order_acquire);
+      const auto difference = static_cast<i64>(sequence) - static_cast<i64>(position);
+      if (difference == 0) {
+        if (self.enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (difference < 0) {
+        return false;
+      } else {
+        position = self.enqueue_position.load(std::memory_order_relaxed);
+      }
+    }
+
+    cell->value = std::move(value);
+    cell->sequence.store(position + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer thread only.
+  auto try_pop(this MPSCQueue& self, T& out) -> bool {
+    const auto position = self.dequeue_position.load(std::memory_order_relaxed);
+    auto& cell = self.cells[position & MASK];
+    const auto sequence = cell.sequence.load(std::memory_order_acquire);
+    if (static_cast<i64>(sequence) - static_cast<i64>(position + 1) < 0) {
+      return false;
+    }
+
+    out = std::move(cell.value);
+    cell.sequence.store(position + Capacity, std::memory_order_release);
+    self.dequeue_position.store(position + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+  auto size_approx(this const MPSCQueue& self) -> usize {
+    const auto enqueued = self.enqueue_position.load(std::memory_order_relaxed);
+    const auto dequeued = self.dequeue_position.load(std::memory_order_relaxed);
+    return enqueued > dequeued ? enqueued - dequeued : 0;
+  }
+
+private:
+  struct Cell {
+    std::atomic<usize> sequence = 0;
+    T value = {};
+  };
+
+  alignas(QUEUE_CACHE_LINE) std::atomic<usize> enqueue_position = 0;
+  alignas(QUEUE_CACHE_LINE) std::atomic<usize> dequeue_position = 0;
+  alignas(QUEUE_CACHE_LINE) std::array<Cell, Capacity> cells = {};
+};
+} // namespace ox
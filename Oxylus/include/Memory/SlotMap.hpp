@@ -23,16 +23,12 @@ constexpr static u64 SLOT_MAP_INDEX_MASK = (1_u64 << SLOT_MAP_VERSION_BITS) - 1_
 
 template <SlotMapID ID>
 constexpr auto SlotMap_encode_id(u32 version, u32 index) -> ID {
-  ZoneScoped;
-
   u64 raw = (static_cast<u64>(version) << SLOT_MAP_VERSION_BITS) | static_cast<u64>(index);
   return static_cast<ID>(raw);
 }
 
 template <SlotMapID ID>
 constexpr auto SlotMap_decode_id(ID id) -> SlotMapIDUnpacked {
-  ZoneScoped;
-
   auto raw = static_cast<u64>(id);
   auto version = static_cast<u32>(raw >> SLOT_MAP_VERSION_BITS);
   auto index = static_cast<u32>(raw & SLOT_MAP_INDEX_MASK);
@@ -103,16 +99,12 @@ public:
   }
 
   auto is_valid(this const Self& self, ID id) -> bool {
-    ZoneScoped;
-
     std::shared_lock _(self.mutex);
     auto [version, index] = SlotMap_decode_id(id);
     return index < self.slots.size() && self.versions[index] == version;
   }
 
   auto slot(this Self& self, ID id) -> T* {
-    ZoneScoped;
-
     if (self.is_valid(id)) {
       std::shared_lock _(self.mutex);
       auto index = SlotMap_decode_id(id).index;
@@ -123,8 +115,6 @@ public:
   }
 
   auto slotc(this const Self& self, ID id) -> const T* {
-    ZoneScoped;
-
     if (self.is_valid(id)) {
       std::shared_lock _(self.mutex);
       auto index = SlotMap_decode_id(id).index;
@@ -180,8 +170,6 @@ public:
   }
 
   auto get_mutex(this Self& self) -> std::shared_mutex& {
-    ZoneScoped;
-
     return self.mutex;
   }
 };
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <algorithm>
+#include <span>
+#include <vector>
+
+#include "Core/Types.hpp"
+
+namespace ox {
+// LSB first bit packing, the last byte is zero padded.
+struct BitWriter {
+  std::vector<u8> bytes = {};
+  u64 scratch = 0;
+  u32 scratch_bits = 0;
+
+  auto clear(this BitWriter& self) -> void {
+    self.bytes.clear();
+    self.scratch = 0;
+    self.scratch_bits = 0;
+  }
+
+  // `count` must be 32 at most.
+  auto write_bits(this BitWriter& self, u64 value, u32 count) -> void {
+    self.scratch |= (value & ((1_u64 << count) - 1_u64)) << self.scratch_bits;
+    self.scratch_bits += count;
+    while (self.scratch_bits >= 8) {
+      self.bytes.push_back(static_cast<u8>(self.scratch));
+      self.scratch >>= 8;
+      self.scratch_bits -= 8;
+    }
+  }
+
+  auto write_bool(this BitWriter& self, bool value) -> void { self.write_bits(value ? 1 : 0, 1); }
+
+  // 7 bits per group, high bit tells if another group follows.
+  auto write_varint(this BitWriter& self, u64 value) -> void {
+    while (value >= 0x80) {
+      self.write_bits((value & 0x7f) | 0x80, 8);
+      value >>= 7;
+    }
+    self.write_bits(value, 8);
+  }
+
+  auto write_zigzag(this BitWriter& self, i64 value) -> void {
+    self.write_varint((static_cast<u64>(value) << 1) ^ static_cast<u64>(value >> 63));
+  }
+
+  auto write_bytes(this BitWriter& self, std::span<const u8> data) -> void {
+    if (self.scratch_bits == 0) {
+      self.bytes.insert(self.bytes.end(), data.begin(), data.end());
+      return;
+    }
+
+    for (auto byte : data) {
+      self.write_bits(byte, 8);
+    }
+  }
+
+  auto flush(this BitWriter& self) -> std::span<const u8> {
+    if (self.scratch_bits != 0) {
+      self.bytes.push_back(static_cast<u8>(self.scratch));
+      self.scratch = 0;
+      self.scratch_bits = 0;
+    }
+
+    return self.bytes;
+  }
+};
+
+// Reading past the end never touches memory, it sets `failed` and keeps returning zeroes.
+struct BitReader {
+  std::span<const u8> bytes = {};
+  usize bit_offset = 0;
+  bool failed = false;
+
+  auto remaining_bits(this const BitReader& self) -> usize {
+    return self.failed ? 0 : self.bytes.size() * 8 - self.bit_offset;
+  }
+
+  auto read_bits(this BitReader& self, u32 count) -> u64 {
+    if (count > self.remaining_bits()) {
+      self.failed = true;
+      return 0;
+    }
+
+    auto value = 0_u64;
+    auto read = 0_u32;
+    while (read < count) {
+      const auto bit_in_byte = static_cast<u32>(self.bit_offset & 7);
+      const auto take = std::min(8 - bit_in_byte, count - read);
+      const auto bits = (self.bytes[self.bit_offset >> 3] >> bit_in_byte) & ((1_u32 << take) - 1);
+      value |= static_cast<u64>(bits) << read;
+      read += take;
+      self.bit_offset += take;
+    }
+
+    return value;
+  }
+
+  auto read_bool(this BitReader& self) -> bool { return self.read_bits(1) != 0; }
+
+  auto read_varint(this BitReader& self) -> u64 {
+    auto value = 0_u64;
+    for (auto shift = 0_u32; shift < 64; shift += 7) {
+      const auto group = self.read_bits(8);
+      value |= (group & 0x7f) << shift;
+      if ((group & 0x80) == 0) {
+        return value;
+      }
+    }
+
+    // Longer than any u64 can be.
+    self.failed = true;
+    return 0;
+  }
+
+  auto read_zigzag(this BitReader& self) -> i64 {
+    const auto value = self.read_varint();
+    return static_cast<i64>(value >> 1) ^ -static_cast<i64>(value & 1);
+  }
+
+  auto read_bytes(this BitReader& self, std::span<u8> out) -> bool {
+    if (out.size() * 8 > self.remaining_bits()) {
+      self.failed = true;
+      return false;
+    }
+
+    if ((self.bit_offset & 7) == 0) {
+      std::ranges::copy(self.bytes.subspan(self.bit_offset >> 3, out.size()), out.begin());
+      self.bit_offset += out.size() * 8;
+      return true;
+    }
+
+    for (auto& byte : out) {
+      byte = static_cast<u8>(self.read_bits(8));
+    }
+
+    return true;
+  }
+};
+} // namespace ox
@@ -22,6 +22,19 @@ struct NetStats {
   u32 last_received_bytes = 0;
   u32 last_sent_packets = 0;
 };
+
+// Game thread side of the network I/O thread, refreshed on every dispatch.
+struct NetIOStats {
+  u32 dispatched_events = 0;
+  u32 inbound_depth = 0;
+  u32 outbound_depth = 0;
+  u32 dropped_sends = 0;
+  // Time from the I/O thread receiving an event to the game thread handling it.
+  f32 latency_avg_ms = 0.0f;
+  f32 latency_max_ms = 0.0f;
+};
+
+struct NetHostIO;
 } // namespace ox
 
 typedef struct _ENetHost ENetHost;
@@ -1,10 +1,14 @@
 #pragma once
 
+#include <array>
+#include <memory>
 #include <string_view>
 
 #include "Core/Types.hpp"
 #include "Networking/Fwd.hpp"
+#include "Networking/NetHostIO.hpp"
 #include "Networking/NetPacket.hpp"
+#include "Networking/NetTimeline.hpp"
 #include "Utils/Timestep.hpp"
 
 namespace ox {
@@ -16,40 +20,94 @@ enum class NetClientStatus : u32 {
   TimedOut,
 };
 
+// The server's scene as the client should show it this frame, see `NetClient::on_scene_snapshot`. Points at
+// the client's sampled state, only valid while the event is emitted, so it can't be enqueued.
 struct ClientSceneSnapshotEvent {
-  u8 sequence;
-  SceneState scene_state;
+  f64 playback_ms;
+  const SceneState* scene_state;
 };
 
 struct NetClient {
   NetClientStatus status = NetClientStatus::None;
   NetStats stats = {};
+  NetIOStats io_stats = {};
   ENetHost* local_host = nullptr;
   ENetPeer* remote_peer = nullptr;
+  // Local clients own their host's queues, the server's view of a remote client borrows the server's.
+  std::unique_ptr<NetHostIO> host_io = nullptr;
+  NetHostIO* io = nullptr;
   u64 net_id = 0;
   f64 timeout_elapsed = 0.0f;
   f64 timeout_max = 0.0f;
   f64 tick_interval = 1000.0f / 20.0f;
   f64 tick_accum = 0.0f;
 
-  ankerl::unordered_dense::map<u64, NetRPCPacket::Callback> rpcs = {};
+  NetProcTable procs = {};
+  // Ids of the procs on the other end, known once the handshake went through.
+  NetRemoteProcs remote_procs = {};
+  std::array<NetRPCBatch, NET_CHANNEL_COUNT> rpc_batches = {};
+  // Has to match the server's. NetworkManager configures it and the handshake builds its schema from `world`.
+  SnapshotCodec snapshot_codec = {};
+  // World the server's snapshots are about, with the same networked components registered as on the server.
+  flecs::world* world = nullptr;
+  // Every snapshot that resolves goes in here and gets acked, so the server can send deltas. The handshake
+  // builds its schema from `world`, `tick` samples it.
+  NetTimeline timeline = {};
+  // What `tick` sampled last, reused every frame.
+  SceneState sampled_state = {};
 
-  NetClient(ENetHost* local_host_) : local_host(local_host_) { add_builtin_procs(); }
-  NetClient(ENetPeer* remote_peer_, u64 net_id_) : remote_peer(remote_peer_), net_id(net_id_) { add_builtin_procs(); }
+  NetClient(ENetHost* local_host_) :
+      local_host(local_host_),
+      host_io(std::make_unique<NetHostIO>(local_host_)),
+      io(host_io.get()) {
+    add_builtin_procs();
+  }
+  NetClient(ENetPeer* remote_peer_, u64 net_id_, NetHostIO* io_ = nullptr) :
+      remote_peer(remote_peer_),
+      io(io_),
+      net_id(net_id_) {
+    add_builtin_procs();
+  }
+  NetClient(NetClient&&) = default;
+  NetClient& operator=(NetClient&&) = default;
   virtual ~NetClient() = default;
 
   auto set_tick_rate(this NetClient&, f64 tick_rate) -> void;
+  // Set it before connecting, the snapshot schema is built from it once the server accepts.
+  auto set_world(this NetClient&, flecs::world& world) -> void;
   auto connect(this NetClient&, std::string_view host_name, u16 port, f64 timeout) -> bool;
   auto disconnect(this NetClient&, bool immediate, u32 data = 0) -> void;
+  // Advances timeouts, stats and the timeline, then hands what the timeline samples to `on_scene_snapshot`.
+  // Call it once per frame, true when a network tick is due. Packets are handled in `dispatch`.
   auto tick(this NetClient&, const Timestep& ts) -> bool;
+  // Handles everything the I/O thread received, NetworkManager calls it once per frame.
+  auto dispatch(this NetClient&) -> void;
+  // Services the host on the calling thread first, for clients that aren't on the I/O thread.
+  auto poll(this NetClient&) -> void;
+  auto handle_event(this NetClient&, NetEvent& event) -> void;
   auto handle_packet(this NetClient&, NetPacket& packet) -> void;
 
   auto add_builtin_procs(this NetClient&) -> void;
-  auto register_proc(this NetClient&, std::string_view identifier, NetRPCPacket::Callback&& cb) -> void;
+  // Register before connecting, the handshake is what tells the server about them.
+  auto register_proc(this NetClient&, std::string_view identifier, NetProcCallback&& cb) -> NetProcID;
+  auto find_remote_proc(this const NetClient&, std::string_view identifier) -> option<NetProcID>;
+  // Queued until `flush_rpcs`, everything queued on one channel goes out as a single packet. The name
+  // based overload looks the id up every time, keep the id around for hot calls.
+  auto call(this NetClient&, NetProcID proc_id, std::span<const RPCParameter> params, bool reliable = true) -> bool;
+  auto call(this NetClient&, std::string_view identifier, std::span<const RPCParameter> params, bool reliable = true)
+    -> bool;
+  // NetworkManager does this once per frame, before handling what came in.
+  auto flush_rpcs(this NetClient&) -> void;
 
+  // Queued for the I/O thread, `packet` must not be touched afterwards.
   auto send_reliable(this NetClient&, NetPacket& packet) -> void;
   auto send_unreliable(this NetClient&, NetPacket& packet) -> void;
 
-  virtual auto on_scene_snapshot(u8 sequence, SceneState&& state) -> void {};
+  // Once per `tick` while the timeline has anything buffered. `state` is the whole replicated scene at
+  // `playback_ms` on the server's clock, deltas and upserts resolved and networked components interpolated.
+  virtual auto on_scene_snapshot(f64 playback_ms, const SceneState& state) -> void {};
+
+private:
+  auto flush_rpc_batch(this NetClient&, u32 channel) -> void;
 };
 } // namespace ox
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <tracy/Tracy.hpp>
+
+#include "Memory/LockFreeQueue.hpp"
+#include "Networking/Fwd.hpp"
+
+namespace ox {
+enum class NetEventKind : u32 {
+  Connect = 0,
+  Receive,
+  Disconnect,
+};
+
+struct NetEvent {
+  NetEventKind kind = NetEventKind::Connect;
+  ENetPeer* peer = nullptr;
+  ENetPacket* packet = nullptr; // Receive only, owned by whoever pops the event
+  u32 data = 0;
+  u64 received_ns = 0;
+};
+
+enum class NetCommandKind : u32 {
+  Send = 0,
+  DisconnectLater,
+};
+
+struct NetCommand {
+  NetCommandKind kind = NetCommandKind::Send;
+  ENetPeer* peer = nullptr;
+  ENetPacket* packet = nullptr;
+  u8 channel = 0;
+  u32 data = 0;
+};
+
+// An ENet host split between the network I/O thread, which services it, and the game thread, which only
+// ever sees its events through `inbound` and talks back through `outbound`.
+struct NetHostIO {
+  constexpr static usize INBOUND_CAPACITY = 4096;
+  constexpr static usize OUTBOUND_CAPACITY = 4096;
+
+  ENetHost* host = nullptr;
+  // Held while servicing, the game thread only takes it for calls that can't be queued (connect, stats).
+  std::mutex host_mutex = {};
+  SPSCQueue<NetEvent, INBOUND_CAPACITY> inbound = {};
+  MPSCQueue<NetCommand, OUTBOUND_CAPACITY> outbound = {};
+  std::atomic<u32> dropped_sends = 0;
+
+  explicit NetHostIO(ENetHost* host_) : host(host_) {}
+  // Frees whatever packets never made it across.
+  ~NetHostIO();
+
+  // Any thread. The packet belongs to ENet afterwards, even if sending it fails.
+  auto send(this NetHostIO&, ENetPeer* peer, ENetPacket* packet, u8 channel) -> void;
+  // Immediate disconnects skip the queue, but still go out after everything sent before them.
+  auto disconnect(this NetHostIO&, ENetPeer* peer, bool immediate, u32 data) -> void;
+
+  // I/O thread, or the game thread when there is none.
+  auto service(this NetHostIO&) -> void;
+
+  // Game thread. Hands `fn` the events that were queued when it got called, a burst arriving meanwhile
+  // waits for the next frame.
+  template <typename Fn>
+  auto dispatch(this NetHostIO& self, NetIOStats& stats, Fn&& fn) -> void {
+    ZoneScoped;
+
+    const auto now = now_ns();
+    const auto pending = self.inbound.size();
+    auto latency_total_ms = 0.0f;
+    auto latency_max_ms = 0.0f;
+    auto dispatched = 0_u32;
+
+    auto event = NetEvent{};
+    while (dispatched < pending && self.inbound.try_pop(event)) {
+      const auto latency_ms = static_cast<f32>(now - std::min(now, event.received_ns)) / 1'000'000.0f;
+      latency_total_ms += latency_ms;
+      latency_max_ms = std::max(latency_max_ms, latency_ms);
+      dispatched += 1;
+
+      fn(event);
+    }
+
+    stats.dispatched_events = dispatched;
+    stats.inbound_depth = static_cast<u32>(pending);
+    stats.outbound_depth = static_cast<u32>(self.outbound.size_approx());
+    stats.dropped_sends = self.dropped_sends.load(std::memory_order_relaxed);
+    stats.latency_avg_ms = dispatched ? latency_total_ms / static_cast<f32>(dispatched) : 0.0f;
+    stats.latency_max_ms = latency_max_ms;
+  }
+
+  static auto now_ns() -> u64;
+
+private:
+  // Needs `host_mutex`.
+  auto flush_commands(this NetHostIO&) -> void;
+};
+} // namespace ox
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <tracy/Tracy.hpp>
+#include <vector>
+
+#include "Core/Option.hpp"
+#include "Core/Types.hpp"
+
+namespace ox {
+// Client side prediction for whatever the local player drives. Inputs run right away and are kept
+// until the server confirms it ran them, every authoritative state that comes in is rewound to and
+// the unconfirmed inputs are replayed on top of it.
+//
+// The sequence `predict` returns goes to the server with the input (e.g. as an RPC parameter), the
+// server sends back the last sequence it ran next to the state that produced. `step(State&, const
+// Input&)` has to be deterministic and match the server's, otherwise replays won't line up.
+template <typename Input, typename State>
+struct NetPrediction {
+  // Inputs the server never got to are dropped past this, a bigger backlog means the link is gone anyway.
+  constexpr static usize MAX_PENDING = 256;
+
+  struct Command {
+    u32 sequence = 0;
+    Input input = {};
+  };
+
+  State state = {};
+  std::vector<Command> pending = {};
+  u32 next_sequence = 0;
+  option<u32> last_acked = nullopt;
+
+  template <typename StepFn>
+  auto predict(this NetPrediction& self, const Input& input, StepFn&& step) -> u32 {
+    ZoneScoped;
+
+    if (self.pending.size() >= MAX_PENDING) {
+      self.pending.erase(self.pending.begin());
+    }
+
+    const auto sequence = self.next_sequence++;
+    self.pending.push_back({.sequence = sequence, .input = input});
+    step(self.state, input);
+
+    return sequence;
+  }
+
+  // Returns how many inputs were replayed. Acks older than the last one are ignored, they can arrive
+  // out of order on an unreliable channel.
+  template <typename StepFn>
+  auto reconcile(this NetPrediction& self, u32 acked, const State& authoritative, StepFn&& step) -> usize {
+    ZoneScoped;
+
+    if (self.last_acked.has_value() && static_cast<i32>(acked - self.last_acked.value()) < 0) {
+      return 0;
+    }
+
+    self.last_acked = acked;
+    std::erase_if(self.pending, [acked](const Command& command) {
+      return static_cast<i32>(command.sequence - acked) <= 0;
+    });
+
+    self.state = authoritative;
+    for (const auto& command : self.pending) {
+      step(self.state, command.input);
+    }
+
+    return self.pending.size();
+  }
+
+  auto reset(this NetPrediction& self, const State& state = {}) -> void {
+    self.state = state;
+    self.pending.clear();
+    self.next_sequence = 0;
+    self.last_acked = nullopt;
+  }
+};
+} // namespace ox
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <ankerl/svector.h>
+#include <ankerl/unordered_dense.h>
+#include <array>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include "Core/Option.hpp"
+#include "Core/Types.hpp"
+#include "Core/UUID.hpp"
+#include "Networking/Fwd.hpp"
+
+namespace ox {
+// What gets sent, owns its data.
+struct RPCParameter {
+  // The alternative index is what goes over the wire, only ever append to this list. `RPCArg` has to
+  // follow along.
+  using Value = std::variant<
+    std::monostate,     // none
+    u8,                 // byte
+    u16,                // short
+    i32,                // int
+    i64,                // int64
+    f32,                // float
+    f64,                // double
+    std::string,        // string
+    std::array<u8, 16>, // uuid
+    std::vector<u8>>;   // byte array
+
+  Value value = {};
+};
+
+// What a callback receives. Strings and byte arrays point into the packet they arrived in, so they are
+// only valid until the callback returns.
+struct RPCArg {
+  using Value = std::variant<
+    std::monostate,
+    u8,
+    u16,
+    i32,
+    i64,
+    f32,
+    f64,
+    std::string_view,
+    std::array<u8, 16>,
+    std::span<const u8>>;
+  static_assert(std::variant_size_v<Value> == std::variant_size_v<RPCParameter::Value>);
+
+  Value value = {};
+
+  auto as_f32(this const RPCArg&) -> option<const f32>;
+  auto as_int64(this const RPCArg&) -> option<const i64>;
+  auto as_str(this const RPCArg&) -> std::string_view;
+  auto as_uuid(this const RPCArg&) -> option<UUID>;
+  // Byte arrays are 8 byte aligned inside the packet, so any T up to that viewing them is fine.
+  template <typename T>
+  auto as_span(this const RPCArg& self) -> std::span<const T> {
+    static_assert(alignof(T) <= 8);
+    const auto* bytes = std::get_if<std::span<const u8>>(&self.value);
+    if (!bytes || reinterpret_cast<uptr>(bytes->data()) % alignof(T) != 0) {
+      return {};
+    }
+
+    return std::span{reinterpret_cast<const T*>(bytes->data()), bytes->size() / sizeof(T)};
+  }
+};
+
+using NetProcID = u16;
+using NetProcCallback = std::function<void(NetClientID, std::span<const RPCArg>)>;
+
+// Sent in the handshake, tells the other side which id to call a proc by.
+struct NetProcEntry {
+  u64 hash = 0;
+  NetProcID id = 0;
+};
+
+// Walks the calls of an RPC packet without copying anything out of it.
+struct NetRPCReader {
+  struct Call {
+    NetProcID proc_id = 0;
+    ankerl::svector<RPCArg, 8> args = {};
+  };
+
+  std::span<const u8> bytes = {};
+  usize offset = 1; // past the packet type
+  bool failed = false;
+
+  // False once there are no calls left, or the packet turned out to be malformed (`failed`).
+  auto next(this NetRPCReader&, Call& call) -> bool;
+};
+
+// Procs this side can be called on, ids are just indices so receiving a call is a vector lookup.
+struct NetProcTable {
+  std::vector<NetProcCallback> callbacks = {};
+  std::vector<NetProcEntry> entries = {};
+  ankerl::unordered_dense::map<u64, NetProcID> ids = {};
+
+  static auto hash(std::string_view identifier) -> u64;
+
+  // Registering the same identifier again replaces its callback and keeps its id. Only procs registered
+  // before the handshake are announced to the other side.
+  auto add(this NetProcTable&, std::string_view identifier, NetProcCallback&& cb) -> NetProcID;
+  // Runs every call in an RPC packet, false when the packet is malformed. Calls before the bad one
+  // have already run.
+  auto dispatch(this const NetProcTable&, NetClientID caller, NetRPCReader reader) -> bool;
+};
+
+// Ids the other side announced, keyed by the identifier's hash.
+struct NetRemoteProcs {
+  ankerl::unordered_dense::map<u64, NetProcID> ids = {};
+
+  auto assign(this NetRemoteProcs&, std::span<const NetProcEntry> entries) -> void;
+  auto find(this const NetRemoteProcs&, std::string_view identifier) -> option<NetProcID>;
+};
+
+// Calls queued for one channel, already encoded the way the packet will carry them.
+struct NetRPCBatch {
+  // Flushed early past this, unreliable ones would get fragmented and lost whole otherwise.
+  constexpr static usize FLUSH_BYTES = 1200;
+
+  std::vector<u8> bytes = {};
+  u32 call_count = 0;
+
+  auto add(this NetRPCBatch&, NetProcID proc_id, std::span<const RPCParameter> params) -> bool;
+  auto empty(this const NetRPCBatch& self) -> bool { return self.call_count == 0; }
+  auto should_flush(this const NetRPCBatch& self) -> bool { return self.bytes.size() >= FLUSH_BYTES; }
+  auto clear(this NetRPCBatch&) -> void;
+};
+} // namespace ox
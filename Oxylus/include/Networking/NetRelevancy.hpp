@@ -0,0 +1,91 @@
+#pragma once
+
+#include <ankerl/unordered_dense.h>
+#include <array>
+#include <flecs.h>
+#include <glm/vec3.hpp>
+#include <vector>
+
+#include "Core/Types.hpp"
+#include "Networking/Fwd.hpp"
+#include "Scene/SceneSnapshot.hpp"
+
+namespace ox {
+struct NetInterest {
+  glm::vec3 center = {};
+  f32 radius = 100.0f;
+  // Rough cap of component bytes per snapshot, 0 for no limit.
+  u32 budget_bytes = 0;
+};
+
+// Per client filtering of snapshots. Entities outside a client's area of interest are removed from it,
+// the rest are sent as often as their accumulated priority allows (closer ones every tick, far ones less
+// often) within the client's byte budget. Every entity is delta'd against the last state of it the client
+// acked, so lost packets only cost a resend of the entities they carried.
+struct NetRelevancy {
+  // Size of a spatial grid cell, in world units.
+  f32 cell_size = 32.0f;
+  // Part of the radius that is updated every tick, priority falls off linearly past it.
+  f32 full_rate_fraction = 0.25f;
+  // Priority gained per tick at the edge of the area, an entity is sent once it reaches 1.
+  f32 min_priority_rate = 0.1f;
+
+  auto set_interest(this NetRelevancy&, NetClientID client_id, const NetInterest& interest) -> void;
+  auto has_interest(this const NetRelevancy&, NetClientID client_id) -> bool;
+  auto has_clients(this const NetRelevancy&) -> bool { return !clients.empty(); }
+  auto remove_client(this NetRelevancy&, NetClientID client_id) -> void;
+
+  // Places the entities of the builder's current frame on the grid, once per capture.
+  auto update(this NetRelevancy&, flecs::world& world, SceneSnapshotBuilder& builder) -> void;
+  // Upserts and removals for one client, to be sent without a baseline. Overwritten by the next build.
+  auto build(this NetRelevancy&, SceneSnapshotBuilder& builder, NetClientID client_id) -> const SnapshotDelta&;
+  auto ack(this NetRelevancy&, const SceneSnapshotBuilder& builder, NetClientID client_id, u8 sequence) -> void;
+
+private:
+  struct Placement {
+    flecs::entity_t entity = 0;
+    SnapshotRow row = {};
+    glm::vec3 position = {};
+  };
+
+  struct EntityTrack {
+    f32 priority = 0.0f;
+    u64 seen_frame = 0;
+    // Last frame of this entity the client acked, 0 until one is.
+    u64 acked_frame = 0;
+    u8 acked_slot = 0;
+    bool sent = false;
+    bool removing = false;
+  };
+
+  struct SentFrame {
+    u64 frame_id = 0;
+    std::vector<flecs::entity_t> entities = {};
+    std::vector<flecs::entity_t> removed = {};
+  };
+
+  struct ClientState {
+    NetInterest interest = {};
+    ankerl::unordered_dense::map<flecs::entity_t, EntityTrack> tracks = {};
+    std::array<SentFrame, SceneSnapshotBuilder::MAX_SEQUENCES> sent = {};
+  };
+
+  struct Candidate {
+    flecs::entity_t entity = 0;
+    SnapshotRow row = {};
+    f32 priority = 0.0f;
+  };
+
+  ankerl::unordered_dense::map<NetClientID, ClientState> clients = {};
+  std::vector<Placement> placements = {};
+  // Entities without a transform, relevant to everyone.
+  std::vector<Placement> unplaced = {};
+  ankerl::unordered_dense::map<u64, std::vector<u32>> grid = {};
+  std::vector<Candidate> candidates = {};
+  std::vector<flecs::entity_t> dropped = {};
+  SnapshotDelta delta = {};
+
+  template <typename Fn>
+  auto for_each_in_radius(this const NetRelevancy&, glm::vec3 center, f32 radius, Fn&& fn) -> void;
+};
+} // namespace ox
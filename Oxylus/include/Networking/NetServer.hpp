@@ -3,6 +3,7 @@
 #include "Memory/SlotMap.hpp"
 #include "Networking/Fwd.hpp"
 #include "Networking/NetClient.hpp"
+#include "Networking/NetRelevancy.hpp"
 #include "Utils/Timestep.hpp"
 
 namespace ox {
@@ -19,21 +20,45 @@ struct ClientAckEvent {
 
 struct NetServer {
   ENetHost* local_host = nullptr;
+  std::unique_ptr<NetHostIO> io = nullptr;
+  NetIOStats io_stats = {};
   SlotMap<NetClient, NetClientID> remote_clients = {};
   u64 net_id_counter = 0;
   f64 tick_interval = 1000.0f / 20.0f;
   f64 tick_accum = 0.0f;
 
-  ankerl::unordered_dense::map<u64, NetRPCPacket::Callback> rpcs = {};
+  NetProcTable procs = {};
+  SceneSnapshotBuilder snapshots = {};
+  // NetworkManager configures it, the schema is built from the world passed to the first `send_snapshots`.
+  SnapshotCodec snapshot_codec = {};
+  bool snapshot_schema_built = false;
+  NetRelevancy relevancy = {};
 
-  NetServer(ENetHost* local_host_) : local_host(local_host_) {};
+  NetServer(ENetHost* local_host_) : local_host(local_host_), io(std::make_unique<NetHostIO>(local_host_)) {};
   virtual ~NetServer() = default;
 
   auto set_tick_rate(this NetServer&, f64 tick_rate) -> void;
+  // True when a network tick is due. Packets are handled in `dispatch`.
   auto tick(this NetServer&, const Timestep& ts) -> bool;
+  // Handles everything the I/O thread received, NetworkManager calls it once per frame.
+  auto dispatch(this NetServer&) -> void;
+  // Services the host on the calling thread first, for servers that aren't on the I/O thread.
+  auto poll(this NetServer&) -> void;
+  auto handle_event(this NetServer&, NetEvent& event) -> void;
   auto handle_packet(this NetServer&, ENetPeer* remote_peer, NetPacket& packet) -> void;
 
-  auto register_proc(this NetServer&, std::string_view identifier, NetRPCPacket::Callback&& cb) -> void;
+  // Register before clients connect, the handshake is what tells them about it.
+  auto register_proc(this NetServer&, std::string_view identifier, NetProcCallback&& cb) -> NetProcID;
+  // Queued on the client until `flush_rpcs`, see NetClient::call.
+  auto call(
+    this NetServer&, NetClientID client_id, std::string_view identifier, std::span<const RPCParameter> params,
+    bool reliable = true
+  ) -> bool;
+  auto flush_rpcs(this NetServer&) -> void;
+  // Captures `world` and sends every client a delta against the last snapshot it acked. Clients with an
+  // area of interest only get the entities around it instead, see NetRelevancy.
+  auto send_snapshots(this NetServer&, flecs::world& world) -> void;
+  auto set_client_interest(this NetServer&, NetClientID client_id, const NetInterest& interest) -> void;
 
   virtual auto on_client_connect(NetClientID client_id) -> void {};
   virtual auto on_client_disconnect(NetClientID client_id) -> void {};
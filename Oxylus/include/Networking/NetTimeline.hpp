@@ -0,0 +1,115 @@
+#pragma once
+
+#include <ankerl/unordered_dense.h>
+#include <array>
+#include <flecs.h>
+#include <span>
+#include <vector>
+
+#include "Core/Option.hpp"
+#include "Core/Types.hpp"
+#include "Scene/SceneSnapshot.hpp"
+
+namespace ox {
+enum class NetLerpKind : u8 {
+  Vec3 = 0, // lerp
+  Quat,     // shortest path slerp
+};
+
+struct NetLerpField {
+  NetLerpKind kind = NetLerpKind::Vec3;
+  u32 offset = 0;
+};
+
+// Parts of networked components that get blended between two snapshots, found through their flecs
+// meta. Everything else snaps to the newer snapshot.
+struct NetInterpolationSchema {
+  ankerl::unordered_dense::map<flecs::id_t, std::vector<NetLerpField>> components = {};
+
+  auto build(this NetInterpolationSchema&, flecs::world& world) -> void;
+  auto find(this const NetInterpolationSchema&, flecs::id_t component_id) -> std::span<const NetLerpField>;
+
+  // `out` has to hold a copy of `to` already, only the blended fields are written.
+  static auto blend(
+    std::span<const NetLerpField> fields, std::span<const u8> from, std::span<const u8> to, f32 t, std::span<u8> out
+  ) -> void;
+};
+
+struct NetTimelineStats {
+  f64 delay_ms = 0.0;  // how far playback runs behind the server
+  f64 jitter_ms = 0.0; // recent worst lateness of snapshots relative to the fastest ones
+  u32 buffered = 0;
+  u32 late = 0;       // arrived after playback was already past them
+  u32 unresolved = 0; // deltas against a baseline this side doesn't have (anymore)
+  u32 starved = 0;    // samples that had nothing newer to interpolate towards
+};
+
+// Client side view of the server's snapshot stream. Snapshots are resolved to full states, buffered
+// and played back a bit behind the newest one. How far behind follows the jitter of the link, so there
+// are two snapshots to interpolate between even when some arrive late or never.
+//
+// Times are milliseconds. Local time only moves through `advance`, which makes the whole thing
+// deterministic to test.
+struct NetTimeline {
+  // Same as the server ring, a sequence names the same slot on both ends.
+  constexpr static auto MAX_FRAMES = SceneSnapshotBuilder::MAX_SEQUENCES;
+
+  struct Frame {
+    i64 tick = 0; // unwrapped sequence
+    SceneState state = {};
+  };
+
+  NetInterpolationSchema schema = {};
+  // The server's, the handshake sets it.
+  f64 tick_interval_ms = 1000.0 / 20.0;
+  // Delay is this many ticks plus `jitter_scale` times the jitter. Two ticks covers a single lost snapshot.
+  f64 min_delay_ticks = 2.0;
+  f64 jitter_scale = 1.5;
+  f64 max_delay_ms = 500.0;
+  // Playback runs at most this much faster or slower to drift towards the target delay, instead of jumping.
+  f64 max_time_scale = 0.05;
+
+  NetTimelineStats stats = {};
+
+  auto reset(this NetTimeline&) -> void;
+  // Moves local time and playback forward, once per frame.
+  auto advance(this NetTimeline&, f64 delta_ms) -> void;
+  // Resolves a snapshot against its baseline and buffers it. Without one it is the full state, or with `upsert`
+  // goes on top of the newest earlier frame. False when it can't be used, the sender should only ack what was
+  // pushed successfully so deltas keep resolving.
+  auto push(this NetTimeline&, u8 sequence, option<u8> baseline, const SceneState& state, bool upsert = false)
+    -> bool;
+  // Entities interpolated to the playback time, false while nothing is buffered. `out` is updated in place, pass
+  // the same state every frame: it's only copied into when playback moves on to other frames, in between only
+  // the blended fields are written again.
+  auto sample(this NetTimeline&, SceneState& out) -> bool;
+
+  auto playback_ms(this const NetTimeline& self) -> f64 { return self.playback; }
+  auto local_ms(this const NetTimeline& self) -> f64 { return self.local_time; }
+  auto find_frame(this const NetTimeline&, i64 tick) -> const Frame*;
+
+private:
+  // Ticks of the frames the last sample was made from.
+  struct SampledPair {
+    option<i64> from = nullopt;
+    option<i64> to = nullopt;
+
+    auto operator==(const SampledPair&) const -> bool = default;
+  };
+
+  std::array<option<Frame>, MAX_FRAMES> frames = {};
+  option<SampledPair> sampled_pair = nullopt;
+  const SceneState* sampled_out = nullptr;
+  option<i64> latest_tick = nullopt;
+  u32 rejected_in_row = 0;
+
+  f64 local_time = 0.0;
+  f64 playback = 0.0;
+  // Local arrival time minus server send time, tracks the fastest snapshots.
+  option<f64> clock_offset = nullopt;
+
+  auto unwrap(this const NetTimeline&, u8 sequence) -> i64;
+  auto target_delay(this const NetTimeline&) -> f64;
+  auto update_clock(this NetTimeline&, i64 tick) -> void;
+};
+} // namespace ox
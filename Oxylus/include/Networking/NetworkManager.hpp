@@ -3,7 +3,10 @@
 #include <ankerl/svector.h>
 #include <expected>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "Core/Types.hpp"
 #include "Memory/TLSFAllocator.hpp"
@@ -15,12 +18,6 @@ namespace ox {
 struct NetServer;
 struct NetClient;
 
-enum class NetEventKind : u32 {
-  Connect = 0,
-  Receive,
-  Disconnect,
-};
-
 struct NetworkManager {
   constexpr static auto MODULE_NAME = "NetworkManager";
 
@@ -28,13 +25,31 @@ struct NetworkManager {
   ankerl::svector<std::unique_ptr<NetServer>, 1> servers = {};
   ankerl::svector<std::unique_ptr<NetClient>, 1> clients = {};
 
+  // ENet hosts are serviced on their own thread unless this is turned off before init, then `dispatch`
+  // services them inline.
+  bool threaded = true;
+  // How long the I/O thread sleeps between passes over the hosts.
+  u32 io_interval_us = 500;
+  // Snapshot compression of every server and client created from here on.
+  SnapshotCodecConfig snapshot_config = {};
+
   auto init(this NetworkManager&) -> std::expected<void, std::string>;
   auto deinit(this NetworkManager&) -> std::expected<void, std::string>;
   auto update(this NetworkManager&, const Timestep& timestep) -> void;
+  // Game thread sync point, App::step runs it before any module update. RPCs queued last frame are sent
+  // and every packet received since is handled (and every RPC called) here.
+  auto dispatch(this NetworkManager&) -> void;
 
 private:
+  std::jthread io_thread = {};
+  std::mutex io_hosts_mutex = {};
+  std::vector<NetHostIO*> io_hosts = {};
+
   auto create_server_handle(this NetworkManager&, u16 port, u32 max_clients) -> ENetHost*;
   auto create_client_handle(this NetworkManager&) -> ENetHost*;
+  auto io_loop(this NetworkManager&, std::stop_token stop_token) -> void;
+  auto add_io_host(this NetworkManager&, NetHostIO* io) -> void;
+  auto remove_io_host(this NetworkManager&, NetHostIO* io) -> void;
 
 public:
   template <typename T = NetServer, typename... Args>
@@ -46,6 +61,8 @@ public:
 
     auto server = std::make_unique<T>(host, std::forward<Args>(args)...);
     auto server_ptr = server.get();
+    server_ptr->snapshot_codec.configure(self.snapshot_config);
+    self.add_io_host(server_ptr->io.get());
     self.servers.emplace_back(std::move(server));
 
     return server_ptr;
@@ -60,6 +77,8 @@ public:
 
     auto client = std::make_unique<T>(host, std::forward<Args>(args)...);
     auto client_ptr = client.get();
+    client_ptr->snapshot_codec.configure(self.snapshot_config);
+    self.add_io_host(client_ptr->io);
     self.clients.emplace_back(std::move(client));
 
     return client_ptr;
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <ankerl/unordered_dense.h>
+#include <filesystem>
+#include <flecs.h>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "Core/Option.hpp"
+#include "Core/Types.hpp"
+#include "Networking/BitStream.hpp"
+#include "Scene/SceneSnapshot.hpp"
+
+typedef struct ZSTD_CCtx_s ZSTD_CCtx;
+typedef struct ZSTD_DCtx_s ZSTD_DCtx;
+typedef struct ZSTD_CDict_s ZSTD_CDict;
+typedef struct ZSTD_DDict_s ZSTD_DDict;
+
+namespace ox {
+enum class SnapshotFieldKind : u8 {
+  Raw = 0,
+  Bool,  // 1 bit
+  Fixed, // f32 as a zigzag varint multiple of `precision`
+  Quat,  // 4 x f32, smallest three
+};
+
+struct SnapshotField {
+  SnapshotFieldKind kind = SnapshotFieldKind::Raw;
+  u32 offset = 0;
+  u32 size = 0;
+  f32 precision = 0.0f;
+};
+
+struct SnapshotComponentLayout {
+  u32 size = 0;
+  std::vector<SnapshotField> fields = {};
+};
+
+// Wire layout of networked components, derived from their flecs meta and NetQuantize hints. Both
+// ends have to build it from the same registrations, anything missing from it is sent as raw bytes.
+struct SnapshotSchema {
+  ankerl::unordered_dense::map<flecs::id_t, SnapshotComponentLayout> components = {};
+
+  auto build(this SnapshotSchema&, flecs::world& world) -> void;
+  auto find(this const SnapshotSchema&, flecs::id_t component_id) -> const SnapshotComponentLayout*;
+};
+
+struct ZstdContextDeleter {
+  auto operator()(ZSTD_CCtx* ctx) const -> void;
+  auto operator()(ZSTD_DCtx* ctx) const -> void;
+  auto operator()(ZSTD_CDict* dict) const -> void;
+  auto operator()(ZSTD_DDict* dict) const -> void;
+};
+
+struct SnapshotCodecConfig {
+  // zstd on top of the bit packing. Only the sender needs it, every packet says whether it is compressed.
+  bool compress = false;
+  i32 compression_level = 3;
+  // Trained with `SnapshotCodec::train_dictionary`, both ends have to load the same file. Empty for plain zstd.
+  std::filesystem::path dictionary_path = {};
+};
+
+// Bit packs scene snapshots, optionally followed by zstd with a shared dictionary.
+struct SnapshotCodec {
+  constexpr static auto QUAT_COMPONENT_BITS = 12_u32;
+  constexpr static auto MAX_DECODED_SIZE = 16_sz * 1024 * 1024;
+
+  SnapshotSchema schema = {};
+  bool compress = false;
+  i32 compression_level = 3;
+
+  // Takes the compression settings and loads the dictionary, false when it can't be read.
+  auto configure(this SnapshotCodec&, const SnapshotCodecConfig& config) -> bool;
+  // Both ends need the same dictionary, an empty span goes back to plain zstd.
+  auto set_dictionary(this SnapshotCodec&, std::span<const u8> dictionary) -> void;
+  // What zstd calls the current dictionary, 0 without one. Handshakes carry it to catch mismatched ends.
+  auto dictionary_id(this const SnapshotCodec& self) -> u32 { return self.dict_id; }
+  static auto train_dictionary(std::span<const std::vector<u8>> samples, usize dictionary_size) -> std::vector<u8>;
+
+  // Appends the encoded snapshot to `out`.
+  auto encode(
+    this SnapshotCodec&, const SceneState& state, u8 sequence, option<u8> baseline, std::vector<u8>& out
+  ) -> bool;
+  // Same wire format, straight from the builder's records.
+  auto encode(
+    this SnapshotCodec&, const SnapshotDelta& delta, u8 sequence, option<u8> baseline, std::vector<u8>& out
+  ) -> bool;
+  auto decode(
+    this SnapshotCodec&, std::span<const u8> bytes, u8& sequence, option<u8>& baseline, SceneState& state
+  ) -> bool;
+
+private:
+  BitWriter writer = {};
+  std::vector<u8> scratch = {};
+  std::vector<u32> record_order = {};
+  std::unique_ptr<ZSTD_CCtx, ZstdContextDeleter> compress_ctx = nullptr;
+  std::unique_ptr<ZSTD_DCtx, ZstdContextDeleter> decompress_ctx = nullptr;
+  std::unique_ptr<ZSTD_CDict, ZstdContextDeleter> compress_dict = nullptr;
+  std::unique_ptr<ZSTD_DDict, ZstdContextDeleter> decompress_dict = nullptr;
+  u32 dict_id = 0;
+
+  auto encode_state(this SnapshotCodec&, const SceneState& state, u8 sequence, option<u8> baseline) -> void;
+  auto encode_delta(this SnapshotCodec&, const SnapshotDelta& delta, u8 sequence, option<u8> baseline) -> void;
+  auto finish_encode(this SnapshotCodec&, std::vector<u8>& out) -> bool;
+  auto decode_state(
+    this const SnapshotCodec&, std::span<const u8> bytes, u8& sequence, option<u8>& baseline, SceneState& state
+  ) -> bool;
+};
+} // namespace ox
@@ -10,16 +10,44 @@
 #include <Jolt/Physics/PhysicsSystem.h>
 // clang-format on
 
+#include <shared_mutex>
+
+#include "Core/UUID.hpp"
+
 namespace ox {
 class RayCast;
 
+enum class ShapeType : u32 { Box = 0, Sphere, Capsule, TaperedCapsule, Cylinder, Mesh };
+
+// Everything a collider shape is built from. Colliders with equal keys share the same shape.
+struct ShapeKey {
+  ShapeType type = ShapeType::Box;
+  // Half extents for boxes, scale for meshes, (radius, half height, bottom radius) otherwise.
+  glm::vec3 dimensions = {};
+  glm::vec3 offset = {};
+  f32 density = 1.0f;
+  f32 friction = 0.5f;
+  f32 restitution = 0.0f;
+
+  // Mesh shapes only
+  UUID mesh_uuid = {};
+  u32 mesh_index = 0;
+
+  auto operator==(const ShapeKey& other) const -> bool = default;
+};
+
+struct ShapeKeyHash {
+  using is_avalanching = void;
+  auto operator()(const ShapeKey& key) const noexcept -> u64;
+};
+
 class Physics {
 public:
   constexpr static auto MODULE_NAME = "Physics";
 
-  static constexpr uint32_t MAX_BODIES = 1024;
-  static constexpr uint32_t MAX_BODY_PAIRS = 1024;
-  static constexpr uint32_t MAX_CONTACT_CONSTRAINS = 1024;
+  static constexpr uint32_t MAX_BODIES = 65536;
+  static constexpr uint32_t MAX_BODY_PAIRS = 65536;
+  static constexpr uint32_t MAX_CONTACT_CONSTRAINS = 10240;
   BPLayerInterfaceImpl layer_interface;
   ObjectVsBroadPhaseLayerFilterImpl object_vs_broad_phase_layer_filter_interface;
   ObjectLayerPairFilterImpl object_layer_pair_filter_interface;
@@ -33,8 +61,20 @@ public:
   auto get_temp_allocator(this const Physics& self) -> JPH::TempAllocatorImpl* { return self.temp_allocator.get(); }
   auto get_job_system(this const Physics& self) -> JPH::JobSystemWithBarrier* { return self.job_system.get(); }
 
+  // Returns the shared shape for `key`, building it on first use. Mesh shapes are restored from
+  // the `<model>.oxshapes` file baked by rcli when it's up to date, cooked from the model otherwise.
+  auto get_shape(this Physics& self, const ShapeKey& key) -> JPH::ShapeRefC;
+  // Drops cached shapes that no body references anymore.
+  auto trim_shape_cache(this Physics& self) -> void;
+
 private:
   std::unique_ptr<JPH::TempAllocatorImpl> temp_allocator = nullptr;
   std::unique_ptr<JPH::JobSystemWithBarrier> job_system = nullptr;
+
+  std::shared_mutex shape_cache_mutex = {};
+  ankerl::unordered_dense::map<ShapeKey, JPH::ShapeRefC, ShapeKeyHash> shape_cache = {};
+
+  auto create_shape(this Physics& self, const ShapeKey& key) -> JPH::ShapeRefC;
+  auto load_mesh_shapes(this Physics& self, const UUID& model_uuid) -> std::vector<JPH::ShapeRefC>;
 };
 } // namespace ox
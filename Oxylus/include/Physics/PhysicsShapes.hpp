@@ -0,0 +1,30 @@
+#pragma once
+
+// clang-format off
+#include <Jolt/Jolt.h>
+#include <Jolt/Physics/Collision/Shape/Shape.h>
+// clang-format on
+
+#include <filesystem>
+#include <span>
+#include <vector>
+
+#include "Core/Types.hpp"
+
+namespace ox {
+// Builds one triangle mesh shape per mesh of a glTF model. Meshes are visited in the same
+// order `AssetManager::load_model` assigns them, so `MeshComponent::mesh_index` indexes
+// the result directly. Meshes that can't be cooked are left null.
+auto cook_gltf_mesh_shapes(const std::filesystem::path& path) -> std::vector<JPH::ShapeRefC>;
+
+// Jolt's binary shape format, see `JPH::Shape::SaveWithChildren`.
+// Shapes are saved without materials, friction and restitution come from the body.
+auto save_shape_binary(const JPH::Shape* shape) -> std::vector<u8>;
+auto restore_shape_binary(std::span<const u8> bytes) -> JPH::ShapeRefC;
+
+// Where rcli bakes a model's shapes and the runtime looks for them.
+auto baked_shapes_path(const std::filesystem::path& model_path) -> std::filesystem::path;
+// Identifies the source a baked shape was cooked from, the model file and the external buffers it references,
+// used to reject stale bakes.
+auto hash_shape_source(const std::filesystem::path& path) -> u64;
+} // namespace ox
@@ -5,6 +5,7 @@
 #include "Asset/Texture.hpp"
 #include "Render/Renderer.hpp"
 #include "Render/RendererCVar.hpp"
+#include "Scene/Components.hpp"
 #include "Scene/SceneGPU.hpp"
 
 namespace ox {
@@ -378,6 +379,23 @@ private:
   Scene& scene;
   Renderer& renderer;
   GPU::RenderQueue2D render_queue_2d = {};
+  // Entity ids of the sprites the camera sees this frame, kept to reuse the allocation.
+  std::vector<u64> visible_sprites = {};
+
+  // Built once, flecs keeps their matched tables up to date instead of matching them again every frame.
+  flecs::query<const TransformComponent, const CameraComponent> camera_query = {};
+  flecs::query<const TransformComponent, const LightComponent> light_query = {};
+  flecs::query<ParticleSystemComponent> particle_system_query = {};
+  // Settings that rarely change, only gathered again when `changed()`.
+  flecs::query<const AtmosphereComponent> atmosphere_query = {};
+  flecs::query<const SkyComponent> sky_query = {};
+  flecs::query<const AutoExposureComponent> auto_exposure_query = {};
+  flecs::query<const VignetteComponent> vignette_query = {};
+  flecs::query<const ChromaticAberrationComponent> chromatic_aberration_query = {};
+  flecs::query<const FilmGrainComponent> film_grain_query = {};
+  flecs::query<const TonemappingComponent> tonemapping_query = {};
+  // What the settings queries found the last time they ran, kept for the frames they are skipped.
+  GPU::SceneFlags settings_scene_flags = {};
   bool saved_camera = false;
 
   glm::uvec2 viewport_size = {};
@@ -103,6 +103,16 @@ struct ComponentBuilder {
     return self;
   }
 
+  // Attaches `value` to the meta entity of a member, e.g. a NetQuantize hint for the snapshot encoder.
+  template <auto Member, typename T>
+  auto member_hint(this ComponentBuilder self, const T& value) -> ComponentBuilder {
+    auto member = self.component.lookup(refl::member_cstr<Member>());
+    if (member) {
+      member.set<T>(value);
+    }
+    return self;
+  }
+
   operator flecs::entity() const { return component; }
 };
 
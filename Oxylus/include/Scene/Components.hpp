@@ -2,6 +2,7 @@
 
 #include <flecs.h>
 
+#include "Asset/Material.hpp"
 #include "Audio/AudioEngine.hpp"
 #include "Core/UUID.hpp"
 #include "Scene/SceneGPU.hpp"
@@ -40,6 +41,10 @@ struct SpriteComponent {
   UUID material = {};
 
   AABB rect = {};
+  // Cached by the renderer, `material` is looked up again when it no longer matches `resolved_material` or
+  // `resolved_material_id` was unloaded since.
+  UUID resolved_material = {};
+  MaterialID resolved_material_id = MaterialID::Invalid;
 };
 
 struct SpriteAnimationComponent {
@@ -189,6 +194,9 @@ struct ParticleSystemComponent {
   f32 rotation_by_speed_max_speed = 1.f;
 
   std::vector<u64> particles = {};
+  // Cached by the renderer like `SpriteComponent::resolved_material_id`.
+  UUID resolved_material = {};
+  MaterialID resolved_material_id = MaterialID::Invalid;
   u32 pool_index = 0;
   float system_time = 0.0f;
   float burst_time = 0.0f;
@@ -301,6 +309,9 @@ struct RigidBodyComponent {
   glm::quat previous_rotation = glm::quat::wxyz(1.0f, 0.0f, 0.0f, 0.0f);
   glm::vec3 translation = glm::vec3(0.0f);
   glm::quat rotation = glm::quat::wxyz(1.0f, 0.0f, 0.0f, 0.0f);
+
+  // Set while the body was active on the last physics tick.
+  bool moving = false;
 };
 
 struct BoxColliderComponent {
@@ -428,6 +439,11 @@ struct Hidden {};
 
 struct Networked {};
 
+// Set on a member of a networked component, floats under it are sent as fixed point multiples of `precision`.
+struct NetQuantize {
+  f32 precision = 0.0f;
+};
+
 struct CoreComponentsModule {
   CoreComponentsModule(flecs::world& world);
 };
@@ -19,6 +19,7 @@
 #include "Render/RendererInstance.hpp"
 #include "Scene/Components.hpp"
 #include "Scene/SceneGPU.hpp"
+#include "Scene/SpatialHash2D.hpp"
 #include "Scripting/LuaSystem.hpp"
 #include "Utils/Timestep.hpp"
 
@@ -65,6 +66,8 @@ public:
   SlotMap<GPU::Transforms, GPU::TransformID> transforms = {};
   ankerl::unordered_dense::map<flecs::entity, GPU::TransformID> entity_transforms_map = {};
   ankerl::unordered_dense::map<u32, flecs::entity> transform_index_entities_map = {};
+  // World space `SpriteComponent::rect` of every sprite with a transform, keyed by entity id.
+  SpatialHash2D sprite_grid = {};
 
   RendererCVar renderer_cvar = {};
 
@@ -127,6 +130,8 @@ public:
   auto get_lua_systems(this const Scene& self) -> const ankerl::unordered_dense::map<UUID, LuaSystem*>&;
   auto add_lua_system(this Scene& self, const UUID& lua_script) -> void;
   auto remove_lua_system(this Scene& self, const UUID& lua_script) -> void;
+  // World scripts work with, the calling thread's stage while parallel systems run and the world otherwise.
+  auto get_script_world(this const Scene& self) -> ecs_world_t*;
 
   // Physics
   auto get_physics_system(this const Scene& self) -> JPH::PhysicsSystem*;
@@ -182,6 +187,7 @@ private:
 
   // Lua
   ankerl::unordered_dense::map<UUID, LuaSystem*> lua_systems = {};
+  std::vector<LuaSystem*> parallel_lua_systems = {};
 
   // Renderer
   std::unique_ptr<RendererInstance> renderer_instance = nullptr;
@@ -193,10 +199,23 @@ private:
   std::unique_ptr<PhysicsDebugRenderer> physics_debug_renderer = nullptr;
   std::unique_ptr<Physics3DContactListener> contact_listener_3d = nullptr;
   std::unique_ptr<Physics3DBodyActivationListener> body_activation_listener_3d = nullptr;
+  // Scratch storage for the per-tick readback, kept around to avoid reallocating every tick.
+  JPH::BodyIDVector physics_active_bodies = {};
+  std::vector<flecs::entity> physics_moving_bodies = {};
+  std::vector<flecs::entity> physics_settling_bodies = {};
+
+  // Creates the Jolt body for a rigidbody without adding it to the broadphase.
+  auto create_body(
+    this Scene& self, flecs::entity entity, const TransformComponent& transform, RigidBodyComponent& component
+  ) -> JPH::Body*;
+  // Pushes a transform written directly into the column (bypassing OnSet) to the renderer side.
+  auto sync_transform(this Scene& self, flecs::entity entity) -> void;
+  auto update_sprite_rect(this Scene& self, flecs::entity entity, SpriteComponent& sprite) -> void;
 
   auto add_transform(this Scene& self, flecs::entity entity) -> GPU::TransformID;
   auto remove_transform(this Scene& self, flecs::entity entity) -> void;
 
   auto run_deferred_functions(this Scene& self) -> void;
+  auto update_parallel_lua_systems(this Scene& self, f32 delta_time) -> void;
 };
 } // namespace ox
@@ -7,6 +7,7 @@
 
 #include "Core/Types.hpp"
 #include "Utils/OxMath.hpp"
+#include "Utils/RadixSort.hpp"
 
 namespace ox::GPU {
 enum class TransformID : u64 { Invalid = ~0_u64 };
@@ -368,40 +369,24 @@ struct SpriteGPUData {
   alignas(4) u32 flags16_distance16 = 0;
   alignas(4) u32 transform_id = 0;
 
-  bool operator>(const SpriteGPUData& other) const {
-    union SortKey {
-      struct {
-        // The order of members is important here, it means the sort priority (low to high)!
-        u64 distance_y : 32;
-        u64 distance_z : 32;
-      } bits;
-
-      u64 value;
-    };
-    static_assert(sizeof(SortKey) == sizeof(u64));
-    const SortKey a = {
-      .bits = {
-        .distance_y = math::unpack_u32_low(flags16_distance16) & RENDER_FLAGS_2D_SORT_Y
-                        ? math::unpack_u32_high(material_id16_ypos16)
-                        : 0u,
-        .distance_z = math::unpack_u32_high(flags16_distance16),
-      },
-    };
-    const SortKey b = {
-      .bits = {
-        .distance_y = math::unpack_u32_low(other.flags16_distance16) & RENDER_FLAGS_2D_SORT_Y
-                        ? math::unpack_u32_high(other.material_id16_ypos16)
-                        : 0u,
-        .distance_z = math::unpack_u32_high(other.flags16_distance16),
-      },
-    };
-    return a.value > b.value;
+  // Distance in the high half and, for y sorted sprites, y position in the low half, both as half floats.
+  // Sprites are drawn from the highest key to the lowest.
+  auto sort_key() const -> u32 {
+    const auto sort_y = math::unpack_u32_low(flags16_distance16) & RENDER_FLAGS_2D_SORT_Y;
+    const auto y = sort_y ? math::unpack_u32_high(material_id16_ypos16) : 0_u16;
+    return math::pack_u16(y, math::unpack_u32_high(flags16_distance16));
   }
+
+  bool operator>(const SpriteGPUData& other) const { return sort_key() > other.sort_key(); }
 };
 
+// Sprites of a frame, sorted on the CPU and drawn in batches. Storage is kept across frames and only cleared by
+// `init`, after the previous frame's graph was submitted, so passes take spans into it instead of copies.
 struct RenderQueue2D {
   std::vector<DrawBatch2D> batches = {};
   std::vector<SpriteGPUData> sprite_data = {};
+  // One per sprite, made once in `add` and inverted so an ascending sort draws back to front.
+  std::vector<u32> sort_keys = {};
 
   u32 num_sprites = 0;
   u32 previous_offset = 0;
@@ -413,6 +398,7 @@ struct RenderQueue2D {
     clear();
     batches.reserve(last_batches_size);
     sprite_data.reserve(last_sprite_data_size);
+    sort_keys.reserve(last_sprite_data_size);
     batches.emplace_back(DrawBatch2D{.pipeline_name = "2d_forward", .offset = previous_offset, .count = 0});
   }
 
@@ -427,18 +413,39 @@ struct RenderQueue2D {
     const u32 flags_and_distance = math::pack_u16(render_flags, glm::packHalf1x16(distance));
     const u32 materialid_and_ypos = math::pack_u16(static_cast<u16>(material_id), glm::packHalf1x16(position_y));
 
-    sprite_data.emplace_back(
+    const auto& sprite = sprite_data.emplace_back(
       SpriteGPUData{
         .material_id16_ypos16 = materialid_and_ypos,
         .flags16_distance16 = flags_and_distance,
         .transform_id = transform_id,
       }
     );
+    sort_keys.push_back(~sprite.sort_key());
 
     num_sprites += 1;
   }
 
-  void sort() { std::ranges::sort(sprite_data, std::greater<SpriteGPUData>()); }
+  // Radix sorts (key, index) pairs, in parallel on `job_manager` for big queues, then gathers the sprites in
+  // that order. Sprites with the same key keep the order they were added in.
+  void sort(JobManager* job_manager = nullptr) {
+    ZoneScoped;
+
+    const auto count = sprite_data.size();
+    sort_indices.resize(count);
+    scratch_keys.resize(count);
+    scratch_indices.resize(count);
+    for (auto i = 0_u32; i < count; i++) {
+      sort_indices[i] = i;
+    }
+
+    radix_sort_pairs(sort_keys, sort_indices, scratch_keys, scratch_indices, job_manager);
+
+    sorted_sprites.resize(count);
+    for (auto i = 0_sz; i < count; i++) {
+      sorted_sprites[i] = sprite_data[sort_indices[i]];
+    }
+    std::swap(sprite_data, sorted_sprites);
+  }
 
   void clear() {
     num_sprites = 0;
@@ -448,7 +455,14 @@ struct RenderQueue2D {
 
     batches.clear();
     sprite_data.clear();
+    sort_keys.clear();
   }
+
+private:
+  std::vector<u32> sort_indices = {};
+  std::vector<u32> scratch_keys = {};
+  std::vector<u32> scratch_indices = {};
+  std::vector<SpriteGPUData> sorted_sprites = {};
 };
 
 } // namespace ox::GPU
@@ -1,17 +1,19 @@
 #pragma once
 
 #include <ankerl/unordered_dense.h>
+#include <array>
 #include <flecs.h>
+#include <span>
 #include <vector>
 
 #include "Core/Option.hpp"
 #include "Core/Types.hpp"
+#include "Networking/Fwd.hpp"
 
 namespace ox {
 struct ComponentState {
   flecs::id_t id = 0;
   u64 hash = 0; // u64_max indicates that this one is a tag
-  // TODO: we should probably replace this vector with something pre-allocated
   std::vector<u8> buffer = {};
 };
 
@@ -21,6 +23,7 @@ struct EntityState {
   ankerl::unordered_dense::set<flecs::id_t> removed_components = {};
 };
 
+// Delta between two snapshot frames grouped per entity, what the client side works with.
 struct SceneState {
   ankerl::unordered_dense::map<flecs::entity_t, EntityState> entities = {};
   ankerl::unordered_dense::set<flecs::entity_t> removed_entities = {};
@@ -31,18 +34,135 @@ struct SceneState {
   }
 };
 
+// One networked component of one flecs table, rows are packed tightly in `SnapshotFrame::arena`.
+struct SnapshotColumn {
+  flecs::id_t component_id = 0;
+  u32 table_index = 0;
+  u32 size = 0; // element size, 0 for tags
+  usize data_offset = 0;
+  u32 hash_offset = 0; // first chunk hash in `SnapshotFrame::chunk_hashes`
+};
+
+struct SnapshotRow {
+  u32 table_index = 0;
+  u32 row = 0;
+};
+
+struct SnapshotTable {
+  u64 type_hash = 0;
+  u32 row_offset = 0; // first entity in `SnapshotFrame::entities`
+  u32 row_count = 0;
+  u32 column_offset = 0;
+  u32 column_count = 0;
+};
+
+// Column-wise capture of every table that has at least one networked component. Frames are
+// reused by the builder ring, `clear` keeps the capacity so steady state captures don't allocate.
+struct SnapshotFrame {
+  constexpr static auto CHUNK_ROWS = 64_u32;
+
+  std::vector<u8> arena = {};
+  std::vector<flecs::entity_t> entities = {};
+  std::vector<u64> chunk_hashes = {};
+  std::vector<SnapshotTable> tables = {};
+  std::vector<SnapshotColumn> columns = {};
+  ankerl::unordered_dense::map<u64, u32> table_lookup = {}; // type hash -> index into `tables`
+  // Per entity lookups are only needed for filtered snapshots, `index_rows` builds this on first use.
+  ankerl::unordered_dense::map<flecs::entity_t, SnapshotRow> rows = {};
+  bool rows_indexed = false;
+
+  auto clear() -> void {
+    arena.clear();
+    entities.clear();
+    chunk_hashes.clear();
+    tables.clear();
+    columns.clear();
+    table_lookup.clear();
+    rows.clear();
+    rows_indexed = false;
+  }
+
+  auto index_rows(this SnapshotFrame&) -> void;
+  auto find_row(this const SnapshotFrame&, flecs::entity_t entity) -> option<SnapshotRow>;
+  auto find_table(this const SnapshotFrame&, u64 type_hash) -> option<u32>;
+  auto find_column(this const SnapshotFrame&, const SnapshotTable& table, flecs::id_t component_id)
+    -> const SnapshotColumn*;
+  auto table_entities(this const SnapshotFrame&, const SnapshotTable& table) -> std::span<const flecs::entity_t>;
+  auto table_columns(this const SnapshotFrame&, const SnapshotTable& table) -> std::span<const SnapshotColumn>;
+  auto element(this const SnapshotFrame&, const SnapshotColumn& column, u32 row) -> std::span<const u8>;
+};
+
+// One change of a delta. Component bytes aren't copied, they are `size` bytes at `offset` in the frame's arena.
+struct SnapshotRecord {
+  flecs::entity_t entity = 0;
+  flecs::id_t component_id = 0;
+  usize offset = 0;
+  u32 size = 0; // 0 for tags and removed components
+  bool removed = false;
+};
+
+// Delta between two snapshot frames as it comes out of the diff, in the order the frame's tables were
+// walked. Builders reuse it across captures, it is only valid until the next diff or capture of `frame`.
+struct SnapshotDelta {
+  const SnapshotFrame* frame = nullptr;
+  std::vector<SnapshotRecord> records = {};
+  std::vector<flecs::entity_t> removed_entities = {};
+
+  auto clear() -> void {
+    frame = nullptr;
+    records.clear();
+    removed_entities.clear();
+  }
+
+  auto empty() const -> bool { return records.empty() && removed_entities.empty(); }
+  auto bytes(this const SnapshotDelta&, const SnapshotRecord& record) -> std::span<const u8>;
+  // Groups the records per entity and copies their bytes out, for whatever still needs the maps.
+  auto to_state(this const SnapshotDelta&, SceneState& state) -> void;
+};
+
 struct SceneSnapshotBuilder {
   constexpr static auto MAX_SEQUENCES = 32_u8;
-  std::array<SceneState, MAX_SEQUENCES> states = {};
-  std::array<bool, MAX_SEQUENCES> acks = {};
+  std::array<SnapshotFrame, MAX_SEQUENCES> frames = {};
+  // Monotonic id of the capture held by each slot (0 when empty), tells a live baseline from a recycled slot.
+  std::array<u64, MAX_SEQUENCES> frame_ids = {};
   u8 current_sequence = 0;
+  u64 frame_counter = 1;
 
-  auto current() -> SceneState& { return states[current_sequence]; }
-  auto ack(u8 seq) -> void { acks[seq % MAX_SEQUENCES] = true; }
-  auto set_current(this SceneSnapshotBuilder&, SceneState& new_state) -> void;
+  auto current() -> SnapshotFrame& { return frames[current_sequence]; }
+  auto capture(this SceneSnapshotBuilder&, flecs::world& world) -> void;
   auto advance(this SceneSnapshotBuilder&) -> void;
-  auto find_last_acked(this SceneSnapshotBuilder& self) -> option<u8>;
-  auto delta(this SceneSnapshotBuilder& self) -> SceneState;
-  static auto take_snapshot(flecs::world& world, SceneState& state) -> void;
+
+  // Every client deltas against the last frame it acked, a lagging client only costs itself.
+  auto ack(this SceneSnapshotBuilder&, NetClientID client_id, u8 sequence) -> void;
+  auto remove_client(this SceneSnapshotBuilder&, NetClientID client_id) -> void;
+  auto baseline(this const SceneSnapshotBuilder&, NetClientID client_id) -> option<u8>;
+  // Delta of the current frame against the client's baseline, full state if it has none.
+  auto delta(this SceneSnapshotBuilder&, NetClientID client_id) -> SceneState;
+  auto delta_from(this SceneSnapshotBuilder&, option<u8> base_sequence) -> SceneState;
+  // Same as `delta_from` without building the per entity maps, the result is overwritten by the next call.
+  auto flat_delta(this SceneSnapshotBuilder&, option<u8> base_sequence) -> const SnapshotDelta&;
+
+  static auto take_snapshot(flecs::world& world, SnapshotFrame& frame) -> void;
+  // Appends the changes of a single entity between two frames, everything it has when `base` is null.
+  // `base` must have its rows indexed. Returns false when nothing changed.
+  static auto diff_entity(
+    const SnapshotFrame* base, const SnapshotFrame& frame, SnapshotRow row, SnapshotDelta& delta
+  ) -> bool;
+
+private:
+  struct Baseline {
+    u8 sequence = 0;
+    u64 frame_id = 0;
+  };
+
+  ankerl::unordered_dense::map<NetClientID, Baseline> baselines = {};
+
+  // Scratch state, only filled when tables don't line up between two frames.
+  ankerl::unordered_dense::map<flecs::entity_t, SnapshotRow> base_locations = {};
+  ankerl::unordered_dense::set<flecs::entity_t> current_entities = {};
+  SnapshotDelta scratch_delta = {};
+
+  auto diff(this SceneSnapshotBuilder&, const SnapshotFrame& base, const SnapshotFrame& frame, SnapshotDelta& delta)
+    -> void;
 };
 } // namespace ox
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <ankerl/unordered_dense.h>
+#include <glm/vec2.hpp>
+#include <limits>
+#include <vector>
+
+#include "Core/Types.hpp"
+#include "Render/BoundingVolume.hpp"
+
+namespace ox {
+// Loose grid over the XY plane, hashed so it only stores cells that hold something. An item lives in the one cell
+// its center falls in, and may stick out of it by up to a cell on every side, so moving it around inside a cell
+// only rewrites its bounds. Items bigger than that are kept aside and tested on every query.
+class SpatialHash2D {
+public:
+  constexpr static f32 DEFAULT_CELL_SIZE = 8.0f;
+
+  explicit SpatialHash2D(f32 cell_size = DEFAULT_CELL_SIZE);
+
+  auto insert_or_update(this SpatialHash2D& self, u64 id, const AABB& bounds) -> void;
+  auto remove(this SpatialHash2D& self, u64 id) -> void;
+  auto clear(this SpatialHash2D& self) -> void;
+
+  // Appends the id of every item whose bounds overlap the rectangle in XY, in no particular order.
+  auto query(this const SpatialHash2D& self, glm::vec2 min, glm::vec2 max, std::vector<u64>& out) -> void;
+
+  auto contains(this const SpatialHash2D& self, u64 id) -> bool { return self.items.contains(id); }
+  auto size(this const SpatialHash2D& self) -> usize { return self.items.size(); }
+  auto get_cell_size(this const SpatialHash2D& self) -> f32 { return self.cell_size; }
+  // Depth every item inserted since the last `clear` fits in, it only grows. `min_z > max_z` while empty.
+  auto get_min_z(this const SpatialHash2D& self) -> f32 { return self.min_z; }
+  auto get_max_z(this const SpatialHash2D& self) -> f32 { return self.max_z; }
+
+private:
+  struct Entry {
+    glm::vec2 min = {};
+    glm::vec2 max = {};
+    u64 id = 0;
+  };
+
+  struct Item {
+    u64 cell = 0;
+    // Index in the cell's, or the large items', entries.
+    u32 slot = 0;
+    bool large = false;
+  };
+
+  f32 cell_size = DEFAULT_CELL_SIZE;
+  f32 inv_cell_size = 1.0f / DEFAULT_CELL_SIZE;
+  ankerl::unordered_dense::map<u64, Item> items = {};
+  ankerl::unordered_dense::map<u64, std::vector<Entry>> cells = {};
+  std::vector<Entry> large_items = {};
+  f32 min_z = std::numeric_limits<f32>::max();
+  f32 max_z = std::numeric_limits<f32>::lowest();
+
+  auto cell_of(this const SpatialHash2D& self, glm::vec2 point) -> glm::ivec2;
+  auto entries_of(this SpatialHash2D& self, const Item& item) -> std::vector<Entry>&;
+  auto unlink(this SpatialHash2D& self, const Item& item) -> void;
+};
+} // namespace ox
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <expected>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Asset/AssetFile.hpp"
+#include "Core/Option.hpp"
+#include "Core/Types.hpp"
+
+namespace ox {
+// Where rcli writes the compiled chunk of a script and where `AssetManager::load_script` looks for it,
+// `<path>.oxbc` next to the source.
+auto script_bytecode_path(const std::filesystem::path& script_path) -> std::filesystem::path;
+
+// Identifies the source a chunk was compiled from, used to reject stale bytecode.
+auto hash_script_source(std::span<const u8> source) -> u64;
+
+// Compiles Lua source into a binary chunk, see `lua_dump`. Stripped chunks drop debug info, errors
+// raised from them have no line numbers.
+auto compile_script_bytecode(std::span<const u8> source, const std::string& chunk_name, bool strip)
+  -> std::expected<std::vector<u8>, std::string>;
+
+// Reads the compiled chunk of `script_path`. Returns nothing when there is none or when the source
+// changed since it was compiled. A chunk without its source next to it is trusted as is.
+auto load_script_bytecode(const std::filesystem::path& script_path) -> option<ScriptBytecodeData>;
+
+// Scripts opt into running on worker threads with a `--!parallel` line in the comments they start with.
+// They get a Lua state of their own and must only write to the world through the one `scene:world()`
+// returns while they run, see `Scene::update_parallel_lua_systems`.
+auto is_parallel_script(std::string_view source) -> bool;
+} // namespace ox
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <flecs.h>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Core/Types.hpp"
+
+namespace sol {
+class state;
+}
+
+namespace ox {
+struct LuaComponentLayout;
+
+enum class LuaFieldKind : u8 {
+  Bool,
+  Char,
+  U8,
+  U16,
+  U32,
+  U64,
+  I8,
+  I16,
+  I32,
+  I64,
+  F32,
+  F64,
+  String,
+  Entity,
+  Id,
+  Enum,
+  Vec2,
+  Vec3,
+  Vec4,
+  Quat,
+  Struct,
+  UUID,
+  Opaque,
+};
+
+struct LuaComponentField {
+  std::string name = {};
+  LuaFieldKind kind = LuaFieldKind::F32;
+  // Offset from the start of the struct the field is in.
+  u32 offset = 0;
+  // Type of a struct or opaque field.
+  flecs::entity_t type = 0;
+  // Storage of an enum field.
+  ecs_meta_op_kind_t underlying_kind = EcsOpI32;
+  // Fields of a struct field.
+  const LuaComponentLayout* layout = nullptr;
+};
+
+// Where every field of a component lives, built once per component type from its flecs meta ops. Layouts
+// are owned by the world they were built in and go away with it.
+struct LuaComponentLayout {
+  ecs_world_t* world = nullptr;
+  flecs::entity_t type = 0;
+  std::vector<LuaComponentField> fields = {};
+  std::vector<std::unique_ptr<LuaComponentLayout>> nested = {};
+
+  // Components have a handful of fields, a linear search beats hashing the key.
+  auto find(this const LuaComponentLayout& self, std::string_view name) -> const LuaComponentField*;
+
+  static auto get(flecs::world& world, flecs::entity_t type) -> const LuaComponentLayout*;
+  // Rebuilt on the next `get`, for components whose members changed. Layouts already handed out stay
+  // valid until the world goes away, they just describe the old members.
+  static auto invalidate(flecs::world& world, flecs::entity_t type) -> void;
+};
+
+// What scripts get for a component. Fields are read from and written to the component's memory through
+// the layout's offsets, nothing is copied into Lua. Views point into flecs storage, they are only valid
+// until the entity's table changes, same as a pointer from `get_mut`.
+//
+// Vector fields can also be read and written as numbers, `x, y, z = t:position_xyz()` and
+// `t:set_position_xyz(x, y, z)`, which unlike `t.position` don't make a new userdata per access.
+//
+// Writes mark `component` modified on `entity`, so change queries and OnSet observers see them. Views over
+// memory no entity owns leave those empty.
+struct LuaComponentView {
+  void* ptr = nullptr;
+  const LuaComponentLayout* layout = nullptr;
+  bool is_mutable = false;
+  ecs_world_t* world = nullptr;
+  flecs::entity_t entity = 0;
+  flecs::id_t component = 0;
+
+  static auto bind(sol::state* state) -> void;
+};
+
+// Every component of one column of a flecs table, `count` of them `stride` bytes apart. A component the
+// whole table shares has a stride of 0. Indexed from 0, same as iterators.
+//
+// Writes mark the component modified on the entity they went to, `entities[i]` or the shared component's
+// `source`.
+struct LuaComponentColumn {
+  u8* data = nullptr;
+  usize stride = 0;
+  u32 count = 0;
+  const LuaComponentLayout* layout = nullptr;
+  ecs_world_t* world = nullptr;
+  const flecs::entity_t* entities = nullptr;
+  flecs::entity_t source = 0;
+  flecs::id_t component = 0;
+
+  static auto from_iter(ecs_iter_t* it, i8 index, flecs::entity_t type) -> LuaComponentColumn;
+  static auto bind(sol::state* state) -> void;
+};
+
+// One field of every component in a column. Besides element access it has helpers that go over the whole
+// array in C++, so a script can update a column without calling into Lua per element.
+struct LuaFieldArray {
+  // Start of the first component, not of the field.
+  u8* data = nullptr;
+  usize stride = 0;
+  u32 count = 0;
+  const LuaComponentLayout* layout = nullptr;
+  const LuaComponentField* field = nullptr;
+  // Owners of the elements, same as the column's.
+  ecs_world_t* world = nullptr;
+  const flecs::entity_t* entities = nullptr;
+  flecs::entity_t source = 0;
+  flecs::id_t component = 0;
+
+  template <typename T>
+  auto at(this const LuaFieldArray& self, u32 index) -> T& {
+    return *reinterpret_cast<T*>(self.data + index * self.stride + self.field->offset);
+  }
+};
+} // namespace ox
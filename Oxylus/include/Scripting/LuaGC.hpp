@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Core/Types.hpp"
+
+struct lua_State;
+
+namespace ox {
+struct LuaGCConfig {
+  // Time the collector gets every frame.
+  f64 budget_us = 500.0;
+  // Work done per step, in KB worth of objects. Smaller steps stay closer to the budget.
+  i32 step_kb = 8;
+  // Heap size at which frames start the next cycle, in percent of its size after the last one. Same
+  // meaning as Lua's own pause.
+  i32 pause = 150;
+  // Pause handed to Lua's collector, so it only starts a cycle by itself when frame steps fall behind.
+  i32 backstop_pause = 400;
+  // Speed of the collector relative to allocation, see `LUA_GCINC`.
+  i32 step_multiplier = 200;
+};
+
+struct LuaGCStats {
+  usize heap_bytes = 0;
+  // Last frame.
+  f64 step_us = 0.0;
+  u32 steps = 0;
+  // Cycles the frame steps finished plus full collections, since init.
+  u64 completed_cycles = 0;
+  u64 full_collections = 0;
+};
+
+// Incremental collection of a Lua state done in small steps within a per-frame time budget, so script
+// garbage is collected a little every frame rather than all at once in whichever allocation trips it.
+struct LuaGC {
+  LuaGCConfig config = {};
+  LuaGCStats stats = {};
+  usize heap_after_cycle = 0;
+  bool in_cycle = false;
+
+  auto init(this LuaGC& self, lua_State* L, const LuaGCConfig& config = {}) -> void;
+  // Once per frame.
+  auto step(this LuaGC& self, lua_State* L) -> void;
+  // Stop-the-world, for teardown and other places where a hitch doesn't matter.
+  auto full_collect(this LuaGC& self, lua_State* L) -> void;
+};
+} // namespace ox
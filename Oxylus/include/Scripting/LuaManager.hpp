@@ -5,6 +5,8 @@
 #include <sol/state.hpp>
 
 #include "Scripting/LuaBinding.hpp"
+#include "Scripting/LuaGC.hpp"
+#include "Scripting/LuaProfiler.hpp"
 
 namespace ox {
 class LuaManager {
@@ -15,6 +17,17 @@ public:
   auto deinit(this LuaManager& self) -> std::expected<void, std::string>;
 
   auto get_state(this const LuaManager& self) -> sol::state* { return self.state.get(); }
+  // A state of its own with the same libraries and bindings as the shared one, for parallel scripts.
+  auto create_state(this const LuaManager& self) -> std::unique_ptr<sol::state>;
+
+  // Collection is spread over frames, `App::step` calls `step_gc` once per frame after the modules.
+  auto configure_gc(this LuaManager& self, const LuaGCConfig& config) -> void;
+  auto step_gc(this LuaManager& self) -> void;
+  auto collect_gc(this LuaManager& self) -> void;
+  auto get_gc_stats(this const LuaManager& self) -> const LuaGCStats& { return self.gc.stats; }
+
+  // Samples calls into the shared state, parallel scripts have their own.
+  auto get_profiler(this const LuaManager& self) -> LuaProfiler* { return self.profiler.get(); }
 
   template <typename T>
   void bind(this LuaManager& self, const std::string& name, sol::state* state) {
@@ -32,9 +45,13 @@ public:
 
 private:
   ankerl::unordered_dense::map<std::string, std::unique_ptr<LuaBinding>> bindings = {};
+  // Before the state, closing it still goes through the profiler's allocator.
+  std::unique_ptr<LuaProfiler> profiler = nullptr;
   std::unique_ptr<sol::state> state = nullptr;
+  LuaGC gc = {};
 
-  auto bind_log(this const LuaManager& self) -> void;
-  auto bind_vector(this const LuaManager& self) -> void;
+  static auto open_state(sol::state* state) -> void;
+  static auto bind_log(sol::state* state) -> void;
+  static auto bind_vector(sol::state* state) -> void;
 };
 } // namespace ox
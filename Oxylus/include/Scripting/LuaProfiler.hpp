@@ -0,0 +1,160 @@
+#pragma once
+
+#include <ankerl/unordered_dense.h>
+#include <expected>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Core/Types.hpp"
+
+struct lua_State;
+struct lua_Debug;
+
+namespace ox {
+struct LuaProfilerConfig {
+  // VM instructions between samples, lower is finer and slower.
+  i32 sample_interval = 1000;
+  // Lua frames past it are cut off, the innermost ones are kept.
+  u32 max_depth = 32;
+};
+
+struct LuaCost {
+  f64 ms = 0.0;
+  u64 samples = 0;
+  u64 alloc_bytes = 0;
+};
+
+struct LuaNamedCost {
+  std::string name = {};
+  LuaCost cost = {};
+};
+
+struct LuaFunctionCost {
+  // `function (file:line it is defined at)`.
+  std::string name = {};
+  // Spent in the function itself and in everything it called.
+  LuaCost self = {};
+  LuaCost total = {};
+};
+
+// What scripts cost in one frame, every list sorted by time, most expensive first.
+struct LuaProfileFrame {
+  u64 index = 0;
+  LuaCost total = {};
+  // Folded call stacks, the script that was called, then its Lua frames outermost first, then the line that ran,
+  // separated by `;`.
+  std::vector<LuaNamedCost> stacks = {};
+  std::vector<LuaFunctionCost> functions = {};
+  // By the script that was called from C++.
+  std::vector<LuaNamedCost> scripts = {};
+  // `file:line`, self cost only.
+  std::vector<LuaNamedCost> lines = {};
+};
+
+// Every frame of the history summed, divide by `frames` for per frame costs.
+struct LuaProfileSummary {
+  usize frames = 0;
+  LuaProfileFrame totals = {};
+};
+
+// Sampling profiler for one Lua state. A count hook stops the VM every `sample_interval` instructions and
+// charges the time since the previous sample to the call stack it finds. Allocations are counted by wrapping the
+// state's allocator and are charged the same way, to the next sample, so both are statistical and only as fine
+// as the interval. Only time between `begin_call` and `end_call` is sampled, what C++ does with the state in
+// between is not the scripts' cost.
+//
+// A profiler belongs to one state and is used from one thread at a time. Calls are merged into the frame every
+// profiler shares when they end, `end_frame` closes it on the main thread.
+class LuaProfiler {
+public:
+  constexpr static usize HISTORY_SIZE = 120;
+
+  LuaProfiler() = default;
+  ~LuaProfiler() = default;
+  LuaProfiler(const LuaProfiler&) = delete;
+  LuaProfiler& operator=(const LuaProfiler&) = delete;
+
+  // The profiler wraps the state's allocator, it has to outlive the state or be detached before the state is
+  // closed. The state keeps a pointer to it, it must not move while attached.
+  auto attach(this LuaProfiler& self, lua_State* L, const LuaProfilerConfig& config = {}) -> void;
+  auto detach(this LuaProfiler& self) -> void;
+  static auto from_state(lua_State* L) -> LuaProfiler*;
+
+  // `script` and `function` name the root of every stack sampled until the matching `end_call`. Calls into the
+  // same state while one is open are part of it.
+  auto begin_call(this LuaProfiler& self, std::string_view script, std::string_view function) -> void;
+  auto end_call(this LuaProfiler& self) -> void;
+
+  static auto set_enabled(bool enabled) -> void;
+  static auto is_enabled() -> bool;
+
+  static auto end_frame() -> void;
+  // Oldest first, main thread only.
+  static auto history() -> std::vector<const LuaProfileFrame*>;
+  static auto last_frame() -> const LuaProfileFrame*;
+  // Merged once per closed frame, valid until the next `end_frame` or `reset`.
+  static auto summary() -> const LuaProfileSummary&;
+  static auto reset() -> void;
+
+  // Stacks of the whole history in the folded format flame graph tools read, one `stack weight` per line.
+  // Weighted by microseconds, or by allocated bytes.
+  static auto export_folded(const std::filesystem::path& path, bool allocations = false)
+    -> std::expected<void, std::string>;
+
+private:
+  struct Stack {
+    LuaCost cost = {};
+    std::string folded = {};
+    // Every function in the stack once, recursion is not counted twice.
+    std::vector<std::string> functions = {};
+    std::string leaf_function = {};
+    std::string line = {};
+  };
+
+  lua_State* state = nullptr;
+  LuaProfilerConfig config = {};
+  void* (*alloc_fn)(void*, void*, usize, usize) = nullptr;
+  void* alloc_ud = nullptr;
+
+  u32 open_calls = 0;
+  std::string script = {};
+  std::string function = {};
+  u64 last_sample_ns = 0;
+  u64 pending_alloc_bytes = 0;
+  u64 last_stack = 0;
+  bool recording = false;
+  bool sampled = false;
+  // Keyed by a hash of the functions in the stack, only lives for one call.
+  ankerl::unordered_dense::map<u64, Stack> stacks = {};
+
+  auto sample(this LuaProfiler& self, lua_State* L) -> void;
+  auto make_stack(this const LuaProfiler& self, lua_State* L) -> Stack;
+  auto charge(this LuaProfiler& self, u64 key, u64 now_ns) -> void;
+
+  static auto hook(lua_State* L, lua_Debug* ar) -> void;
+  static auto alloc(void* ud, void* ptr, usize old_size, usize new_size) -> void*;
+};
+
+// Brackets a call from C++ into a state for its profiler, if it has one.
+struct LuaProfileCall {
+  LuaProfileCall(LuaProfiler* profiler_, std::string_view script, std::string_view function) : profiler(profiler_) {
+    if (profiler) {
+      profiler->begin_call(script, function);
+    }
+  }
+
+  ~LuaProfileCall() {
+    if (profiler) {
+      profiler->end_call();
+    }
+  }
+
+  LuaProfileCall(const LuaProfileCall&) = delete;
+  LuaProfileCall& operator=(const LuaProfileCall&) = delete;
+
+private:
+  LuaProfiler* profiler = nullptr;
+};
+} // namespace ox
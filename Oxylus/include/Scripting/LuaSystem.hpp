@@ -4,10 +4,14 @@
 #include <filesystem>
 #include <flecs.h>
 #include <sol/environment.hpp>
+#include <sol/state.hpp>
+#include <span>
 #include <vuk/Types.hpp>
 
 #include "Core/Option.hpp"
 #include "Core/Types.hpp"
+#include "Scripting/LuaGC.hpp"
+#include "Scripting/LuaProfiler.hpp"
 
 namespace JPH {
 class ContactSettings;
@@ -21,6 +25,14 @@ namespace ox {
 class Scene;
 
 enum class ScriptID : u64 { Invalid = std::numeric_limits<u64>::max() };
+enum class ScriptLoadResult : u8 {
+  Loaded,
+  // The chunk didn't compile or load, none of it ran.
+  LoadFailed,
+  // The top level errored, everything before the error did run.
+  RunFailed,
+};
+
 class LuaSystem {
 public:
   LuaSystem() = default;
@@ -30,6 +42,11 @@ public:
   // Either use a path to load it from a lua file or pass in the lua
   auto load(this LuaSystem& self, const std::filesystem::path& path, const ox::option<std::string> script = nullopt)
     -> void;
+  // Runs a chunk compiled by rcli, see `compile_script_bytecode`. `path` is still the source, `reload` reads it.
+  // Only falling back to the source on `LoadFailed` keeps the top level from running twice.
+  auto load_bytecode(
+    this LuaSystem& self, const std::filesystem::path& path, std::span<const u8> bytecode, bool parallel = false
+  ) -> ScriptLoadResult;
   auto reload(this LuaSystem& self) -> void;
 
   auto reset_functions(this LuaSystem& self) -> void;
@@ -67,11 +84,26 @@ public:
 
   auto get_path() const -> const std::filesystem::path& { return file_path; }
 
+  // Scripts marked with `--!parallel` live in a Lua state of their own, `on_scene_update` of them may run on
+  // any thread as long as no other function of the same system runs at the time.
+  auto is_parallel(this const LuaSystem& self) -> bool { return self.own_state != nullptr; }
+  // Collector steps for the system's own state, the shared one is stepped by `LuaManager`.
+  auto step_gc(this LuaSystem& self) -> void;
+
 private:
   std::filesystem::path file_path = {};
   ox::option<std::string> script_ = {};
   ankerl::unordered_dense::map<int, std::string> errors = {};
 
+  // Before everything that references it, so it is destroyed last. The profiler goes after the state it
+  // allocates for.
+  std::unique_ptr<LuaProfiler> own_profiler = nullptr;
+  std::unique_ptr<sol::state> own_state = nullptr;
+  LuaGC own_gc = {};
+  // Whichever state the script lives in.
+  LuaProfiler* profiler = nullptr;
+  std::string profile_name = {};
+
   std::unique_ptr<sol::environment> environment = nullptr;
 
   std::unique_ptr<sol::protected_function> on_add_func = nullptr;
@@ -89,9 +121,13 @@ private:
   std::unique_ptr<sol::protected_function> on_body_activated_func = nullptr;
   std::unique_ptr<sol::protected_function> on_body_deactivated_func = nullptr;
 
-  void init_script(
-    this LuaSystem& self, const std::filesystem::path& path, const ox::option<std::string> script = nullopt
-  );
+  auto init_script(
+    this LuaSystem& self,
+    const std::filesystem::path& path,
+    const ox::option<std::string> script = nullopt,
+    std::span<const u8> bytecode = {},
+    bool bytecode_parallel = false
+  ) -> ScriptLoadResult;
   static void check_result(const sol::protected_function_result& result, const char* func_name);
 };
 } // namespace ox
@@ -1,10 +1,15 @@
 #pragma once
 
 #include "Networking/NetClient.hpp"
+#include "Networking/NetServer.hpp"
 
 namespace ox {
 class NetStatsViewer {
 public:
   static auto draw_network_stats(const NetClient& client) -> void;
+  static auto draw_server_network_stats(const NetServer& server) -> void;
+
+private:
+  static auto draw_io_stats(const NetIOStats& io_stats) -> void;
 };
 } // namespace ox
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <ankerl/unordered_dense.h>
+#include <string>
+#include <vector>
+
+#include "Scripting/LuaProfiler.hpp"
+#include "Utils/FrameProfiler.hpp"
+
+namespace ox {
+class ProfilerViewer {
+public:
+  ProfilerViewer() = default;
+
+  // Where the export buttons write to, the extension is added.
+  std::string export_stem = "logs/profile";
+
+  auto render(this ProfilerViewer& self, const char* id, bool* visible) -> void;
+
+private:
+  std::vector<f32> frame_ms = {};
+  std::vector<f64> history_ms = {};
+  std::vector<std::vector<u32>> children = {};
+  // Keyed by thread and node.
+  ankerl::unordered_dense::map<u64, f64> scope_sums = {};
+  // Average over the history, indexed like the last frame's scopes.
+  std::vector<f64> mean_scope_ms = {};
+  std::string export_status = {};
+
+  auto draw_scope(this ProfilerViewer& self, const ProfileFrame& frame, u32 index) -> void;
+  auto draw_scopes(this ProfilerViewer& self, const ProfileFrame& frame) -> void;
+  auto draw_metrics(this ProfilerViewer& self, const ProfileFrame& frame) -> void;
+  auto draw_lua(this ProfilerViewer& self) -> void;
+};
+} // namespace ox
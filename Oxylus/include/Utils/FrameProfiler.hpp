@@ -0,0 +1,163 @@
+#pragma once
+
+#include <array>
+#include <expected>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Core/Base.hpp"
+#include "Core/Types.hpp"
+
+namespace ox {
+enum class MetricID : u32 { Invalid = ~0_u32 };
+
+enum class MetricKind : u8 {
+  Counter = 0, // summed over a frame, reset every frame
+  Gauge,       // last value set
+};
+
+struct MetricInfo {
+  std::string name = {};
+  MetricKind kind = MetricKind::Counter;
+};
+
+// A scope's time within one frame. Scopes of a thread form a tree, `parent` is an index into the same
+// frame's scope list, roots are the threads themselves.
+struct ProfileScopeStats {
+  constexpr static u32 NO_PARENT = ~0_u32;
+
+  const char* name = nullptr;
+  u32 parent = NO_PARENT;
+  u32 depth = 0;
+  // Stays the same for the same scope across frames, per thread.
+  u32 thread = 0;
+  u32 node = 0;
+  u32 calls = 0;
+  f64 total_ms = 0.0;
+};
+
+struct ProfileFrame {
+  u64 index = 0;
+  // Time between `begin_frame` and `end_frame`.
+  f64 cpu_ms = 0.0;
+  // Timestep delta, includes waiting for the frame limit.
+  f64 delta_ms = 0.0;
+  std::vector<ProfileScopeStats> scopes = {};
+  // Indexed by MetricID, counters hold the frame's sum and gauges their value at the end of it.
+  std::vector<f64> metrics = {};
+};
+
+struct FrameTimeSummary {
+  usize frames = 0;
+  f64 mean_ms = 0.0;
+  f64 p50_ms = 0.0;
+  f64 p90_ms = 0.0;
+  f64 p95_ms = 0.0;
+  f64 p99_ms = 0.0;
+  f64 max_ms = 0.0;
+};
+
+// Nearest rank percentiles.
+auto summarize_frame_times(std::vector<f64> frame_ms) -> FrameTimeSummary;
+
+// Frame times binned into fixed buckets, so a long run's percentiles don't need every frame kept and
+// sorted. Mean and max are exact, percentiles are off by less than a bucket.
+struct FrameTimeHistogram {
+  constexpr static f64 BUCKET_MS = 0.01;
+  // Up to 200ms, slower frames all land in the last bucket.
+  constexpr static usize BUCKET_COUNT = 20'000;
+
+  std::vector<u32> buckets = {};
+  usize frames = 0;
+  f64 total_ms = 0.0;
+  f64 max_ms = 0.0;
+
+  auto add(this FrameTimeHistogram&, f64 frame_ms) -> void;
+  auto clear(this FrameTimeHistogram&) -> void;
+  auto summary(this const FrameTimeHistogram&) -> FrameTimeSummary;
+};
+
+// In-engine CPU profiler, works with or without Tracy. Scopes are timed per thread and folded into a tree
+// per frame, counters and gauges are global. The last `HISTORY_SIZE` frames are kept in full, frame times
+// of the whole run go in a histogram for percentiles.
+//
+// Scopes and metrics can be touched from any thread, frames begin and end on the main thread and only it
+// reads the history.
+class FrameProfiler {
+public:
+  constexpr static usize HISTORY_SIZE = 512;
+  constexpr static usize MAX_METRICS = 256;
+
+  static void set_enabled(bool enabled);
+  static bool is_enabled();
+
+  // Scope names have to outlive the profiler, string literals in practice.
+  static void begin_scope(const char* name);
+  static void end_scope();
+
+  // Same name returns the same id.
+  static auto register_metric(std::string_view name, MetricKind kind) -> MetricID;
+  static void add(MetricID id, f64 value);
+  static void set(MetricID id, f64 value);
+  static auto metrics() -> std::vector<MetricInfo>;
+
+  static void begin_frame();
+  static void end_frame(f64 delta_ms);
+  // Oldest first.
+  static auto history() -> std::vector<const ProfileFrame*>;
+  static auto last_frame() -> const ProfileFrame*;
+  static auto thread_name(u32 thread) -> std::string;
+  // Whole run, cheap enough to call every frame.
+  static auto summary() -> FrameTimeSummary;
+  static void reset();
+
+  // Summary, metric totals, average scope times and the history as JSON.
+  static auto export_json(const std::filesystem::path& path) -> std::expected<void, std::string>;
+  // One row per frame in the history.
+  static auto export_csv(const std::filesystem::path& path) -> std::expected<void, std::string>;
+  // Picks the format from the extension.
+  static auto export_to(const std::filesystem::path& path) -> std::expected<void, std::string>;
+};
+
+struct ProfileScope {
+  explicit ProfileScope(const char* name) {
+    if (FrameProfiler::is_enabled()) {
+      FrameProfiler::begin_scope(name);
+      active = true;
+    }
+  }
+
+  ~ProfileScope() {
+    if (active) {
+      FrameProfiler::end_scope();
+    }
+  }
+
+  ProfileScope(const ProfileScope&) = delete;
+  ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+  bool active = false;
+};
+} // namespace ox
+
+// Tracy zone and frame profiler scope in one, meant for the coarse parts of a frame. Every scope takes
+// two clock reads and an uncontended lock, tiny functions are better off without.
+#define OX_PROFILE_SCOPE(name) \
+  ZoneScopedN(name);           \
+  ::ox::ProfileScope OX_UNIQUE_VAR()(name)
+
+#define OX_COUNTER_ADD(name, value)                                                                         \
+  do {                                                                                                      \
+    static const auto ox_metric_id_ = ::ox::FrameProfiler::register_metric(name, ::ox::MetricKind::Counter); \
+    ::ox::FrameProfiler::add(ox_metric_id_, static_cast<f64>(value));                                       \
+  } while (false)
+
+#define OX_GAUGE_SET(name, value)                                                                         \
+  do {                                                                                                    \
+    static const auto ox_metric_id_ = ::ox::FrameProfiler::register_metric(name, ::ox::MetricKind::Gauge); \
+    ::ox::FrameProfiler::set(ox_metric_id_, static_cast<f64>(value));                                     \
+  } while (false)
@@ -1,14 +1,147 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <cstring>
 #include <fmt/std.h>
 #include <loguru.hpp>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+#include "Core/Option.hpp"
+#include "Core/Types.hpp"
 
 namespace ox {
+// Debug is the chattiest one and only compiled into debug builds by default.
+enum class LogLevel : u8 {
+  Debug = 0,
+  Trace,
+  Info,
+  Warn,
+  Error,
+};
+
+// Every log call site gets one of these as a function local static.
+struct LogSite {
+  const char* file = nullptr;
+  u32 line = 0;
+  LogLevel level = LogLevel::Info;
+
+  // Rate limiting, messages past the limit within one window are only counted.
+  std::atomic<u64> window_start_ns = 0;
+  std::atomic<u32> window_count = 0;
+  std::atomic<u32> suppressed = 0;
+};
+
+struct LogRecord;
+using LogFormatFn = void (*)(const LogRecord& record, fmt::memory_buffer& out);
+
+// One message in a thread's ring. Arguments are copied into `payload` as they are and only formatted
+// by the log thread.
+struct LogRecord {
+  constexpr static usize PAYLOAD_SIZE = 176;
+
+  const LogSite* site = nullptr;
+  LogFormatFn format_fn = nullptr;
+  fmt::string_view format = {};
+  u64 time_ns = 0;
+  u32 suppressed = 0;
+  // Already formatted message when `format_fn` is null, for arguments that didn't fit in the payload
+  // or can't be copied without pointing back into the caller's memory.
+  std::string text = {};
+  std::array<u8, PAYLOAD_SIZE> payload = {};
+};
+
+namespace detail {
+template <typename T>
+using log_arg_t = std::remove_cv_t<std::decay_t<T>>;
+
+template <typename T>
+concept log_value_arg = std::is_arithmetic_v<T> || std::is_enum_v<T> || std::is_same_v<T, const void*> ||
+                        std::is_same_v<T, void*>;
+
+template <typename T>
+concept log_string_arg = std::is_same_v<T, const char*> || std::is_same_v<T, char*> ||
+                         std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>;
+
+// Anything else (views, paths, user types) could reference memory that is gone by the time the log thread
+// gets to it, so those messages are formatted right away.
+template <typename T>
+concept log_capturable_arg = log_value_arg<T> || log_string_arg<T>;
+
+inline auto log_string(std::string_view str) -> std::string_view { return str; }
+inline auto log_string(const char* str) -> std::string_view { return str ? std::string_view(str) : "(null)"; }
+
+template <typename T>
+auto log_arg_size(const T& value) -> usize {
+  if constexpr (log_value_arg<log_arg_t<T>>) {
+    return sizeof(log_arg_t<T>);
+  } else {
+    return sizeof(u32) + log_string(value).size();
+  }
+}
+
+template <typename T>
+auto write_log_arg(u8* payload, usize& offset, const T& value) -> void {
+  if constexpr (log_value_arg<log_arg_t<T>>) {
+    const log_arg_t<T> copy = value;
+    std::memcpy(payload + offset, &copy, sizeof(copy));
+    offset += sizeof(copy);
+  } else {
+    const auto str = log_string(value);
+    const auto size = static_cast<u32>(str.size());
+    std::memcpy(payload + offset, &size, sizeof(size));
+    std::memcpy(payload + offset + sizeof(size), str.data(), size);
+    offset += sizeof(size) + size;
+  }
+}
+
+template <typename T>
+auto read_log_arg(const u8* payload, usize& offset) {
+  if constexpr (log_value_arg<T>) {
+    auto value = T{};
+    std::memcpy(&value, payload + offset, sizeof(value));
+    offset += sizeof(value);
+    return value;
+  } else {
+    auto size = 0_u32;
+    std::memcpy(&size, payload + offset, sizeof(size));
+    const auto str = std::string_view(reinterpret_cast<const char*>(payload + offset + sizeof(size)), size);
+    offset += sizeof(size) + size;
+    return str;
+  }
+}
+
+template <typename... Args>
+auto format_log_record(const LogRecord& record, fmt::memory_buffer& out) -> void {
+  [[maybe_unused]] auto offset = 0_sz;
+  // Braced init, arguments are read in order.
+  const auto args = std::tuple{read_log_arg<Args>(record.payload.data(), offset)...};
+  std::apply(
+    [&](const auto&... values) { fmt::vformat_to(fmt::appender(out), record.format, fmt::make_format_args(values...)); },
+    args
+  );
+}
+} // namespace detail
+
 class Log {
 public:
   static void init(int argc, char** argv);
   static void shutdown();
 
+  // The log thread, messages are written synchronously while it isn't running.
+  static void start_backend();
+  static void stop_backend();
+  static bool is_async();
+  // Blocks until everything logged before the call is written.
+  static void flush();
+
+  // At most `max_messages` per call site every `window_ms`, the rest is counted and reported with the next
+  // message that goes through. Zero turns it off.
+  static void set_rate_limit(u32 max_messages, u32 window_ms);
+
   static void add_callback(
     const char* id,
     loguru::log_handler_t callback,
@@ -21,20 +154,100 @@ public:
   static void remove_callback(const char* id);
 
   static void set_verbose();
+
+  template <typename... Args>
+  static void write(LogSite& site, fmt::format_string<Args...> format, Args&&... args) {
+    const auto stamp = admit(site);
+    if (!stamp.has_value()) {
+      return;
+    }
+
+    auto* record = begin_record();
+    if (!record) {
+      write_now(site, stamp->suppressed, fmt::vformat(format, fmt::make_format_args(args...)));
+      return;
+    }
+
+    record->site = &site;
+    record->format = fmt::string_view(format);
+    record->time_ns = stamp->time_ns;
+    record->suppressed = stamp->suppressed;
+
+    if constexpr ((detail::log_capturable_arg<detail::log_arg_t<Args>> && ...)) {
+      const auto size = (0_sz + ... + detail::log_arg_size(args));
+      if (size <= LogRecord::PAYLOAD_SIZE) {
+        auto offset = 0_sz;
+        (detail::write_log_arg(record->payload.data(), offset, args), ...);
+        record->format_fn = &detail::format_log_record<detail::log_arg_t<Args>...>;
+        record->text.clear();
+        end_record();
+        return;
+      }
+    }
+
+    record->format_fn = nullptr;
+    record->text = fmt::vformat(format, fmt::make_format_args(args...));
+    end_record();
+  }
+
+private:
+  struct Stamp {
+    u64 time_ns = 0;
+    u32 suppressed = 0;
+  };
+
+  // Verbosity cutoff and rate limit, nullopt when the message is dropped.
+  static auto admit(LogSite& site) -> option<Stamp>;
+  // Slot in the calling thread's ring, waits for the log thread when it's full. Null when there is no
+  // log thread.
+  static auto begin_record() -> LogRecord*;
+  static void end_record();
+  static void write_now(const LogSite& site, u32 suppressed, std::string_view message);
 };
 } // namespace ox
 
 // log macros
-#ifdef OX_DEBUG
-  #define OX_LOG_DEBUG(...) DLOG_F(MAX, __VA_ARGS__)
+#ifndef OX_LOG_MIN_LEVEL
+  #ifdef OX_DEBUG
+    #define OX_LOG_MIN_LEVEL 0
+  #else
+    #define OX_LOG_MIN_LEVEL 1
+  #endif
+#endif
+
+#define OX_LOG_AT(log_level, ...)                                                                 \
+  do {                                                                                            \
+    static ::ox::LogSite ox_log_site_ = {.file = __FILE__, .line = __LINE__, .level = log_level}; \
+    ::ox::Log::write(ox_log_site_, __VA_ARGS__);                                                  \
+  } while (false)
+
+#if OX_LOG_MIN_LEVEL <= 0
+  #define OX_LOG_DEBUG(...) OX_LOG_AT(::ox::LogLevel::Debug, __VA_ARGS__)
+#else
+  #define OX_LOG_DEBUG(...) ((void)0)
+#endif
+#if OX_LOG_MIN_LEVEL <= 1
+  #define OX_LOG_TRACE(...) OX_LOG_AT(::ox::LogLevel::Trace, __VA_ARGS__)
+#else
+  #define OX_LOG_TRACE(...) ((void)0)
+#endif
+#if OX_LOG_MIN_LEVEL <= 2
+  #define OX_LOG_INFO(...) OX_LOG_AT(::ox::LogLevel::Info, __VA_ARGS__)
+#else
+  #define OX_LOG_INFO(...) ((void)0)
+#endif
+#if OX_LOG_MIN_LEVEL <= 3
+  #define OX_LOG_WARN(...) OX_LOG_AT(::ox::LogLevel::Warn, __VA_ARGS__)
 #else
-  #define OX_LOG_DEBUG(...)
+  #define OX_LOG_WARN(...) ((void)0)
 #endif
-#define OX_LOG_TRACE(...) LOG_F(MAX, __VA_ARGS__)
-#define OX_LOG_INFO(...) LOG_F(INFO, __VA_ARGS__)
-#define OX_LOG_WARN(...) LOG_F(WARNING, __VA_ARGS__)
-#define OX_LOG_ERROR(...) LOG_F(ERROR, __VA_ARGS__)
-#define OX_LOG_FATAL(...) LOG_F(FATAL, __VA_ARGS__)
+#define OX_LOG_ERROR(...) OX_LOG_AT(::ox::LogLevel::Error, __VA_ARGS__)
+// Fatal goes out synchronously, after everything logged before it.
+#define OX_LOG_FATAL(...)      \
+  do {                         \
+    ::ox::Log::flush();        \
+    LOG_F(FATAL, __VA_ARGS__); \
+  } while (false)
 
 #define OX_ASSERT(test, ...) CHECK_F(test, ##__VA_ARGS__)
 #define OX_CHECK_NULL(test, ...) CHECK_NOTNULL_F(test, ##__VA_ARGS__)
@@ -45,7 +258,7 @@ public:
 #define OX_CHECK_LE(a, b, ...) CHECK_LE_F(a, b, ##__VA_ARGS__)
 #define OX_CHECK_GE(a, b, ...) CHECK_GE_F(a, b, ##__VA_ARGS__)
 
-#define OX_UNIMPLEMENTED(func, ...) LOG_F(ERROR, "Unimplemented: {} " __VA_ARGS__, #func)
+#define OX_UNIMPLEMENTED(func, ...) OX_LOG_ERROR("Unimplemented: {} " __VA_ARGS__, #func)
 
 #ifndef OX_DEBUG
   #define OX_DISABLE_DEBUG_BREAKS
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <span>
+
+#include "Core/Types.hpp"
+
+namespace ox {
+class JobManager;
+
+// Inputs at least this long are sorted on the job manager's workers when one is given.
+constexpr auto RADIX_SORT_PARALLEL_MIN = 1_sz << 16;
+
+// Stable LSD radix sort of u32 keys carrying a u32 value each, ascending, one byte of the key per pass. Passes in
+// which every key has the same digit are skipped. The scratch spans are as long as `keys`, the result ends up in
+// `keys` and `values`.
+//
+// In parallel the input is split into one chunk per thread, every pass histograms and then scatters each chunk on
+// its own thread. Chunks keep their order, so the sort stays stable.
+auto radix_sort_pairs(
+  std::span<u32> keys,
+  std::span<u32> values,
+  std::span<u32> scratch_keys,
+  std::span<u32> scratch_values,
+  JobManager* job_manager = nullptr
+) -> void;
+} // namespace ox
@@ -26,6 +26,18 @@ public:
   auto set_max_frame_time(this Timestep& self, f64 value) -> void { self.max_frame_time = value; }
   auto reset_max_frame_time(this Timestep& self) -> void { self.max_frame_time = -1.0; }
 
+  // Every update then reports exactly `value` milliseconds and waits on an absolute deadline by sleeping
+  // only, a tick that ran late is made up by the ones after it instead of stretching the step.
+  auto get_fixed_step(this const Timestep& self) -> f64 { return self.fixed_step; }
+  auto set_fixed_step(this Timestep& self, f64 value) -> void;
+  auto reset_fixed_step(this Timestep& self) -> void { self.set_fixed_step(-1.0); }
+
+  // Every update reports exactly `value` milliseconds and returns right away, wall time doesn't matter.
+  // For replays and benchmarks that have to run the same frames, as fast as they can. Wins over the rest.
+  auto get_simulated_step(this const Timestep& self) -> f64 { return self.simulated_step; }
+  auto set_simulated_step(this Timestep& self, f64 value) -> void { self.simulated_step = value; }
+  auto reset_simulated_step(this Timestep& self) -> void { self.simulated_step = -1.0; }
+
   explicit operator float() const { return (float)timestep; }
 
 private:
@@ -33,7 +45,12 @@ private:
   f64 last_time = 0;
   f64 elapsed = 0;
   f64 max_frame_time = -1.0;
+  f64 fixed_step = -1.0;
+  f64 simulated_step = -1.0;
+  f64 next_deadline = 0;
 
   Timer* timer = nullptr;
+
+  auto update_fixed(this Timestep& self) -> void;
 };
 } // namespace ox
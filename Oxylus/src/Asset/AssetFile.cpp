@@ -25,6 +25,14 @@ auto AssetFile::unpack(const std::filesystem::path& path) -> option<AssetFile> {
     return nullopt;
   }
 
+  // Entries carry no layout info of their own, an older pack would deserialize into garbage.
+  if (header.version != AssetFileHeader::VERSION) {
+    OX_LOG_ERROR(
+      "Asset file {} is version {}, expected {}. Rebuild it with rcli.", path, header.version, AssetFileHeader::VERSION
+    );
+    return nullopt;
+  }
+
   if (zpp::bits::failure(deser(entries))) {
     OX_LOG_ERROR("Failed to deserialize Asset entries.");
     return nullopt;
@@ -71,4 +79,26 @@ auto AssetFile::add_entry(this AssetFile& self, ShaderPipelineData&& entry) -> v
   );
 }
 
+auto AssetFile::add_entry(this AssetFile& self, PhysicsShapeData&& entry) -> void {
+  ZoneScoped;
+
+  self.entries.push_back(
+    AssetFileEntry{
+      .type = AssetType::PhysicsShape,
+      .data = std::move(entry),
+    }
+  );
+}
+
+auto AssetFile::add_entry(this AssetFile& self, ScriptBytecodeData&& entry) -> void {
+  ZoneScoped;
+
+  self.entries.push_back(
+    AssetFileEntry{
+      .type = AssetType::Script,
+      .data = std::move(entry),
+    }
+  );
+}
+
 } // namespace ox
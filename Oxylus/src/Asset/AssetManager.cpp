@@ -5,10 +5,14 @@
 #include <vuk/vsl/Core.hpp>
 #include <zpp_bits.h>
 
+#include "Audio/AudioEngine.hpp"
+#include "Core/App.hpp"
 #include "Memory/Hasher.hpp"
 #include "Memory/Stack.hpp"
 #include "OS/File.hpp"
+#include "Scripting/LuaBytecode.hpp"
 #include "Scripting/LuaSystem.hpp"
+#include "Utils/FrameProfiler.hpp"
 #include "Utils/Log.hpp"
 
 namespace ox {
@@ -195,16 +199,17 @@ auto AssetManager::to_asset_type_sv(AssetType type) -> std::string_view {
   ZoneScoped;
 
   switch (type) {
-    case AssetType::None    : return "None";
-    case AssetType::Shader  : return "Shader";
-    case AssetType::Model   : return "Model";
-    case AssetType::Texture : return "Texture";
-    case AssetType::Material: return "Material";
-    case AssetType::Font    : return "Font";
-    case AssetType::Scene   : return "Scene";
-    case AssetType::Audio   : return "Audio";
-    case AssetType::Script  : return "Script";
-    default                 : return {};
+    case AssetType::None        : return "None";
+    case AssetType::Shader      : return "Shader";
+    case AssetType::Model       : return "Model";
+    case AssetType::Texture     : return "Texture";
+    case AssetType::Material    : return "Material";
+    case AssetType::Font        : return "Font";
+    case AssetType::Scene       : return "Scene";
+    case AssetType::Audio       : return "Audio";
+    case AssetType::Script      : return "Script";
+    case AssetType::PhysicsShape: return "PhysicsShape";
+    default                     : return {};
   }
 }
 
@@ -405,6 +410,7 @@ auto AssetManager::acquire_ref(this AssetManager& self, ReadGuard<Asset> asset)
     case AssetType::Scene:
     case AssetType::Audio:
     case AssetType::Texture:
+    case AssetType::PhysicsShape:
     case AssetType::Script : break;
     case AssetType::Model  : {
       auto model = self.get_model(asset->model_id);
@@ -452,6 +458,7 @@ auto AssetManager::release_ref(this AssetManager& self, ReadGuard<Asset> asset)
     case AssetType::Scene:
     case AssetType::Audio:
     case AssetType::Texture:
+    case AssetType::PhysicsShape:
     case AssetType::Script : break;
     case AssetType::Model  : {
       auto model = self.get_model(asset->model_id);
@@ -577,6 +584,13 @@ auto AssetManager::load_asset(this AssetManager& self, const UUID& uuid, LoadInf
 
   asset.reset();
 
+  // Headless apps have nowhere to upload pixels to and nothing to play sounds on, these stay unloaded
+  // without it counting as a failure.
+  if ((asset_type == AssetType::Texture && !App::has_rendercontext()) ||
+      (asset_type == AssetType::Audio && !App::has_mod<AudioEngine>())) {
+    return true;
+  }
+
   auto asset_id = [&]() -> u64 {
     switch (asset_type) {
       case AssetType::Model  : return static_cast<u64>(self.load_model(asset_path));
@@ -612,6 +626,7 @@ auto AssetManager::load_asset(this AssetManager& self, const UUID& uuid, LoadInf
   }
 
   asset->model_id = static_cast<ModelID>(asset_id);
+  OX_COUNTER_ADD("assets.loaded", 1);
   if (should_acquire) {
     self.acquire_ref(std::move(asset));
   }
@@ -765,8 +780,14 @@ auto AssetManager::unload_audio(this AssetManager& self, ReadGuard<Asset> asset)
 auto AssetManager::load_script(this AssetManager& self, const std::filesystem::path& path) -> ScriptID {
   ZoneScoped;
 
+  // Prefer the chunk rcli compiled, scripts only get parsed here when there is none, it is stale or it
+  // doesn't load. A chunk that ran and errored isn't retried, its top level already ran once.
   auto lua_system = std::make_unique<LuaSystem>();
-  lua_system->load(path);
+  auto compiled = load_script_bytecode(path);
+  if (!compiled.has_value()
+      || lua_system->load_bytecode(path, compiled->bytecode, compiled->parallel) == ScriptLoadResult::LoadFailed) {
+    lua_system->load(path);
+  }
 
   auto write_lock = std::unique_lock(self.scripts_mutex);
   return self.script_map.create_slot(std::move(lua_system));
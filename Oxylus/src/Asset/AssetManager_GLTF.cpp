@@ -562,7 +562,9 @@ auto AssetManager::load_model(this AssetManager& self, const std::filesystem::pa
     processing_gltf_nodes.push({node_index, 0});
   }
 
-  auto& render_context = App::get()->get_rendercontext();
+  // Headless apps only keep the hierarchy, materials and lights. Meshes still get an (empty) slot each so
+  // mesh indices mean the same thing everywhere.
+  const auto uploads_to_gpu = App::has_rendercontext();
 
   auto compute_lod_upload_size = //
     [](
@@ -634,6 +636,21 @@ auto AssetManager::load_model(this AssetManager& self, const std::filesystem::pa
         continue;
       }
 
+      auto mesh_material_index = option<u32>(nullopt);
+      if (gltf_primitive.materialIndex.has_value()) {
+        mesh_material_index = static_cast<u32>(gltf_primitive.materialIndex.value());
+      }
+
+      if (!uploads_to_gpu) {
+        mesh_group.mesh_indices.push_back(model.gpu_meshes.size());
+        model.lod0_meshlet_counts.push_back(0);
+        model.material_indices.push_back(mesh_material_index);
+        model.gpu_meshes.emplace_back();
+        model.gpu_mesh_buffers.emplace_back();
+        continue;
+      }
+
+      auto& render_context = App::get_rendercontext();
       auto gpu_mesh = GPU::Mesh{};
       auto gpu_mesh_lods = std::array<GPU::MeshLOD, GPU::Mesh::MAX_LODS>{};
 
@@ -1007,10 +1024,6 @@ auto AssetManager::load_model(this AssetManager& self, const std::filesystem::pa
       auto mesh_index = model.gpu_meshes.size();
       mesh_group.mesh_indices.push_back(mesh_index);
       model.lod0_meshlet_counts.push_back(gpu_mesh_lods[0].meshlet_count);
-      auto mesh_material_index = option<u32>(nullopt);
-      if (gltf_primitive.materialIndex.has_value()) {
-        mesh_material_index = static_cast<u32>(gltf_primitive.materialIndex.value());
-      }
       model.material_indices.push_back(mesh_material_index);
       model.gpu_meshes.push_back(gpu_mesh);
       model.gpu_mesh_buffers.push_back(std::move(gpu_mesh_buffer));
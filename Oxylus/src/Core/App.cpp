@@ -6,13 +6,35 @@
 #include "Core/Input.hpp"
 #include "Core/JobManager.hpp"
 #include "Core/VFS.hpp"
+#include "Networking/NetworkManager.hpp"
+#include "Render/DebugRenderer.hpp"
 #include "Render/RenderContext.hpp"
 #include "Render/Renderer.hpp"
 #include "Render/Window.hpp"
+#include "Scripting/LuaManager.hpp"
 #include "UI/ImGuiRenderer.hpp"
+#include "UI/RmlUI.hpp"
+#include "Utils/FrameProfiler.hpp"
 #include "Utils/Profiler.hpp"
 
 namespace ox {
+namespace {
+// Value of `--flag <path>`.
+auto path_arg(const AppCommandLineArgs& args, std::string_view flag) -> option<std::string> {
+  const auto index = args.get_index(flag);
+  if (!index.has_value()) {
+    return nullopt;
+  }
+
+  if (auto arg = args.get(index.value() + 1)) {
+    return arg->arg_str;
+  }
+
+  OX_LOG_ERROR("{} needs a path.", flag);
+  return nullopt;
+}
+} // namespace
+
 App* App::instance_ = nullptr;
 
 App::App(int argc, char** argv) {
@@ -43,6 +65,10 @@ auto App::init(this App& self) -> void {
     OX_LOG_TRACE("Enabled verbose logging.");
   }
 
+  if (auto path = path_arg(self.command_line_args, "--profile-output")) {
+    self.profile_output_path = path.value();
+  }
+
   if (self.working_directory.empty())
     self.working_directory = std::filesystem::current_path();
   else
@@ -50,11 +76,17 @@ auto App::init(this App& self) -> void {
 
   self.vfs.mount_dir(VFS::APP_DIR, std::filesystem::absolute(self.assets_path));
 
-  if (self.window_info.has_value()) {
+  if (self.headless) {
+    OX_ASSERT(!self.registry.has<Renderer>() && !self.registry.has<ImGuiRenderer>() && !self.registry.has<RmlUI>() &&
+                !self.registry.has<DebugRenderer>(),
+              "Headless apps can't run modules that render.");
+    self.timestep.set_fixed_step(1000.0 / self.tick_rate);
+    OX_LOG_INFO("Running headless at {} ticks per second.", self.tick_rate);
+  } else if (self.window_info.has_value()) {
     self.window = Window::create(*self.window_info);
   }
 
-  if (self.registry.has<Renderer>()) {
+  if (!self.headless && self.registry.has<Renderer>()) {
     self.render_context = std::make_unique<RenderContext>();
 
     const bool enable_validation = self.command_line_args.contains("--vulkan-validation");
@@ -75,31 +107,95 @@ auto App::init(this App& self) -> void {
 
   self.registry.init();
 
+  self.init_input_replay();
+
   self.job_manager.wait();
 }
 
 auto App::step(this App& self) -> void {
-  const i32 frame_limit = self.frame_limit > 0 ? self.frame_limit : self.render_context->context_cvar.cvar_frame_limit.get();
-  if (frame_limit > 0) {
-    self.timestep.set_max_frame_time(1000.0 / static_cast<f64>(frame_limit));
-  } else {
-    self.timestep.reset_max_frame_time();
+  // Headless apps pace themselves with the fixed step set up in init.
+  if (!self.headless) {
+    auto frame_limit = self.frame_limit;
+    if (frame_limit <= 0 && self.render_context != nullptr) {
+      frame_limit = self.render_context->context_cvar.cvar_frame_limit.get();
+    }
+
+    if (frame_limit > 0) {
+      self.timestep.set_max_frame_time(1000.0 / static_cast<f64>(frame_limit));
+    } else {
+      self.timestep.reset_max_frame_time();
+    }
+  }
+
+  if (self.input_replay.has_value()) {
+    if (self.input_replay->done()) {
+      OX_LOG_INFO("Input replay finished after {} frames.", self.input_replay->recording.frames.size());
+      self.should_stop();
+      return;
+    }
+
+    self.timestep.set_simulated_step(self.input_replay->next_delta_ms());
   }
 
   self.timestep.on_update();
 
-  self.run_deferred_tasks();
+  // After the frame limit wait, that isn't work.
+  FrameProfiler::begin_frame();
+
+  {
+    OX_PROFILE_SCOPE("Deferred tasks");
+    self.run_deferred_tasks();
+  }
 
-  if (self.window.has_value())
+  if (self.window.has_value()) {
+    OX_PROFILE_SCOPE("Window");
     self.window->update(self.timestep);
+  }
+
+  if (self.registry.has<Input>()) {
+    auto& input = self.mod<Input>();
+    if (self.input_replay.has_value()) {
+      input.replay_frame(self.input_replay->advance());
+    } else if (input.is_recording()) {
+      input.end_recorded_frame(self.timestep.get_millis());
+    }
+  }
 
   if (!self.is_running)
     return;
 
-  self.registry.update(self.timestep);
+  // Network events and RPCs land here, before anything gets a chance to look at the world.
+  if (self.registry.has<NetworkManager>()) {
+    OX_PROFILE_SCOPE("Network dispatch");
+    self.mod<NetworkManager>().dispatch();
+  }
+
+  {
+    // Everything queued with EventSystem::enqueue since last frame.
+    OX_PROFILE_SCOPE("Queued events");
+    self.event_system.dispatch_queued();
+  }
+
+  {
+    OX_PROFILE_SCOPE("Modules");
+    self.registry.update(self.timestep);
+  }
+
+  // Script garbage is collected here in budgeted steps, never in whichever allocation happens to trip it.
+  if (self.registry.has<LuaManager>()) {
+    {
+      OX_PROFILE_SCOPE("Lua GC");
+      self.mod<LuaManager>().step_gc();
+    }
+
+    // Every script call of the frame has ended by now, parallel ones included.
+    LuaProfiler::end_frame();
+  }
 
   if (self.registry.has<Input>())
     self.mod<Input>().reset_pressed();
+
+  FrameProfiler::end_frame(self.timestep.get_millis());
 }
 
 void App::run(this App& self) {
@@ -123,6 +219,30 @@ void App::stop(this App& self) {
   // Single point where the close is announced, so it fires no matter how the loop was left.
   std::ignore = self.event_system.emit<AppCloseEvent>(AppCloseEvent{});
 
+  if (self.registry.has<Input>() && self.mod<Input>().is_recording()) {
+    const auto recording = self.mod<Input>().stop_recording();
+    if (auto result = recording.save(self.input_recording_path); result.has_value()) {
+      OX_LOG_INFO("Recorded {} frames of input to {}.", recording.frames.size(), self.input_recording_path);
+    } else {
+      OX_LOG_ERROR("{}", result.error());
+    }
+  }
+
+  if (!self.profile_output_path.empty()) {
+    if (auto result = FrameProfiler::export_to(self.profile_output_path); result.has_value()) {
+      const auto summary = FrameProfiler::summary();
+      OX_LOG_INFO(
+        "Wrote profile of {} frames to {}, p50 {:.2f}ms p99 {:.2f}ms.",
+        summary.frames,
+        self.profile_output_path,
+        summary.p50_ms,
+        summary.p99_ms
+      );
+    } else {
+      OX_LOG_ERROR("{}", result.error());
+    }
+  }
+
   // Anything queued for "next frame" never got one. Run it while every module is still alive,
   // since those callbacks are how deferred destruction is expressed.
   self.run_deferred_tasks();
@@ -157,6 +277,9 @@ void App::stop(this App& self) {
   if (self.window.has_value()) {
     self.window->destroy();
   }
+
+  // Whatever is logged past this point is written right away.
+  Log::stop_backend();
 }
 
 auto App::should_stop(this App& self) -> void {
@@ -173,6 +296,29 @@ auto App::with_window(this App& self, WindowInfo window_info) -> App& {
   return self;
 }
 
+auto App::with_headless(this App& self, f64 tick_rate) -> App& {
+  OX_ASSERT(tick_rate > 0.0);
+  self.headless = true;
+  self.tick_rate = tick_rate;
+  self.window_info = nullopt;
+  return self;
+}
+
+auto App::with_input_recording(this App& self, const std::filesystem::path& path) -> App& {
+  self.input_recording_path = path;
+  return self;
+}
+
+auto App::with_input_replay(this App& self, const std::filesystem::path& path) -> App& {
+  self.input_replay_path = path;
+  return self;
+}
+
+auto App::with_profile_output(this App& self, const std::filesystem::path& path) -> App& {
+  self.profile_output_path = path;
+  return self;
+}
+
 auto App::with_working_directory(this App& self, const std::filesystem::path& dir) -> App& {
   self.working_directory = dir;
   return self;
@@ -203,6 +349,43 @@ auto App::run_deferred_tasks(this App& self) -> void {
   self.processing_tasks.clear();
 }
 
+auto App::init_input_replay(this App& self) -> void {
+  ZoneScoped;
+
+  if (auto path = path_arg(self.command_line_args, "--record-input")) {
+    self.input_recording_path = path.value();
+  }
+  if (auto path = path_arg(self.command_line_args, "--replay-input")) {
+    self.input_replay_path = path.value();
+  }
+
+  if (self.input_recording_path.empty() && self.input_replay_path.empty()) {
+    return;
+  }
+
+  if (!self.registry.has<Input>()) {
+    OX_LOG_ERROR("Recording or replaying input needs the Input module.");
+    return;
+  }
+
+  auto& input = self.mod<Input>();
+  if (!self.input_replay_path.empty()) {
+    auto recording = InputRecording::load(self.input_replay_path);
+    if (!recording.has_value()) {
+      OX_LOG_ERROR("{}", recording.error());
+      return;
+    }
+
+    OX_LOG_INFO("Replaying {} frames of input from {}.", recording->frames.size(), self.input_replay_path);
+    self.input_replay = InputReplay{.recording = std::move(recording.value())};
+    input.set_replaying(true);
+    return;
+  }
+
+  input.start_recording();
+  OX_LOG_INFO("Recording input to {}.", self.input_recording_path);
+}
+
 auto App::get_command_line_args(this const App& self) -> const AppCommandLineArgs& {
   return self.command_line_args; //
 }
@@ -216,6 +399,10 @@ auto App::get_rendercontext() -> RenderContext& {
   return *instance_->render_context; //
 }
 
+auto App::has_rendercontext() -> bool {
+  return instance_->render_context != nullptr; //
+}
+
 auto App::get_timestep() -> const Timestep& {
   return instance_->timestep; //
 }
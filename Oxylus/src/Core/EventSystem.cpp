@@ -23,11 +23,28 @@ auto EventSystem::deinit() -> std::expected<void, std::string> {
   return {};
 }
 
+void EventSystem::dispatch_queued() {
+  ZoneScoped;
+  if (shutdown_.load()) {
+    return;
+  }
+
+  for (auto& slot : registry_slots_) {
+    if (auto* registry = slot.registry.load(std::memory_order_acquire)) {
+      registry->dispatch_queued();
+    }
+  }
+}
+
 void EventSystem::shutdown() {
   ZoneScoped;
   shutdown_.store(true);
 
   std::unique_lock lock(registries_mutex_);
+  for (auto& slot : registry_slots_) {
+    slot.type_id.store(0, std::memory_order_release);
+    slot.registry.store(nullptr, std::memory_order_release);
+  }
   registries_.clear();
 }
 
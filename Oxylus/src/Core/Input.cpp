@@ -8,6 +8,23 @@
 #include "Render/Window.hpp"
 
 namespace ox {
+namespace {
+// Codes outside the bitset (e.g. GamepadButtonCode::None) are never down.
+template <usize N, typename T>
+auto test_bit(const std::bitset<N>& bits, T code) -> bool {
+  const auto index = static_cast<usize>(code);
+  return index < N && bits.test(index);
+}
+
+template <usize N, typename T>
+auto set_bit(std::bitset<N>& bits, T code, bool state) -> void {
+  const auto index = static_cast<usize>(code);
+  if (index < N) {
+    bits.set(index, state);
+  }
+}
+} // namespace
+
 auto Input::init() -> std::expected<void, std::string> { return {}; }
 
 auto Input::deinit() -> std::expected<void, std::string> { return {}; }
@@ -24,21 +41,30 @@ auto Input::update() -> void {
       data.next_repeat_time += gamepad_interval.count();
     }
   }
+
+  update_action_states();
 }
 
 auto Input::reset_pressed() -> void {
   ZoneScoped;
 
-  input_data.keyboard_data.scancode_pressed.clear();
-  input_data.keyboard_data.scancode_released.clear();
-  input_data.mouse_data.mouse_pressed.clear();
-  input_data.mouse_data.mouse_released.clear();
+  input_data.keyboard_data.scancode_pressed.reset();
+  input_data.keyboard_data.scancode_released.reset();
+  input_data.mouse_data.mouse_pressed.reset();
+  input_data.mouse_data.mouse_released.reset();
   input_data.mouse_data.scroll_offset_y = 0;
   input_data.mouse_data.mouse_moved = false;
 
   for (auto& [id, data] : input_data.gamepad_data_map) {
-    data.gamepad_pressed.clear();
-    data.gamepad_released.clear();
+    data.gamepad_pressed.reset();
+    data.gamepad_released.reset();
+  }
+
+  action_states.pressed.clear();
+  action_states.released.clear();
+  for (auto& [id, states] : gamepad_action_states) {
+    states.pressed.clear();
+    states.released.clear();
   }
 }
 
@@ -48,6 +74,8 @@ auto Input::reset() -> void {
   input_data.keyboard_data = {};
   input_data.mouse_data = {};
   input_data.gamepad_data_map.clear();
+  action_states = {};
+  gamepad_action_states.clear();
 }
 
 auto Input::get_bindings(this const Input& self) -> std::unordered_multimap<std::string, ActionBinding> {
@@ -66,11 +94,12 @@ auto Input::get_binding(this const Input& self, std::string_view action_id) -> c
 auto Input::get_active_binding(this const Input& self, std::string_view action_id) -> const ActionBinding* {
   ZoneScoped;
 
-  auto binding = self.get_binding(action_id);
-  if (binding && binding->context == self.active_context) {
-    return binding;
+  const auto action = self.find_action(action_id);
+  if (action == ActionID::Invalid) {
+    return nullptr;
   }
-  return nullptr;
+
+  return self.compiled_actions[static_cast<usize>(action)].binding;
 }
 
 auto Input::bind_action(this Input& self, ActionBinding binding) -> std::expected<void, BindingError> {
@@ -86,13 +115,20 @@ auto Input::bind_action(this Input& self, ActionBinding binding) -> std::expecte
     OX_LOG_WARN("Conflicts found for action: {}", binding.action_id);
   }
 
-  if (auto it = self.action_bindings.find(binding.action_id); it != self.action_bindings.end()) {
-    self.remove_from_reverse_map(it->second);
+  // Binding the same action again replaces it, as long as it's for the same context.
+  auto [first, last] = self.action_bindings.equal_range(binding.action_id);
+  for (auto it = first; it != last; ++it) {
+    if (it->second.context == binding.context) {
+      self.remove_from_reverse_map(it->second);
+      self.action_bindings.erase(it);
+      break;
+    }
   }
 
   self.add_to_reverse_map(binding);
 
   self.action_bindings.emplace(binding.action_id, binding);
+  self.compile_actions();
 
   return {};
 }
@@ -107,6 +143,7 @@ auto Input::unbind_action(this Input& self, std::string action_id) -> std::expec
 
   self.remove_from_reverse_map(it->second);
   self.action_bindings.erase(it);
+  self.compile_actions();
 
   return {};
 }
@@ -125,14 +162,38 @@ auto Input::rebind_action(
   it->second.secondary_inputs = std::move(new_secondary);
 
   self.add_to_reverse_map(it->second);
+  self.compile_actions();
 
   return {};
 }
 
+auto Input::resolve_action(this Input& self, std::string_view action_id) -> ActionID {
+  ZoneScoped;
+
+  if (auto it = self.action_ids.find(action_id); it != self.action_ids.end()) {
+    return it->second;
+  }
+
+  const auto action = static_cast<ActionID>(self.compiled_actions.size());
+  self.compiled_actions.push_back({.name = std::string(action_id)});
+  self.action_ids.emplace(std::string(action_id), action);
+
+  return action;
+}
+
+auto Input::find_action(this const Input& self, std::string_view action_id) -> ActionID {
+  if (auto it = self.action_ids.find(action_id); it != self.action_ids.end()) {
+    return it->second;
+  }
+
+  return ActionID::Invalid;
+}
+
 auto Input::set_context(this Input& self, std::string_view context) -> void {
   ZoneScoped;
 
   self.active_context = context;
+  self.compile_actions();
 }
 
 auto Input::push_context(this Input& self, std::string_view context) -> void {
@@ -140,6 +201,7 @@ auto Input::push_context(this Input& self, std::string_view context) -> void {
 
   self.context_stack.emplace_back(self.active_context);
   self.active_context = context;
+  self.compile_actions();
 }
 
 auto Input::pop_context(this Input& self) -> void {
@@ -148,6 +210,7 @@ auto Input::pop_context(this Input& self) -> void {
   if (!self.context_stack.empty()) {
     self.active_context = self.context_stack.back();
     self.context_stack.pop_back();
+    self.compile_actions();
   }
 }
 
@@ -160,76 +223,61 @@ auto Input::get_active_context(this const Input& self) -> std::string_view {
 auto Input::get_action_pressed(this const Input& self, std::string_view action_id, u32 instance_id) -> bool {
   ZoneScoped;
 
-  auto binding = self.get_active_binding(action_id);
-  if (!binding) {
-    return false;
-  }
-
-  for (const auto& input : binding->primary_inputs) {
-    if (self.check_input_active(input, instance_id, InputState::Pressed)) {
-      return true;
-    }
-  }
-
-  for (const auto& input : binding->secondary_inputs) {
-    if (self.check_input_active(input, instance_id, InputState::Pressed)) {
-      return true;
-    }
-  }
-
-  return false;
+  return self.get_action_pressed(self.find_action(action_id), instance_id);
 }
 
 auto Input::get_action_released(this const Input& self, std::string_view action_id, u32 instance_id) -> bool {
   ZoneScoped;
 
-  auto binding = self.get_active_binding(action_id);
-  if (!binding) {
-    return false;
-  }
-
-  for (const auto& input : binding->primary_inputs) {
-    if (self.check_input_active(input, instance_id, InputState::Released)) {
-      return true;
-    }
-  }
+  return self.get_action_released(self.find_action(action_id), instance_id);
+}
 
-  for (const auto& input : binding->secondary_inputs) {
-    if (self.check_input_active(input, instance_id, InputState::Released)) {
-      return true;
-    }
-  }
+auto Input::get_action_held(this const Input& self, std::string_view action_id, u32 instance_id) -> bool {
+  ZoneScoped;
 
-  return false;
+  return self.get_action_held(self.find_action(action_id), instance_id);
 }
 
-auto Input::get_action_held(this const Input& self, std::string_view action_id, u32 instance_id) -> bool {
+auto Input::get_action_axis(this const Input& self, std::string_view action_id, u32 instance_id) -> glm::vec2 {
   ZoneScoped;
 
-  auto binding = self.get_active_binding(action_id);
-  if (!binding) {
-    return false;
+  return self.get_action_axis(self.find_action(action_id), instance_id);
+}
+
+// No zones in these, scripts call them per entity per frame.
+auto Input::get_action_pressed(this const Input& self, ActionID action, u32 instance_id) -> bool {
+  if (self.action_states.pressed.test(action)) {
+    return true;
   }
 
-  for (const auto& input : binding->primary_inputs) {
-    if (self.check_input_active(input, instance_id, InputState::Held)) {
-      return true;
-    }
+  auto it = self.gamepad_action_states.find(instance_id);
+  return it != self.gamepad_action_states.end() && it->second.pressed.test(action);
+}
+
+auto Input::get_action_released(this const Input& self, ActionID action, u32 instance_id) -> bool {
+  if (self.action_states.released.test(action)) {
+    return true;
   }
 
-  for (const auto& input : binding->secondary_inputs) {
-    if (self.check_input_active(input, instance_id, InputState::Held)) {
-      return true;
-    }
+  auto it = self.gamepad_action_states.find(instance_id);
+  return it != self.gamepad_action_states.end() && it->second.released.test(action);
+}
+
+auto Input::get_action_held(this const Input& self, ActionID action, u32 instance_id) -> bool {
+  if (self.action_states.held.test(action)) {
+    return true;
   }
 
-  return false;
+  auto it = self.gamepad_action_states.find(instance_id);
+  return it != self.gamepad_action_states.end() && it->second.held.test(action);
 }
 
-auto Input::get_action_axis(this const Input& self, std::string_view action_id, u32 instance_id) -> glm::vec2 {
-  ZoneScoped;
+auto Input::get_action_axis(this const Input& self, ActionID action, u32 instance_id) -> glm::vec2 {
+  if (static_cast<usize>(action) >= self.compiled_actions.size()) {
+    return {};
+  }
 
-  auto binding = self.get_active_binding(action_id);
+  const auto* binding = self.compiled_actions[static_cast<usize>(action)].binding;
   if (!binding) {
     return {};
   }
@@ -276,34 +324,19 @@ auto Input::get_action_axis(this const Input& self, std::string_view action_id,
 auto Input::get_key_pressed(this const Input& self, const ScanCode key) -> bool {
   ZoneScoped;
 
-  const auto it = self.input_data.keyboard_data.scancode_pressed.find(key);
-  if (it != self.input_data.keyboard_data.scancode_pressed.end()) {
-    return it->second;
-  }
-
-  return false;
+  return test_bit(self.input_data.keyboard_data.scancode_pressed, key);
 }
 
 auto Input::get_key_released(this const Input& self, const ScanCode key) -> bool {
   ZoneScoped;
 
-  const auto it = self.input_data.keyboard_data.scancode_released.find(key);
-  if (it != self.input_data.keyboard_data.scancode_released.end()) {
-    return it->second;
-  }
-
-  return false;
+  return test_bit(self.input_data.keyboard_data.scancode_released, key);
 }
 
 auto Input::get_key_held(this const Input& self, const ScanCode key) -> bool {
   ZoneScoped;
 
-  const auto it = self.input_data.keyboard_data.scancode_held.find(key);
-  if (it != self.input_data.keyboard_data.scancode_held.end()) {
-    return it->second;
-  }
-
-  return false;
+  return test_bit(self.input_data.keyboard_data.scancode_held, key);
 }
 
 auto Input::get_keyboard_state(this const Input& self) -> std::pair<u32, const bool*> {
@@ -325,34 +358,19 @@ auto Input::get_mod_state(this const Input& self) -> ModCode {
 auto Input::get_mouse_clicked(this const Input& self, const MouseCode key) -> bool {
   ZoneScoped;
 
-  const auto it = self.input_data.mouse_data.mouse_pressed.find(key);
-  if (it != self.input_data.mouse_data.mouse_pressed.end()) {
-    return it->second;
-  }
-
-  return false;
+  return test_bit(self.input_data.mouse_data.mouse_pressed, key);
 }
 
 auto Input::get_mouse_released(this const Input& self, const MouseCode key) -> bool {
   ZoneScoped;
 
-  const auto it = self.input_data.mouse_data.mouse_released.find(key);
-  if (it != self.input_data.mouse_data.mouse_released.end()) {
-    return it->second;
-  }
-
-  return false;
+  return test_bit(self.input_data.mouse_data.mouse_released, key);
 }
 
 auto Input::get_mouse_held(this const Input& self, const MouseCode key) -> bool {
   ZoneScoped;
 
-  const auto it = self.input_data.mouse_data.mouse_held.find(key);
-  if (it != self.input_data.mouse_data.mouse_held.end()) {
-    return it->second;
-  }
-
-  return false;
+  return test_bit(self.input_data.mouse_data.mouse_held, key);
 }
 
 auto Input::get_mouse_position(this const Input& self) -> glm::vec2 {
@@ -433,10 +451,7 @@ auto Input::get_gamepad_button_pressed(this const Input& self, u32 instance_id,
 
   const auto it = self.input_data.gamepad_data_map.find(instance_id);
   if (it != self.input_data.gamepad_data_map.end()) {
-    const auto button_it = it->second.gamepad_pressed.find(button);
-    if (button_it != it->second.gamepad_pressed.end()) {
-      return button_it->second;
-    }
+    return test_bit(it->second.gamepad_pressed, button);
   }
 
   return false;
@@ -448,10 +463,7 @@ auto Input::get_gamepad_button_released(this const Input& self, u32 instance_id,
 
   const auto it = self.input_data.gamepad_data_map.find(instance_id);
   if (it != self.input_data.gamepad_data_map.end()) {
-    const auto button_it = it->second.gamepad_released.find(button);
-    if (button_it != it->second.gamepad_released.end()) {
-      return button_it->second;
-    }
+    return test_bit(it->second.gamepad_released, button);
   }
 
   return false;
@@ -462,10 +474,7 @@ auto Input::get_gamepad_button_held(this const Input& self, u32 instance_id, con
 
   const auto it = self.input_data.gamepad_data_map.find(instance_id);
   if (it != self.input_data.gamepad_data_map.end()) {
-    const auto button_it = it->second.gamepad_held.find(button);
-    if (button_it != it->second.gamepad_held.end()) {
-      return button_it->second;
-    }
+    return test_bit(it->second.gamepad_held, button);
   }
 
   return false;
@@ -476,9 +485,9 @@ auto Input::get_gamepad_axis(this const Input& self, u32 instance_id, const Game
 
   const auto it = self.input_data.gamepad_data_map.find(instance_id);
   if (it != self.input_data.gamepad_data_map.end()) {
-    const auto axis_it = it->second.gamepad_axises.find(axis);
-    if (axis_it != it->second.gamepad_axises.end()) {
-      return axis_it->second;
+    const auto index = static_cast<usize>(axis);
+    if (index < it->second.gamepad_axises.size()) {
+      return it->second.gamepad_axises[index];
     }
   }
 
@@ -500,6 +509,97 @@ auto Input::get_scan_code_from_key_code(KeyCode key_code) -> ScanCode {
   return static_cast<ScanCode>(SDL_GetScancodeFromKey(static_cast<SDL_Keycode>(key_code), nullptr));
 }
 
+auto Input::push_event(this Input& self, const InputEvent& event) -> void {
+  ZoneScoped;
+
+  if (self.replaying) {
+    return;
+  }
+
+  if (self.recording.has_value()) {
+    self.recording->events.push_back(event);
+    self.recorded_frame_events += 1;
+  }
+
+  self.apply_event(event);
+}
+
+auto Input::start_recording(this Input& self) -> void {
+  ZoneScoped;
+
+  self.recording = InputRecording{};
+  self.recorded_frame_events = 0;
+}
+
+auto Input::end_recorded_frame(this Input& self, f64 delta_ms) -> void {
+  if (!self.recording.has_value()) {
+    return;
+  }
+
+  self.recording->frames.push_back({.delta_ms = delta_ms, .event_count = self.recorded_frame_events});
+  self.recorded_frame_events = 0;
+}
+
+auto Input::stop_recording(this Input& self) -> InputRecording {
+  ZoneScoped;
+
+  if (!self.recording.has_value()) {
+    return {};
+  }
+
+  // Events after the last closed frame never got a frame time, they'd only confuse a replay.
+  self.recording->events.resize(self.recording->events.size() - self.recorded_frame_events);
+  auto result = std::move(self.recording.value());
+  self.recording.reset();
+  self.recorded_frame_events = 0;
+
+  return result;
+}
+
+auto Input::replay_frame(this Input& self, std::span<const InputEvent> events) -> void {
+  ZoneScoped;
+
+  for (const auto& event : events) {
+    self.apply_event(event);
+  }
+
+  self.update();
+}
+
+auto Input::apply_event(this Input& self, const InputEvent& event) -> void {
+  switch (event.type) {
+    case InputEventType::Key: {
+      const auto scan_code = static_cast<ScanCode>(event.code);
+      self.set_mod(event.mod);
+      self.set_key_pressed(scan_code, event.down && !event.repeat);
+      self.set_key_released(scan_code, !event.down);
+      self.set_key_held(scan_code, event.down);
+    } break;
+    case InputEventType::MouseButton: {
+      const auto button = static_cast<MouseCode>(event.code);
+      self.set_mouse_clicked(button, event.down);
+      self.set_mouse_released(button, !event.down);
+      self.set_mouse_held(button, event.down);
+    } break;
+    case InputEventType::MouseMotion: {
+      self.set_mouse_position(event.value);
+      self.set_mouse_position_rel(event.relative);
+      self.set_mouse_moved(true);
+    } break;
+    case InputEventType::MouseScroll: {
+      self.set_mouse_scroll_offset_y(event.value.y);
+    } break;
+    case InputEventType::GamepadButton: {
+      const auto button = static_cast<GamepadButtonCode>(event.code);
+      self.set_gamepad_button_pressed(event.instance_id, button, event.down);
+      self.set_gamepad_button_released(event.instance_id, button, !event.down);
+    } break;
+    case InputEventType::GamepadAxis: {
+      self.set_gamepad_axis(event.instance_id, static_cast<GamepadAxisCode>(event.code), event.value.x);
+    } break;
+  }
+}
+
 auto Input::set_mod(const ModCode mod) -> void {
   ZoneScoped;
 
@@ -509,7 +609,7 @@ auto Input::set_mod(const ModCode mod) -> void {
 auto Input::set_key_pressed(const ScanCode scan_code, const bool state) -> void {
   ZoneScoped;
 
-  input_data.keyboard_data.scancode_pressed.insert_or_assign(scan_code, state);
+  set_bit(input_data.keyboard_data.scancode_pressed, scan_code, state);
 
   if (state) {
     for (const auto& [id, binding] : action_bindings) {
@@ -521,7 +621,7 @@ auto Input::set_key_pressed(const ScanCode scan_code, const bool state) -> void
 void Input::set_key_released(const ScanCode scan_code, const bool state) {
   ZoneScoped;
 
-  input_data.keyboard_data.scancode_released.insert_or_assign(scan_code, state);
+  set_bit(input_data.keyboard_data.scancode_released, scan_code, state);
 
   if (state) {
     for (const auto& [id, binding] : action_bindings) {
@@ -533,7 +633,7 @@ void Input::set_key_released(const ScanCode scan_code, const bool state) {
 void Input::set_key_held(const ScanCode scan_code, const bool state) {
   ZoneScoped;
 
-  input_data.keyboard_data.scancode_held.insert_or_assign(scan_code, state);
+  set_bit(input_data.keyboard_data.scancode_held, scan_code, state);
 
   if (state) {
     for (const auto& [id, binding] : action_bindings) {
@@ -545,7 +645,7 @@ void Input::set_key_held(const ScanCode scan_code, const bool state) {
 void Input::set_mouse_clicked(const MouseCode key, const bool state) {
   ZoneScoped;
 
-  input_data.mouse_data.mouse_pressed.insert_or_assign(key, state);
+  set_bit(input_data.mouse_data.mouse_pressed, key, state);
 
   if (state) {
     for (const auto& [id, binding] : action_bindings) {
@@ -557,7 +657,7 @@ void Input::set_mouse_clicked(const MouseCode key, const bool state) {
 void Input::set_mouse_released(const MouseCode key, const bool state) {
   ZoneScoped;
 
-  input_data.mouse_data.mouse_released.insert_or_assign(key, state);
+  set_bit(input_data.mouse_data.mouse_released, key, state);
 
   if (state) {
     for (const auto& [id, binding] : action_bindings) {
@@ -569,7 +669,7 @@ void Input::set_mouse_released(const MouseCode key, const bool state) {
 void Input::set_mouse_held(const MouseCode key, const bool state) {
   ZoneScoped;
 
-  input_data.mouse_data.mouse_held.insert_or_assign(key, state);
+  set_bit(input_data.mouse_data.mouse_held, key, state);
 
   if (state) {
     for (const auto& [id, binding] : action_bindings) {
@@ -612,18 +712,10 @@ auto Input::set_gamepad_button_pressed(u32 instance_id, const GamepadButtonCode
   const auto now = SDL_GetTicksNS();
   const auto next_repeat_time = now + gamepad_repeat_delay.count();
 
-  const auto it = input_data.gamepad_data_map.find(instance_id);
-  if (it != input_data.gamepad_data_map.end()) {
-    it->second.gamepad_pressed.insert_or_assign(button, state);
-    it->second.gamepad_held.insert_or_assign(button, true);
-    it->second.next_repeat_time = next_repeat_time;
-  } else {
-    auto data = InputData::GamepadData{};
-    data.gamepad_pressed.insert_or_assign(button, state);
-    data.gamepad_held.insert_or_assign(button, true);
-    data.next_repeat_time = next_repeat_time;
-    input_data.gamepad_data_map.insert_or_assign(instance_id, data);
-  }
+  auto& data = input_data.gamepad_data_map[instance_id];
+  set_bit(data.gamepad_pressed, button, state);
+  set_bit(data.gamepad_held, button, true);
+  data.next_repeat_time = next_repeat_time;
 
   if (state) {
     for (const auto& [id, binding] : action_bindings) {
@@ -635,16 +727,9 @@ auto Input::set_gamepad_button_pressed(u32 instance_id, const GamepadButtonCode
 auto Input::set_gamepad_button_released(u32 instance_id, const GamepadButtonCode button, const bool state) -> void {
   ZoneScoped;
 
-  const auto it = input_data.gamepad_data_map.find(instance_id);
-  if (it != input_data.gamepad_data_map.end()) {
-    it->second.gamepad_released.insert_or_assign(button, state);
-    it->second.gamepad_held.insert_or_assign(button, !state);
-  } else {
-    auto data = InputData::GamepadData{};
-    data.gamepad_released.insert_or_assign(button, state);
-    it->second.gamepad_held.insert_or_assign(button, !state);
-    input_data.gamepad_data_map.insert_or_assign(instance_id, data);
-  }
+  auto& data = input_data.gamepad_data_map[instance_id];
+  set_bit(data.gamepad_released, button, state);
+  set_bit(data.gamepad_held, button, !state);
 
   if (state) {
     for (const auto& [id, binding] : action_bindings) {
@@ -656,13 +741,10 @@ auto Input::set_gamepad_button_released(u32 instance_id, const GamepadButtonCode
 auto Input::set_gamepad_axis(u32 instance_id, const GamepadAxisCode axis, f32 value) -> void {
   ZoneScoped;
 
-  const auto it = input_data.gamepad_data_map.find(instance_id);
-  if (it != input_data.gamepad_data_map.end()) {
-    it->second.gamepad_axises.insert_or_assign(axis, value);
-  } else {
-    auto data = InputData::GamepadData{};
-    data.gamepad_axises.insert_or_assign(axis, value);
-    input_data.gamepad_data_map.insert_or_assign(instance_id, data);
+  auto& data = input_data.gamepad_data_map[instance_id];
+  const auto index = static_cast<usize>(axis);
+  if (index < data.gamepad_axises.size()) {
+    data.gamepad_axises[index] = value;
   }
 
   for (const auto& [id, binding] : action_bindings) {
@@ -838,6 +920,74 @@ auto Input::check_input_axis(
   }
 }
 
+auto Input::compile_actions(this Input& self) -> void {
+  ZoneScoped;
+
+  for (auto& action : self.compiled_actions) {
+    action.binding = nullptr;
+  }
+
+  for (const auto& [action_id, binding] : self.action_bindings) {
+    if (binding.context == self.active_context) {
+      const auto action = self.resolve_action(action_id);
+      self.compiled_actions[static_cast<usize>(action)].binding = &binding;
+    }
+  }
+
+  self.update_action_states();
+}
+
+auto Input::update_action_states(this Input& self) -> void {
+  ZoneScoped;
+
+  self.action_states.pressed.clear();
+  self.action_states.released.clear();
+  self.action_states.held.clear();
+  for (const auto& [instance_id, data] : self.input_data.gamepad_data_map) {
+    auto& states = self.gamepad_action_states[instance_id];
+    states.pressed.clear();
+    states.released.clear();
+    states.held.clear();
+  }
+
+  const auto test_input = [&self](ActionStates& states, ActionID action, const InputCode& input, u32 instance_id) {
+    if (self.check_input_active(input, instance_id, InputState::Pressed)) {
+      states.pressed.set(action);
+    }
+    if (self.check_input_active(input, instance_id, InputState::Released)) {
+      states.released.set(action);
+    }
+    if (self.check_input_active(input, instance_id, InputState::Held)) {
+      states.held.set(action);
+    }
+  };
+
+  for (usize i = 0; i < self.compiled_actions.size(); i++) {
+    const auto* binding = self.compiled_actions[i].binding;
+    if (!binding) {
+      continue;
+    }
+
+    const auto action = static_cast<ActionID>(i);
+    for (const auto* inputs : {&binding->primary_inputs, &binding->secondary_inputs}) {
+      for (const auto& input : *inputs) {
+        switch (input.type) {
+          case InputType::Keyboard:
+          case InputType::MouseButton: {
+            test_input(self.action_states, action, input, DEFAULT_INSTANCE_ID);
+          } break;
+          case InputType::GamepadButton: {
+            for (const auto& [instance_id, data] : self.input_data.gamepad_data_map) {
+              test_input(self.gamepad_action_states[instance_id], action, input, instance_id);
+            }
+          } break;
+          default: break;
+        }
+      }
+    }
+  }
+}
+
 auto Input::find_conflicts(this const Input& self, const ActionBinding& binding) -> std::vector<std::string> {
   ZoneScoped;
 
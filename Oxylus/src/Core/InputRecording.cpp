@@ -0,0 +1,220 @@
+#include "Core/InputRecording.hpp"
+
+#include <algorithm>
+#include <bit>
+
+#include "Networking/BitStream.hpp"
+#include "OS/File.hpp"
+#include "Utils/Log.hpp"
+
+namespace ox {
+namespace {
+constexpr auto EVENT_TYPE_BITS = 3_u32;
+
+auto write_f32(BitWriter& writer, f32 value) -> void { writer.write_bits(std::bit_cast<u32>(value), 32); }
+
+auto read_f32(BitReader& reader) -> f32 { return std::bit_cast<f32>(static_cast<u32>(reader.read_bits(32))); }
+
+auto write_f64(BitWriter& writer, f64 value) -> void {
+  const auto bits = std::bit_cast<u64>(value);
+  writer.write_bits(bits & 0xffff'ffff, 32);
+  writer.write_bits(bits >> 32, 32);
+}
+
+auto read_f64(BitReader& reader) -> f64 {
+  const auto low = reader.read_bits(32);
+  const auto high = reader.read_bits(32);
+  return std::bit_cast<f64>(low | (high << 32));
+}
+
+auto write_event(BitWriter& writer, const InputEvent& event) -> void {
+  writer.write_bits(static_cast<u64>(event.type), EVENT_TYPE_BITS);
+  switch (event.type) {
+    case InputEventType::Key: {
+      writer.write_bool(event.down);
+      writer.write_bool(event.repeat);
+      writer.write_varint(static_cast<u16>(event.mod));
+      writer.write_varint(event.code);
+    } break;
+    case InputEventType::MouseButton: {
+      writer.write_bool(event.down);
+      writer.write_varint(event.code);
+    } break;
+    case InputEventType::MouseMotion: {
+      write_f32(writer, event.value.x);
+      write_f32(writer, event.value.y);
+      write_f32(writer, event.relative.x);
+      write_f32(writer, event.relative.y);
+    } break;
+    case InputEventType::MouseScroll: {
+      write_f32(writer, event.value.y);
+    } break;
+    case InputEventType::GamepadButton: {
+      writer.write_bool(event.down);
+      writer.write_varint(event.instance_id);
+      writer.write_varint(event.code);
+    } break;
+    case InputEventType::GamepadAxis: {
+      writer.write_varint(event.instance_id);
+      writer.write_varint(event.code);
+      write_f32(writer, event.value.x);
+    } break;
+  }
+}
+
+auto read_event(BitReader& reader) -> std::expected<InputEvent, std::string> {
+  auto event = InputEvent{};
+  const auto type = reader.read_bits(EVENT_TYPE_BITS);
+  if (type > static_cast<u64>(InputEventType::GamepadAxis)) {
+    return std::unexpected(fmt::format("Unknown input event type {}.", type));
+  }
+
+  event.type = static_cast<InputEventType>(type);
+  switch (event.type) {
+    case InputEventType::Key: {
+      event.down = reader.read_bool();
+      event.repeat = reader.read_bool();
+      event.mod = static_cast<ModCode>(reader.read_varint());
+      event.code = static_cast<u32>(reader.read_varint());
+    } break;
+    case InputEventType::MouseButton: {
+      event.down = reader.read_bool();
+      event.code = static_cast<u32>(reader.read_varint());
+    } break;
+    case InputEventType::MouseMotion: {
+      event.value.x = read_f32(reader);
+      event.value.y = read_f32(reader);
+      event.relative.x = read_f32(reader);
+      event.relative.y = read_f32(reader);
+    } break;
+    case InputEventType::MouseScroll: {
+      event.value.y = read_f32(reader);
+    } break;
+    case InputEventType::GamepadButton: {
+      event.down = reader.read_bool();
+      event.instance_id = static_cast<u32>(reader.read_varint());
+      event.code = static_cast<u32>(reader.read_varint());
+    } break;
+    case InputEventType::GamepadAxis: {
+      event.instance_id = static_cast<u32>(reader.read_varint());
+      event.code = static_cast<u32>(reader.read_varint());
+      event.value.x = read_f32(reader);
+    } break;
+  }
+
+  return event;
+}
+} // namespace
+
+auto InputRecording::encode(this const InputRecording& self) -> std::vector<u8> {
+  ZoneScoped;
+
+  auto writer = BitWriter{};
+  writer.write_bits(MAGIC, 32);
+  writer.write_varint(VERSION);
+  writer.write_varint(self.frames.size());
+
+  // Frame times are nearly always the same as the one before, with a fixed step always.
+  auto previous_delta = option<f64>{};
+  auto event_offset = 0_sz;
+  for (const auto& frame : self.frames) {
+    const auto same_delta = previous_delta.has_value() && previous_delta.value() == frame.delta_ms;
+    writer.write_bool(same_delta);
+    if (!same_delta) {
+      write_f64(writer, frame.delta_ms);
+    }
+    previous_delta = frame.delta_ms;
+
+    writer.write_varint(frame.event_count);
+    for (auto i = 0_sz; i < frame.event_count && event_offset < self.events.size(); i++) {
+      write_event(writer, self.events[event_offset++]);
+    }
+  }
+
+  auto bytes = writer.flush();
+  return {bytes.begin(), bytes.end()};
+}
+
+auto InputRecording::decode(std::span<const u8> bytes) -> std::expected<InputRecording, std::string> {
+  ZoneScoped;
+
+  auto reader = BitReader{.bytes = bytes};
+  if (reader.read_bits(32) != MAGIC) {
+    return std::unexpected("Not an input recording.");
+  }
+
+  const auto version = reader.read_varint();
+  if (version != VERSION) {
+    return std::unexpected(fmt::format("Unsupported input recording version {}.", version));
+  }
+
+  auto recording = InputRecording{};
+  const auto frame_count = reader.read_varint();
+  // Every frame takes two bits at least, anything claiming more is corrupt.
+  if (reader.failed || frame_count > reader.remaining_bits() / 2) {
+    return std::unexpected("Input recording is truncated.");
+  }
+
+  recording.frames.reserve(frame_count);
+  auto delta_ms = 0.0;
+  for (auto i = 0_u64; i < frame_count; i++) {
+    if (!reader.read_bool()) {
+      delta_ms = read_f64(reader);
+    }
+
+    const auto event_count = reader.read_varint();
+    if (reader.failed || event_count > reader.remaining_bits() / EVENT_TYPE_BITS) {
+      return std::unexpected("Input recording is truncated.");
+    }
+
+    recording.frames.push_back({.delta_ms = delta_ms, .event_count = static_cast<u32>(event_count)});
+    for (auto j = 0_u64; j < event_count; j++) {
+      auto event = read_event(reader);
+      if (!event.has_value()) {
+        return std::unexpected(event.error());
+      }
+
+      recording.events.push_back(event.value());
+    }
+  }
+
+  if (reader.failed) {
+    return std::unexpected("Input recording is truncated.");
+  }
+
+  return recording;
+}
+
+auto InputRecording::save(this const InputRecording& self, const std::filesystem::path& path)
+  -> std::expected<void, std::string> {
+  ZoneScoped;
+
+  const auto bytes = self.encode();
+  auto file = File(path, FileAccess::Write);
+  if (!file || file.write(bytes) != bytes.size()) {
+    return std::unexpected(fmt::format("Failed to write input recording {}.", path));
+  }
+
+  return {};
+}
+
+auto InputRecording::load(const std::filesystem::path& path) -> std::expected<InputRecording, std::string> {
+  ZoneScoped;
+
+  const auto bytes = File::to_bytes(path);
+  if (bytes.empty()) {
+    return std::unexpected(fmt::format("Failed to read input recording {}.", path));
+  }
+
+  return decode(bytes);
+}
+
+auto InputReplay::advance(this InputReplay& self) -> std::span<const InputEvent> {
+  const auto& frame = self.recording.frames[self.next_frame++];
+  const auto first = std::min(self.next_event, self.recording.events.size());
+  const auto count = std::min<usize>(frame.event_count, self.recording.events.size() - first);
+  self.next_event = first + count;
+
+  return std::span(self.recording.events).subspan(first, count);
+}
+} // namespace ox
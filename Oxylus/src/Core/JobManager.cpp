@@ -3,6 +3,7 @@
 #include "Core/Base.hpp"
 #include "Memory/Stack.hpp"
 #include "OS/OS.hpp"
+#include "Utils/FrameProfiler.hpp"
 #include "Utils/Log.hpp"
 
 namespace ox {
@@ -113,6 +114,7 @@ auto JobManager::worker(this JobManager& self, u32 id) -> void {
 
     job->task();
     self.job_count.fetch_sub(1);
+    OX_COUNTER_ADD("jobs.executed", 1);
 
     for (auto& barrier : job->barriers) {
       if (--barrier->counter == 0) {
@@ -18,13 +18,22 @@ auto NetClient::set_tick_rate(this NetClient& self, f64 tick_rate) -> void {
   self.tick_accum = 0.0f;
 }
 
+auto NetClient::set_world(this NetClient& self, flecs::world& world) -> void {
+  ZoneScoped;
+
+  self.world = &world;
+}
+
 auto NetClient::connect(this NetClient& self, std::string_view host_name, u16 port, f64 timeout) -> bool {
   ZoneScoped;
 
   auto address = ENetAddress{};
   enet_address_set_host(&address, host_name.data());
   address.port = port;
-  self.remote_peer = enet_host_connect(self.local_host, &address, NET_CHANNEL_COUNT, 0);
+  {
+    auto lock = std::unique_lock(self.io->host_mutex);
+    self.remote_peer = enet_host_connect(self.local_host, &address, NET_CHANNEL_COUNT, 0);
+  }
   if (!self.remote_peer) {
     return false;
   }
@@ -45,7 +54,9 @@ auto NetClient::disconnect(this NetClient& self, bool immediate, u32 data) -> vo
     return;
   }
 
-  if (immediate) {
+  if (self.io) {
+    self.io->disconnect(self.remote_peer, immediate, data);
+  } else if (immediate) {
     enet_peer_disconnect_now(self.remote_peer, data);
   } else {
     enet_peer_disconnect_later(self.remote_peer, data);
@@ -57,43 +68,9 @@ auto NetClient::disconnect(this NetClient& self, bool immediate, u32 data) -> vo
 auto NetClient::tick(this NetClient& self, const Timestep& ts) -> bool {
   ZoneScoped;
 
-  auto event = ENetEvent{};
-  while (enet_host_service(self.local_host, &event, 0) > 0) {
-    switch (event.type) {
-      case ENET_EVENT_TYPE_CONNECT: {
-        ZoneScopedN("ENET_EVENT_TYPE_CONNECT");
-        OX_LOG_INFO("NetClient connected.");
-        self.status = NetClientStatus::Connected;
-
-        if (auto handshake_packet = NetPacket::handshake({.version = 1})) {
-          self.send_reliable(handshake_packet.value());
-        }
-      } break;
-      case ENET_EVENT_TYPE_DISCONNECT_TIMEOUT:
-      case ENET_EVENT_TYPE_DISCONNECT        : {
-        ZoneScopedN("ENET_EVENT_TYPE_DISCONNECT");
-        OX_LOG_INFO("NetClient disconnected.");
-
-        event.peer->data = nullptr;
-      } break;
-      case ENET_EVENT_TYPE_RECEIVE: {
-        ZoneScopedN("ENET_EVENT_TYPE_RECEIVE");
-        OX_DEFER(&) { enet_packet_destroy(event.packet); };
-
-        auto packet = NetPacket::from_packet(event.packet);
-        if (!packet.has_value()) {
-          OX_LOG_ERROR("Received a packet with bad data.");
-          break;
-        }
-
-        self.handle_packet(packet.value());
-      } break;
-      case ENET_EVENT_TYPE_NONE: {
-      } break;
-    }
-  }
-
-  if (self.remote_peer) {
+  // Peer counters belong to the I/O thread, a busy host just keeps last tick's numbers.
+  auto lock = std::unique_lock(self.io->host_mutex, std::try_to_lock);
+  if (self.remote_peer && lock.owns_lock()) {
     auto current_sent_bytes = self.remote_peer->totalDataSent;
     auto current_received_bytes = self.remote_peer->totalDataReceived;
     auto current_sent_packets = self.remote_peer->packetsSent;
@@ -116,6 +93,9 @@ auto NetClient::tick(this NetClient& self, const Timestep& ts) -> bool {
       OX_LOG_ERROR("Connection attempt timed out after {:.1f}ms", self.timeout_elapsed);
 
       if (self.remote_peer) {
+        if (!lock.owns_lock()) {
+          lock.lock();
+        }
         enet_peer_reset(self.remote_peer);
         self.remote_peer = nullptr;
       }
@@ -126,6 +106,16 @@ auto NetClient::tick(this NetClient& self, const Timestep& ts) -> bool {
     }
   }
 
+  self.timeline.advance(ts.get_millis());
+  if (self.timeline.sample(self.sampled_state)) {
+    auto& es = App::get_event_system();
+    std::ignore = es.emit<ClientSceneSnapshotEvent>(
+      ClientSceneSnapshotEvent(self.timeline.playback_ms(), &self.sampled_state)
+    );
+
+    self.on_scene_snapshot(self.timeline.playback_ms(), self.sampled_state);
+  }
+
   self.tick_accum += ts.get_millis();
   if (self.tick_accum >= self.tick_interval) {
     self.tick_accum -= self.tick_interval;
@@ -135,6 +125,54 @@ auto NetClient::tick(this NetClient& self, const Timestep& ts) -> bool {
   return false;
 }
 
+auto NetClient::dispatch(this NetClient& self) -> void {
+  ZoneScoped;
+
+  self.io->dispatch(self.io_stats, [&](NetEvent& event) { self.handle_event(event); });
+}
+
+auto NetClient::poll(this NetClient& self) -> void {
+  ZoneScoped;
+
+  self.io->service();
+  self.dispatch();
+}
+
+auto NetClient::handle_event(this NetClient& self, NetEvent& event) -> void {
+  ZoneScoped;
+
+  switch (event.kind) {
+    case NetEventKind::Connect: {
+      ZoneScopedN("NetEventKind::Connect");
+      OX_LOG_INFO("NetClient connected.");
+      self.status = NetClientStatus::Connected;
+
+      if (auto handshake_packet = NetPacket::handshake({.version = 1, .procs = self.procs.entries})) {
+        self.send_reliable(handshake_packet.value());
+      }
+    } break;
+    case NetEventKind::Disconnect: {
+      ZoneScopedN("NetEventKind::Disconnect");
+      OX_LOG_INFO("NetClient disconnected.");
+      self.timeline.reset();
+
+      event.peer->data = nullptr;
+    } break;
+    case NetEventKind::Receive: {
+      ZoneScopedN("NetEventKind::Receive");
+      OX_DEFER(&) { enet_packet_destroy(event.packet); };
+
+      auto packet = NetPacket::from_packet(event.packet);
+      if (!packet.has_value()) {
+        OX_LOG_ERROR("Received a packet with bad data.");
+        break;
+      }
+
+      self.handle_packet(packet.value());
+    } break;
+  }
+}
+
 auto NetClient::handle_packet(this NetClient& self, NetPacket& packet) -> void {
   ZoneScoped;
 
@@ -146,35 +184,46 @@ auto NetClient::handle_packet(this NetClient& self, NetPacket& packet) -> void {
       }
 
       self.net_id = handshake->net_id;
+      self.remote_procs.assign(handshake->procs);
+      if (handshake->tick_interval_ms > 0.0) {
+        self.timeline.tick_interval_ms = handshake->tick_interval_ms;
+      }
+
+      if (self.world) {
+        self.snapshot_codec.schema.build(*self.world);
+        self.timeline.schema.build(*self.world);
+      } else {
+        OX_LOG_WARN("NetClient has no world, snapshots with packed components won't decode.");
+      }
+
+      if (handshake->snapshot_dictionary_id != self.snapshot_codec.dictionary_id()) {
+        OX_LOG_ERROR(
+          "Server compresses snapshots with dictionary {}, this client has {}!",
+          handshake->snapshot_dictionary_id,
+          self.snapshot_codec.dictionary_id()
+        );
+      }
     } break;
     case NetPacketType::SceneSnapshot: {
-      auto snapshot = packet.get_scene_snapshot();
+      auto snapshot = packet.get_scene_snapshot(&self.snapshot_codec);
       if (!snapshot.has_value()) {
         return;
       }
 
-      // TODO: Copying the whole scene snapshot...
-      auto& es = App::get_event_system();
-      std::ignore = es.emit<ClientSceneSnapshotEvent>(ClientSceneSnapshotEvent(snapshot->sequence, snapshot->state));
-
-      self.on_scene_snapshot(snapshot->sequence, std::move(snapshot->state));
+      // Only buffered here, `tick` applies what the timeline samples.
+      if (self.timeline.push(snapshot->sequence, snapshot->baseline, snapshot->state, snapshot->upsert)) {
+        if (auto ack_packet = NetPacket::client_ack({.acked = snapshot->sequence})) {
+          self.send_unreliable(ack_packet.value());
+        }
+      }
     } break;
     case NetPacketType::ClientAck: {
       // Not our job
     } break;
     case NetPacketType::RPC: {
-      auto rpc = packet.get_rpc();
-      if (!rpc.has_value()) {
-        return;
+      if (auto rpcs = packet.get_rpcs()) {
+        self.procs.dispatch(NetClientID::Invalid, rpcs.value());
       }
-
-      auto procs_it = self.rpcs.find(rpc->proc_hash);
-      if (procs_it == self.rpcs.end()) {
-        OX_LOG_ERROR("Server is trying to call an invalid proc!");
-        return;
-      }
-
-      procs_it->second(NetClientID::Invalid, std::span(rpc->parameters));
     } break;
     case NetPacketType::Unknown: {
     } break;
@@ -183,17 +232,91 @@ auto NetClient::handle_packet(this NetClient& self, NetPacket& packet) -> void {
 
 auto NetClient::add_builtin_procs(this NetClient& self) -> void { ZoneScoped; }
 
-auto NetClient::register_proc(this NetClient& self, std::string_view identifier, NetRPCPacket::Callback&& cb) -> void {
+auto NetClient::register_proc(this NetClient& self, std::string_view identifier, NetProcCallback&& cb) -> NetProcID {
+  ZoneScoped;
+
+  return self.procs.add(identifier, std::move(cb));
+}
+
+auto NetClient::find_remote_proc(this const NetClient& self, std::string_view identifier) -> option<NetProcID> {
+  return self.remote_procs.find(identifier);
+}
+
+auto NetClient::call(this NetClient& self, NetProcID proc_id, std::span<const RPCParameter> params, bool reliable)
+  -> bool {
+  ZoneScoped;
+
+  const auto channel = reliable ? NET_CHANNEL_RELIABLE : NET_CHANNEL_UNRELIABLE;
+  auto& batch = self.rpc_batches[channel];
+  if (!batch.add(proc_id, params)) {
+    return false;
+  }
+
+  if (batch.should_flush()) {
+    self.flush_rpc_batch(channel);
+  }
+
+  return true;
+}
+
+auto NetClient::call(
+  this NetClient& self, std::string_view identifier, std::span<const RPCParameter> params, bool reliable
+) -> bool {
   ZoneScoped;
 
-  auto hash = ankerl::unordered_dense::detail::wyhash::hash(identifier.data(), identifier.size());
-  self.rpcs.emplace(hash, std::move(cb));
+  auto proc_id = self.find_remote_proc(identifier);
+  if (!proc_id.has_value()) {
+    OX_LOG_ERROR("Trying to call proc {} the other side never announced!", identifier);
+    return false;
+  }
+
+  return self.call(proc_id.value(), params, reliable);
+}
+
+auto NetClient::flush_rpcs(this NetClient& self) -> void {
+  ZoneScoped;
+
+  for (auto channel = 0_u32; channel < NET_CHANNEL_COUNT; channel++) {
+    self.flush_rpc_batch(channel);
+  }
+}
+
+auto NetClient::flush_rpc_batch(this NetClient& self, u32 channel) -> void {
+  ZoneScoped;
+
+  auto& batch = self.rpc_batches[channel];
+  if (batch.empty()) {
+    return;
+  }
+
+  // Nobody to send them to, calls don't survive a reconnect either.
+  if (!self.remote_peer || self.status == NetClientStatus::Connecting) {
+    batch.clear();
+    return;
+  }
+
+  auto packet = NetPacket::rpc(batch);
+  batch.clear();
+  if (!packet.has_value()) {
+    return;
+  }
+
+  if (channel == NET_CHANNEL_RELIABLE) {
+    self.send_reliable(packet.value());
+  } else {
+    self.send_unreliable(packet.value());
+  }
 }
 
 auto NetClient::send_reliable(this NetClient& self, NetPacket& packet) -> void {
   ZoneScoped;
 
   packet.inner->flags = ENET_PACKET_FLAG_RELIABLE;
+  if (self.io) {
+    self.io->send(self.remote_peer, packet, NET_CHANNEL_RELIABLE);
+    return;
+  }
+
   if (enet_peer_send(self.remote_peer, NET_CHANNEL_RELIABLE, packet) < 0) {
     if (packet.can_destroy()) {
       packet.destroy();
@@ -205,6 +328,11 @@ auto NetClient::send_unreliable(this NetClient& self, NetPacket& packet) -> void
   ZoneScoped;
 
   packet.inner->flags = 0;
+  if (self.io) {
+    self.io->send(self.remote_peer, packet, NET_CHANNEL_UNRELIABLE);
+    return;
+  }
+
   if (enet_peer_send(self.remote_peer, NET_CHANNEL_UNRELIABLE, packet) < 0) {
     if (packet.can_destroy()) {
       packet.destroy();
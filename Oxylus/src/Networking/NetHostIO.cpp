@@ -0,0 +1,120 @@
+#include "Networking/NetHostIO.hpp"
+
+#include <chrono>
+#include <enet.h>
+#include <tuple>
+
+namespace ox {
+NetHostIO::~NetHostIO() {
+  auto event = NetEvent{};
+  while (inbound.try_pop(event)) {
+    if (event.packet) {
+      enet_packet_destroy(event.packet);
+    }
+  }
+
+  auto command = NetCommand{};
+  while (outbound.try_pop(command)) {
+    if (command.packet && command.packet->referenceCount == 0) {
+      enet_packet_destroy(command.packet);
+    }
+  }
+}
+
+auto NetHostIO::send(this NetHostIO& self, ENetPeer* peer, ENetPacket* packet, u8 channel) -> void {
+  ZoneScoped;
+
+  auto command = NetCommand{.kind = NetCommandKind::Send, .peer = peer, .packet = packet, .channel = channel};
+  if (self.outbound.try_push(command)) {
+    return;
+  }
+
+  // The I/O thread fell behind, drain the queue here so ordering holds and send directly.
+  auto lock = std::unique_lock(self.host_mutex);
+  self.flush_commands();
+  if (enet_peer_send(peer, channel, packet) < 0) {
+    self.dropped_sends.fetch_add(1, std::memory_order_relaxed);
+    if (packet->referenceCount == 0) {
+      enet_packet_destroy(packet);
+    }
+  }
+}
+
+auto NetHostIO::disconnect(this NetHostIO& self, ENetPeer* peer, bool immediate, u32 data) -> void {
+  ZoneScoped;
+
+  if (!immediate) {
+    auto command = NetCommand{.kind = NetCommandKind::DisconnectLater, .peer = peer, .data = data};
+    if (self.outbound.try_push(command)) {
+      return;
+    }
+  }
+
+  auto lock = std::unique_lock(self.host_mutex);
+  self.flush_commands();
+  if (immediate) {
+    enet_peer_disconnect_now(peer, data);
+  } else {
+    enet_peer_disconnect_later(peer, data);
+  }
+}
+
+auto NetHostIO::service(this NetHostIO& self) -> void {
+  ZoneScoped;
+
+  auto lock = std::unique_lock(self.host_mutex);
+  self.flush_commands();
+
+  auto event = ENetEvent{};
+  // Whatever doesn't fit stays in ENet until the game thread catches up.
+  while (self.inbound.free_space() > 0 && enet_host_service(self.host, &event, 0) > 0) {
+    auto net_event = NetEvent{.peer = event.peer, .data = event.data, .received_ns = now_ns()};
+    switch (event.type) {
+      case ENET_EVENT_TYPE_CONNECT: {
+        net_event.kind = NetEventKind::Connect;
+      } break;
+      case ENET_EVENT_TYPE_DISCONNECT_TIMEOUT:
+      case ENET_EVENT_TYPE_DISCONNECT        : {
+        net_event.kind = NetEventKind::Disconnect;
+      } break;
+      case ENET_EVENT_TYPE_RECEIVE: {
+        net_event.kind = NetEventKind::Receive;
+        net_event.packet = event.packet;
+      } break;
+      case ENET_EVENT_TYPE_NONE: {
+        continue;
+      }
+    }
+
+    std::ignore = self.inbound.try_push(net_event);
+  }
+
+  enet_host_flush(self.host);
+}
+
+auto NetHostIO::now_ns() -> u64 {
+  const auto now = std::chrono::steady_clock::now().time_since_epoch();
+  return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+}
+
+auto NetHostIO::flush_commands(this NetHostIO& self) -> void {
+  ZoneScoped;
+
+  auto command = NetCommand{};
+  while (self.outbound.try_pop(command)) {
+    switch (command.kind) {
+      case NetCommandKind::Send: {
+        if (enet_peer_send(command.peer, command.channel, command.packet) < 0) {
+          self.dropped_sends.fetch_add(1, std::memory_order_relaxed);
+          if (command.packet->referenceCount == 0) {
+            enet_packet_destroy(command.packet);
+          }
+        }
+      } break;
+      case NetCommandKind::DisconnectLater: {
+        enet_peer_disconnect_later(command.peer, command.data);
+      } break;
+    }
+  }
+}
+} // namespace ox
@@ -8,6 +8,7 @@ namespace ox {
 constexpr auto MAX_PACKET_ALLOC_SIZE = 16_sz * 1024 * 1024;
 using SizeOption = zpp::bits::options::size_varint;
 using AllocLimitOption = zpp::bits::alloc_limit<MAX_PACKET_ALLOC_SIZE>;
+constexpr auto SNAPSHOT_FLAG_UPSERT = 1_u8 << 0;
 
 template <typename... T>
 auto serialize_packet(NetPacketType type, const T&... payload) -> option<NetPacket> {
@@ -27,57 +28,44 @@ auto serialize_packet(NetPacketType type, const T&... payload) -> option<NetPack
   return NetPacket{.type = type, .inner = packet};
 }
 
-template <typename... T>
-auto deserialize_packet(NetPacket& self, NetPacketType type, T&... payload) -> bool {
+template <typename T>
+auto encode_snapshot_packet(const T& state, u8 sequence, option<u8> baseline, SnapshotCodec* codec, bool upsert)
+  -> option<NetPacket> {
   ZoneScoped;
 
-  if (self.type != type) {
-    return false;
-  }
-
-  auto bytes = std::span(self.inner->data, self.inner->dataLength);
-  auto deser = zpp::bits::in(bytes, SizeOption{}, AllocLimitOption{});
-
-  // The type is part of the payload, it has already been peeked at by `from_packet`.
-  auto packet_type = NetPacketType::Unknown;
-  return !zpp::bits::failure(deser(packet_type, payload...));
-}
+  thread_local auto raw_codec = SnapshotCodec{};
+  thread_local auto data = std::vector<u8>{};
 
-auto RPCParameter::as_f32(this const RPCParameter& self) -> option<const f32> {
-  const auto* v = std::get_if<f32>(&self.value);
-  if (!v) {
+  data.clear();
+  data.push_back(static_cast<u8>(NetPacketType::SceneSnapshot));
+  data.push_back(upsert ? SNAPSHOT_FLAG_UPSERT : 0_u8);
+  if (!(codec ? codec : &raw_codec)->encode(state, sequence, baseline, data)) {
+    OX_LOG_ERROR("Failed to serialize packet.");
     return nullopt;
   }
 
-  return *v;
-}
-
-auto RPCParameter::as_int64(this const RPCParameter& self) -> option<const i64> {
-  const auto* v = std::get_if<i64>(&self.value);
-  if (!v) {
+  auto* packet = enet_packet_create(data.data(), data.size(), 0);
+  if (!packet) {
     return nullopt;
   }
 
-  return *v;
+  return NetPacket{.type = NetPacketType::SceneSnapshot, .inner = packet};
 }
 
-auto RPCParameter::as_str(this const RPCParameter& self) -> std::string_view {
-  const auto* v = std::get_if<std::string>(&self.value);
-  if (!v) {
-    return {};
-  }
-
-  return *v;
-}
+template <typename... T>
+auto deserialize_packet(NetPacket& self, NetPacketType type, T&... payload) -> bool {
+  ZoneScoped;
 
-auto RPCParameter::as_uuid(this const RPCParameter& self) -> option<UUID> {
-  const auto* v = std::get_if<std::array<u8, 16>>(&self.value);
-  if (!v) {
-    return nullopt;
+  if (self.type != type) {
+    return false;
   }
 
-  auto bytes = *v;
-  return UUID::from_bytes(bytes);
+  auto bytes = std::span(self.inner->data, self.inner->dataLength);
+  auto deser = zpp::bits::in(bytes, SizeOption{}, AllocLimitOption{});
+
+  // The type is part of the payload, it has already been peeked at by `from_packet`.
+  auto packet_type = NetPacketType::Unknown;
+  return !zpp::bits::failure(deser(packet_type, payload...));
 }
 
 auto NetPacket::handshake(const NetHandshakePacket& info) -> option<NetPacket> {
@@ -86,10 +74,16 @@ auto NetPacket::handshake(const NetHandshakePacket& info) -> option<NetPacket> {
   return serialize_packet(NetPacketType::Handshake, info);
 }
 
-auto NetPacket::scene_snapshot(const SceneState& state, u8 sequence) -> option<NetPacket> {
-  ZoneScoped;
+auto NetPacket::scene_snapshot(
+  const SceneState& state, u8 sequence, option<u8> baseline, SnapshotCodec* codec, bool upsert
+) -> option<NetPacket> {
+  return encode_snapshot_packet(state, sequence, baseline, codec, upsert);
+}
 
-  return serialize_packet(NetPacketType::SceneSnapshot, sequence, state);
+auto NetPacket::scene_snapshot(
+  const SnapshotDelta& delta, u8 sequence, option<u8> baseline, SnapshotCodec* codec, bool upsert
+) -> option<NetPacket> {
+  return encode_snapshot_packet(delta, sequence, baseline, codec, upsert);
 }
 
 auto NetPacket::client_ack(const NetClientAckPacket& info) -> option<NetPacket> {
@@ -98,11 +92,20 @@ auto NetPacket::client_ack(const NetClientAckPacket& info) -> option<NetPacket>
   return serialize_packet(NetPacketType::ClientAck, info);
 }
 
-auto NetPacket::rpc(std::string_view proc, std::span<const RPCParameter> params) -> option<NetPacket> {
+auto NetPacket::rpc(const NetRPCBatch& batch) -> option<NetPacket> {
   ZoneScoped;
 
-  const auto proc_hash = ankerl::unordered_dense::detail::wyhash::hash(proc.data(), proc.size());
-  return serialize_packet(NetPacketType::RPC, proc_hash, params);
+  // Batches are encoded as they get filled, type byte included.
+  if (batch.empty()) {
+    return nullopt;
+  }
+
+  auto* packet = enet_packet_create(batch.bytes.data(), batch.bytes.size(), 0);
+  if (!packet) {
+    return nullopt;
+  }
+
+  return NetPacket{.type = NetPacketType::RPC, .inner = packet};
 }
 
 auto NetPacket::from_packet(ENetPacket* packet) -> option<NetPacket> {
@@ -152,11 +155,24 @@ auto NetPacket::get_handshake(this NetPacket& self) -> option<NetHandshakePacket
   return info;
 }
 
-auto NetPacket::get_scene_snapshot(this NetPacket& self) -> option<NetSceneSnapshotPacket> {
+auto NetPacket::get_scene_snapshot(this NetPacket& self, SnapshotCodec* codec) -> option<NetSceneSnapshotPacket> {
   ZoneScoped;
 
-  auto info = NetSceneSnapshotPacket{};
-  if (!deserialize_packet(self, NetPacketType::SceneSnapshot, info.sequence, info.state)) {
+  if (self.type != NetPacketType::SceneSnapshot) {
+    return nullopt;
+  }
+
+  thread_local auto raw_codec = SnapshotCodec{};
+
+  // Snapshots are bit packed by the codec, behind the zpp_bits type and a byte of flags.
+  auto bytes = std::span<const u8>(self.inner->data, self.inner->dataLength);
+  if (bytes.size() < 2) {
+    return nullopt;
+  }
+
+  auto info = NetSceneSnapshotPacket{.upsert = (bytes[1] & SNAPSHOT_FLAG_UPSERT) != 0};
+  bytes = bytes.subspan(2);
+  if (!(codec ? codec : &raw_codec)->decode(bytes, info.sequence, info.baseline, info.state)) {
     return nullopt;
   }
 
@@ -174,14 +190,13 @@ auto NetPacket::get_client_ack(this NetPacket& self) -> option<NetClientAckPacke
   return info;
 }
 
-auto NetPacket::get_rpc(this NetPacket& self) -> option<NetRPCPacket> {
+auto NetPacket::get_rpcs(this NetPacket& self) -> option<NetRPCReader> {
   ZoneScoped;
 
-  auto info = NetRPCPacket{};
-  if (!deserialize_packet(self, NetPacketType::RPC, info.proc_hash, info.parameters)) {
+  if (self.type != NetPacketType::RPC) {
     return nullopt;
   }
 
-  return info;
+  return NetRPCReader{.bytes = std::span<const u8>(self.inner->data, self.inner->dataLength)};
 }
 } // namespace ox
@@ -0,0 +1,273 @@
+#include "Networking/NetRPC.hpp"
+
+#include <cstring>
+#include <limits>
+
+#include "Networking/NetPacket.hpp"
+#include "Utils/Log.hpp"
+
+namespace ox {
+namespace {
+// Byte arrays start on this, relative to the start of the packet.
+constexpr auto RPC_BYTES_ALIGNMENT = 8_sz;
+
+template <typename T>
+auto write_value(std::vector<u8>& bytes, const T& value) -> void {
+  const auto offset = bytes.size();
+  bytes.resize(offset + sizeof(T));
+  std::memcpy(bytes.data() + offset, &value, sizeof(T));
+}
+
+template <typename T>
+auto read_value(std::span<const u8> bytes, usize& offset, T& value) -> bool {
+  if (bytes.size() - offset < sizeof(T)) {
+    return false;
+  }
+
+  std::memcpy(&value, bytes.data() + offset, sizeof(T));
+  offset += sizeof(T);
+  return true;
+}
+
+auto read_view(std::span<const u8> bytes, usize& offset, usize alignment, std::span<const u8>& view) -> bool {
+  auto size = 0_u32;
+  if (!read_value(bytes, offset, size)) {
+    return false;
+  }
+
+  offset = ox::align_up(offset, alignment);
+  if (offset > bytes.size() || bytes.size() - offset < size) {
+    return false;
+  }
+
+  view = bytes.subspan(offset, size);
+  offset += size;
+  return true;
+}
+} // namespace
+
+auto RPCArg::as_f32(this const RPCArg& self) -> option<const f32> {
+  const auto* v = std::get_if<f32>(&self.value);
+  if (!v) {
+    return nullopt;
+  }
+
+  return *v;
+}
+
+auto RPCArg::as_int64(this const RPCArg& self) -> option<const i64> {
+  const auto* v = std::get_if<i64>(&self.value);
+  if (!v) {
+    return nullopt;
+  }
+
+  return *v;
+}
+
+auto RPCArg::as_str(this const RPCArg& self) -> std::string_view {
+  const auto* v = std::get_if<std::string_view>(&self.value);
+  if (!v) {
+    return {};
+  }
+
+  return *v;
+}
+
+auto RPCArg::as_uuid(this const RPCArg& self) -> option<UUID> {
+  const auto* v = std::get_if<std::array<u8, 16>>(&self.value);
+  if (!v) {
+    return nullopt;
+  }
+
+  auto bytes = *v;
+  return UUID::from_bytes(bytes);
+}
+
+auto NetProcTable::hash(std::string_view identifier) -> u64 {
+  return ankerl::unordered_dense::detail::wyhash::hash(identifier.data(), identifier.size());
+}
+
+auto NetProcTable::add(this NetProcTable& self, std::string_view identifier, NetProcCallback&& cb) -> NetProcID {
+  ZoneScoped;
+
+  const auto proc_hash = hash(identifier);
+  if (auto it = self.ids.find(proc_hash); it != self.ids.end()) {
+    self.callbacks[it->second] = std::move(cb);
+    return it->second;
+  }
+
+  OX_ASSERT(self.callbacks.size() <= std::numeric_limits<NetProcID>::max(), "Too many procs registered.");
+  const auto id = static_cast<NetProcID>(self.callbacks.size());
+  self.callbacks.push_back(std::move(cb));
+  self.entries.push_back({.hash = proc_hash, .id = id});
+  self.ids.emplace(proc_hash, id);
+
+  return id;
+}
+
+auto NetProcTable::dispatch(this const NetProcTable& self, NetClientID caller, NetRPCReader reader) -> bool {
+  ZoneScoped;
+
+  auto call = NetRPCReader::Call{};
+  while (reader.next(call)) {
+    if (call.proc_id >= self.callbacks.size() || !self.callbacks[call.proc_id]) {
+      OX_LOG_ERROR("Peer is trying to call an invalid proc {}!", call.proc_id);
+      continue;
+    }
+
+    self.callbacks[call.proc_id](caller, std::span<const RPCArg>(call.args));
+  }
+
+  if (reader.failed) {
+    OX_LOG_ERROR("Received a malformed RPC packet.");
+  }
+
+  return !reader.failed;
+}
+
+auto NetRemoteProcs::assign(this NetRemoteProcs& self, std::span<const NetProcEntry> entries) -> void {
+  ZoneScoped;
+
+  self.ids.clear();
+  for (const auto& entry : entries) {
+    self.ids.emplace(entry.hash, entry.id);
+  }
+}
+
+auto NetRemoteProcs::find(this const NetRemoteProcs& self, std::string_view identifier) -> option<NetProcID> {
+  auto it = self.ids.find(NetProcTable::hash(identifier));
+  if (it == self.ids.end()) {
+    return nullopt;
+  }
+
+  return it->second;
+}
+
+auto NetRPCBatch::add(this NetRPCBatch& self, NetProcID proc_id, std::span<const RPCParameter> params) -> bool {
+  ZoneScoped;
+
+  if (params.size() > std::numeric_limits<u8>::max()) {
+    OX_LOG_ERROR("RPCs take at most {} parameters, got {}.", std::numeric_limits<u8>::max(), params.size());
+    return false;
+  }
+
+  if (self.bytes.empty()) {
+    self.bytes.push_back(static_cast<u8>(NetPacketType::RPC));
+  }
+
+  const auto call_start = self.bytes.size();
+  write_value(self.bytes, proc_id);
+  self.bytes.push_back(static_cast<u8>(params.size()));
+
+  auto write_view = [&](std::span<const u8> view, usize alignment) {
+    if (view.size() > std::numeric_limits<u32>::max()) {
+      return false;
+    }
+
+    write_value(self.bytes, static_cast<u32>(view.size()));
+    self.bytes.resize(ox::align_up(self.bytes.size(), alignment), 0);
+    self.bytes.insert(self.bytes.end(), view.begin(), view.end());
+    return true;
+  };
+
+  for (const auto& param : params) {
+    self.bytes.push_back(static_cast<u8>(param.value.index()));
+    const auto written = std::visit(
+      ox::match{
+        [](const std::monostate&) { return true; },
+        [&](const std::string& v) {
+          return write_view({reinterpret_cast<const u8*>(v.data()), v.size()}, 1);
+        },
+        [&](const std::vector<u8>& v) { return write_view(v, RPC_BYTES_ALIGNMENT); },
+        [&](const auto& v) {
+          write_value(self.bytes, v);
+          return true;
+        },
+      },
+      param.value
+    );
+
+    if (!written) {
+      OX_LOG_ERROR("RPC parameter is too large to send.");
+      self.bytes.resize(call_start);
+      return false;
+    }
+  }
+
+  self.call_count += 1;
+  return true;
+}
+
+auto NetRPCBatch::clear(this NetRPCBatch& self) -> void {
+  self.bytes.clear();
+  self.call_count = 0;
+}
+
+auto NetRPCReader::next(this NetRPCReader& self, Call& call) -> bool {
+  if (self.failed || self.offset >= self.bytes.size()) {
+    return false;
+  }
+
+  auto arg_count = 0_u8;
+  if (!read_value(self.bytes, self.offset, call.proc_id) || !read_value(self.bytes, self.offset, arg_count)) {
+    self.failed = true;
+    return false;
+  }
+
+  call.args.clear();
+  for (auto i = 0_u8; i < arg_count; i++) {
+    auto tag = 0_u8;
+    if (!read_value(self.bytes, self.offset, tag)) {
+      self.failed = true;
+      return false;
+    }
+
+    auto& arg = call.args.emplace_back();
+    auto ok = true;
+    switch (tag) {
+      case 0: {
+        arg.value = std::monostate{};
+      } break;
+      case 1: {
+        ok = read_value(self.bytes, self.offset, arg.value.emplace<u8>());
+      } break;
+      case 2: {
+        ok = read_value(self.bytes, self.offset, arg.value.emplace<u16>());
+      } break;
+      case 3: {
+        ok = read_value(self.bytes, self.offset, arg.value.emplace<i32>());
+      } break;
+      case 4: {
+        ok = read_value(self.bytes, self.offset, arg.value.emplace<i64>());
+      } break;
+      case 5: {
+        ok = read_value(self.bytes, self.offset, arg.value.emplace<f32>());
+      } break;
+      case 6: {
+        ok = read_value(self.bytes, self.offset, arg.value.emplace<f64>());
+      } break;
+      case 7: {
+        auto view = std::span<const u8>{};
+        ok = read_view(self.bytes, self.offset, 1, view);
+        arg.value = std::string_view(reinterpret_cast<const char*>(view.data()), view.size());
+      } break;
+      case 8: {
+        ok = read_value(self.bytes, self.offset, arg.value.emplace<std::array<u8, 16>>());
+      } break;
+      case 9: {
+        ok = read_view(self.bytes, self.offset, RPC_BYTES_ALIGNMENT, arg.value.emplace<std::span<const u8>>());
+      } break;
+      default: {
+        ok = false;
+      } break;
+    }
+
+    if (!ok) {
+      self.failed = true;
+      return false;
+    }
+  }
+
+  return true;
+}
+} // namespace ox
@@ -0,0 +1,285 @@
+#include "Networking/NetRelevancy.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <glm/geometric.hpp>
+
+#include "Scene/Components.hpp"
+
+namespace ox {
+namespace {
+constexpr auto CELL_BITS = 21_u64;
+constexpr auto CELL_MASK = (1_u64 << CELL_BITS) - 1;
+
+auto cell_coord(f32 value, f32 cell_size) -> i32 { return static_cast<i32>(std::floor(value / cell_size)); }
+
+auto cell_key(i32 x, i32 y, i32 z) -> u64 {
+  return (static_cast<u64>(x) & CELL_MASK) | ((static_cast<u64>(y) & CELL_MASK) << CELL_BITS) |
+         ((static_cast<u64>(z) & CELL_MASK) << (CELL_BITS * 2));
+}
+
+auto estimate_size(std::span<const SnapshotRecord> records) -> usize {
+  auto size = sizeof(u64);
+  for (const auto& record : records) {
+    size += sizeof(u64) + record.size;
+  }
+
+  return size;
+}
+} // namespace
+
+template <typename Fn>
+auto NetRelevancy::for_each_in_radius(this const NetRelevancy& self, glm::vec3 center, f32 radius, Fn&& fn) -> void {
+  const auto radius_sq = radius * radius;
+  const auto min = glm::ivec3(
+    cell_coord(center.x - radius, self.cell_size),
+    cell_coord(center.y - radius, self.cell_size),
+    cell_coord(center.z - radius, self.cell_size)
+  );
+  const auto max = glm::ivec3(
+    cell_coord(center.x + radius, self.cell_size),
+    cell_coord(center.y + radius, self.cell_size),
+    cell_coord(center.z + radius, self.cell_size)
+  );
+
+  const auto cell_count = static_cast<f64>(max.x - min.x + 1) * static_cast<f64>(max.y - min.y + 1) *
+                          static_cast<f64>(max.z - min.z + 1);
+  // Huge areas touch more cells than there are entities, a linear walk is cheaper then.
+  if (cell_count > static_cast<f64>(self.placements.size())) {
+    for (const auto& placement : self.placements) {
+      const auto offset = placement.position - center;
+      if (glm::dot(offset, offset) <= radius_sq) {
+        fn(placement, glm::length(offset));
+      }
+    }
+
+    return;
+  }
+
+  for (auto z = min.z; z <= max.z; z++) {
+    for (auto y = min.y; y <= max.y; y++) {
+      for (auto x = min.x; x <= max.x; x++) {
+        auto cell_it = self.grid.find(cell_key(x, y, z));
+        if (cell_it == self.grid.end()) {
+          continue;
+        }
+
+        for (auto index : cell_it->second) {
+          const auto& placement = self.placements[index];
+          const auto offset = placement.position - center;
+          if (glm::dot(offset, offset) <= radius_sq) {
+            fn(placement, glm::length(offset));
+          }
+        }
+      }
+    }
+  }
+}
+
+auto NetRelevancy::set_interest(this NetRelevancy& self, NetClientID client_id, const NetInterest& interest) -> void {
+  ZoneScoped;
+
+  self.clients[client_id].interest = interest;
+}
+
+auto NetRelevancy::has_interest(this const NetRelevancy& self, NetClientID client_id) -> bool {
+  return self.clients.contains(client_id);
+}
+
+auto NetRelevancy::remove_client(this NetRelevancy& self, NetClientID client_id) -> void {
+  ZoneScoped;
+
+  self.clients.erase(client_id);
+}
+
+auto NetRelevancy::update(this NetRelevancy& self, flecs::world& world, SceneSnapshotBuilder& builder) -> void {
+  ZoneScoped;
+
+  for (auto& [key, cell] : self.grid) {
+    cell.clear();
+  }
+  self.placements.clear();
+  self.unplaced.clear();
+
+  auto& frame = builder.current();
+  frame.index_rows();
+
+  const auto transform_id = world.id<TransformComponent>().raw_id();
+  for (auto table_index = 0_u32; table_index < frame.tables.size(); table_index++) {
+    const auto& table = frame.tables[table_index];
+    const auto entities = frame.table_entities(table);
+    const auto* transform_column = frame.find_column(table, transform_id);
+    for (auto row = 0_u32; row < table.row_count; row++) {
+      auto placement = Placement{.entity = entities[row], .row = {.table_index = table_index, .row = row}};
+      if (!transform_column || transform_column->size < sizeof(TransformComponent)) {
+        self.unplaced.push_back(placement);
+        continue;
+      }
+
+      const auto bytes = frame.element(*transform_column, row);
+      std::memcpy(&placement.position, bytes.data() + offsetof(TransformComponent, position), sizeof(glm::vec3));
+
+      const auto key = cell_key(
+        cell_coord(placement.position.x, self.cell_size),
+        cell_coord(placement.position.y, self.cell_size),
+        cell_coord(placement.position.z, self.cell_size)
+      );
+      self.grid[key].push_back(static_cast<u32>(self.placements.size()));
+      self.placements.push_back(placement);
+    }
+  }
+
+  // Cells nobody stands in anymore.
+  std::erase_if(self.grid, [](const auto& cell) { return cell.second.empty(); });
+}
+
+auto NetRelevancy::build(this NetRelevancy& self, SceneSnapshotBuilder& builder, NetClientID client_id)
+  -> const SnapshotDelta& {
+  ZoneScoped;
+
+  auto& delta = self.delta;
+  delta.clear();
+  auto client_it = self.clients.find(client_id);
+  if (client_it == self.clients.end()) {
+    return delta;
+  }
+
+  auto& client = client_it->second;
+  const auto slot = builder.current_sequence;
+  const auto frame_id = builder.frame_ids[slot];
+  auto& sent = client.sent[slot];
+  sent.frame_id = frame_id;
+  sent.entities.clear();
+  sent.removed.clear();
+
+  self.candidates.clear();
+  auto visit = [&](const Placement& placement, f32 distance) {
+    auto& track = client.tracks[placement.entity];
+    if (track.removing) {
+      // Came back before the removal got acked, the client may or may not still have it. Sent in full right
+      // away like a new entity, but still removed like a sent one if it leaves before that goes out.
+      track = EntityTrack{.priority = 1.0f, .sent = true};
+    }
+
+    const auto full_rate_distance = client.interest.radius * self.full_rate_fraction;
+    const auto falloff = std::max(client.interest.radius - full_rate_distance, 1e-6f);
+    const auto rate = 1.0f - std::max(distance - full_rate_distance, 0.0f) / falloff;
+    track.seen_frame = frame_id;
+    track.priority += std::max(rate, self.min_priority_rate);
+    if (!track.sent) {
+      // Whatever just came into view goes out right away.
+      track.priority = std::max(track.priority, 1.0f);
+    }
+    if (track.priority >= 1.0f) {
+      self.candidates.push_back({.entity = placement.entity, .row = placement.row, .priority = track.priority});
+    }
+  };
+
+  self.for_each_in_radius(client.interest.center, client.interest.radius, visit);
+  for (const auto& placement : self.unplaced) {
+    visit(placement, 0.0f);
+  }
+
+  // Whatever wasn't visited left the area or got destroyed.
+  self.dropped.clear();
+  for (auto& [entity, track] : client.tracks) {
+    if (track.seen_frame == frame_id) {
+      continue;
+    }
+
+    if (!track.sent) {
+      self.dropped.push_back(entity);
+      continue;
+    }
+
+    // Sent again every tick until the client acks one of them.
+    track.removing = true;
+    delta.removed_entities.push_back(entity);
+    sent.removed.push_back(entity);
+  }
+  for (auto entity : self.dropped) {
+    client.tracks.erase(entity);
+  }
+
+  std::ranges::sort(self.candidates, [](const Candidate& lhs, const Candidate& rhs) {
+    return lhs.priority > rhs.priority;
+  });
+
+  const auto& frame = builder.frames[slot];
+  auto used_bytes = 0_sz;
+  for (const auto& candidate : self.candidates) {
+    auto& track = client.tracks[candidate.entity];
+
+    const SnapshotFrame* base = nullptr;
+    if (track.acked_frame != 0 && builder.frame_ids[track.acked_slot] == track.acked_frame) {
+      auto& base_frame = builder.frames[track.acked_slot];
+      base_frame.index_rows();
+      base = &base_frame;
+    }
+
+    const auto first_record = delta.records.size();
+    if (!SceneSnapshotBuilder::diff_entity(base, frame, candidate.row, delta)) {
+      // Client is up to date with this one.
+      track.priority = 0.0f;
+      continue;
+    }
+
+    const auto entity_size = estimate_size(std::span(delta.records).subspan(first_record));
+    if (client.interest.budget_bytes != 0 && !sent.entities.empty() &&
+        used_bytes + entity_size > client.interest.budget_bytes) {
+      // Out of budget, the rest keep their priority and go first next tick.
+      delta.records.resize(first_record);
+      break;
+    }
+
+    used_bytes += entity_size;
+    track.priority = 0.0f;
+    track.sent = true;
+    sent.entities.push_back(candidate.entity);
+  }
+
+  return delta;
+}
+
+auto NetRelevancy::ack(this NetRelevancy& self, const SceneSnapshotBuilder& builder, NetClientID client_id, u8 sequence)
+  -> void {
+  ZoneScoped;
+
+  auto client_it = self.clients.find(client_id);
+  if (client_it == self.clients.end()) {
+    return;
+  }
+
+  auto& client = client_it->second;
+  const auto slot = static_cast<u8>(sequence % SceneSnapshotBuilder::MAX_SEQUENCES);
+  auto& sent = client.sent[slot];
+  const auto frame_id = builder.frame_ids[slot];
+  if (frame_id == 0 || sent.frame_id != frame_id) {
+    return;
+  }
+
+  for (auto entity : sent.entities) {
+    auto track_it = client.tracks.find(entity);
+    if (track_it == client.tracks.end() || track_it->second.removing) {
+      continue;
+    }
+
+    auto& track = track_it->second;
+    if (track.acked_frame < frame_id) {
+      track.acked_frame = frame_id;
+      track.acked_slot = slot;
+    }
+  }
+
+  for (auto entity : sent.removed) {
+    auto track_it = client.tracks.find(entity);
+    if (track_it != client.tracks.end() && track_it->second.removing) {
+      client.tracks.erase(track_it);
+    }
+  }
+
+  // Acks are only worth something once.
+  sent.frame_id = 0;
+}
+} // namespace ox
@@ -4,6 +4,7 @@
 
 #include "Core/App.hpp"
 #include "Core/Base.hpp"
+#include "Utils/FrameProfiler.hpp"
 #include "Utils/Log.hpp"
 
 namespace ox {
@@ -17,49 +18,6 @@ auto NetServer::set_tick_rate(this NetServer& self, f64 tick_rate) -> void {
 auto NetServer::tick(this NetServer& self, const Timestep& ts) -> bool {
   ZoneScoped;
 
-  auto event = ENetEvent{};
-  while (enet_host_service(self.local_host, &event, 0) > 0) {
-    switch (event.type) {
-      case ENET_EVENT_TYPE_CONNECT: {
-        ZoneScopedN("ENET_EVENT_TYPE_CONNECT");
-        OX_LOG_INFO("New client(peer: {}) connected.", static_cast<void*>(event.peer));
-      } break;
-      case ENET_EVENT_TYPE_DISCONNECT_TIMEOUT:
-      case ENET_EVENT_TYPE_DISCONNECT        : {
-        ZoneScopedN("ENET_EVENT_TYPE_DISCONNECT");
-        auto* remote_peer = event.peer;
-
-        auto client_id = NetClientID::Invalid;
-        if (remote_peer->data) {
-          client_id = static_cast<NetClientID>(reinterpret_cast<uptr>(remote_peer->data));
-        }
-
-        auto& es = App::get_event_system();
-        std::ignore = es.emit<ClientDisconnectEvent>({.client_id = client_id});
-
-        self.on_client_disconnect(client_id);
-        self.remote_clients.destroy_slot(client_id);
-
-        event.peer->data = nullptr;
-        OX_LOG_INFO("Client(peer: {}) disconnected.", static_cast<void*>(event.peer));
-      } break;
-      case ENET_EVENT_TYPE_RECEIVE: {
-        ZoneScopedN("ENET_EVENT_TYPE_RECEIVE");
-        OX_DEFER(&) { enet_packet_destroy(event.packet); };
-        auto packet = NetPacket::from_packet(event.packet);
-        auto* remote_peer = event.peer;
-        if (!packet.has_value()) {
-          OX_LOG_ERROR("Received a packet with bad data.");
-          break;
-        }
-
-        self.handle_packet(remote_peer, packet.value());
-      } break;
-      case ENET_EVENT_TYPE_NONE: {
-      } break;
-    }
-  }
-
   self.tick_accum += ts.get_millis();
   if (self.tick_accum >= self.tick_interval) {
     self.tick_accum -= self.tick_interval;
@@ -69,6 +27,62 @@ auto NetServer::tick(this NetServer& self, const Timestep& ts) -> bool {
   return false;
 }
 
+auto NetServer::dispatch(this NetServer& self) -> void {
+  ZoneScoped;
+
+  self.io->dispatch(self.io_stats, [&](NetEvent& event) { self.handle_event(event); });
+}
+
+auto NetServer::poll(this NetServer& self) -> void {
+  ZoneScoped;
+
+  self.io->service();
+  self.dispatch();
+}
+
+auto NetServer::handle_event(this NetServer& self, NetEvent& event) -> void {
+  ZoneScoped;
+
+  switch (event.kind) {
+    case NetEventKind::Connect: {
+      ZoneScopedN("NetEventKind::Connect");
+      OX_LOG_INFO("New client(peer: {}) connected.", static_cast<void*>(event.peer));
+    } break;
+    case NetEventKind::Disconnect: {
+      ZoneScopedN("NetEventKind::Disconnect");
+      auto* remote_peer = event.peer;
+
+      auto client_id = NetClientID::Invalid;
+      if (remote_peer->data) {
+        client_id = static_cast<NetClientID>(reinterpret_cast<uptr>(remote_peer->data));
+      }
+
+      auto& es = App::get_event_system();
+      std::ignore = es.emit<ClientDisconnectEvent>({.client_id = client_id});
+
+      self.on_client_disconnect(client_id);
+      self.snapshots.remove_client(client_id);
+      self.relevancy.remove_client(client_id);
+      self.remote_clients.destroy_slot(client_id);
+
+      event.peer->data = nullptr;
+      OX_LOG_INFO("Client(peer: {}) disconnected.", static_cast<void*>(event.peer));
+    } break;
+    case NetEventKind::Receive: {
+      ZoneScopedN("NetEventKind::Receive");
+      OX_DEFER(&) { enet_packet_destroy(event.packet); };
+      auto packet = NetPacket::from_packet(event.packet);
+      auto* remote_peer = event.peer;
+      if (!packet.has_value()) {
+        OX_LOG_ERROR("Received a packet with bad data.");
+        break;
+      }
+
+      self.handle_packet(remote_peer, packet.value());
+    } break;
+  }
+}
+
 auto NetServer::handle_packet(this NetServer& self, ENetPeer* remote_peer, NetPacket& packet) -> void {
   ZoneScoped;
 
@@ -88,11 +102,20 @@ auto NetServer::handle_packet(this NetServer& self, ENetPeer* remote_peer, NetPa
 
       // At this point client is accepted
       auto unique_net_id = self.net_id_counter++;
-      client_id = self.remote_clients.create_slot(NetClient(remote_peer, unique_net_id));
+      client_id = self.remote_clients.create_slot(NetClient(remote_peer, unique_net_id, self.io.get()));
       remote_peer->data = reinterpret_cast<void*>(static_cast<uptr>(client_id));
 
-      if (auto accept_handshake_packet = NetPacket::handshake({.version = 1, .net_id = unique_net_id})) {
-        auto client = self.remote_clients.slot(client_id);
+      auto client = self.remote_clients.slot(client_id);
+      client->remote_procs.assign(handshake->procs);
+
+      auto accept_handshake = NetHandshakePacket{
+        .version = 1,
+        .net_id = unique_net_id,
+        .procs = self.procs.entries,
+        .tick_interval_ms = self.tick_interval,
+        .snapshot_dictionary_id = self.snapshot_codec.dictionary_id(),
+      };
+      if (auto accept_handshake_packet = NetPacket::handshake(accept_handshake)) {
         client->send_reliable(accept_handshake_packet.value());
       }
 
@@ -117,36 +140,100 @@ auto NetServer::handle_packet(this NetServer& self, ENetPeer* remote_peer, NetPa
         return;
       }
 
+      self.snapshots.ack(client_id, client_ack->acked);
+      self.relevancy.ack(self.snapshots, client_id, client_ack->acked);
+
       auto& es = App::get_event_system();
       std::ignore = es.emit<ClientAckEvent>(ClientAckEvent(client_id, client_ack.value()));
 
       self.on_client_ack(client_id, client_ack.value());
     } break;
     case NetPacketType::RPC: {
-      auto rpc = packet.get_rpc();
-      if (!rpc.has_value()) {
-        return;
-      }
-
-      auto procs_it = self.rpcs.find(rpc->proc_hash);
-      if (procs_it == self.rpcs.end()) {
-        OX_LOG_ERROR("Client is trying to call an invalid proc!");
-        return;
+      if (auto rpcs = packet.get_rpcs()) {
+        self.procs.dispatch(client_id, rpcs.value());
       }
-
-      procs_it->second(client_id, std::span(rpc->parameters));
     } break;
     case NetPacketType::Unknown: {
-      OX_LOG_ERROR("Peer {} sent an unkown packet.");
+      OX_LOG_ERROR("Peer {} sent an unkown packet.", SlotMap_decode_id(client_id).index);
     } break;
   }
 }
 
-auto NetServer::register_proc(this NetServer& self, std::string_view identifier, NetRPCPacket::Callback&& cb) -> void {
+auto NetServer::register_proc(this NetServer& self, std::string_view identifier, NetProcCallback&& cb) -> NetProcID {
+  ZoneScoped;
+
+  return self.procs.add(identifier, std::move(cb));
+}
+
+auto NetServer::call(
+  this NetServer& self,
+  NetClientID client_id,
+  std::string_view identifier,
+  std::span<const RPCParameter> params,
+  bool reliable
+) -> bool {
+  ZoneScoped;
+
+  auto* client = self.remote_clients.slot(client_id);
+  if (!client) {
+    return false;
+  }
+
+  return client->call(identifier, params, reliable);
+}
+
+auto NetServer::flush_rpcs(this NetServer& self) -> void {
+  ZoneScoped;
+
+  self.remote_clients.for_each_active([](usize, NetClient& client) { client.flush_rpcs(); });
+}
+
+auto NetServer::send_snapshots(this NetServer& self, flecs::world& world) -> void {
+  ZoneScoped;
+
+  // Components are registered by the time the world is running, clients build theirs at handshake.
+  if (!self.snapshot_schema_built) {
+    self.snapshot_codec.schema.build(world);
+    self.snapshot_schema_built = true;
+  }
+
+  self.snapshots.capture(world);
+  OX_GAUGE_SET("net.clients", self.remote_clients.size());
+  if (self.relevancy.has_clients()) {
+    self.relevancy.update(world, self.snapshots);
+  }
+
+  const auto sequence = self.snapshots.current_sequence;
+  self.remote_clients.for_each_active([&](usize, NetClient& client) {
+    if (!client.remote_peer || !client.remote_peer->data) {
+      return;
+    }
+
+    auto client_id = static_cast<NetClientID>(reinterpret_cast<uptr>(client.remote_peer->data));
+    if (self.relevancy.has_interest(client_id)) {
+      const auto& delta = self.relevancy.build(self.snapshots, client_id);
+      if (auto packet = NetPacket::scene_snapshot(delta, sequence, nullopt, &self.snapshot_codec, true)) {
+        OX_COUNTER_ADD("net.snapshot_bytes", packet->inner->dataLength);
+        client.send_unreliable(packet.value());
+      }
+      return;
+    }
+
+    auto baseline = self.snapshots.baseline(client_id);
+    const auto& delta = self.snapshots.flat_delta(baseline);
+    if (auto packet = NetPacket::scene_snapshot(delta, sequence, baseline, &self.snapshot_codec)) {
+      OX_COUNTER_ADD("net.snapshot_bytes", packet->inner->dataLength);
+      client.send_unreliable(packet.value());
+    }
+  });
+
+  self.snapshots.advance();
+}
+
+auto NetServer::set_client_interest(this NetServer& self, NetClientID client_id, const NetInterest& interest) -> void {
   ZoneScoped;
 
-  auto hash = ankerl::unordered_dense::detail::wyhash::hash(identifier.data(), identifier.size());
-  self.rpcs.emplace(hash, std::move(cb));
+  self.relevancy.set_interest(client_id, interest);
 }
 
 } // namespace ox
@@ -0,0 +1,381 @@
+#include "Networking/NetTimeline.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "Scene/Components.hpp"
+
+namespace ox {
+namespace {
+// How fast the clock offset creeps back up after the fastest snapshot pulled it down, so drift
+// between the two clocks doesn't pile up.
+constexpr auto OFFSET_CREEP = 0.01;
+// Jitter follows spikes right away and only slowly forgets them.
+constexpr auto JITTER_DECAY = 0.01;
+
+auto wrap_sequence(i64 value) -> i64 {
+  constexpr auto count = static_cast<i64>(NetTimeline::MAX_FRAMES);
+  return ((value % count) + count) % count;
+}
+
+auto append_lerp_fields(
+  flecs::world& world,
+  flecs::entity_t type,
+  u32 offset,
+  flecs::entity_t vec3_id,
+  flecs::entity_t quat_id,
+  std::vector<NetLerpField>& fields
+) -> void {
+  if (type == vec3_id) {
+    fields.push_back({.kind = NetLerpKind::Vec3, .offset = offset});
+    return;
+  }
+
+  if (type == quat_id) {
+    fields.push_back({.kind = NetLerpKind::Quat, .offset = offset});
+    return;
+  }
+
+  const auto* meta_struct = ecs_get(world.c_ptr(), type, EcsStruct);
+  if (!meta_struct) {
+    return;
+  }
+
+  const auto* members = ecs_vec_first_t(&meta_struct->members, ecs_member_t);
+  const auto member_count = ecs_vec_count(&meta_struct->members);
+  for (auto i = 0; i < member_count; i++) {
+    const auto& member = members[i];
+    const auto* member_component = ecs_get(world.c_ptr(), member.type, EcsComponent);
+    if (!member_component) {
+      continue;
+    }
+
+    const auto element_count = std::max(member.count, 1);
+    for (auto element = 0; element < element_count; element++) {
+      const auto element_offset = offset + static_cast<u32>(member.offset + element * member_component->size);
+      append_lerp_fields(world, member.type, element_offset, vec3_id, quat_id, fields);
+    }
+  }
+}
+
+// Full states never carry removals, they are applied right away.
+auto apply_delta(SceneState& full, const SceneState& delta) -> void {
+  for (const auto& [entity_id, entity_delta] : delta.entities) {
+    auto& entity = full.entities[entity_id];
+    entity.entity_id = entity_id;
+    for (const auto& [component_id, component] : entity_delta.components) {
+      entity.components[component_id] = component;
+    }
+
+    for (const auto component_id : entity_delta.removed_components) {
+      entity.components.erase(component_id);
+    }
+  }
+
+  for (const auto entity_id : delta.removed_entities) {
+    full.entities.erase(entity_id);
+  }
+}
+} // namespace
+
+auto NetInterpolationSchema::build(this NetInterpolationSchema& self, flecs::world& world) -> void {
+  ZoneScoped;
+
+  self.components.clear();
+
+  const auto vec3_id = world.component<glm::vec3>().id();
+  const auto quat_id = world.component<glm::quat>().id();
+  world.query_builder()
+    .with<Networked>() //
+    .each([&](flecs::entity component) {
+      auto fields = std::vector<NetLerpField>{};
+      append_lerp_fields(world, component.id(), 0, vec3_id, quat_id, fields);
+      if (!fields.empty()) {
+        self.components.emplace(component.raw_id(), std::move(fields));
+      }
+    });
+}
+
+auto NetInterpolationSchema::find(this const NetInterpolationSchema& self, flecs::id_t component_id)
+  -> std::span<const NetLerpField> {
+  auto it = self.components.find(component_id);
+  if (it == self.components.end()) {
+    return {};
+  }
+
+  return it->second;
+}
+
+auto NetInterpolationSchema::blend(
+  std::span<const NetLerpField> fields, std::span<const u8> from, std::span<const u8> to, f32 t, std::span<u8> out
+) -> void {
+  const auto size = std::min({from.size(), to.size(), out.size()});
+  for (const auto& field : fields) {
+    switch (field.kind) {
+      case NetLerpKind::Vec3: {
+        if (field.offset + sizeof(glm::vec3) > size) {
+          continue;
+        }
+
+        auto a = glm::vec3{};
+        auto b = glm::vec3{};
+        std::memcpy(&a, from.data() + field.offset, sizeof(glm::vec3));
+        std::memcpy(&b, to.data() + field.offset, sizeof(glm::vec3));
+        const auto value = glm::mix(a, b, t);
+        std::memcpy(out.data() + field.offset, &value, sizeof(glm::vec3));
+      } break;
+      case NetLerpKind::Quat: {
+        if (field.offset + sizeof(glm::quat) > size) {
+          continue;
+        }
+
+        auto a = glm::quat{};
+        auto b = glm::quat{};
+        std::memcpy(&a, from.data() + field.offset, sizeof(glm::quat));
+        std::memcpy(&b, to.data() + field.offset, sizeof(glm::quat));
+        const auto value = glm::slerp(a, b, t);
+        std::memcpy(out.data() + field.offset, &value, sizeof(glm::quat));
+      } break;
+    }
+  }
+}
+
+auto NetTimeline::reset(this NetTimeline& self) -> void {
+  ZoneScoped;
+
+  for (auto& frame : self.frames) {
+    frame.reset();
+  }
+
+  self.latest_tick = nullopt;
+  self.sampled_pair = nullopt;
+  self.clock_offset = nullopt;
+  self.rejected_in_row = 0;
+  self.playback = 0.0;
+  self.stats = {};
+}
+
+auto NetTimeline::advance(this NetTimeline& self, f64 delta_ms) -> void {
+  ZoneScoped;
+
+  self.local_time += delta_ms;
+  if (!self.clock_offset.has_value()) {
+    return;
+  }
+
+  const auto delay = self.target_delay();
+  const auto target = self.local_time - self.clock_offset.value() - delay;
+  const auto error = target - (self.playback + delta_ms);
+  if (std::abs(error) > delay) {
+    // Too far off to drift there, e.g. after the first snapshots were all slow ones.
+    self.playback = target;
+  } else {
+    const auto scale = 1.0 + std::clamp(error / delay, -self.max_time_scale, self.max_time_scale);
+    self.playback += delta_ms * scale;
+  }
+
+  self.stats.delay_ms = self.local_time - self.clock_offset.value() - self.playback;
+}
+
+auto NetTimeline::push(
+  this NetTimeline& self, u8 sequence, option<u8> baseline, const SceneState& state, bool upsert
+) -> bool {
+  ZoneScoped;
+
+  // The clock got lost somehow (server restart, long stall), start over instead of rejecting forever.
+  if (self.rejected_in_row >= MAX_FRAMES) {
+    self.reset();
+  }
+
+  const auto tick = self.unwrap(sequence);
+  self.update_clock(tick);
+
+  auto& slot = self.frames[static_cast<usize>(wrap_sequence(tick))];
+  if (slot.has_value() && slot->tick == tick) {
+    return true;
+  }
+
+  const auto frame_end_ms = static_cast<f64>(tick + 1) * self.tick_interval_ms;
+  if ((slot.has_value() && slot->tick > tick) || frame_end_ms < self.playback) {
+    self.stats.late += 1;
+    self.rejected_in_row += 1;
+    return false;
+  }
+
+  auto resolved = SceneState{};
+  if (baseline.has_value()) {
+    const auto base_tick = tick - wrap_sequence(static_cast<i64>(sequence) - baseline.value());
+    const auto* base = self.find_frame(base_tick);
+    if (base_tick == tick || !base) {
+      self.stats.unresolved += 1;
+      self.rejected_in_row += 1;
+      return false;
+    }
+
+    resolved = base->state;
+  } else if (upsert) {
+    // Area of interest snapshots only carry what changed around the client, the rest is still there.
+    const Frame* previous = nullptr;
+    for (const auto& frame : self.frames) {
+      if (frame.has_value() && frame->tick < tick && (!previous || frame->tick > previous->tick)) {
+        previous = &frame.value();
+      }
+    }
+
+    if (previous) {
+      resolved = previous->state;
+    }
+  }
+
+  apply_delta(resolved, state);
+  slot = Frame{.tick = tick, .state = std::move(resolved)};
+  self.latest_tick = std::max(self.latest_tick.value_or(tick), tick);
+  self.rejected_in_row = 0;
+
+  return true;
+}
+
+auto NetTimeline::sample(this NetTimeline& self, SceneState& out) -> bool {
+  ZoneScoped;
+
+  const Frame* from = nullptr;
+  const Frame* to = nullptr;
+  auto buffered = 0_u32;
+  for (const auto& frame : self.frames) {
+    if (!frame.has_value()) {
+      continue;
+    }
+
+    if (static_cast<f64>(frame->tick) * self.tick_interval_ms <= self.playback) {
+      if (!from || frame->tick > from->tick) {
+        from = &frame.value();
+      }
+    } else {
+      buffered += 1;
+      if (!to || frame->tick < to->tick) {
+        to = &frame.value();
+      }
+    }
+  }
+
+  self.stats.buffered = buffered;
+  if (!from && !to) {
+    self.sampled_pair = nullopt;
+    out.clear();
+    return false;
+  }
+
+  // Buffered frames never change under the same tick, so the same pair sampled into the same state has
+  // everything but the blended fields in place already.
+  const auto pair = SampledPair{
+    .from = from ? option<i64>(from->tick) : nullopt,
+    .to = to ? option<i64>(to->tick) : nullopt,
+  };
+  const auto is_same_pair = self.sampled_pair == pair && self.sampled_out == &out;
+  self.sampled_pair = pair;
+  self.sampled_out = &out;
+
+  // Nothing newer arrived in time, hold the last one rather than guessing.
+  if (!to) {
+    self.stats.starved += 1;
+    if (!is_same_pair) {
+      out.entities = from->state.entities;
+    }
+    return true;
+  }
+
+  if (!is_same_pair) {
+    // Assigned over the previous sample, which keeps the buffers it already has.
+    out.entities = to->state.entities;
+  }
+
+  if (!from) {
+    return true;
+  }
+
+  const auto from_ms = static_cast<f64>(from->tick) * self.tick_interval_ms;
+  const auto span_ms = static_cast<f64>(to->tick - from->tick) * self.tick_interval_ms;
+  const auto t = static_cast<f32>(std::clamp((self.playback - from_ms) / span_ms, 0.0, 1.0));
+
+  // `out` is a copy of `to`, entries line up.
+  auto to_entity = to->state.entities.begin();
+  for (auto& [entity_id, sampled] : out.entities) {
+    const auto& entity = (to_entity++)->second;
+    auto from_entity = from->state.entities.find(entity_id);
+    if (from_entity == from->state.entities.end()) {
+      continue;
+    }
+
+    auto to_component = entity.components.begin();
+    for (auto& [component_id, component] : sampled.components) {
+      const auto& to_buffer = (to_component++)->second.buffer;
+      const auto fields = self.schema.find(component_id);
+      if (fields.empty()) {
+        continue;
+      }
+
+      auto from_component = from_entity->second.components.find(component_id);
+      if (from_component == from_entity->second.components.end()) {
+        continue;
+      }
+
+      NetInterpolationSchema::blend(fields, from_component->second.buffer, to_buffer, t, component.buffer);
+    }
+  }
+
+  return true;
+}
+
+auto NetTimeline::find_frame(this const NetTimeline& self, i64 tick) -> const Frame* {
+  const auto& slot = self.frames[static_cast<usize>(wrap_sequence(tick))];
+  if (!slot.has_value() || slot->tick != tick) {
+    return nullptr;
+  }
+
+  return &slot.value();
+}
+
+auto NetTimeline::unwrap(this const NetTimeline& self, u8 sequence) -> i64 {
+  // Nearest tick with this sequence to where the server should be right now, or to the newest one
+  // before the clock is known.
+  auto reference = self.latest_tick.value_or(sequence);
+  if (self.clock_offset.has_value()) {
+    reference = std::llround((self.local_time - self.clock_offset.value()) / self.tick_interval_ms);
+  }
+
+  auto distance = wrap_sequence(static_cast<i64>(sequence) - reference);
+  if (distance >= static_cast<i64>(MAX_FRAMES / 2)) {
+    distance -= static_cast<i64>(MAX_FRAMES);
+  }
+
+  return reference + distance;
+}
+
+auto NetTimeline::target_delay(this const NetTimeline& self) -> f64 {
+  const auto delay = self.min_delay_ticks * self.tick_interval_ms + self.jitter_scale * self.stats.jitter_ms;
+  return std::min(delay, self.max_delay_ms);
+}
+
+auto NetTimeline::update_clock(this NetTimeline& self, i64 tick) -> void {
+  const auto server_ms = static_cast<f64>(tick) * self.tick_interval_ms;
+  const auto offset = self.local_time - server_ms;
+  if (!self.clock_offset.has_value()) {
+    self.clock_offset = offset;
+    self.playback = server_ms - self.target_delay();
+    self.stats.delay_ms = self.target_delay();
+    return;
+  }
+
+  // Lateness is measured against the fastest snapshots, anything faster becomes the new reference.
+  const auto deviation = offset - self.clock_offset.value();
+  self.clock_offset = self.clock_offset.value() + (deviation < 0.0 ? deviation : deviation * OFFSET_CREEP);
+
+  const auto lateness = std::abs(deviation);
+  if (lateness > self.stats.jitter_ms) {
+    self.stats.jitter_ms = lateness;
+  } else {
+    self.stats.jitter_ms += (lateness - self.stats.jitter_ms) * JITTER_DECAY;
+  }
+}
+} // namespace ox
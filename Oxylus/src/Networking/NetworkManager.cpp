@@ -1,11 +1,13 @@
 #include "Networking/NetworkManager.hpp"
 
+#include <chrono>
 #include <enet.h>
 
+#include "OS/OS.hpp"
 #include "Utils/Log.hpp"
 
 namespace ox {
-auto NetworkManager::init(this NetworkManager&) -> std::expected<void, std::string> {
+auto NetworkManager::init(this NetworkManager& self) -> std::expected<void, std::string> {
   ZoneScoped;
 
   // TODO: There is also `_with_callbacks` version to controll allocations ourselves
@@ -13,6 +15,10 @@ auto NetworkManager::init(this NetworkManager&) -> std::expected<void, std::stri
     return std::unexpected("An error occurred while initializing ENet");
   }
 
+  if (self.threaded) {
+    self.io_thread = std::jthread([&self](std::stop_token stop_token) { self.io_loop(stop_token); });
+  }
+
   return {};
 }
 
@@ -22,6 +28,11 @@ auto NetworkManager::deinit(this NetworkManager& self) -> std::expected<void, st
   OX_ASSERT(self.servers.empty());
   OX_ASSERT(self.clients.empty());
 
+  if (self.io_thread.joinable()) {
+    self.io_thread.request_stop();
+    self.io_thread.join();
+  }
+
   enet_deinitialize();
 
   return {};
@@ -29,6 +40,68 @@ auto NetworkManager::deinit(this NetworkManager& self) -> std::expected<void, st
 
 auto NetworkManager::update(this NetworkManager&, const Timestep&) -> void { ZoneScoped; }
 
+auto NetworkManager::dispatch(this NetworkManager& self) -> void {
+  ZoneScoped;
+
+  // Everything called last frame goes out first, one packet per channel and peer, inline hosts then
+  // send it right away while servicing.
+  for (auto& server : self.servers) {
+    server->flush_rpcs();
+  }
+  for (auto& client : self.clients) {
+    client->flush_rpcs();
+  }
+
+  const auto inline_service = !self.io_thread.joinable();
+  for (auto& server : self.servers) {
+    if (inline_service) {
+      server->poll();
+    } else {
+      server->dispatch();
+    }
+  }
+
+  for (auto& client : self.clients) {
+    if (inline_service) {
+      client->poll();
+    } else {
+      client->dispatch();
+    }
+  }
+}
+
+auto NetworkManager::io_loop(this NetworkManager& self, std::stop_token stop_token) -> void {
+  os::set_thread_name("Network I/O");
+  loguru::set_thread_name("Network I/O");
+
+  while (!stop_token.stop_requested()) {
+    {
+      ZoneScopedN("NetworkManager::io_pass");
+      auto lock = std::unique_lock(self.io_hosts_mutex);
+      for (auto* io : self.io_hosts) {
+        io->service();
+      }
+    }
+
+    std::this_thread::sleep_for(std::chrono::microseconds(self.io_interval_us));
+  }
+}
+
+auto NetworkManager::add_io_host(this NetworkManager& self, NetHostIO* io) -> void {
+  ZoneScoped;
+
+  auto lock = std::unique_lock(self.io_hosts_mutex);
+  self.io_hosts.push_back(io);
+}
+
+auto NetworkManager::remove_io_host(this NetworkManager& self, NetHostIO* io) -> void {
+  ZoneScoped;
+
+  // Once this returns the I/O thread is done with the host and it can be destroyed.
+  auto lock = std::unique_lock(self.io_hosts_mutex);
+  std::erase(self.io_hosts, io);
+}
+
 auto NetworkManager::create_server_handle(this NetworkManager& self, u16 port, u32 max_clients) -> ENetHost* {
   ZoneScoped;
 
@@ -69,6 +142,7 @@ auto NetworkManager::create_client_handle(this NetworkManager& self) -> ENetHost
 auto NetworkManager::destroy_server(this NetworkManager& self, NetServer* server) -> void {
   ZoneScoped;
 
+  self.remove_io_host(server->io.get());
   enet_host_destroy(server->local_host);
   std::erase_if(self.servers, [&](std::unique_ptr<NetServer>& v) { return v.get() == server; });
 
@@ -78,6 +152,7 @@ auto NetworkManager::destroy_server(this NetworkManager& self, NetServer* server
 auto NetworkManager::destroy_client(this NetworkManager& self, NetClient* client) -> void {
   ZoneScoped;
 
+  self.remove_io_host(client->io);
   client->disconnect(true);
   enet_host_destroy(client->local_host);
   std::erase_if(self.clients, [&](std::unique_ptr<NetClient>& v) { return v.get() == client; });
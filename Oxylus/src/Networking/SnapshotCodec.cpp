@@ -0,0 +1,602 @@
+#include "Networking/SnapshotCodec.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <tuple>
+#include <zdict.h>
+#include <zstd.h>
+
+#include "OS/File.hpp"
+#include "Scene/Components.hpp"
+#include "Utils/Log.hpp"
+
+namespace ox {
+namespace {
+constexpr auto FLAG_COMPRESSED = 1_u8 << 0;
+constexpr auto QUAT_RANGE = 0.70710678f; // the three smallest components of a unit quaternion stay within 1/sqrt(2)
+constexpr auto QUAT_MAX_VALUE = (1_u32 << SnapshotCodec::QUAT_COMPONENT_BITS) - 1;
+
+auto append_fields(
+  flecs::world& world,
+  flecs::entity type,
+  u32 offset,
+  f32 precision,
+  flecs::entity_t quat_id,
+  std::vector<SnapshotField>& fields
+) -> bool {
+  const auto* component = ecs_get(world.c_ptr(), type.id(), EcsComponent);
+  if (!component || component->size <= 0) {
+    return false;
+  }
+
+  const auto size = static_cast<u32>(component->size);
+  if (type.id() == quat_id) {
+    fields.push_back({.kind = SnapshotFieldKind::Quat, .offset = offset, .size = size});
+    return true;
+  }
+
+  if (const auto* primitive = ecs_get(world.c_ptr(), type.id(), EcsPrimitive)) {
+    if (primitive->kind == EcsBool) {
+      fields.push_back({.kind = SnapshotFieldKind::Bool, .offset = offset, .size = size});
+    } else if (primitive->kind == EcsF32 && precision > 0.0f) {
+      fields.push_back({.kind = SnapshotFieldKind::Fixed, .offset = offset, .size = size, .precision = precision});
+    } else {
+      fields.push_back({.kind = SnapshotFieldKind::Raw, .offset = offset, .size = size});
+    }
+
+    return true;
+  }
+
+  const auto* meta_struct = ecs_get(world.c_ptr(), type.id(), EcsStruct);
+  if (!meta_struct) {
+    // Enums, opaque types and everything else flecs can't look into.
+    fields.push_back({.kind = SnapshotFieldKind::Raw, .offset = offset, .size = size});
+    return true;
+  }
+
+  const auto* members = ecs_vec_first_t(&meta_struct->members, ecs_member_t);
+  const auto member_count = ecs_vec_count(&meta_struct->members);
+  for (auto i = 0; i < member_count; i++) {
+    const auto& member = members[i];
+    auto member_precision = precision;
+    if (auto member_entity = type.lookup(member.name)) {
+      if (const auto* hint = member_entity.try_get<NetQuantize>()) {
+        member_precision = hint->precision;
+      }
+    }
+
+    const auto* member_component = ecs_get(world.c_ptr(), member.type, EcsComponent);
+    if (!member_component) {
+      return false;
+    }
+
+    const auto element_count = std::max(member.count, 1);
+    for (auto element = 0; element < element_count; element++) {
+      const auto element_offset = offset + static_cast<u32>(member.offset + element * member_component->size);
+      if (!append_fields(world, world.entity(member.type), element_offset, member_precision, quat_id, fields)) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+auto quantize(f32 value, f32 precision) -> i64 {
+  const auto scaled = std::round(static_cast<f64>(value) / precision);
+  if (!std::isfinite(scaled)) {
+    return 0;
+  }
+
+  return static_cast<i64>(std::clamp(scaled, -0x1p62, 0x1p62));
+}
+
+auto write_quat(BitWriter& writer, std::span<const u8> bytes) -> void {
+  auto q = std::array<f32, 4>{};
+  std::memcpy(q.data(), bytes.data(), sizeof(q));
+
+  const auto length = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+  if (!(length > 1e-6f) || !std::isfinite(length)) {
+    q = {0.0f, 0.0f, 0.0f, 1.0f};
+  } else {
+    for (auto& v : q) {
+      v /= length;
+    }
+  }
+
+  auto largest = 0_u32;
+  for (auto i = 1_u32; i < 4; i++) {
+    if (std::abs(q[i]) > std::abs(q[largest])) {
+      largest = i;
+    }
+  }
+
+  // q and -q are the same rotation, flipping keeps the dropped component positive.
+  const auto sign = q[largest] < 0.0f ? -1.0f : 1.0f;
+  writer.write_bits(largest, 2);
+  for (auto i = 0_u32; i < 4; i++) {
+    if (i == largest) {
+      continue;
+    }
+
+    const auto v = std::clamp(q[i] * sign, -QUAT_RANGE, QUAT_RANGE);
+    const auto normalized = (v + QUAT_RANGE) / (2.0f * QUAT_RANGE);
+    writer.write_bits(static_cast<u32>(std::round(normalized * QUAT_MAX_VALUE)), SnapshotCodec::QUAT_COMPONENT_BITS);
+  }
+}
+
+auto read_quat(BitReader& reader, std::span<u8> bytes) -> void {
+  auto q = std::array<f32, 4>{};
+  const auto largest = static_cast<u32>(reader.read_bits(2));
+  auto sum = 0.0f;
+  for (auto i = 0_u32; i < 4; i++) {
+    if (i == largest) {
+      continue;
+    }
+
+    const auto value = static_cast<f32>(reader.read_bits(SnapshotCodec::QUAT_COMPONENT_BITS));
+    q[i] = value / QUAT_MAX_VALUE * (2.0f * QUAT_RANGE) - QUAT_RANGE;
+    sum += q[i] * q[i];
+  }
+
+  q[largest] = std::sqrt(std::max(0.0f, 1.0f - sum));
+  std::memcpy(bytes.data(), q.data(), sizeof(q));
+}
+
+auto write_fields(BitWriter& writer, const SnapshotComponentLayout& layout, std::span<const u8> buffer) -> void {
+  for (const auto& field : layout.fields) {
+    const auto bytes = buffer.subspan(field.offset, field.size);
+    switch (field.kind) {
+      case SnapshotFieldKind::Raw  : writer.write_bytes(bytes); break;
+      case SnapshotFieldKind::Bool : writer.write_bool(bytes[0] != 0); break;
+      case SnapshotFieldKind::Fixed: {
+        auto value = 0.0f;
+        std::memcpy(&value, bytes.data(), sizeof(f32));
+        writer.write_zigzag(quantize(value, field.precision));
+      } break;
+      case SnapshotFieldKind::Quat: write_quat(writer, bytes); break;
+    }
+  }
+}
+
+auto read_fields(BitReader& reader, const SnapshotComponentLayout& layout, std::span<u8> buffer) -> void {
+  for (const auto& field : layout.fields) {
+    auto bytes = buffer.subspan(field.offset, field.size);
+    switch (field.kind) {
+      case SnapshotFieldKind::Raw  : reader.read_bytes(bytes); break;
+      case SnapshotFieldKind::Bool : bytes[0] = reader.read_bool() ? 1 : 0; break;
+      case SnapshotFieldKind::Fixed: {
+        const auto value = static_cast<f32>(static_cast<f64>(reader.read_zigzag()) * field.precision);
+        std::memcpy(bytes.data(), &value, sizeof(f32));
+      } break;
+      case SnapshotFieldKind::Quat: read_quat(reader, bytes); break;
+    }
+  }
+}
+
+auto write_component(
+  BitWriter& writer, const SnapshotSchema& schema, flecs::id_t component_id, std::span<const u8> buffer
+) -> void {
+  writer.write_varint(component_id);
+
+  const auto is_tag = buffer.empty();
+  writer.write_bool(is_tag);
+  if (is_tag) {
+    return;
+  }
+
+  const auto* layout = schema.find(component_id);
+  const auto packed = layout != nullptr && layout->size == buffer.size();
+  writer.write_bool(packed);
+  if (packed) {
+    write_fields(writer, *layout, buffer);
+  } else {
+    writer.write_varint(buffer.size());
+    writer.write_bytes(buffer);
+  }
+}
+
+// Every counted element takes at least a bit, anything claiming more than that is garbage.
+auto read_count(BitReader& reader) -> option<usize> {
+  const auto count = reader.read_varint();
+  if (reader.failed || count > reader.remaining_bits()) {
+    return nullopt;
+  }
+
+  return static_cast<usize>(count);
+}
+} // namespace
+
+auto ZstdContextDeleter::operator()(ZSTD_CCtx* ctx) const -> void { ZSTD_freeCCtx(ctx); }
+auto ZstdContextDeleter::operator()(ZSTD_DCtx* ctx) const -> void { ZSTD_freeDCtx(ctx); }
+auto ZstdContextDeleter::operator()(ZSTD_CDict* dict) const -> void { ZSTD_freeCDict(dict); }
+auto ZstdContextDeleter::operator()(ZSTD_DDict* dict) const -> void { ZSTD_freeDDict(dict); }
+
+auto SnapshotSchema::build(this SnapshotSchema& self, flecs::world& world) -> void {
+  ZoneScoped;
+
+  self.components.clear();
+
+  const auto quat_id = world.component<glm::quat>().id();
+  world.query_builder()
+    .with<Networked>() //
+    .each([&](flecs::entity component) {
+      auto layout = SnapshotComponentLayout{};
+      if (!append_fields(world, component, 0, 0.0f, quat_id, layout.fields)) {
+        return;
+      }
+
+      layout.size = static_cast<u32>(component.get<flecs::Component>().size);
+
+      // Neighbouring raw fields are copied in one go.
+      auto merged = std::vector<SnapshotField>{};
+      for (const auto& field : layout.fields) {
+        if (!merged.empty() && field.kind == SnapshotFieldKind::Raw && merged.back().kind == SnapshotFieldKind::Raw &&
+            merged.back().offset + merged.back().size == field.offset) {
+          merged.back().size += field.size;
+          continue;
+        }
+
+        merged.push_back(field);
+      }
+
+      layout.fields = std::move(merged);
+      self.components.emplace(component.raw_id(), std::move(layout));
+    });
+}
+
+auto SnapshotSchema::find(this const SnapshotSchema& self, flecs::id_t component_id) -> const SnapshotComponentLayout* {
+  auto it = self.components.find(component_id);
+  if (it == self.components.end()) {
+    return nullptr;
+  }
+
+  return &it->second;
+}
+
+auto SnapshotCodec::configure(this SnapshotCodec& self, const SnapshotCodecConfig& config) -> bool {
+  ZoneScoped;
+
+  self.compress = config.compress;
+  self.compression_level = config.compression_level;
+  if (config.dictionary_path.empty()) {
+    self.set_dictionary({});
+    return true;
+  }
+
+  const auto dictionary = File::to_bytes(config.dictionary_path);
+  if (dictionary.empty()) {
+    OX_LOG_ERROR("Failed to read snapshot dictionary {}!", config.dictionary_path);
+    self.set_dictionary({});
+    return false;
+  }
+
+  self.set_dictionary(dictionary);
+  return self.compress_dict != nullptr;
+}
+
+auto SnapshotCodec::set_dictionary(this SnapshotCodec& self, std::span<const u8> dictionary) -> void {
+  ZoneScoped;
+
+  self.compress_dict.reset();
+  self.decompress_dict.reset();
+  self.dict_id = 0;
+  if (dictionary.empty()) {
+    return;
+  }
+
+  self.compress_dict.reset(ZSTD_createCDict(dictionary.data(), dictionary.size(), self.compression_level));
+  self.decompress_dict.reset(ZSTD_createDDict(dictionary.data(), dictionary.size()));
+  if (!self.compress_dict || !self.decompress_dict) {
+    OX_LOG_ERROR("Failed to create snapshot compression dictionary!");
+    self.compress_dict.reset();
+    self.decompress_dict.reset();
+    return;
+  }
+
+  self.dict_id = ZSTD_getDictID_fromDict(dictionary.data(), dictionary.size());
+}
+
+auto SnapshotCodec::train_dictionary(std::span<const std::vector<u8>> samples, usize dictionary_size)
+  -> std::vector<u8> {
+  ZoneScoped;
+
+  auto joined = std::vector<u8>{};
+  auto sizes = std::vector<usize>{};
+  for (const auto& sample : samples) {
+    joined.insert(joined.end(), sample.begin(), sample.end());
+    sizes.push_back(sample.size());
+  }
+
+  auto dictionary = std::vector<u8>(dictionary_size);
+  const auto result = ZDICT_trainFromBuffer(
+    dictionary.data(), dictionary.size(), joined.data(), sizes.data(), static_cast<u32>(sizes.size())
+  );
+  if (ZDICT_isError(result)) {
+    OX_LOG_ERROR("Failed to train snapshot dictionary: {}", ZDICT_getErrorName(result));
+    return {};
+  }
+
+  dictionary.resize(result);
+  return dictionary;
+}
+
+auto SnapshotCodec::encode(
+  this SnapshotCodec& self, const SceneState& state, u8 sequence, option<u8> baseline, std::vector<u8>& out
+) -> bool {
+  ZoneScoped;
+
+  self.encode_state(state, sequence, baseline);
+  return self.finish_encode(out);
+}
+
+auto SnapshotCodec::encode(
+  this SnapshotCodec& self, const SnapshotDelta& delta, u8 sequence, option<u8> baseline, std::vector<u8>& out
+) -> bool {
+  ZoneScoped;
+
+  self.encode_delta(delta, sequence, baseline);
+  return self.finish_encode(out);
+}
+
+auto SnapshotCodec::finish_encode(this SnapshotCodec& self, std::vector<u8>& out) -> bool {
+  ZoneScoped;
+
+  const auto packed = self.writer.flush();
+
+  if (!self.compress) {
+    out.push_back(0);
+    out.insert(out.end(), packed.begin(), packed.end());
+    return true;
+  }
+
+  if (!self.compress_ctx) {
+    self.compress_ctx.reset(ZSTD_createCCtx());
+  }
+
+  const auto header_size = out.size();
+  out.resize(header_size + 1 + ZSTD_compressBound(packed.size()));
+  out[header_size] = FLAG_COMPRESSED;
+
+  auto* dst = out.data() + header_size + 1;
+  const auto dst_capacity = out.size() - header_size - 1;
+  const auto written = self.compress_dict
+                         ? ZSTD_compress_usingCDict(
+                             self.compress_ctx.get(), dst, dst_capacity, packed.data(), packed.size(), self.compress_dict.get()
+                           )
+                         : ZSTD_compressCCtx(
+                             self.compress_ctx.get(), dst, dst_capacity, packed.data(), packed.size(), self.compression_level
+                           );
+  if (ZSTD_isError(written)) {
+    OX_LOG_ERROR("Failed to compress snapshot: {}", ZSTD_getErrorName(written));
+    out.resize(header_size);
+    return false;
+  }
+
+  out.resize(header_size + 1 + written);
+  return true;
+}
+
+auto SnapshotCodec::decode(
+  this SnapshotCodec& self, std::span<const u8> bytes, u8& sequence, option<u8>& baseline, SceneState& state
+) -> bool {
+  ZoneScoped;
+
+  if (bytes.empty()) {
+    return false;
+  }
+
+  const auto flags = bytes[0];
+  const auto payload = bytes.subspan(1);
+  if ((flags & FLAG_COMPRESSED) == 0) {
+    return self.decode_state(payload, sequence, baseline, state);
+  }
+
+  const auto content_size = ZSTD_getFrameContentSize(payload.data(), payload.size());
+  if (content_size == ZSTD_CONTENTSIZE_ERROR || content_size == ZSTD_CONTENTSIZE_UNKNOWN ||
+      content_size > MAX_DECODED_SIZE) {
+    return false;
+  }
+
+  if (!self.decompress_ctx) {
+    self.decompress_ctx.reset(ZSTD_createDCtx());
+  }
+
+  self.scratch.resize(content_size);
+  const auto read = self.decompress_dict
+                      ? ZSTD_decompress_usingDDict(
+                          self.decompress_ctx.get(),
+                          self.scratch.data(),
+                          self.scratch.size(),
+                          payload.data(),
+                          payload.size(),
+                          self.decompress_dict.get()
+                        )
+                      : ZSTD_decompressDCtx(
+                          self.decompress_ctx.get(), self.scratch.data(), self.scratch.size(), payload.data(), payload.size()
+                        );
+  if (ZSTD_isError(read) || read != content_size) {
+    return false;
+  }
+
+  return self.decode_state(self.scratch, sequence, baseline, state);
+}
+
+auto SnapshotCodec::encode_state(this SnapshotCodec& self, const SceneState& state, u8 sequence, option<u8> baseline)
+  -> void {
+  ZoneScoped;
+
+  auto& writer = self.writer;
+  writer.clear();
+
+  writer.write_bits(sequence, 8);
+  writer.write_bool(baseline.has_value());
+  if (baseline.has_value()) {
+    writer.write_bits(baseline.value(), 8);
+  }
+
+  writer.write_varint(state.removed_entities.size());
+  for (auto entity_id : state.removed_entities) {
+    writer.write_varint(entity_id);
+  }
+
+  writer.write_varint(state.entities.size());
+  for (const auto& [entity_id, entity_state] : state.entities) {
+    writer.write_varint(entity_id);
+
+    writer.write_varint(entity_state.removed_components.size());
+    for (auto component_id : entity_state.removed_components) {
+      writer.write_varint(component_id);
+    }
+
+    writer.write_varint(entity_state.components.size());
+    for (const auto& [component_id, component_state] : entity_state.components) {
+      write_component(writer, self.schema, component_id, component_state.buffer);
+    }
+  }
+}
+
+auto SnapshotCodec::encode_delta(this SnapshotCodec& self, const SnapshotDelta& delta, u8 sequence, option<u8> baseline)
+  -> void {
+  ZoneScoped;
+
+  auto& writer = self.writer;
+  writer.clear();
+
+  writer.write_bits(sequence, 8);
+  writer.write_bool(baseline.has_value());
+  if (baseline.has_value()) {
+    writer.write_bits(baseline.value(), 8);
+  }
+
+  writer.write_varint(delta.removed_entities.size());
+  for (auto entity_id : delta.removed_entities) {
+    writer.write_varint(entity_id);
+  }
+
+  // Records come in table order, an entity's changes are spread over its table's columns.
+  auto& order = self.record_order;
+  order.resize(delta.records.size());
+  for (auto i = 0_u32; i < order.size(); i++) {
+    order[i] = i;
+  }
+  std::ranges::sort(order, [&](u32 lhs, u32 rhs) {
+    return std::tie(delta.records[lhs].entity, lhs) < std::tie(delta.records[rhs].entity, rhs);
+  });
+
+  auto entity_count = 0_sz;
+  for (auto i = 0_sz; i < order.size(); i++) {
+    entity_count += i == 0 || delta.records[order[i]].entity != delta.records[order[i - 1]].entity;
+  }
+
+  writer.write_varint(entity_count);
+  for (auto first = 0_sz; first < order.size();) {
+    const auto entity_id = delta.records[order[first]].entity;
+    auto last = first;
+    auto removed_count = 0_sz;
+    while (last < order.size() && delta.records[order[last]].entity == entity_id) {
+      removed_count += delta.records[order[last]].removed;
+      last++;
+    }
+
+    writer.write_varint(entity_id);
+    writer.write_varint(removed_count);
+    for (auto i = first; i < last; i++) {
+      if (delta.records[order[i]].removed) {
+        writer.write_varint(delta.records[order[i]].component_id);
+      }
+    }
+
+    writer.write_varint(last - first - removed_count);
+    for (auto i = first; i < last; i++) {
+      const auto& record = delta.records[order[i]];
+      if (!record.removed) {
+        write_component(writer, self.schema, record.component_id, delta.bytes(record));
+      }
+    }
+
+    first = last;
+  }
+}
+
+auto SnapshotCodec::decode_state(
+  this const SnapshotCodec& self, std::span<const u8> bytes, u8& sequence, option<u8>& baseline, SceneState& state
+) -> bool {
+  ZoneScoped;
+
+  auto reader = BitReader{.bytes = bytes};
+  sequence = static_cast<u8>(reader.read_bits(8));
+  baseline = nullopt;
+  if (reader.read_bool()) {
+    baseline = static_cast<u8>(reader.read_bits(8));
+  }
+
+  auto removed_entity_count = read_count(reader);
+  if (!removed_entity_count.has_value()) {
+    return false;
+  }
+
+  for (auto i = 0_sz; i < removed_entity_count.value(); i++) {
+    state.removed_entities.insert(reader.read_varint());
+  }
+
+  auto entity_count = read_count(reader);
+  if (!entity_count.has_value()) {
+    return false;
+  }
+
+  for (auto i = 0_sz; i < entity_count.value() && !reader.failed; i++) {
+    const auto entity_id = reader.read_varint();
+    auto& entity_state = state.entities[entity_id];
+    entity_state.entity_id = entity_id;
+
+    auto removed_component_count = read_count(reader);
+    if (!removed_component_count.has_value()) {
+      return false;
+    }
+
+    for (auto j = 0_sz; j < removed_component_count.value(); j++) {
+      entity_state.removed_components.insert(reader.read_varint());
+    }
+
+    auto component_count = read_count(reader);
+    if (!component_count.has_value()) {
+      return false;
+    }
+
+    for (auto j = 0_sz; j < component_count.value() && !reader.failed; j++) {
+      auto component_state = ComponentState{.id = reader.read_varint(), .hash = ~0_u64};
+      if (!reader.read_bool()) {
+        if (reader.read_bool()) {
+          const auto* layout = self.schema.find(component_state.id);
+          if (!layout) {
+            OX_LOG_ERROR("Snapshot has a packed component that isn't in the schema!");
+            return false;
+          }
+
+          component_state.buffer.resize(layout->size);
+          read_fields(reader, *layout, component_state.buffer);
+        } else {
+          auto size = read_count(reader);
+          if (!size.has_value() || size.value() * 8 > reader.remaining_bits()) {
+            return false;
+          }
+
+          component_state.buffer.resize(size.value());
+          reader.read_bytes(component_state.buffer);
+        }
+
+        component_state.hash = ankerl::unordered_dense::detail::wyhash::hash(
+          component_state.buffer.data(), component_state.buffer.size()
+        );
+      }
+
+      entity_state.components.insert_or_assign(component_state.id, std::move(component_state));
+    }
+  }
+
+  // Anything but the zero padding of the last byte left over means the packet wasn't ours.
+  return !reader.failed && reader.remaining_bits() < 8;
+}
+} // namespace ox
@@ -4,10 +4,24 @@
 #include <Jolt/Physics/Body/BodyManager.h>
 #include <Jolt/Physics/Collision/CastResult.h>
 #include <Jolt/Physics/Collision/RayCast.h>
+#include <Jolt/Physics/Collision/Shape/BoxShape.h>
+#include <Jolt/Physics/Collision/Shape/CapsuleShape.h>
+#include <Jolt/Physics/Collision/Shape/CylinderShape.h>
+#include <Jolt/Physics/Collision/Shape/RotatedTranslatedShape.h>
+#include <Jolt/Physics/Collision/Shape/ScaledShape.h>
+#include <Jolt/Physics/Collision/Shape/SphereShape.h>
+#include <Jolt/Physics/Collision/Shape/TaperedCapsuleShape.h>
 #include <Jolt/RegisterTypes.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <cstdarg>
 
+#include "Asset/AssetManager.hpp"
 #include "Core/App.hpp"
+#include "OS/File.hpp"
+#include "Physics/PhysicsMaterial.hpp"
+#include "Physics/PhysicsShapes.hpp"
 #include "Physics/RayCast.hpp"
 #include "Utils/Log.hpp"
 #include "Utils/OxMath.hpp"
@@ -90,6 +104,8 @@ auto Physics::init(this Physics& self) -> std::expected<void, std::string> {
 auto Physics::deinit(this Physics& self) -> std::expected<void, std::string> {
   ZoneScoped;
 
+  self.shape_cache.clear();
+
   JPH::UnregisterTypes();
   delete JPH::Factory::sInstance;
   JPH::Factory::sInstance = nullptr;
@@ -119,4 +135,232 @@ auto Physics::new_debug_renderer(this const Physics& self) -> std::unique_ptr<Ph
 
   return std::make_unique<PhysicsDebugRenderer>();
 }
+
+namespace {
+auto shape_key_values(const ShapeKey& key) -> std::array<f32, 9> {
+  return {
+    key.dimensions.x,
+    key.dimensions.y,
+    key.dimensions.z,
+    key.offset.x,
+    key.offset.y,
+    key.offset.z,
+    key.density,
+    key.friction,
+    key.restitution,
+  };
+}
+} // namespace
+
+auto ShapeKeyHash::operator()(const ShapeKey& key) const noexcept -> u64 {
+  // Hashed as bytes, so -0.0 has to become 0.0 first to hash the same as the key it compares equal to.
+  auto values = shape_key_values(key);
+  for (auto& value : values) {
+    value += 0.0f;
+  }
+
+  auto seed = static_cast<usize>(ankerl::unordered_dense::detail::wyhash::hash(values.data(), sizeof(values)));
+  hash_combine(seed, static_cast<usize>(key.type));
+  hash_combine(seed, key.mesh_index);
+  hash_combine(seed, ankerl::unordered_dense::hash<UUID>{}(key.mesh_uuid));
+
+  return seed;
+}
+
+auto Physics::get_shape(this Physics& self, const ShapeKey& key) -> JPH::ShapeRefC {
+  ZoneScoped;
+
+  // A NaN key never equals itself, every lookup would miss and add another shape to the cache.
+  if (std::ranges::any_of(shape_key_values(key), [](f32 value) { return std::isnan(value); })) {
+    OX_LOG_ERROR("Collider shape has NaN dimensions or material values");
+    return nullptr;
+  }
+
+  {
+    auto read_lock = std::shared_lock(self.shape_cache_mutex);
+    if (auto it = self.shape_cache.find(key); it != self.shape_cache.end()) {
+      return it->second;
+    }
+  }
+
+  auto shape = self.create_shape(key);
+  if (shape == nullptr) {
+    return nullptr;
+  }
+
+  // Another thread might have built the same shape meanwhile, keep whichever got in first.
+  auto write_lock = std::unique_lock(self.shape_cache_mutex);
+  return self.shape_cache.try_emplace(key, std::move(shape)).first->second;
+}
+
+auto Physics::trim_shape_cache(this Physics& self) -> void {
+  ZoneScoped;
+
+  auto write_lock = std::unique_lock(self.shape_cache_mutex);
+  // Decorated (offset, scaled) shapes hold a reference to their inner shape, so unwrap them layer by layer.
+  for (auto pass = 0; pass < 3; pass++) {
+    std::erase_if(self.shape_cache, [](const auto& pair) { return pair.second->GetRefCount() == 1; });
+  }
+}
+
+auto Physics::create_shape(this Physics& self, const ShapeKey& key) -> JPH::ShapeRefC {
+  ZoneScoped;
+
+  if (key.offset != glm::vec3(0.0f)) {
+    auto inner_key = key;
+    inner_key.offset = {};
+    auto inner_shape = self.get_shape(inner_key);
+    if (inner_shape == nullptr) {
+      return nullptr;
+    }
+
+    auto shape_settings = JPH::RotatedTranslatedShapeSettings(
+      {key.offset.x, key.offset.y, key.offset.z},
+      JPH::Quat::sIdentity(),
+      inner_shape
+    );
+    auto shape_result = shape_settings.Create();
+    if (shape_result.HasError()) {
+      OX_LOG_ERROR("Jolt shape error: {}", shape_result.GetError().c_str());
+      return nullptr;
+    }
+
+    return shape_result.Get();
+  }
+
+  if (key.type == ShapeType::Mesh && key.dimensions != glm::vec3(1.0f)) {
+    auto inner_key = key;
+    inner_key.dimensions = glm::vec3(1.0f);
+    auto inner_shape = self.get_shape(inner_key);
+    if (inner_shape == nullptr) {
+      return nullptr;
+    }
+
+    auto shape_settings = JPH::ScaledShapeSettings(inner_shape, {key.dimensions.x, key.dimensions.y, key.dimensions.z});
+    auto shape_result = shape_settings.Create();
+    if (shape_result.HasError()) {
+      OX_LOG_ERROR("Jolt shape error: {}", shape_result.GetError().c_str());
+      return nullptr;
+    }
+
+    return shape_result.Get();
+  }
+
+  if (key.type == ShapeType::Mesh) {
+    auto shapes = self.load_mesh_shapes(key.mesh_uuid);
+    if (key.mesh_index >= shapes.size() || shapes[key.mesh_index] == nullptr) {
+      OX_LOG_ERROR("Model {} has no collision shape for mesh {}.", key.mesh_uuid.str(), key.mesh_index);
+      return nullptr;
+    }
+
+    // The whole model was cooked, keep its other meshes around too.
+    auto write_lock = std::unique_lock(self.shape_cache_mutex);
+    for (const auto& [shape, mesh_index] : std::views::zip(shapes, std::views::iota(0_u32))) {
+      if (shape != nullptr && mesh_index != key.mesh_index) {
+        auto mesh_key = ShapeKey{
+          .type = ShapeType::Mesh,
+          .dimensions = glm::vec3(1.0f),
+          .mesh_uuid = key.mesh_uuid,
+          .mesh_index = mesh_index,
+        };
+        self.shape_cache.try_emplace(mesh_key, shape);
+      }
+    }
+
+    return shapes[key.mesh_index];
+  }
+
+  const JPH::Ref<PhysicsMaterial3D> mat = new PhysicsMaterial3D(
+    "Collider",
+    JPH::ColorArg(255, 0, 0),
+    key.friction,
+    key.restitution
+  );
+
+  auto shape_result = JPH::ShapeSettings::ShapeResult{};
+  switch (key.type) {
+    case ShapeType::Box: {
+      auto shape_settings = JPH::BoxShapeSettings({key.dimensions.x, key.dimensions.y, key.dimensions.z}, 0.05f, mat);
+      shape_settings.SetDensity(key.density);
+      shape_result = shape_settings.Create();
+    } break;
+    case ShapeType::Sphere: {
+      auto shape_settings = JPH::SphereShapeSettings(key.dimensions.x, mat);
+      shape_settings.SetDensity(key.density);
+      shape_result = shape_settings.Create();
+    } break;
+    case ShapeType::Capsule: {
+      auto shape_settings = JPH::CapsuleShapeSettings(key.dimensions.y, key.dimensions.x, mat);
+      shape_settings.SetDensity(key.density);
+      shape_result = shape_settings.Create();
+    } break;
+    case ShapeType::TaperedCapsule: {
+      auto shape_settings = JPH::TaperedCapsuleShapeSettings(key.dimensions.y, key.dimensions.x, key.dimensions.z, mat);
+      shape_settings.SetDensity(key.density);
+      shape_result = shape_settings.Create();
+    } break;
+    case ShapeType::Cylinder: {
+      auto shape_settings = JPH::CylinderShapeSettings(key.dimensions.y, key.dimensions.x, 0.05f, mat);
+      shape_settings.SetDensity(key.density);
+      shape_result = shape_settings.Create();
+    } break;
+    case ShapeType::Mesh: break;
+  }
+
+  if (shape_result.HasError()) {
+    OX_LOG_ERROR("Jolt shape error: {}", shape_result.GetError().c_str());
+    return nullptr;
+  }
+
+  return shape_result.IsEmpty() ? nullptr : shape_result.Get();
+}
+
+auto Physics::load_mesh_shapes(this Physics& self, const UUID& model_uuid) -> std::vector<JPH::ShapeRefC> {
+  ZoneScoped;
+
+  auto model_path = std::filesystem::path{};
+  {
+    auto& asset_man = App::mod<AssetManager>();
+    auto asset = asset_man.get_asset(model_uuid);
+    if (!asset || asset->type != AssetType::Model) {
+      OX_LOG_ERROR("Mesh collider references {}, which is not a model asset.", model_uuid.str());
+      return {};
+    }
+
+    model_path = asset->path;
+  }
+
+  const auto baked_path = baked_shapes_path(model_path);
+  if (std::filesystem::exists(baked_path)) {
+    if (auto baked_file = AssetFile::unpack(baked_path)) {
+      const auto source_hash = hash_shape_source(model_path);
+      auto shapes = std::vector<JPH::ShapeRefC>();
+      auto stale = false;
+      for (auto& entry : baked_file->entries) {
+        auto* shape_data = std::get_if<PhysicsShapeData>(&entry.data);
+        if (!shape_data) {
+          continue;
+        }
+
+        if (shape_data->source_hash != source_hash) {
+          stale = true;
+          break;
+        }
+
+        if (shapes.size() <= shape_data->mesh_index) {
+          shapes.resize(shape_data->mesh_index + 1);
+        }
+        shapes[shape_data->mesh_index] = restore_shape_binary(shape_data->shape_data);
+      }
+
+      if (!stale) {
+        return shapes;
+      }
+
+      OX_LOG_WARN("Baked shapes '{}' are out of date, cooking from source.", baked_path);
+    }
+  }
+
+  return cook_gltf_mesh_shapes(model_path);
+}
 } // namespace ox
@@ -0,0 +1,182 @@
+#include "Physics/PhysicsShapes.hpp"
+
+// clang-format off
+#include <Jolt/Core/StreamWrapper.h>
+#include <Jolt/Physics/Collision/Shape/MeshShape.h>
+// clang-format on
+#include <ankerl/unordered_dense.h>
+#include <fastgltf/core.hpp>
+#include <fastgltf/tools.hpp>
+#include <fastgltf/types.hpp>
+#include <queue>
+#include <sstream>
+
+#include "OS/File.hpp"
+#include "Utils/Log.hpp"
+
+namespace ox {
+// AssetManager_GLTF.cpp
+auto get_default_gltf_extensions() -> fastgltf::Extensions;
+
+auto cook_gltf_mesh_shapes(const std::filesystem::path& path) -> std::vector<JPH::ShapeRefC> {
+  ZoneScoped;
+
+  auto gltf_buffer = fastgltf::GltfDataBuffer::FromPath(path);
+  if (fastgltf::determineGltfFileType(gltf_buffer.get()) == fastgltf::GltfType::Invalid) {
+    OX_LOG_ERROR("GLTF model type is invalid!");
+    return {};
+  }
+
+  auto gltf_parser = fastgltf::Parser(get_default_gltf_extensions());
+  auto gltf_result = gltf_parser
+                       .loadGltf(gltf_buffer.get(), path.parent_path(), fastgltf::Options::LoadExternalBuffers);
+  if (!gltf_result) {
+    OX_LOG_ERROR("Failed to load GLTF! {}", fastgltf::getErrorMessage(gltf_result.error()));
+    return {};
+  }
+
+  auto& gltf_asset = gltf_result.get();
+  if (gltf_asset.scenes.size() != 1) {
+    OX_LOG_ERROR("Error loading {}. The GLTF scene can only contain one scene.", path);
+    return {};
+  }
+
+  auto shapes = std::vector<JPH::ShapeRefC>();
+
+  // Same traversal as `AssetManager::load_model`, mesh indices must line up.
+  auto& gltf_default_scene = gltf_asset.scenes[gltf_asset.defaultScene.value_or(0_sz)];
+  auto processing_gltf_nodes = std::queue<usize>();
+  for (auto node_index : gltf_default_scene.nodeIndices) {
+    processing_gltf_nodes.push(node_index);
+  }
+
+  while (!processing_gltf_nodes.empty()) {
+    const auto& node = gltf_asset.nodes[processing_gltf_nodes.front()];
+    processing_gltf_nodes.pop();
+
+    for (auto child_node_index : node.children) {
+      processing_gltf_nodes.push(child_node_index);
+    }
+
+    if (!node.meshIndex.has_value()) {
+      continue;
+    }
+
+    const auto& gltf_mesh = gltf_asset.meshes[node.meshIndex.value()];
+    for (const auto& gltf_primitive : gltf_mesh.primitives) {
+      if (!gltf_primitive.indicesAccessor.has_value()) {
+        continue;
+      }
+
+      auto& shape = shapes.emplace_back();
+      auto attrib = gltf_primitive.findAttribute("POSITION");
+      if (attrib == gltf_primitive.attributes.end()) {
+        continue;
+      }
+
+      auto vertices = JPH::VertexList();
+      auto& position_accessor = gltf_asset.accessors[attrib->accessorIndex];
+      vertices.resize(position_accessor.count);
+      fastgltf::iterateAccessorWithIndex<fastgltf::math::fvec3>(
+        gltf_asset,
+        position_accessor,
+        [&](fastgltf::math::fvec3 pos, usize i) { vertices[i] = JPH::Float3(pos.x(), pos.y(), pos.z()); }
+      );
+
+      auto& index_accessor = gltf_asset.accessors[gltf_primitive.indicesAccessor.value()];
+      auto indices = std::vector<u32>(index_accessor.count);
+      fastgltf::iterateAccessorWithIndex<u32>(gltf_asset, index_accessor, [&](u32 index, usize i) {
+        indices[i] = index;
+      });
+
+      auto triangles = JPH::IndexedTriangleList();
+      triangles.reserve(indices.size() / 3);
+      for (auto i = 0_sz; i + 2 < indices.size(); i += 3) {
+        triangles.emplace_back(indices[i + 0], indices[i + 1], indices[i + 2]);
+      }
+
+      auto shape_settings = JPH::MeshShapeSettings(std::move(vertices), std::move(triangles));
+      auto shape_result = shape_settings.Create();
+      if (shape_result.HasError()) {
+        OX_LOG_ERROR("Jolt shape error for mesh {} of {}: {}", shapes.size() - 1, path, shape_result.GetError().c_str());
+        continue;
+      }
+
+      shape = shape_result.Get();
+    }
+  }
+
+  return shapes;
+}
+
+auto save_shape_binary(const JPH::Shape* shape) -> std::vector<u8> {
+  ZoneScoped;
+
+  auto stream = std::stringstream(std::ios::out | std::ios::binary);
+  auto stream_out = JPH::StreamOutWrapper(stream);
+  auto shape_map = JPH::Shape::ShapeToIDMap();
+  auto material_map = JPH::Shape::MaterialToIDMap();
+  shape->SaveWithChildren(stream_out, shape_map, material_map);
+  if (stream_out.IsFailed()) {
+    return {};
+  }
+
+  auto str = std::move(stream).str();
+  return {str.begin(), str.end()};
+}
+
+auto restore_shape_binary(std::span<const u8> bytes) -> JPH::ShapeRefC {
+  ZoneScoped;
+
+  auto stream = std::stringstream(
+    std::string(reinterpret_cast<const c8*>(bytes.data()), bytes.size()),
+    std::ios::in | std::ios::binary
+  );
+  auto stream_in = JPH::StreamInWrapper(stream);
+  auto shape_map = JPH::Shape::IDToShapeMap();
+  auto material_map = JPH::Shape::IDToMaterialMap();
+  auto shape_result = JPH::Shape::sRestoreWithChildren(stream_in, shape_map, material_map);
+  if (shape_result.HasError()) {
+    OX_LOG_ERROR("Failed to restore baked shape: {}", shape_result.GetError().c_str());
+    return nullptr;
+  }
+
+  return shape_result.Get();
+}
+
+auto baked_shapes_path(const std::filesystem::path& model_path) -> std::filesystem::path {
+  return std::filesystem::path(model_path.string() + ".oxshapes");
+}
+
+auto hash_shape_source(const std::filesystem::path& path) -> u64 {
+  ZoneScoped;
+
+  auto bytes = File::to_bytes(path);
+  auto hash = ankerl::unordered_dense::detail::wyhash::hash(bytes.data(), bytes.size());
+
+  // Vertices and indices usually live in external buffers, editing only those must invalidate the bake too.
+  auto gltf_buffer = fastgltf::GltfDataBuffer::FromPath(path);
+  if (!gltf_buffer) {
+    return hash;
+  }
+
+  auto gltf_parser = fastgltf::Parser(get_default_gltf_extensions());
+  auto gltf_result = gltf_parser.loadGltf(gltf_buffer.get(), path.parent_path(), fastgltf::Options::None);
+  if (!gltf_result) {
+    return hash;
+  }
+
+  for (const auto& buffer : gltf_result.get().buffers) {
+    const auto* uri = std::get_if<fastgltf::sources::URI>(&buffer.data);
+    if (!uri || !uri->uri.isLocalPath()) {
+      continue;
+    }
+
+    const auto buffer_bytes = File::to_bytes(path.parent_path() / uri->uri.fspath());
+    const auto buffer_hash = ankerl::unordered_dense::detail::wyhash::hash(buffer_bytes.data(), buffer_bytes.size());
+    hash = ankerl::unordered_dense::detail::wyhash::mix(hash, buffer_hash);
+  }
+
+  return hash;
+}
+} // namespace ox
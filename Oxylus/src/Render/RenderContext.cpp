@@ -15,6 +15,7 @@
 #include "Core/App.hpp"
 #include "Render/Renderer.hpp"
 #include "Render/Window.hpp"
+#include "Utils/FrameProfiler.hpp"
 #include "Utils/Profiler.hpp"
 
 namespace ox {
@@ -52,7 +53,7 @@ static VkBool32 debug_callback(
   } else if (messageSeverity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT) {
     OX_LOG_INFO("{}", debug_message.str());
   } else if (messageSeverity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT) {
-    OX_LOG_WARN(debug_message.str().c_str());
+    OX_LOG_WARN("{}", debug_message.str());
     // OX_DEBUGBREAK();
   } else if (messageSeverity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT) {
     OX_LOG_ERROR("{}", debug_message.str());
@@ -989,6 +990,7 @@ auto RenderContext::upload_staging(
 
   auto cpu_buffer = alloc_transient_buffer(vuk::MemoryUsage::eCPUonly, data_size, 8, LOC);
   std::memcpy(cpu_buffer->mapped_ptr, data, data_size);
+  OX_COUNTER_ADD("gpu.bytes_uploaded", data_size);
 
   auto dst_buffer = vuk::discard_buf("dst", dst->subrange(dst_offset, cpu_buffer->size), LOC);
   return upload_staging(std::move(cpu_buffer), std::move(dst_buffer), LOC);
@@ -1001,6 +1003,7 @@ auto RenderContext::upload_staging(
 
   auto cpu_buffer = alloc_transient_buffer(vuk::MemoryUsage::eCPUonly, data_size, 8, LOC);
   std::memcpy(cpu_buffer->mapped_ptr, data, data_size);
+  OX_COUNTER_ADD("gpu.bytes_uploaded", data_size);
 
   auto dst_buffer = vuk::discard_buf("dst", dst.subrange(dst_offset, cpu_buffer->size), LOC);
   return upload_staging(std::move(cpu_buffer), std::move(dst_buffer), LOC);
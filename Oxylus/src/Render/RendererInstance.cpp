@@ -10,6 +10,7 @@
 #include "Render/RenderContext.hpp"
 #include "Render/Utils/VukCommon.hpp"
 #include "Scene/SceneGPU.hpp"
+#include "Utils/FrameProfiler.hpp"
 #include "Utils/Log.hpp"
 
 namespace ox {
@@ -108,6 +109,106 @@ auto update_projected_transform_buffer(
   prepared_buffer = update_pass(std::move(upload_buffer), std::move(buffer_handle));
 }
 
+namespace {
+struct ViewRect2D {
+  glm::vec2 min = {};
+  glm::vec2 max = {};
+};
+
+// XY bounds of the part of the view frustum between `min_z` and `max_z`, the depth sprites are at. Exact for a
+// camera looking down Z, larger than needed for any other. `nullopt` when the frustum doesn't reach that depth.
+auto frustum_rect_2d(const glm::mat4& inv_projection_view, f32 min_z, f32 max_z) -> option<ViewRect2D> {
+  auto corners = std::array<glm::vec3, 8>();
+  for (auto i = 0_sz; i < corners.size(); i++) {
+    const auto ndc = glm::vec4(i & 1 ? 1.0f : -1.0f, i & 2 ? 1.0f : -1.0f, i & 4 ? 1.0f : 0.0f, 1.0f);
+    const auto world = inv_projection_view * ndc;
+    corners[i] = glm::vec3(world) / world.w;
+    // No usable camera, nothing can be culled.
+    if (glm::any(glm::isnan(corners[i])) || glm::any(glm::isinf(corners[i]))) {
+      return ViewRect2D{
+        .min = glm::vec2(std::numeric_limits<f32>::lowest()),
+        .max = glm::vec2(std::numeric_limits<f32>::max()),
+      };
+    }
+  }
+
+  auto rect = ViewRect2D{
+    .min = glm::vec2(std::numeric_limits<f32>::max()),
+    .max = glm::vec2(std::numeric_limits<f32>::lowest()),
+  };
+  // Every edge of the frustum joins two corners one bit apart, clip each to the depth range.
+  for (auto first = 0_sz; first < corners.size(); first++) {
+    for (auto bit = 1_sz; bit < corners.size(); bit <<= 1) {
+      if (first & bit) {
+        continue;
+      }
+
+      const auto& p0 = corners[first];
+      const auto& p1 = corners[first | bit];
+      auto t0 = 0.0f;
+      auto t1 = 1.0f;
+      const auto dz = p1.z - p0.z;
+      if (glm::abs(dz) > glm::epsilon<f32>()) {
+        auto enter = (min_z - p0.z) / dz;
+        auto exit = (max_z - p0.z) / dz;
+        if (enter > exit) {
+          std::swap(enter, exit);
+        }
+        t0 = std::max(t0, enter);
+        t1 = std::min(t1, exit);
+      } else if (p0.z < min_z || p0.z > max_z) {
+        continue;
+      }
+
+      if (t0 > t1) {
+        continue;
+      }
+
+      for (const auto t : {t0, t1}) {
+        const auto point = glm::vec2(glm::mix(p0, p1, t));
+        rect.min = glm::min(rect.min, point);
+        rect.max = glm::max(rect.max, point);
+      }
+    }
+  }
+
+  if (rect.min.x > rect.max.x || rect.min.y > rect.max.y) {
+    return nullopt;
+  }
+
+  return rect;
+}
+
+// Planes as `math::calc_frustum_planes` writes them, a point is inside when `dot(normal, point) >= w` for all.
+auto sphere_on_frustum(const glm::vec4 (&planes)[6], glm::vec3 center, f32 radius) -> bool {
+  for (const auto& plane : planes) {
+    if (glm::dot(glm::vec3(plane), center) - plane.w < -radius) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// Looks `material` up only when it is not the one `resolved` and `resolved_id` were cached for, or that one
+// got unloaded since. False until the material is loaded.
+auto resolve_material(AssetManager& asset_man, const UUID& material, UUID& resolved, MaterialID& resolved_id)
+  -> bool {
+  if (resolved && resolved == material && asset_man.is_material_loaded(resolved_id)) {
+    return true;
+  }
+
+  auto asset = asset_man.get_asset(material);
+  if (!asset || asset->material_id == MaterialID::Invalid) {
+    return false;
+  }
+
+  resolved = material;
+  resolved_id = asset->material_id;
+  return true;
+}
+} // namespace
+
 RendererInstance::RendererInstance(Scene& owner_scene, Renderer& parent_renderer)
     : scene(owner_scene),
       renderer(parent_renderer) {
@@ -116,6 +217,30 @@ RendererInstance::RendererInstance(Scene& owner_scene, Renderer& parent_renderer
   auto& allocator = render_context.superframe_allocator;
   render_queue_2d.init();
 
+  auto& world = scene.world;
+  camera_query = world.query_builder<const TransformComponent, const CameraComponent>().cached().build();
+  light_query = world.query_builder<const TransformComponent, const LightComponent>().cached().build();
+  particle_system_query = world.query_builder<ParticleSystemComponent>().cached().build();
+  // Only the settings are watched for changes, the entities carrying them moving around is not a change.
+  atmosphere_query = world.query_builder<const AtmosphereComponent>()
+                       .with<TransformComponent>()
+                       .with<LightComponent>()
+                       .cached()
+                       .build();
+  sky_query = world.query_builder<const SkyComponent>() //
+                .with<TransformComponent>()
+                .with<LightComponent>()
+                .cached()
+                .build();
+  auto_exposure_query = world.query_builder<const AutoExposureComponent>().cached().build();
+  vignette_query = world.query_builder<const VignetteComponent>().with<TransformComponent>().cached().build();
+  chromatic_aberration_query = world.query_builder<const ChromaticAberrationComponent>()
+                                 .with<TransformComponent>()
+                                 .cached()
+                                 .build();
+  film_grain_query = world.query_builder<const FilmGrainComponent>().with<TransformComponent>().cached().build();
+  tonemapping_query = world.query_builder<const TonemappingComponent>().cached().build();
+
   lights_buffer = render_context.allocate_buffer_super(
     vuk::MemoryUsage::eGPUonly,
     GPU::MAX_LIGHTS * sizeof(GPU::Light)
@@ -514,7 +639,7 @@ auto RendererInstance::render(
   self.prepared_frame.camera_buffer = self.renderer.render_context->scratch_buffer(self.camera_data);
 
   self.render_queue_2d.update();
-  self.render_queue_2d.sort();
+  self.render_queue_2d.sort(&App::get_job_manager());
   auto vertex_buffer_2d = self.renderer.render_context->scratch_buffer_span(
     std::span(self.render_queue_2d.sprite_data)
   );
@@ -941,11 +1066,12 @@ auto RendererInstance::render(
 
   // --- 2D Pass ---
   if (!self.render_queue_2d.sprite_data.empty()) {
-    // WARN: rq2d is copied each frame (it needs to be copied)
+    // The queue isn't touched again until the next frame's `init`, after this graph is submitted.
+    const auto batches_2d = std::span<const GPU::DrawBatch2D>(self.render_queue_2d.batches);
 
     auto forward_2d_vis_pass = vuk::make_pass(
       "2d_forward_vis_pass",
-      [rq2d = self.render_queue_2d](
+      [batches_2d](
         vuk::CommandBuffer& cmd_list,
         VUK_IA(vuk::eColorWrite) target,
         VUK_IA(vuk::eDepthStencilRW) depth,
@@ -959,7 +1085,7 @@ auto RendererInstance::render(
           vuk::Format::eR32Uint, // 4 transforms_id
         };
 
-        for (const auto& batch : rq2d.batches) {
+        for (const auto& batch : batches_2d) {
           if (batch.count < 1)
             continue;
 
@@ -1006,7 +1132,7 @@ auto RendererInstance::render(
 
     auto forward_2d_pass = vuk::make_pass(
       "2d_forward_pass",
-      [rq2d = self.render_queue_2d, &descriptor_set = bindless_set](
+      [batches_2d, &descriptor_set = bindless_set](
         vuk::CommandBuffer& cmd_list,
         VUK_IA(vuk::eColorWrite) target,
         VUK_IA(vuk::eDepthStencilRW) depth,
@@ -1021,7 +1147,7 @@ auto RendererInstance::render(
           vuk::Format::eR32Uint, // 4 transforms_id
         };
 
-        for (const auto& batch : rq2d.batches) {
+        for (const auto& batch : batches_2d) {
           if (batch.count < 1)
             continue;
 
@@ -1204,28 +1330,25 @@ auto RendererInstance::update(this RendererInstance& self, RendererInstanceUpdat
   CameraComponent frozen_camera = {};
   const auto freeze_culling = static_cast<bool>(cvar.cvar_freeze_culling_frustum.get());
 
-  self.scene.world
-    .query_builder<const TransformComponent, const CameraComponent>() //
-    .build()
-    .each([&](flecs::entity e, const TransformComponent& tc, const CameraComponent& c) {
-      if (freeze_culling && !self.saved_camera) {
-        self.saved_camera = true;
-        frozen_camera = current_camera;
-      } else if (!freeze_culling && self.saved_camera) {
-        self.saved_camera = false;
-      }
+  self.camera_query.each([&](flecs::entity e, const TransformComponent& tc, const CameraComponent& c) {
+    if (freeze_culling && !self.saved_camera) {
+      self.saved_camera = true;
+      frozen_camera = current_camera;
+    } else if (!freeze_culling && self.saved_camera) {
+      self.saved_camera = false;
+    }
 
-      if (
-        static_cast<bool>(cvar.cvar_freeze_culling_frustum.get()) &&
-        static_cast<bool>(cvar.cvar_draw_camera_frustum.get())
-      ) {
-        const auto proj = frozen_camera.get_projection_matrix() * frozen_camera.get_view_matrix();
-        auto& debug_renderer = App::mod<ox::DebugRenderer>();
-        debug_renderer.draw_frustum(proj, glm::vec4(0, 1, 0, 1), frozen_camera.near_clip, frozen_camera.far_clip);
-      }
+    if (
+      static_cast<bool>(cvar.cvar_freeze_culling_frustum.get()) &&
+      static_cast<bool>(cvar.cvar_draw_camera_frustum.get())
+    ) {
+      const auto proj = frozen_camera.get_projection_matrix() * frozen_camera.get_view_matrix();
+      auto& debug_renderer = App::mod<ox::DebugRenderer>();
+      debug_renderer.draw_frustum(proj, glm::vec4(0, 1, 0, 1), frozen_camera.near_clip, frozen_camera.far_clip);
+    }
 
-      current_camera = c;
-    });
+    current_camera = c;
+  });
 
   CameraComponent cam = freeze_culling ? frozen_camera : current_camera;
 
@@ -1258,182 +1381,216 @@ auto RendererInstance::update(this RendererInstance& self, RendererInstanceUpdat
 
   self.scene.lights.reset();
 
-  self.scene.world
-    .query_builder<const TransformComponent, const LightComponent>() //
-    .build()
-    .each([&self](flecs::entity e, const TransformComponent& tc, const LightComponent& lc) {
-      if (!e.enabled()) {
-        return;
-      }
+  self.light_query.each([&self](flecs::entity e, const TransformComponent& tc, const LightComponent& lc) {
+    if (!e.enabled()) {
+      return;
+    }
 
-      const glm::mat4 world_transform = self.scene.get_world_transform(e);
-      const glm::vec3 world_position = world_transform[3];
-      const glm::vec3 world_forward = glm::normalize(glm::mat3(world_transform) * glm::vec3(0.0f, 0.0f, -1.0f));
-
-      if (lc.type == LightComponent::LightType::Directional) {
-        self.gpu_scene_flags |= GPU::SceneFlags::HasDirectionalLight;
-        self.directional_light.color = lc.color;
-        self.directional_light.intensity = lc.intensity;
-        self.sun_direction_changed = world_forward != self.previous_sun_direction;
-        self.previous_sun_direction = world_forward;
-        self.directional_light.direction = world_forward;
-        self.first_clipmap_width = lc.first_clipmap_width;
-        self.clipmap_selection_bias = lc.clipmap_selection_bias;
-
-        self.directional_light_cast_shadows = lc.cast_shadows;
-      } else {
-        const auto kind = lc.type == LightComponent::LightType::Spot ? GPU::LightKind::Spot : GPU::LightKind::Point;
-        const auto direction = lc.type == LightComponent::LightType::Spot ? world_forward : glm::vec3(0.0f);
-        self.scene.lights.create_slot(
-          GPU::Light{
-            .position = world_position,
-            .intensity = lc.intensity,
-            .color = lc.color,
-            .range = lc.radius,
-            .direction = direction,
-            .inner_cone_angle = lc.inner_cone_angle,
-            .outer_cone_angle = lc.outer_cone_angle,
-            .kind = kind,
-          }
-        );
-      }
-      if (const auto* atmos_info = e.try_get<AtmosphereComponent>()) {
-        self.gpu_scene_flags |= GPU::SceneFlags::HasAtmosphere;
-
-        self.atmosphere.rayleigh_scatter = atmos_info->rayleigh_scattering * 1e-3f;
-        self.atmosphere.rayleigh_density = atmos_info->rayleigh_density;
-        self.atmosphere.mie_scatter = atmos_info->mie_scattering * 1e-3f;
-        self.atmosphere.mie_density = atmos_info->mie_density;
-        self.atmosphere.mie_extinction = atmos_info->mie_extinction * 1e-3f;
-        self.atmosphere.mie_asymmetry = atmos_info->mie_asymmetry;
-        self.atmosphere.ozone_absorption = atmos_info->ozone_absorption * 1e-3f;
-        self.atmosphere.ozone_height = atmos_info->ozone_height;
-        self.atmosphere.ozone_thickness = atmos_info->ozone_thickness;
-        self.atmosphere.aerial_perspective_start_km = atmos_info->aerial_perspective_start_km;
-        self.atmosphere.aerial_perspective_exposure = atmos_info->aerial_perspective_exposure;
-        self.atmosphere.sky_view_lut_size = self.sky_view_lut_extent;
-        self.atmosphere.aerial_perspective_lut_size = self.sky_aerial_perspective_lut_extent;
-        self.atmosphere.transmittance_lut_size = self.sky_transmittance_lut.get_extent();
-        self.atmosphere.multiscattering_lut_size = self.sky_multiscatter_lut.get_extent();
-      }
+    const glm::mat4 world_transform = self.scene.get_world_transform(e);
+    const glm::vec3 world_position = world_transform[3];
+    const glm::vec3 world_forward = glm::normalize(glm::mat3(world_transform) * glm::vec3(0.0f, 0.0f, -1.0f));
+
+    if (lc.type == LightComponent::LightType::Directional) {
+      self.gpu_scene_flags |= GPU::SceneFlags::HasDirectionalLight;
+      self.directional_light.color = lc.color;
+      self.directional_light.intensity = lc.intensity;
+      self.sun_direction_changed = world_forward != self.previous_sun_direction;
+      self.previous_sun_direction = world_forward;
+      self.directional_light.direction = world_forward;
+      self.first_clipmap_width = lc.first_clipmap_width;
+      self.clipmap_selection_bias = lc.clipmap_selection_bias;
+
+      self.directional_light_cast_shadows = lc.cast_shadows;
+    } else {
+      const auto kind = lc.type == LightComponent::LightType::Spot ? GPU::LightKind::Spot : GPU::LightKind::Point;
+      const auto direction = lc.type == LightComponent::LightType::Spot ? world_forward : glm::vec3(0.0f);
+      self.scene.lights.create_slot(
+        GPU::Light{
+          .position = world_position,
+          .intensity = lc.intensity,
+          .color = lc.color,
+          .range = lc.radius,
+          .direction = direction,
+          .inner_cone_angle = lc.inner_cone_angle,
+          .outer_cone_angle = lc.outer_cone_angle,
+          .kind = kind,
+        }
+      );
+    }
+  });
 
-      if (const auto* sky_info = e.try_get<SkyComponent>()) {
-        self.gpu_scene_flags |= GPU::SceneFlags::HasSky;
+  // Settings that rarely change are only gathered again when flecs saw their components written or entities carrying
+  // them come and go, the flags they set are kept for the frames they are skipped.
+  const auto gather_settings = [&self](auto& query, GPU::SceneFlags flag, const auto& gather) {
+    if (!query.changed()) {
+      return;
+    }
 
-        self.sky_data.solid_color = sky_info->solid_color;
-        self.sky_data.ambient_color = sky_info->ambient_color;
-        self.sky_data.has_texture = static_cast<bool>(sky_info->texture);
-      }
-    });
+    self.settings_scene_flags = static_cast<GPU::SceneFlags>(
+      std::to_underlying(self.settings_scene_flags) & ~std::to_underlying(flag)
+    );
+    query.each(gather);
+  };
+
+  const auto gather_atmosphere = [&self](const AtmosphereComponent& atmos_info) {
+    self.settings_scene_flags |= GPU::SceneFlags::HasAtmosphere;
+
+    self.atmosphere.rayleigh_scatter = atmos_info.rayleigh_scattering * 1e-3f;
+    self.atmosphere.rayleigh_density = atmos_info.rayleigh_density;
+    self.atmosphere.mie_scatter = atmos_info.mie_scattering * 1e-3f;
+    self.atmosphere.mie_density = atmos_info.mie_density;
+    self.atmosphere.mie_extinction = atmos_info.mie_extinction * 1e-3f;
+    self.atmosphere.mie_asymmetry = atmos_info.mie_asymmetry;
+    self.atmosphere.ozone_absorption = atmos_info.ozone_absorption * 1e-3f;
+    self.atmosphere.ozone_height = atmos_info.ozone_height;
+    self.atmosphere.ozone_thickness = atmos_info.ozone_thickness;
+    self.atmosphere.aerial_perspective_start_km = atmos_info.aerial_perspective_start_km;
+    self.atmosphere.aerial_perspective_exposure = atmos_info.aerial_perspective_exposure;
+    self.atmosphere.sky_view_lut_size = self.sky_view_lut_extent;
+    self.atmosphere.aerial_perspective_lut_size = self.sky_aerial_perspective_lut_extent;
+    self.atmosphere.transmittance_lut_size = self.sky_transmittance_lut.get_extent();
+    self.atmosphere.multiscattering_lut_size = self.sky_multiscatter_lut.get_extent();
+  };
+  gather_settings(self.atmosphere_query, GPU::SceneFlags::HasAtmosphere, gather_atmosphere);
+
+  gather_settings(self.sky_query, GPU::SceneFlags::HasSky, [&self](const SkyComponent& sky_info) {
+    self.settings_scene_flags |= GPU::SceneFlags::HasSky;
+
+    self.sky_data.solid_color = sky_info.solid_color;
+    self.sky_data.ambient_color = sky_info.ambient_color;
+    self.sky_data.has_texture = static_cast<bool>(sky_info.texture);
+  });
 
   self.render_queue_2d.init();
 
-  self.scene.world
-    .query_builder<const TransformComponent, const SpriteComponent>() //
-    .build()
-    .each([&asset_man,
-           &s = self.scene,
-           &cam,
-           &rq2d = self.render_queue_2d](flecs::entity e, const TransformComponent& tc, const SpriteComponent& comp) {
-      const auto distance = glm::distance(glm::vec3(0.f, 0.f, cam.position.z), glm::vec3(0.f, 0.f, tc.position.z));
-      if (auto material = asset_man.get_asset(comp.material)) {
-        u16 flags = 0;
-        if (comp.sort_y)
-          flags |= GPU::RENDER_FLAGS_2D_SORT_Y;
-        if (comp.flip_x)
-          flags |= GPU::RENDER_FLAGS_2D_FLIP_X;
-
-        if (auto transform_id = s.get_entity_transform_id(e)) {
-          rq2d.add(
-            flags,
-            tc.position.y,
-            SlotMap_decode_id(*transform_id).index,
-            SlotMap_decode_id(material->material_id).index,
-            distance
-          );
-        } else {
-          OX_LOG_WARN("No registered transform for sprite entity: {}", e.name().c_str());
-        }
-      }
-    });
-
-  self.scene.world
-    .query_builder<const TransformComponent, const ParticleComponent>() //
-    .build()
-    .each([&asset_man,
-           &s = self.scene,
-           &cam,
-           &rq2d = self.render_queue_2d](flecs::entity e, const TransformComponent& tc, const ParticleComponent& comp) {
-      if (comp.life_remaining <= 0.0f)
-        return;
-
-      const auto distance = glm::distance(glm::vec3(0.f, 0.f, cam.position.z), glm::vec3(0.f, 0.f, tc.position.z));
-
-      auto particle_system_component = e.parent().try_get<ParticleSystemComponent>();
-      if (particle_system_component) {
-        if (auto material = asset_man.get_asset(particle_system_component->material)) {
-          if (auto transform_id = s.get_entity_transform_id(e)) {
-            rq2d.add(
-              GPU::RENDER_FLAGS_2D_SORT_Y,
-              tc.position.y,
-              SlotMap_decode_id(*transform_id).index,
-              SlotMap_decode_id(material->material_id).index,
-              distance
-            );
-          } else {
-            OX_LOG_WARN("No registered transform for sprite entity: {}", e.name().c_str());
-          }
-        }
+  // Only sprites in view pay for a queue slot, the grid keeps the rest from being looked at at all.
+  auto& sprite_grid = self.scene.sprite_grid;
+  self.visible_sprites.clear();
+  if (sprite_grid.size() > 0) {
+    const auto view_rect = frustum_rect_2d(
+      self.camera_data.inv_projection_view,
+      sprite_grid.get_min_z(),
+      sprite_grid.get_max_z()
+    );
+    if (view_rect) {
+      sprite_grid.query(view_rect->min, view_rect->max, self.visible_sprites);
+    }
+  }
+  // Sprites that sort equal keep the same draw order from frame to frame.
+  std::ranges::sort(self.visible_sprites);
+  OX_GAUGE_SET("render.sprites_visible", self.visible_sprites.size());
+
+  for (const auto entity_id : self.visible_sprites) {
+    const auto e = flecs::entity(self.scene.world, entity_id);
+    const auto* tc = e.try_get<TransformComponent>();
+    auto* comp = e.try_get_mut<SpriteComponent>();
+    if (!tc || !comp) {
+      continue;
+    }
+
+    if (!resolve_material(asset_man, comp->material, comp->resolved_material, comp->resolved_material_id)) {
+      continue;
+    }
+
+    const auto distance = glm::abs(cam.position.z - tc->position.z);
+    u16 flags = 0;
+    if (comp->sort_y)
+      flags |= GPU::RENDER_FLAGS_2D_SORT_Y;
+    if (comp->flip_x)
+      flags |= GPU::RENDER_FLAGS_2D_FLIP_X;
+
+    if (auto transform_id = self.scene.get_entity_transform_id(e)) {
+      self.render_queue_2d.add(
+        flags,
+        tc->position.y,
+        SlotMap_decode_id(*transform_id).index,
+        SlotMap_decode_id(comp->resolved_material_id).index,
+        distance
+      );
+    } else {
+      OX_LOG_WARN("No registered transform for sprite entity: {}", e.name().c_str());
+    }
+  }
+
+  self.particle_system_query.each([&asset_man,
+                                   &s = self.scene,
+                                   &cam,
+                                   &planes = self.camera_data.frustum_planes,
+                                   &rq2d = self.render_queue_2d](ParticleSystemComponent& system) {
+    if (!resolve_material(asset_man, system.material, system.resolved_material, system.resolved_material_id)) {
+      return;
+    }
+
+    for (const auto particle_id : system.particles) {
+      const auto e = flecs::entity(s.world, particle_id);
+      const auto* comp = e.is_alive() ? e.try_get<ParticleComponent>() : nullptr;
+      if (!comp || comp->life_remaining <= 0.0f)
+        continue;
+
+      const auto transform_id = s.get_entity_transform_id(e);
+      const auto* transform = transform_id ? s.get_entity_transform(*transform_id) : nullptr;
+      const auto* tc = e.try_get<TransformComponent>();
+      if (!transform || !tc) {
+        OX_LOG_WARN("No registered transform for particle entity: {}", e.name().c_str());
+        continue;
       }
-    });
-
-  self.scene.world
-    .query_builder<const AutoExposureComponent>() //
-    .build()
-    .each([&self](flecs::entity e, const AutoExposureComponent& c) {
-      self.gpu_scene_flags |= GPU::SceneFlags::HasEyeAdaptation;
-      self.eye_adaptation.max_exposure = c.max_exposure;
-      self.eye_adaptation.min_exposure = c.min_exposure;
-      self.eye_adaptation.adaptation_speed = c.adaptation_speed;
-      self.eye_adaptation.ev100_bias = c.ev100_bias;
-    });
-
-  self.scene.world
-    .query_builder<const TransformComponent, const VignetteComponent>() //
-    .build()
-    .each([&](flecs::entity e, const TransformComponent& tc, const VignetteComponent& c) {
-      self.post_proces_settings.vignette_amount = c.amount;
-
-      self.gpu_scene_flags |= GPU::SceneFlags::HasVignette;
-    });
-
-  self.scene.world
-    .query_builder<const TransformComponent, const ChromaticAberrationComponent>() //
-    .build()
-    .each([&](flecs::entity e, const TransformComponent& tc, const ChromaticAberrationComponent& c) {
+
+      // Bounds the quad however it is rotated.
+      const auto& world = transform->world;
+      const auto radius = 0.5f * (glm::length(glm::vec3(world[0])) + glm::length(glm::vec3(world[1])));
+      if (!sphere_on_frustum(planes, glm::vec3(world[3]), radius))
+        continue;
+
+      const auto distance = glm::abs(cam.position.z - tc->position.z);
+      rq2d.add(
+        GPU::RENDER_FLAGS_2D_SORT_Y,
+        tc->position.y,
+        SlotMap_decode_id(*transform_id).index,
+        SlotMap_decode_id(system.resolved_material_id).index,
+        distance
+      );
+    }
+  });
+
+  const auto gather_auto_exposure = [&self](const AutoExposureComponent& c) {
+    self.settings_scene_flags |= GPU::SceneFlags::HasEyeAdaptation;
+    self.eye_adaptation.max_exposure = c.max_exposure;
+    self.eye_adaptation.min_exposure = c.min_exposure;
+    self.eye_adaptation.adaptation_speed = c.adaptation_speed;
+    self.eye_adaptation.ev100_bias = c.ev100_bias;
+  };
+  gather_settings(self.auto_exposure_query, GPU::SceneFlags::HasEyeAdaptation, gather_auto_exposure);
+
+  gather_settings(self.vignette_query, GPU::SceneFlags::HasVignette, [&self](const VignetteComponent& c) {
+    self.post_proces_settings.vignette_amount = c.amount;
+
+    self.settings_scene_flags |= GPU::SceneFlags::HasVignette;
+  });
+
+  gather_settings(
+    self.chromatic_aberration_query,
+    GPU::SceneFlags::HasChromaticAberration,
+    [&self](const ChromaticAberrationComponent& c) {
       self.post_proces_settings.chromatic_aberration_amount = c.amount;
 
-      self.gpu_scene_flags |= GPU::SceneFlags::HasChromaticAberration;
-    });
-
-  self.scene.world
-    .query_builder<const TransformComponent, const FilmGrainComponent>() //
-    .build()
-    .each([&](flecs::entity e, const TransformComponent& tc, const FilmGrainComponent& c) {
-      self.post_proces_settings.film_grain_amount = c.amount;
-      self.post_proces_settings.film_grain_scale = c.scale;
-      self.post_proces_settings.film_grain_seed = render_context.num_frames % 16;
-
-      self.gpu_scene_flags |= GPU::SceneFlags::HasFilmGrain;
-    });
-
-  self.scene.world
-    .query_builder<const TonemappingComponent>() //
-    .build()
-    .each([&](flecs::entity e, const TonemappingComponent& tc) {
-      self.tonemap_type = tc.tonemap_type;
-      //
-    });
+      self.settings_scene_flags |= GPU::SceneFlags::HasChromaticAberration;
+    }
+  );
+
+  gather_settings(self.film_grain_query, GPU::SceneFlags::HasFilmGrain, [&self](const FilmGrainComponent& c) {
+    self.post_proces_settings.film_grain_amount = c.amount;
+    self.post_proces_settings.film_grain_scale = c.scale;
+
+    self.settings_scene_flags |= GPU::SceneFlags::HasFilmGrain;
+  });
+  // The grain moves every frame, whether the settings changed or not.
+  self.post_proces_settings.film_grain_seed = render_context.num_frames % 16;
+
+  gather_settings(self.tonemapping_query, GPU::SceneFlags::None, [&self](const TonemappingComponent& tc) {
+    self.tonemap_type = tc.tonemap_type;
+  });
+
+  self.gpu_scene_flags |= self.settings_scene_flags;
 
   auto zero_fill_pass = vuk::make_pass(
     "zero fill",
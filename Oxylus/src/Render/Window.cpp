@@ -208,9 +208,6 @@ auto Window::destroy() const -> void {
 }
 
 auto Window::update(const Timestep& timestep) const -> void {
-  auto& input = App::mod<Input>();
-  input.update();
-
   WindowCallbacks window_callbacks = {};
   window_callbacks.user_data = nullptr;
   window_callbacks.on_resize = [](void* user_data, const glm::uvec2 size) {
@@ -246,19 +243,13 @@ auto Window::update(const Timestep& timestep) const -> void {
       }
     }
 
-    auto& input_system = App::mod<Input>();
-    const auto ox_scan_code = static_cast<ScanCode>(scan_code);
-    const auto ox_mod = static_cast<ModCode>(mods);
-    input_system.set_mod(ox_mod);
-    if (down) {
-      input_system.set_key_pressed(ox_scan_code, !repeat);
-      input_system.set_key_released(ox_scan_code, false);
-      input_system.set_key_held(ox_scan_code, true);
-    } else {
-      input_system.set_key_pressed(ox_scan_code, false);
-      input_system.set_key_released(ox_scan_code, true);
-      input_system.set_key_held(ox_scan_code, false);
-    }
+    App::mod<Input>().push_event({
+      .type = InputEventType::Key,
+      .down = down,
+      .repeat = repeat,
+      .mod = static_cast<ModCode>(mods),
+      .code = scan_code,
+    });
   };
   window_callbacks.on_text_input = [](void* user_data, const c8* text) {
     if (App::has_mod<ImGuiRenderer>()) {
@@ -289,10 +280,7 @@ auto Window::update(const Timestep& timestep) const -> void {
       }
     }
 
-    auto& input_system = App::mod<Input>();
-    input_system.set_mouse_position(position);
-    input_system.set_mouse_position_rel(relative);
-    input_system.set_mouse_moved(true);
+    App::mod<Input>().push_event({.type = InputEventType::MouseMotion, .value = position, .relative = relative});
   };
 
   window_callbacks.on_mouse_button = [](void* user_data, u32 instance_id, const u8 button, const bool down) {
@@ -321,16 +309,7 @@ auto Window::update(const Timestep& timestep) const -> void {
       }
     }
 
-    auto& input_system = App::mod<Input>();
-    if (down) {
-      input_system.set_mouse_clicked(ox_mouse_button, true);
-      input_system.set_mouse_released(ox_mouse_button, false);
-      input_system.set_mouse_held(ox_mouse_button, true);
-    } else {
-      input_system.set_mouse_clicked(ox_mouse_button, false);
-      input_system.set_mouse_released(ox_mouse_button, true);
-      input_system.set_mouse_held(ox_mouse_button, false);
-    }
+    App::mod<Input>().push_event({.type = InputEventType::MouseButton, .down = down, .code = button});
   };
   window_callbacks.on_mouse_scroll = [](void* user_data, u32 instance_id, const glm::vec2 offset) {
     if (App::has_mod<ImGuiRenderer>()) {
@@ -345,27 +324,25 @@ auto Window::update(const Timestep& timestep) const -> void {
       }
     }
 
-    auto& input_system = App::mod<Input>();
-    input_system.set_mouse_scroll_offset_y(offset.y);
+    App::mod<Input>().push_event({.type = InputEventType::MouseScroll, .value = offset});
   };
 
   window_callbacks.on_gamepad_axis = [](void* user_data, u8 axis, i16 value, u32 instance_id) {
-    auto& input_system = App::mod<Input>();
-    auto ox_axis_code = static_cast<GamepadAxisCode>(axis);
-    input_system.set_gamepad_axis(instance_id, ox_axis_code, value);
+    App::mod<Input>().push_event({
+      .type = InputEventType::GamepadAxis,
+      .code = axis,
+      .instance_id = instance_id,
+      .value = glm::vec2(static_cast<f32>(value), 0.0f),
+    });
   };
 
   window_callbacks.on_gamepad = [](void* user_data, u32 button_code, u32 instance_id, bool down) {
-    auto& input_system = App::mod<Input>();
-    const auto ox_button_code = static_cast<GamepadButtonCode>(button_code);
-
-    if (down) {
-      input_system.set_gamepad_button_pressed(instance_id, ox_button_code, true);
-      input_system.set_gamepad_button_released(instance_id, ox_button_code, false);
-    } else {
-      input_system.set_gamepad_button_pressed(instance_id, ox_button_code, false);
-      input_system.set_gamepad_button_released(instance_id, ox_button_code, true);
-    }
+    App::mod<Input>().push_event({
+      .type = InputEventType::GamepadButton,
+      .down = down,
+      .code = button_code,
+      .instance_id = instance_id,
+    });
   };
 
   window_callbacks.on_gamepad_added = [](void* user_data, u32 instance_id) {
@@ -380,6 +357,9 @@ auto Window::update(const Timestep& timestep) const -> void {
   impl->cursor_overridden = false;
 
   poll(window_callbacks);
+
+  // After polling, so this frame's action states see this frame's events.
+  App::mod<Input>().update();
 }
 
 auto Window::poll(const WindowCallbacks& callbacks) const -> void {
@@ -55,7 +55,10 @@ CoreComponentsModule::CoreComponentsModule(flecs::world& world) {
 
   {
     using C = TransformComponent;
-    registry.bind<&C::position, &C::rotation, &C::scale>().tags<Networked>();
+    registry.bind<&C::position, &C::rotation, &C::scale>()
+      .tags<Networked>()
+      .member_hint<&C::position>(NetQuantize{.precision = 1.0f / 1024.0f})
+      .member_hint<&C::scale>(NetQuantize{.precision = 1.0f / 1024.0f});
   }
 
   // Layer
@@ -11,7 +11,6 @@
 #include <Jolt/Physics/Collision/Shape/CapsuleShape.h>
 #include <Jolt/Physics/Collision/Shape/CylinderShape.h>
 #include <Jolt/Physics/Collision/Shape/MeshShape.h>
-#include <Jolt/Physics/Collision/Shape/MutableCompoundShape.h>
 #include <Jolt/Physics/Collision/Shape/RotatedTranslatedShape.h>
 #include <Jolt/Physics/Collision/Shape/SphereShape.h>
 #include <Jolt/Physics/Collision/Shape/TaperedCapsuleShape.h>
@@ -39,6 +38,11 @@
 #include "Utils/Timestep.hpp"
 
 namespace ox {
+namespace {
+// Stage of the parallel Lua system running on this thread, see `Scene::update_parallel_lua_systems`.
+thread_local ecs_world_t* script_stage = nullptr;
+} // namespace
+
 struct JsonEntityDeserializer : IEntitySerializer {
   simdjson::ondemand::value json_value;
   memory::ScopedStack stack;
@@ -393,6 +397,10 @@ Scene::~Scene() {
   if (running)
     runtime_stop();
 
+  if (App::has_mod<Physics>()) {
+    App::mod<Physics>().trim_shape_cache();
+  }
+
   for (auto& [uuid, system] : lua_systems) {
     system->on_remove(this);
   }
@@ -403,7 +411,7 @@ Scene::~Scene() {
 
   if (App::has_mod<LuaManager>()) {
     auto& lua_manager = App::mod<LuaManager>();
-    lua_manager.get_state()->collect_gc();
+    lua_manager.collect_gc();
   }
 }
 
@@ -478,15 +486,15 @@ auto Scene::init(this Scene& self, const std::string& name) -> void {
   self.world.observer<TransformComponent, SpriteComponent>()
     .event(flecs::OnSet)
     .event(flecs::OnAdd)
+    .event(flecs::OnRemove)
     .each([&self](flecs::iter& it, usize i, TransformComponent&, SpriteComponent& sprite) {
       auto entity = it.entity(i);
-      // Set sprite rect
-      if (auto id = self.get_entity_transform_id(entity)) {
-        if (auto* transform = self.get_entity_transform(*id)) {
-          sprite.rect = AABB(glm::vec3(-0.5, -0.5, -0.5), glm::vec3(0.5, 0.5, 0.5));
-          sprite.rect = sprite.rect.get_transformed(transform->world);
-        }
+      if (it.event() == flecs::OnRemove) {
+        self.sprite_grid.remove(entity.id());
+        return;
       }
+
+      self.update_sprite_rect(entity, sprite);
     });
 
   self.world.observer<SpriteComponent>()
@@ -522,6 +530,10 @@ auto Scene::init(this Scene& self, const std::string& name) -> void {
     .event(flecs::OnSet)
     .event(flecs::OnAdd)
     .each([](flecs::iter& it, usize i, AudioListenerComponent& c) {
+      // Headless apps don't run an audio engine, sources never load there either.
+      if (!App::has_mod<AudioEngine>())
+        return;
+
       auto& audio_engine = App::mod<AudioEngine>();
       audio_engine.set_listener_cone(c.listener_index, c.cone_inner_angle, c.cone_outer_angle, c.cone_outer_gain);
     });
@@ -674,7 +686,7 @@ auto Scene::init(this Scene& self, const std::string& name) -> void {
   self.world.system<const TransformComponent, AudioListenerComponent>("audio_listener_update")
     .kind(flecs::PreUpdate)
     .each([&self](const flecs::entity& e, const TransformComponent& tc, AudioListenerComponent& ac) {
-      if (ac.active) {
+      if (ac.active && App::has_mod<AudioEngine>()) {
         auto& audio_engine = App::mod<AudioEngine>();
         const glm::mat4 inverted = glm::inverse(self.get_world_transform(e));
         const glm::vec3 forward = normalize(glm::vec3(inverted[2]));
@@ -721,40 +733,86 @@ auto Scene::init(this Scene& self, const std::string& name) -> void {
       self.physics_system->Update(self.physics_interval, 1, p.get_temp_allocator(), p.get_job_system());
     });
 
-  self.world.system<TransformComponent, RigidBodyComponent>("rigidbody_update")
+  self.world.system("rigidbody_update")
     .kind(flecs::OnUpdate)
     .tick_source(physics_tick_source)
-    .each([&self](const flecs::entity& e, TransformComponent& tc, RigidBodyComponent& rb) {
-      if (!rb.runtime_body)
-        return;
+    .run([&self](flecs::iter& it) {
+      ZoneScopedN("rigidbody_update");
+
+      // Bodies that moved on the previous tick land on their final pose first. The ones still
+      // active get overwritten below, the ones that fell asleep get one more interpolation pass.
+      std::swap(self.physics_moving_bodies, self.physics_settling_bodies);
+      self.physics_moving_bodies.clear();
+      for (auto& e : self.physics_settling_bodies) {
+        auto* rb = e.is_alive() ? e.try_get_mut<RigidBodyComponent>() : nullptr;
+        if (!rb || !rb->moving) {
+          e = {};
+          continue;
+        }
 
-      const auto* body = static_cast<const JPH::Body*>(rb.runtime_body);
-      const auto& body_interface = self.physics_system->GetBodyInterface();
+        rb->previous_translation = rb->translation;
+        rb->previous_rotation = rb->rotation;
+        rb->moving = false;
+      }
 
-      if (!body_interface.IsActive(body->GetID()))
-        return;
+      // Only bodies Jolt simulated this tick are read back, sleeping ones are never touched.
+      self.physics_active_bodies.clear();
+      self.physics_system->GetActiveBodies(JPH::EBodyType::RigidBody, self.physics_active_bodies);
+
+      // Update() has returned, nothing else writes to the bodies until the next tick.
+      const auto& lock_interface = self.physics_system->GetBodyLockInterfaceNoLock();
+      for (const auto& body_id : self.physics_active_bodies) {
+        const auto* body = lock_interface.TryGetBody(body_id);
+        if (!body)
+          continue;
+
+        auto e = flecs::entity(it.world(), static_cast<flecs::entity_t>(body->GetUserData()));
+        auto* rb = e.is_alive() ? e.try_get_mut<RigidBodyComponent>() : nullptr;
+        if (!rb || rb->runtime_body != body)
+          continue; // character controllers and bodies owned by something else
 
-      const JPH::Vec3 position = body->GetPosition();
-      const JPH::Quat rotation = body->GetRotation();
+        const JPH::RVec3 position = body->GetPosition();
+        const JPH::Quat rotation = body->GetRotation();
 
-      rb.previous_translation = rb.translation;
-      rb.previous_rotation = rb.rotation;
-      rb.translation = {position.GetX(), position.GetY(), position.GetZ()};
-      rb.rotation = glm::quat::wxyz(rotation.GetW(), rotation.GetX(), rotation.GetY(), rotation.GetZ());
+        rb->previous_translation = rb->translation;
+        rb->previous_rotation = rb->rotation;
+        rb->translation = {position.GetX(), position.GetY(), position.GetZ()};
+        rb->rotation = glm::quat::wxyz(rotation.GetW(), rotation.GetX(), rotation.GetY(), rotation.GetZ());
+        rb->moving = true;
+
+        self.physics_moving_bodies.push_back(e);
+      }
+
+      for (auto e : self.physics_settling_bodies) {
+        if (e && !e.get<RigidBodyComponent>().moving)
+          self.physics_moving_bodies.push_back(e);
+      }
+      self.physics_settling_bodies.clear();
     });
 
-  self.world.system<TransformComponent, const RigidBodyComponent>("physics_interpolate")
+  self.world.system("physics_interpolate")
     .kind(flecs::OnUpdate)
-    .each([&self](const flecs::entity& e, TransformComponent& tc, const RigidBodyComponent& rb) {
-      if (!rb.runtime_body)
-        return;
+    .run([&self](flecs::iter& it) {
+      ZoneScopedN("physics_interpolate");
 
       f32 alpha = std::clamp(self.physics_accumulator / self.physics_interval, 0.0f, 1.0f);
 
-      tc.position = glm::mix(rb.previous_translation, rb.translation, alpha);
-      tc.rotation = glm::slerp(rb.previous_rotation, rb.rotation, alpha);
+      for (auto e : self.physics_moving_bodies) {
+        if (!e.is_alive())
+          continue;
 
-      e.modified<TransformComponent>();
+        auto* tc = e.try_get_mut<TransformComponent>();
+        const auto* rb = e.try_get<RigidBodyComponent>();
+        if (!tc || !rb || !rb->runtime_body)
+          continue;
+
+        tc->position = glm::mix(rb->previous_translation, rb->translation, alpha);
+        tc->rotation = glm::slerp(rb->previous_rotation, rb->rotation, alpha);
+
+        // Written straight into the column, going through modified() here would run every
+        // TransformComponent observer (mesh re-attach included) for each body, every frame.
+        self.sync_transform(e);
+      }
     });
 
   self.world.system<TransformComponent, CharacterControllerComponent>("character_controller_update")
@@ -960,7 +1018,7 @@ auto Scene::init(this Scene& self, const std::string& name) -> void {
   self.world.system<SpriteComponent>("sprite_aabb")
     .kind(flecs::PostUpdate)
     .each([cvar = &self.renderer_cvar](const flecs::entity entity, SpriteComponent& sprite) {
-      if (cvar->cvar_draw_bounding_boxes.get()) {
+      if (cvar->cvar_draw_bounding_boxes.get() && App::has_mod<DebugRenderer>()) {
         auto& debug_renderer = App::mod<DebugRenderer>();
         debug_renderer.draw_aabb(sprite.rect, glm::vec4(1, 1, 1, 1.0f));
       }
@@ -969,7 +1027,7 @@ auto Scene::init(this Scene& self, const std::string& name) -> void {
   self.world.system<MeshComponent>("mesh_aabb")
     .kind(flecs::PostUpdate)
     .each([cvar = &self.renderer_cvar](const flecs::entity entity, MeshComponent& mc) {
-      if (cvar->cvar_draw_bounding_boxes.get()) {
+      if (cvar->cvar_draw_bounding_boxes.get() && App::has_mod<DebugRenderer>()) {
         auto& debug_renderer = App::mod<DebugRenderer>();
         debug_renderer.draw_aabb(mc.world_aabb, glm::vec4(0.f, 1.f, 0.f, 1.0f));
       }
@@ -1039,16 +1097,39 @@ auto Scene::physics_init(this Scene& self) -> void {
   self.physics_system->SetContactListener(self.contact_listener_3d.get());
 
   // Rigidbodies
+  // Bodies are created first and inserted into the broadphase in two batches (one per activation
+  // mode), inserting them one by one would rebuild the broadphase tree for every single body.
+  auto active_bodies = JPH::BodyIDVector{};
+  auto inactive_bodies = JPH::BodyIDVector{};
   self.world.query_builder<const TransformComponent, RigidBodyComponent>().build().each(
-    [&self](flecs::entity e, const TransformComponent& tc, RigidBodyComponent& rb) {
+    [&](flecs::entity e, const TransformComponent& tc, RigidBodyComponent& rb) {
       if (rb.runtime_body == nullptr) {
         rb.previous_translation = rb.translation = tc.position;
         rb.previous_rotation = rb.rotation = tc.rotation;
-        self.create_rigidbody(e, tc, rb);
+        rb.moving = false;
+        auto* body = self.create_body(e, tc, rb);
+        if (!body)
+          return;
+
+        if (rb.awake && rb.type != RigidBodyComponent::BodyType::Static)
+          active_bodies.push_back(body->GetID());
+        else
+          inactive_bodies.push_back(body->GetID());
       }
     }
   );
 
+  auto& body_interface = self.physics_system->GetBodyInterface();
+  const auto add_bodies = [&body_interface](JPH::BodyIDVector& ids, JPH::EActivation activation) {
+    if (ids.empty())
+      return;
+
+    auto add_state = body_interface.AddBodiesPrepare(ids.data(), static_cast<i32>(ids.size()));
+    body_interface.AddBodiesFinalize(ids.data(), static_cast<i32>(ids.size()), add_state, activation);
+  };
+  add_bodies(active_bodies, JPH::EActivation::Activate);
+  add_bodies(inactive_bodies, JPH::EActivation::DontActivate);
+
   // Characters
   self.world.query_builder<const TransformComponent, CharacterControllerComponent>().build().each(
     [&self](flecs::entity e, const TransformComponent& tc, CharacterControllerComponent& ch) {
@@ -1064,15 +1145,23 @@ auto Scene::physics_init(this Scene& self) -> void {
 auto Scene::physics_deinit(this Scene& self) -> void {
   ZoneScoped;
 
-  self.world.query_builder<RigidBodyComponent>().build().each([&self](const flecs::entity& e, RigidBodyComponent& rb) {
+  auto body_ids = JPH::BodyIDVector{};
+  self.world.query_builder<RigidBodyComponent>().build().each([&body_ids](const flecs::entity& e, RigidBodyComponent& rb) {
     if (rb.runtime_body) {
-      JPH::BodyInterface& body_interface = self.physics_system->GetBodyInterface();
-      const auto* body = static_cast<const JPH::Body*>(rb.runtime_body);
-      body_interface.RemoveBody(body->GetID());
-      body_interface.DestroyBody(body->GetID());
+      body_ids.push_back(static_cast<const JPH::Body*>(rb.runtime_body)->GetID());
       rb.runtime_body = nullptr;
+      rb.moving = false;
     }
   });
+
+  if (!body_ids.empty()) {
+    JPH::BodyInterface& body_interface = self.physics_system->GetBodyInterface();
+    body_interface.RemoveBodies(body_ids.data(), static_cast<i32>(body_ids.size()));
+    body_interface.DestroyBodies(body_ids.data(), static_cast<i32>(body_ids.size()));
+  }
+  self.physics_moving_bodies.clear();
+  self.physics_settling_bodies.clear();
+
   self.world.query_builder<CharacterControllerComponent>().build().each(
     [&self](const flecs::entity& e, CharacterControllerComponent& ch) {
       if (ch.character) {
@@ -1143,15 +1232,20 @@ auto Scene::runtime_update(this Scene& self, const Timestep& delta_time) -> void
   auto pre_update_phase_enabled = !self.world.entity(flecs::PreUpdate).has(flecs::Disabled);
   auto on_update_phase_enabled = !self.world.entity(flecs::OnUpdate).has(flecs::Disabled);
   if (pre_update_phase_enabled && on_update_phase_enabled) {
+    const auto dt = static_cast<f32>(delta_time.get_seconds());
     for (auto& [uuid, system] : self.lua_systems) {
-      system->on_scene_update(&self, static_cast<f32>(delta_time.get_seconds()));
+      if (!system->is_parallel()) {
+        system->on_scene_update(&self, dt);
+      }
     }
+
+    self.update_parallel_lua_systems(dt);
   }
 
   // TODO: Pass our delta_time?
   self.world.progress();
 
-  if (self.renderer_cvar.cvar_enable_physics_debug_renderer.get()) {
+  if (self.renderer_cvar.cvar_enable_physics_debug_renderer.get() && App::has_mod<DebugRenderer>()) {
     JPH::BodyManager::DrawSettings settings{};
     settings.mDrawShape = true;
     settings.mDrawShapeWireframe = true;
@@ -1292,6 +1386,61 @@ auto Scene::remove_lua_system(this Scene& self, const UUID& lua_script) -> void
   self.lua_systems.erase(lua_script);
 }
 
+auto Scene::get_script_world(this const Scene& self) -> ecs_world_t* {
+  return script_stage ? script_stage : self.world.world_;
+}
+
+// Systems marked parallel run on job workers after the serial ones, each in its own Lua state. The world is
+// read only meanwhile, every system gets a stage of its own and whatever it does to the world through it is
+// deferred until `readonly_end` merges all stages back on this thread.
+auto Scene::update_parallel_lua_systems(this Scene& self, f32 delta_time) -> void {
+  ZoneScoped;
+
+  self.parallel_lua_systems.clear();
+  for (auto& [uuid, system] : self.lua_systems) {
+    if (system->is_parallel()) {
+      self.parallel_lua_systems.push_back(system);
+    }
+  }
+
+  if (self.parallel_lua_systems.empty()) {
+    return;
+  }
+
+  const auto system_count = static_cast<i32>(self.parallel_lua_systems.size());
+  if (self.world.get_stage_count() < system_count) {
+    self.world.set_stage_count(system_count);
+  }
+
+  auto run_system = [&self, delta_time](usize index) {
+    script_stage = self.world.get_stage(static_cast<i32>(index)).c_ptr();
+    auto* system = self.parallel_lua_systems[index];
+    system->on_scene_update(&self, delta_time);
+    system->step_gc();
+    script_stage = nullptr;
+  };
+
+  self.world.readonly_begin(true);
+
+  auto& job_man = App::get_job_manager();
+  if (job_man.get_thread_count() == 0) {
+    for (auto i = 0_sz; i < self.parallel_lua_systems.size(); i++) {
+      run_system(i);
+    }
+  } else {
+    auto barrier = Barrier::create();
+    barrier->acquire(static_cast<u32>(system_count));
+    job_man.push_job_name("Parallel Lua system");
+    for (auto i = 0_sz; i < self.parallel_lua_systems.size(); i++) {
+      job_man.submit(Job::create([&run_system, i] { run_system(i); })->signal(barrier));
+    }
+    job_man.pop_job_name();
+    barrier->wait();
+  }
+
+  self.world.readonly_end();
+}
+
 auto Scene::get_physics_system(this const Scene& self) -> JPH::PhysicsSystem* {
   ZoneScoped;
 
@@ -1539,6 +1688,34 @@ auto Scene::get_entity_transform(GPU::TransformID transform_id) const -> const G
   return transforms.slotc(transform_id);
 }
 
+auto Scene::sync_transform(this Scene& self, flecs::entity entity) -> void {
+  ZoneScoped;
+
+  self.set_dirty(entity);
+
+  if (auto* mc = entity.try_get_mut<MeshComponent>()) {
+    if (auto id = self.get_entity_transform_id(entity)) {
+      if (auto* transform = self.get_entity_transform(*id)) {
+        mc->world_aabb = mc->baked_aabb.get_transformed(transform->world);
+      }
+    }
+  }
+
+  if (auto* sprite = entity.try_get_mut<SpriteComponent>()) {
+    self.update_sprite_rect(entity, *sprite);
+  }
+}
+
+auto Scene::update_sprite_rect(this Scene& self, flecs::entity entity, SpriteComponent& sprite) -> void {
+  if (auto id = self.get_entity_transform_id(entity)) {
+    if (auto* transform = self.get_entity_transform(*id)) {
+      sprite.rect = AABB(glm::vec3(-0.5, -0.5, -0.5), glm::vec3(0.5, 0.5, 0.5));
+      sprite.rect = sprite.rect.get_transformed(transform->world);
+      self.sprite_grid.insert_or_update(entity.id(), sprite.rect);
+    }
+  }
+}
+
 auto Scene::add_transform(this Scene& self, flecs::entity entity) -> GPU::TransformID {
   ZoneScoped;
 
@@ -1705,76 +1882,104 @@ auto Scene::create_rigidbody(
     component.runtime_body = nullptr;
   }
 
-  JPH::MutableCompoundShapeSettings compound_shape_settings = {};
-  float max_scale_component = glm::max(glm::max(transform.scale.x, transform.scale.y), transform.scale.z);
+  auto* body = self.create_body(entity, transform, component);
+  if (!body)
+    return;
 
-  const auto entity_name = std::string(entity.name());
+  JPH::EActivation activation = component.awake && component.type != RigidBodyComponent::BodyType::Static
+                                  ? JPH::EActivation::Activate
+                                  : JPH::EActivation::DontActivate;
+  body_interface.AddBody(body->GetID(), activation);
+}
 
-  JPH::ShapeSettings::ShapeResult shape_result = {};
-  glm::vec3 offset = {};
+auto Scene::create_body(
+  this Scene& self, flecs::entity entity, const TransformComponent& transform, RigidBodyComponent& component
+) -> JPH::Body* {
+  ZoneScoped;
+
+  auto& body_interface = self.physics_system->GetBodyInterface();
 
+  float max_scale_component = glm::max(glm::max(transform.scale.x, transform.scale.y), transform.scale.z);
+
+  // Colliders only describe the shape, the shape itself is shared between every entity
+  // that ends up with the same parameters.
+  auto shape_key = option<ShapeKey>(nullopt);
   if (const auto* bc = entity.try_get<BoxColliderComponent>()) {
-    const JPH::Ref<PhysicsMaterial3D>
-      mat = new PhysicsMaterial3D(entity_name, JPH::ColorArg(255, 0, 0), bc->friction, bc->restitution);
-
-    glm::vec3 scale = bc->size;
-    JPH::BoxShapeSettings shape_settings({glm::abs(scale.x), glm::abs(scale.y), glm::abs(scale.z)}, 0.05f, mat);
-    shape_settings.SetDensity(glm::max(0.001f, bc->density));
-    shape_result = shape_settings.Create();
-    offset = bc->offset;
+    shape_key = ShapeKey{
+      .type = ShapeType::Box,
+      .dimensions = glm::abs(bc->size),
+      .offset = bc->offset,
+      .density = bc->density,
+      .friction = bc->friction,
+      .restitution = bc->restitution,
+    };
   } else if (const auto* scc = entity.try_get<SphereColliderComponent>()) {
-    const JPH::Ref<PhysicsMaterial3D>
-      mat = new PhysicsMaterial3D(entity_name, JPH::ColorArg(255, 0, 0), scc->friction, scc->restitution);
-
     float radius = 2.0f * scc->radius * max_scale_component;
-    JPH::SphereShapeSettings shape_settings(glm::max(0.01f, radius), mat);
-    shape_settings.SetDensity(glm::max(0.001f, scc->density));
-    shape_result = shape_settings.Create();
-    offset = scc->offset;
+    shape_key = ShapeKey{
+      .type = ShapeType::Sphere,
+      .dimensions = {glm::max(0.01f, radius), 0.0f, 0.0f},
+      .offset = scc->offset,
+      .density = scc->density,
+      .friction = scc->friction,
+      .restitution = scc->restitution,
+    };
   } else if (const auto* ccc = entity.try_get<CapsuleColliderComponent>()) {
-    const JPH::Ref<PhysicsMaterial3D>
-      mat = new PhysicsMaterial3D(entity_name, JPH::ColorArg(255, 0, 0), ccc->friction, ccc->restitution);
-
     float radius = 2.0f * ccc->radius * max_scale_component;
-    JPH::CapsuleShapeSettings shape_settings(glm::max(0.01f, ccc->height) * 0.5f, glm::max(0.01f, radius), mat);
-    shape_settings.SetDensity(glm::max(0.001f, ccc->density));
-    shape_result = shape_settings.Create();
-    offset = ccc->offset;
+    shape_key = ShapeKey{
+      .type = ShapeType::Capsule,
+      .dimensions = {glm::max(0.01f, radius), glm::max(0.01f, ccc->height) * 0.5f, 0.0f},
+      .offset = ccc->offset,
+      .density = ccc->density,
+      .friction = ccc->friction,
+      .restitution = ccc->restitution,
+    };
   } else if (const auto* tcc = entity.try_get<TaperedCapsuleColliderComponent>()) {
-    const JPH::Ref<PhysicsMaterial3D>
-      mat = new PhysicsMaterial3D(entity_name, JPH::ColorArg(255, 0, 0), tcc->friction, tcc->restitution);
-
     float top_radius = 2.0f * tcc->top_radius * max_scale_component;
     float bottom_radius = 2.0f * tcc->bottom_radius * max_scale_component;
-    JPH::TaperedCapsuleShapeSettings shape_settings(
-      glm::max(0.01f, tcc->height) * 0.5f,
-      glm::max(0.01f, top_radius),
-      glm::max(0.01f, bottom_radius),
-      mat
-    );
-    shape_settings.SetDensity(glm::max(0.001f, tcc->density));
-    shape_result = shape_settings.Create();
-    offset = tcc->offset;
+    shape_key = ShapeKey{
+      .type = ShapeType::TaperedCapsule,
+      .dimensions = {glm::max(0.01f, top_radius), glm::max(0.01f, tcc->height) * 0.5f, glm::max(0.01f, bottom_radius)},
+      .offset = tcc->offset,
+      .density = tcc->density,
+      .friction = tcc->friction,
+      .restitution = tcc->restitution,
+    };
   } else if (const auto* cycc = entity.try_get<CylinderColliderComponent>()) {
-    const JPH::Ref<PhysicsMaterial3D>
-      mat = new PhysicsMaterial3D(entity_name, JPH::ColorArg(255, 0, 0), cycc->friction, cycc->restitution);
-
     float radius = 2.0f * cycc->radius * max_scale_component;
-    JPH::CylinderShapeSettings
-      shape_settings(glm::max(0.01f, cycc->height) * 0.5f, glm::max(0.01f, radius), 0.05f, mat);
-    shape_settings.SetDensity(glm::max(0.001f, cycc->density));
-    shape_result = shape_settings.Create();
-    offset = cycc->offset;
+    shape_key = ShapeKey{
+      .type = ShapeType::Cylinder,
+      .dimensions = {glm::max(0.01f, radius), glm::max(0.01f, cycc->height) * 0.5f, 0.0f},
+      .offset = cycc->offset,
+      .density = cycc->density,
+      .friction = cycc->friction,
+      .restitution = cycc->restitution,
+    };
+  } else if (const auto* mcc = entity.try_get<MeshColliderComponent>()) {
+    if (const auto* mc = entity.try_get<MeshComponent>(); mc && mc->model_uuid) {
+      shape_key = ShapeKey{
+        .type = ShapeType::Mesh,
+        .dimensions = transform.scale,
+        .offset = mcc->offset,
+        .mesh_uuid = mc->model_uuid,
+        .mesh_index = mc->mesh_index,
+      };
+    } else {
+      OX_LOG_ERROR("Mesh collider on '{}' needs a MeshComponent with a model.", entity.name().c_str());
+    }
   }
 
-  if (shape_result.HasError()) {
-    OX_LOG_ERROR("Jolt shape error: {}", shape_result.GetError().c_str());
+  if (!shape_key.has_value()) {
+    return nullptr; // No Shape
   }
 
-  if (!shape_result.IsEmpty()) {
-    compound_shape_settings.AddShape({offset.x, offset.y, offset.z}, JPH::Quat::sIdentity(), shape_result.Get());
-  } else {
-    return; // No Shape
+  if (shape_key->type != ShapeType::Mesh) {
+    shape_key->density = glm::max(0.001f, shape_key->density);
+  }
+
+  auto& physics = App::mod<Physics>();
+  auto shape = physics.get_shape(*shape_key);
+  if (shape == nullptr) {
+    return nullptr;
   }
 
   // Body
@@ -1785,13 +1990,8 @@ auto Scene::create_rigidbody(
     layer_index = layer_component->layer;
   }
 
-  auto compound_shape = compound_shape_settings.Create();
-  if (compound_shape.HasError()) {
-    OX_LOG_ERROR("Jolt shape error: {}", compound_shape.GetError().c_str());
-  }
-
   JPH::BodyCreationSettings body_settings(
-    compound_shape.Get(),
+    shape,
     {transform.position.x, transform.position.y, transform.position.z},
     {rotation.x, rotation.y, rotation.z, rotation.w},
     static_cast<JPH::EMotionType>(component.type),
@@ -1813,18 +2013,21 @@ auto Scene::create_rigidbody(
 
   body_settings.mIsSensor = component.is_sensor;
 
+  // Baked mesh shapes carry no materials, use the collider's surface for the whole body.
+  if (const auto* mcc = entity.try_get<MeshColliderComponent>(); mcc && shape_key->type == ShapeType::Mesh) {
+    body_settings.mFriction = mcc->friction;
+    body_settings.mRestitution = mcc->restitution;
+  }
+
   JPH::Body* body = body_interface.CreateBody(body_settings);
 
   OX_CHECK_NULL(body, "Jolt is out of bodies!");
 
-  JPH::EActivation activation = component.awake && component.type != RigidBodyComponent::BodyType::Static
-                                  ? JPH::EActivation::Activate
-                                  : JPH::EActivation::DontActivate;
-  body_interface.AddBody(body->GetID(), activation);
-
   body->SetUserData(static_cast<u64>(entity.id()));
 
   component.runtime_body = body;
+
+  return body;
 }
 
 void Scene::create_character_controller(
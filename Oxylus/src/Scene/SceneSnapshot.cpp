@@ -1,125 +1,480 @@
 #include "Scene/SceneSnapshot.hpp"
 
-#include <fmt/base.h>
+#include <algorithm>
+#include <ankerl/svector.h>
+#include <cstring>
+#include <tuple>
 
 #include "Scene/Components.hpp"
+#include "Utils/Log.hpp"
 
 namespace ox {
-auto SceneSnapshotBuilder::set_current(this SceneSnapshotBuilder& self, SceneState& new_state) -> void {
+namespace {
+auto hash_bytes(const void* data, usize size) -> u64 {
+  return ankerl::unordered_dense::detail::wyhash::hash(data, size);
+}
+
+auto emit_component(SnapshotDelta& delta, const SnapshotColumn& column, flecs::entity_t entity, u32 row) -> void {
+  delta.records.push_back({
+    .entity = entity,
+    .component_id = column.component_id,
+    .offset = column.data_offset + static_cast<usize>(row) * column.size,
+    .size = column.size,
+  });
+}
+
+auto emit_removed_component(SnapshotDelta& delta, flecs::entity_t entity, flecs::id_t component_id) -> void {
+  delta.records.push_back({.entity = entity, .component_id = component_id, .removed = true});
+}
+
+auto emit_entity(SnapshotDelta& delta, const SnapshotFrame& frame, const SnapshotTable& table, u32 row) -> void {
+  const auto entity = frame.table_entities(table)[row];
+  for (const auto& column : frame.table_columns(table)) {
+    emit_component(delta, column, entity, row);
+  }
+}
+
+auto elements_equal(
+  const SnapshotFrame& base,
+  const SnapshotColumn& base_column,
+  u32 base_row,
+  const SnapshotFrame& frame,
+  const SnapshotColumn& column,
+  u32 row
+) -> bool {
+  if (base_column.size != column.size) {
+    return false;
+  }
+
+  auto base_bytes = base.element(base_column, base_row);
+  auto bytes = frame.element(column, row);
+  return std::memcmp(base_bytes.data(), bytes.data(), bytes.size()) == 0;
+}
+
+// Walks two column lists sorted by component id, the same way a merge would.
+template <typename RemovedFn, typename AddedFn, typename BothFn>
+auto merge_columns(
+  std::span<const SnapshotColumn> base_columns,
+  std::span<const SnapshotColumn> columns,
+  RemovedFn&& on_removed,
+  AddedFn&& on_added,
+  BothFn&& on_both
+) -> void {
+  auto b = 0_sz;
+  auto c = 0_sz;
+  while (b < base_columns.size() || c < columns.size()) {
+    if (c == columns.size() || (b < base_columns.size() && base_columns[b].component_id < columns[c].component_id)) {
+      on_removed(base_columns[b++]);
+    } else if (b == base_columns.size() || columns[c].component_id < base_columns[b].component_id) {
+      on_added(columns[c++]);
+    } else {
+      on_both(base_columns[b++], columns[c++]);
+    }
+  }
+}
+
+auto diff_row(
+  SnapshotDelta& delta,
+  const SnapshotFrame& base,
+  const SnapshotTable& base_table,
+  u32 base_row,
+  const SnapshotFrame& frame,
+  const SnapshotTable& table,
+  u32 row
+) -> void {
+  const auto entity = frame.table_entities(table)[row];
+  merge_columns(
+    base.table_columns(base_table),
+    frame.table_columns(table),
+    [&](const SnapshotColumn& base_column) { emit_removed_component(delta, entity, base_column.component_id); },
+    [&](const SnapshotColumn& column) { emit_component(delta, column, entity, row); },
+    [&](const SnapshotColumn& base_column, const SnapshotColumn& column) {
+      if (!elements_equal(base, base_column, base_row, frame, column, row)) {
+        emit_component(delta, column, entity, row);
+      }
+    }
+  );
+}
+
+// Both tables hold the same entities in the same order, so columns can be compared chunk by chunk.
+auto diff_aligned_table(
+  SnapshotDelta& delta,
+  const SnapshotFrame& base,
+  const SnapshotTable& base_table,
+  const SnapshotFrame& frame,
+  const SnapshotTable& table
+) -> void {
+  const auto entities = frame.table_entities(table);
+  merge_columns(
+    base.table_columns(base_table),
+    frame.table_columns(table),
+    [&](const SnapshotColumn& base_column) {
+      for (auto entity : entities) {
+        emit_removed_component(delta, entity, base_column.component_id);
+      }
+    },
+    [&](const SnapshotColumn& column) {
+      for (auto row = 0_u32; row < table.row_count; row++) {
+        emit_component(delta, column, entities[row], row);
+      }
+    },
+    [&](const SnapshotColumn& base_column, const SnapshotColumn& column) {
+      if (column.size == 0 && base_column.size == 0) {
+        return;
+      }
+
+      for (auto chunk_row = 0_u32; chunk_row < table.row_count; chunk_row += SnapshotFrame::CHUNK_ROWS) {
+        const auto chunk = chunk_row / SnapshotFrame::CHUNK_ROWS;
+        if (base_column.size == column.size &&
+            base.chunk_hashes[base_column.hash_offset + chunk] == frame.chunk_hashes[column.hash_offset + chunk]) {
+          continue;
+        }
+
+        const auto chunk_end = std::min(chunk_row + SnapshotFrame::CHUNK_ROWS, table.row_count);
+        for (auto row = chunk_row; row < chunk_end; row++) {
+          if (!elements_equal(base, base_column, row, frame, column, row)) {
+            emit_component(delta, column, entities[row], row);
+          }
+        }
+      }
+    }
+  );
+}
+} // namespace
+
+auto SnapshotFrame::index_rows(this SnapshotFrame& self) -> void {
   ZoneScoped;
 
-  auto& current = self.current();
-  current.clear();
-  current = new_state; // There is gotta be a way to optimize this copy
+  if (self.rows_indexed) {
+    return;
+  }
+
+  self.rows.clear();
+  self.rows.reserve(self.entities.size());
+  for (auto table_index = 0_u32; table_index < self.tables.size(); table_index++) {
+    const auto& table = self.tables[table_index];
+    const auto entities = self.table_entities(table);
+    for (auto row = 0_u32; row < table.row_count; row++) {
+      self.rows.emplace(entities[row], SnapshotRow{.table_index = table_index, .row = row});
+    }
+  }
+
+  self.rows_indexed = true;
+}
+
+auto SnapshotFrame::find_row(this const SnapshotFrame& self, flecs::entity_t entity) -> option<SnapshotRow> {
+  OX_ASSERT(self.rows_indexed);
+
+  auto it = self.rows.find(entity);
+  if (it == self.rows.end()) {
+    return nullopt;
+  }
+
+  return it->second;
+}
+
+auto SnapshotFrame::find_column(this const SnapshotFrame& self, const SnapshotTable& table, flecs::id_t component_id)
+  -> const SnapshotColumn* {
+  for (const auto& column : self.table_columns(table)) {
+    if (column.component_id == component_id) {
+      return &column;
+    }
+  }
+
+  return nullptr;
+}
+
+auto SnapshotFrame::find_table(this const SnapshotFrame& self, u64 type_hash) -> option<u32> {
+  auto it = self.table_lookup.find(type_hash);
+  if (it == self.table_lookup.end()) {
+    return nullopt;
+  }
+
+  return it->second;
+}
+
+auto SnapshotFrame::table_entities(this const SnapshotFrame& self, const SnapshotTable& table)
+  -> std::span<const flecs::entity_t> {
+  return std::span(self.entities).subspan(table.row_offset, table.row_count);
+}
+
+auto SnapshotFrame::table_columns(this const SnapshotFrame& self, const SnapshotTable& table)
+  -> std::span<const SnapshotColumn> {
+  return std::span(self.columns).subspan(table.column_offset, table.column_count);
+}
+
+auto SnapshotFrame::element(this const SnapshotFrame& self, const SnapshotColumn& column, u32 row)
+  -> std::span<const u8> {
+  return std::span(self.arena).subspan(column.data_offset + static_cast<usize>(row) * column.size, column.size);
+}
+
+auto SnapshotDelta::bytes(this const SnapshotDelta& self, const SnapshotRecord& record) -> std::span<const u8> {
+  return std::span(self.frame->arena).subspan(record.offset, record.size);
+}
+
+auto SnapshotDelta::to_state(this const SnapshotDelta& self, SceneState& state) -> void {
+  ZoneScoped;
+
+  state.removed_entities.insert(self.removed_entities.begin(), self.removed_entities.end());
+  for (const auto& record : self.records) {
+    auto& entity_state = state.entities[record.entity];
+    entity_state.entity_id = record.entity;
+    if (record.removed) {
+      entity_state.removed_components.emplace(record.component_id);
+      continue;
+    }
+
+    auto component_state = ComponentState{.id = record.component_id, .hash = ~0_u64};
+    if (record.size != 0) {
+      const auto bytes = self.bytes(record);
+      component_state.hash = hash_bytes(bytes.data(), bytes.size());
+      component_state.buffer.assign(bytes.begin(), bytes.end());
+    }
+
+    entity_state.components.insert_or_assign(record.component_id, std::move(component_state));
+  }
+}
+
+auto SceneSnapshotBuilder::capture(this SceneSnapshotBuilder& self, flecs::world& world) -> void {
+  ZoneScoped;
+
+  take_snapshot(world, self.current());
+  self.frame_ids[self.current_sequence] = self.frame_counter++;
 }
 
 auto SceneSnapshotBuilder::advance(this SceneSnapshotBuilder& self) -> void {
   ZoneScoped;
 
   self.current_sequence = (self.current_sequence + 1) % MAX_SEQUENCES;
-  self.states[self.current_sequence].clear();
-  self.acks[self.current_sequence] = false;
+  self.frames[self.current_sequence].clear();
+  self.frame_ids[self.current_sequence] = 0;
 }
 
-auto SceneSnapshotBuilder::find_last_acked(this SceneSnapshotBuilder& self) -> option<u8> {
+auto SceneSnapshotBuilder::ack(this SceneSnapshotBuilder& self, NetClientID client_id, u8 sequence) -> void {
   ZoneScoped;
 
-  for (auto i = 1_u8; i < MAX_SEQUENCES; i++) {
-    auto seq = static_cast<u8>((self.current_sequence + MAX_SEQUENCES - 1) % MAX_SEQUENCES);
-    if (self.acks[seq]) {
-      return seq;
-    }
+  // Acks of slots that got recycled, or older than the current baseline (reordered packets), are dropped.
+  const auto slot = static_cast<u8>(sequence % MAX_SEQUENCES);
+  const auto frame_id = self.frame_ids[slot];
+  if (frame_id == 0) {
+    return;
   }
 
-  return nullopt;
+  auto [baseline_it, inserted] = self.baselines.try_emplace(client_id, Baseline{.sequence = slot, .frame_id = frame_id});
+  if (!inserted && baseline_it->second.frame_id < frame_id) {
+    baseline_it->second = Baseline{.sequence = slot, .frame_id = frame_id};
+  }
 }
 
-auto SceneSnapshotBuilder::delta(this SceneSnapshotBuilder& self) -> SceneState {
+auto SceneSnapshotBuilder::remove_client(this SceneSnapshotBuilder& self, NetClientID client_id) -> void {
   ZoneScoped;
 
-  auto delta = SceneState{};
-  const auto& current_state = self.states[self.current_sequence];
-  auto last_acked = self.find_last_acked();
-  if (!last_acked.has_value()) {
-    return current_state;
-  }
-
-  const auto& last_state = self.states[last_acked.value()];
-  // check for changed entities
-  for (const auto& [entity_id, entity_state] : current_state.entities) {
-    auto last_it = last_state.entities.find(entity_id);
-    if (last_it != last_state.entities.end()) {
-      // this entity exist beteen current sequence and last sequence
-      const auto& [last_entity_id, last_entity_state] = *last_it;
-      auto delta_entity = EntityState{.entity_id = entity_id};
-      auto changed = false;
-      // check for changed components
-      for (const auto& [component_id, component_state] : entity_state.components) {
-        auto prev_component_it = last_entity_state.components.find(component_id);
-        if (prev_component_it == last_entity_state.components.end() ||
-            prev_component_it->second.hash != component_state.hash) {
-          delta_entity.components.emplace(component_id, component_state);
-          changed = true; // we've inserted new/changed component
-        }
+  self.baselines.erase(client_id);
+}
+
+auto SceneSnapshotBuilder::baseline(this const SceneSnapshotBuilder& self, NetClientID client_id) -> option<u8> {
+  ZoneScoped;
+
+  auto baseline_it = self.baselines.find(client_id);
+  if (baseline_it == self.baselines.end()) {
+    return nullopt;
+  }
+
+  const auto& baseline = baseline_it->second;
+  if (self.frame_ids[baseline.sequence] != baseline.frame_id) {
+    // Client fell behind the whole ring, it needs a full snapshot again.
+    return nullopt;
+  }
+
+  return baseline.sequence;
+}
+
+auto SceneSnapshotBuilder::delta(this SceneSnapshotBuilder& self, NetClientID client_id) -> SceneState {
+  ZoneScoped;
+
+  return self.delta_from(self.baseline(client_id));
+}
+
+auto SceneSnapshotBuilder::delta_from(this SceneSnapshotBuilder& self, option<u8> base_sequence) -> SceneState {
+  ZoneScoped;
+
+  auto state = SceneState{};
+  self.flat_delta(base_sequence).to_state(state);
+  return state;
+}
+
+auto SceneSnapshotBuilder::flat_delta(this SceneSnapshotBuilder& self, option<u8> base_sequence)
+  -> const SnapshotDelta& {
+  ZoneScoped;
+
+  const auto& frame = self.frames[self.current_sequence];
+  if (!base_sequence.has_value()) {
+    static const auto empty_frame = SnapshotFrame{};
+    self.diff(empty_frame, frame, self.scratch_delta);
+  } else {
+    self.diff(self.frames[base_sequence.value() % MAX_SEQUENCES], frame, self.scratch_delta);
+  }
+
+  return self.scratch_delta;
+}
+
+auto SceneSnapshotBuilder::diff(
+  this SceneSnapshotBuilder& self, const SnapshotFrame& base, const SnapshotFrame& frame, SnapshotDelta& delta
+) -> void {
+  ZoneScoped;
+
+  delta.clear();
+  delta.frame = &frame;
+  auto base_locations_ready = false;
+  // Tables that were compared row for row, their entities can't be missing from the current frame.
+  auto aligned_base_tables = ankerl::svector<u32, 64>{};
+
+  for (const auto& table : frame.tables) {
+    auto base_table_index = base.find_table(table.type_hash);
+    if (base_table_index.has_value()) {
+      const auto& base_table = base.tables[base_table_index.value()];
+      const auto base_entities = base.table_entities(base_table);
+      const auto entities = frame.table_entities(table);
+      if (std::ranges::equal(base_entities, entities)) {
+        diff_aligned_table(delta, base, base_table, frame, table);
+        aligned_base_tables.push_back(base_table_index.value());
+        continue;
       }
+    }
 
-      // check for removed components
-      for (const auto& [component_id, _] : last_entity_state.components) {
-        if (!entity_state.components.contains(component_id)) {
-          delta_entity.removed_components.emplace(component_id);
-          changed = true; // the component has been removed in current seq.
+    // Entities were added, removed or moved between tables since the base frame.
+    if (!base_locations_ready) {
+      self.base_locations.clear();
+      for (auto table_index = 0_u32; table_index < base.tables.size(); table_index++) {
+        const auto& base_table = base.tables[table_index];
+        const auto base_entities = base.table_entities(base_table);
+        for (auto row = 0_u32; row < base_table.row_count; row++) {
+          self.base_locations.emplace(base_entities[row], SnapshotRow{.table_index = table_index, .row = row});
         }
       }
+      base_locations_ready = true;
+    }
 
-      if (changed) {
-        delta.entities.emplace(entity_id, std::move(delta_entity));
+    const auto entities = frame.table_entities(table);
+    for (auto row = 0_u32; row < table.row_count; row++) {
+      auto location_it = self.base_locations.find(entities[row]);
+      if (location_it == self.base_locations.end()) {
+        emit_entity(delta, frame, table, row);
+        continue;
       }
-    } else {
-      // new entity
-      delta.entities.emplace(entity_id, entity_state);
+
+      const auto& location = location_it->second;
+      diff_row(delta, base, base.tables[location.table_index], location.row, frame, table, row);
     }
   }
 
   // check for removed entities
-  for (const auto& [entity_id, _] : last_state.entities) {
-    if (!current_state.entities.contains(entity_id)) {
-      delta.removed_entities.insert(entity_id);
+  if (aligned_base_tables.size() != base.tables.size()) {
+    self.current_entities.clear();
+    self.current_entities.insert(frame.entities.begin(), frame.entities.end());
+
+    for (auto table_index = 0_u32; table_index < base.tables.size(); table_index++) {
+      if (std::ranges::contains(aligned_base_tables, table_index)) {
+        continue;
+      }
+
+      for (auto entity : base.table_entities(base.tables[table_index])) {
+        if (!self.current_entities.contains(entity)) {
+          delta.removed_entities.push_back(entity);
+        }
+      }
     }
   }
+}
+
+auto SceneSnapshotBuilder::diff_entity(
+  const SnapshotFrame* base, const SnapshotFrame& frame, SnapshotRow row, SnapshotDelta& delta
+) -> bool {
+  OX_ASSERT(delta.frame == nullptr || delta.frame == &frame);
+  delta.frame = &frame;
+
+  const auto& table = frame.tables[row.table_index];
+  const auto entity = frame.table_entities(table)[row.row];
+  const auto previous_size = delta.records.size();
+
+  auto base_row = base ? base->find_row(entity) : nullopt;
+  if (!base_row.has_value()) {
+    emit_entity(delta, frame, table, row.row);
+    return true;
+  }
 
-  return delta;
+  diff_row(delta, *base, base->tables[base_row->table_index], base_row->row, frame, table, row.row);
+  return delta.records.size() != previous_size;
 }
 
-auto SceneSnapshotBuilder::take_snapshot(flecs::world& world, SceneState& state) -> void {
+auto SceneSnapshotBuilder::take_snapshot(flecs::world& world, SnapshotFrame& frame) -> void {
   ZoneScoped;
 
+  frame.clear();
+
   world.query_builder()
     .with<Networked>() //
     .each([&](flecs::entity component) {
       auto component_id = component.raw_id();
-      auto is_component = component.has<flecs::Component>();
-      auto component_info = flecs::Component{};
-      if (is_component) {
-        component_info = component.get<flecs::Component>();
+      auto component_size = 0_u32;
+      if (component.has<flecs::Component>()) {
+        component_size = static_cast<u32>(component.get<flecs::Component>().size);
       }
 
-      world.query_builder()
-        .with(component) //
-        .each([&](flecs::entity entity) {
-          auto entity_id = entity.id();
-          auto component_state = ComponentState{.id = component_id, .hash = ~0_u64};
-          if (is_component) {
-            auto* component_data = entity.get(component_id);
-            component_state.hash = ankerl::unordered_dense::detail::wyhash::hash(component_data, component_info.size);
-            component_state.buffer.resize(component_info.size);
-            std::memcpy(component_state.buffer.data(), component_data, component_info.size);
+      // Walks the tables of the component directly, one column copy per table instead of per entity.
+      auto it = ecs_each_id(world.c_ptr(), component_id);
+      while (ecs_each_next(&it)) {
+        const auto row_count = static_cast<u32>(it.count);
+        if (row_count == 0 || ecs_table_has_flags(it.table, EcsTableIsPrefab | EcsTableIsDisabled)) {
+          continue;
+        }
+
+        const auto* type = ecs_table_get_type(it.table);
+        const auto type_hash = hash_bytes(type->array, type->count * sizeof(ecs_id_t));
+        auto [table_it, inserted] = frame.table_lookup.try_emplace(type_hash, static_cast<u32>(frame.tables.size()));
+        if (inserted) {
+          frame.tables.push_back(
+            {.type_hash = type_hash, .row_offset = static_cast<u32>(frame.entities.size()), .row_count = row_count}
+          );
+          frame.entities.insert(frame.entities.end(), it.entities, it.entities + row_count);
+        }
+
+        auto column = SnapshotColumn{
+          .component_id = component_id,
+          .table_index = table_it->second,
+          .size = component_size,
+          .data_offset = frame.arena.size(),
+          .hash_offset = static_cast<u32>(frame.chunk_hashes.size()),
+        };
+
+        if (component_size != 0) {
+          const auto* data = static_cast<const u8*>(ecs_field_w_size(&it, component_size, 0));
+          frame.arena.insert(frame.arena.end(), data, data + static_cast<usize>(row_count) * component_size);
+
+          for (auto row = 0_u32; row < row_count; row += SnapshotFrame::CHUNK_ROWS) {
+            const auto chunk_rows = std::min(SnapshotFrame::CHUNK_ROWS, row_count - row);
+            frame.chunk_hashes.push_back(
+              hash_bytes(data + static_cast<usize>(row) * component_size, static_cast<usize>(chunk_rows) * component_size)
+            );
           }
+        }
 
-          auto& entity_state = state.entities[entity_id];
-          entity_state.entity_id = entity_id;
-          entity_state.components.emplace(component_id, std::move(component_state));
-        });
+        frame.columns.push_back(column);
+      }
     });
+
+  // Group columns by table and order them by component id, so two frames can be merged column by column.
+  std::ranges::sort(frame.columns, [](const SnapshotColumn& lhs, const SnapshotColumn& rhs) {
+    return std::tie(lhs.table_index, lhs.component_id) < std::tie(rhs.table_index, rhs.component_id);
+  });
+
+  for (auto column_index = 0_u32; column_index < frame.columns.size(); column_index++) {
+    auto& table = frame.tables[frame.columns[column_index].table_index];
+    if (table.column_count == 0) {
+      table.column_offset = column_index;
+    }
+    table.column_count++;
+  }
 }
 
 } // namespace ox
@@ -0,0 +1,136 @@
+#include "Scene/SpatialHash2D.hpp"
+
+#include <algorithm>
+#include <glm/common.hpp>
+#include <tracy/Tracy.hpp>
+
+namespace ox {
+namespace {
+// Keeps far away points from overflowing the cell coordinates, they all end up in the edge cells.
+constexpr auto MAX_CELL_COORD = 1 << 30;
+
+auto pack_cell(glm::ivec2 cell) -> u64 {
+  return (static_cast<u64>(static_cast<u32>(cell.x)) << 32) | static_cast<u64>(static_cast<u32>(cell.y));
+}
+
+auto overlaps(glm::vec2 min_a, glm::vec2 max_a, glm::vec2 min_b, glm::vec2 max_b) -> bool {
+  return min_a.x <= max_b.x && max_a.x >= min_b.x && min_a.y <= max_b.y && max_a.y >= min_b.y;
+}
+} // namespace
+
+SpatialHash2D::SpatialHash2D(f32 cell_size_) : cell_size(cell_size_), inv_cell_size(1.0f / cell_size_) {}
+
+auto SpatialHash2D::insert_or_update(this SpatialHash2D& self, u64 id, const AABB& bounds) -> void {
+  ZoneScoped;
+
+  const auto min = glm::vec2(bounds.min);
+  const auto max = glm::vec2(bounds.max);
+  const auto size = max - min;
+  // Centered in its cell it may reach into the neighbours, not past them.
+  const auto large = size.x > self.cell_size * 2.0f || size.y > self.cell_size * 2.0f;
+  const auto cell = large ? 0_u64 : pack_cell(self.cell_of((min + max) * 0.5f));
+
+  self.min_z = std::min(self.min_z, bounds.min.z);
+  self.max_z = std::max(self.max_z, bounds.max.z);
+
+  auto [it, inserted] = self.items.try_emplace(id);
+  auto& item = it->second;
+  if (!inserted) {
+    if (item.large == large && item.cell == cell) {
+      auto& entry = self.entries_of(item)[item.slot];
+      entry.min = min;
+      entry.max = max;
+      return;
+    }
+
+    self.unlink(item);
+  }
+
+  item.cell = cell;
+  item.large = large;
+  auto& entries = self.entries_of(item);
+  item.slot = static_cast<u32>(entries.size());
+  entries.push_back({.min = min, .max = max, .id = id});
+}
+
+auto SpatialHash2D::remove(this SpatialHash2D& self, u64 id) -> void {
+  ZoneScoped;
+
+  auto it = self.items.find(id);
+  if (it == self.items.end()) {
+    return;
+  }
+
+  self.unlink(it->second);
+  self.items.erase(it);
+}
+
+auto SpatialHash2D::clear(this SpatialHash2D& self) -> void {
+  self.items.clear();
+  self.cells.clear();
+  self.large_items.clear();
+  self.min_z = std::numeric_limits<f32>::max();
+  self.max_z = std::numeric_limits<f32>::lowest();
+}
+
+auto SpatialHash2D::query(this const SpatialHash2D& self, glm::vec2 min, glm::vec2 max, std::vector<u64>& out)
+  -> void {
+  ZoneScoped;
+
+  const auto collect = [&](const std::vector<Entry>& entries) {
+    for (const auto& entry : entries) {
+      if (overlaps(entry.min, entry.max, min, max)) {
+        out.push_back(entry.id);
+      }
+    }
+  };
+
+  collect(self.large_items);
+
+  const auto first = self.cell_of(min - self.cell_size);
+  const auto last = self.cell_of(max + self.cell_size);
+  const auto cell_count = static_cast<u64>(last.x - first.x + 1) * static_cast<u64>(last.y - first.y + 1);
+  // Zoomed out past the level, walking what is there is cheaper than probing every cell in view.
+  if (cell_count >= self.cells.size()) {
+    for (const auto& [cell, entries] : self.cells) {
+      collect(entries);
+    }
+
+    return;
+  }
+
+  for (auto y = first.y; y <= last.y; y++) {
+    for (auto x = first.x; x <= last.x; x++) {
+      if (const auto it = self.cells.find(pack_cell({x, y})); it != self.cells.end()) {
+        collect(it->second);
+      }
+    }
+  }
+}
+
+auto SpatialHash2D::cell_of(this const SpatialHash2D& self, glm::vec2 point) -> glm::ivec2 {
+  const auto cell = glm::clamp(
+    glm::floor(point * self.inv_cell_size),
+    glm::vec2(static_cast<f32>(-MAX_CELL_COORD)),
+    glm::vec2(static_cast<f32>(MAX_CELL_COORD))
+  );
+
+  return glm::ivec2(cell);
+}
+
+auto SpatialHash2D::entries_of(this SpatialHash2D& self, const Item& item) -> std::vector<Entry>& {
+  return item.large ? self.large_items : self.cells[item.cell];
+}
+
+auto SpatialHash2D::unlink(this SpatialHash2D& self, const Item& item) -> void {
+  auto& entries = self.entries_of(item);
+  const auto moved = entries.back();
+  entries[item.slot] = moved;
+  entries.pop_back();
+  self.items.find(moved.id)->second.slot = item.slot;
+
+  if (!item.large && entries.empty()) {
+    self.cells.erase(item.cell);
+  }
+}
+} // namespace ox
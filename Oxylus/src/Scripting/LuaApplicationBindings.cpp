@@ -181,7 +181,9 @@ auto AppBinding::bind(sol::state* state) -> void {
   );
   state->new_usertype<ClientSceneSnapshotEvent>(
     "ClientSceneSnapshotEvent",
-    &ClientSceneSnapshotEvent::sequence,
+    "playback_ms",
+    &ClientSceneSnapshotEvent::playback_ms,
+    "scene_state",
     &ClientSceneSnapshotEvent::scene_state
   );
 
@@ -0,0 +1,110 @@
+#include "Scripting/LuaBytecode.hpp"
+
+#include <ankerl/unordered_dense.h>
+#include <lua.hpp>
+
+#include "OS/File.hpp"
+#include "Utils/Log.hpp"
+
+namespace ox {
+auto script_bytecode_path(const std::filesystem::path& script_path) -> std::filesystem::path {
+  return std::filesystem::path(script_path.string() + ".oxbc");
+}
+
+auto hash_script_source(std::span<const u8> source) -> u64 {
+  ZoneScoped;
+
+  return ankerl::unordered_dense::detail::wyhash::hash(source.data(), source.size());
+}
+
+auto compile_script_bytecode(std::span<const u8> source, const std::string& chunk_name, bool strip)
+  -> std::expected<std::vector<u8>, std::string> {
+  ZoneScoped;
+
+  // Only the compiler is needed, a bare state without libraries is enough.
+  auto* L = luaL_newstate();
+  if (L == nullptr) {
+    return std::unexpected("Failed to create a Lua state.");
+  }
+
+  const auto* data = reinterpret_cast<const char*>(source.data());
+  if (luaL_loadbufferx(L, data, source.size(), chunk_name.c_str(), "t") != LUA_OK) {
+    auto error = std::string(lua_tostring(L, -1));
+    lua_close(L);
+    return std::unexpected(std::move(error));
+  }
+
+  auto bytecode = std::vector<u8>();
+  constexpr auto writer = [](lua_State*, const void* p, usize size, void* user_data) -> i32 {
+    auto* out = static_cast<std::vector<u8>*>(user_data);
+    const auto* bytes = static_cast<const u8*>(p);
+    out->insert(out->end(), bytes, bytes + size);
+    return 0;
+  };
+  const auto result = lua_dump(L, writer, &bytecode, strip ? 1 : 0);
+  lua_close(L);
+
+  if (result != 0) {
+    return std::unexpected("Failed to dump the compiled chunk.");
+  }
+
+  return bytecode;
+}
+
+auto load_script_bytecode(const std::filesystem::path& script_path) -> option<ScriptBytecodeData> {
+  ZoneScoped;
+
+  const auto bytecode_path = script_bytecode_path(script_path);
+  if (!std::filesystem::exists(bytecode_path)) {
+    return nullopt;
+  }
+
+  auto bytecode_file = AssetFile::unpack(bytecode_path);
+  if (!bytecode_file.has_value()) {
+    return nullopt;
+  }
+
+  for (auto& entry : bytecode_file->entries) {
+    auto* script_data = std::get_if<ScriptBytecodeData>(&entry.data);
+    if (!script_data) {
+      continue;
+    }
+
+    if (std::filesystem::exists(script_path)) {
+      const auto source = File::to_bytes(script_path);
+      if (script_data->source_hash != hash_script_source(source)) {
+        OX_LOG_WARN("Compiled script '{}' is out of date, loading from source.", bytecode_path);
+        return nullopt;
+      }
+    }
+
+    return std::move(*script_data);
+  }
+
+  return nullopt;
+}
+
+auto is_parallel_script(std::string_view source) -> bool {
+  constexpr auto WHITESPACE = std::string_view(" \t\r");
+  while (!source.empty()) {
+    const auto line_end = source.find('\n');
+    auto line = source.substr(0, line_end);
+    source = line_end == std::string_view::npos ? std::string_view() : source.substr(line_end + 1);
+
+    const auto first = line.find_first_not_of(WHITESPACE);
+    if (first == std::string_view::npos) {
+      continue;
+    }
+    line = line.substr(first, line.find_last_not_of(WHITESPACE) - first + 1);
+
+    if (line == "--!parallel") {
+      return true;
+    }
+    if (!line.starts_with("--")) {
+      return false;
+    }
+  }
+
+  return false;
+}
+} // namespace ox
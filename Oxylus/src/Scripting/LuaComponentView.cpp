@@ -0,0 +1,1074 @@
+#include "Scripting/LuaComponentView.hpp"
+
+#include <algorithm>
+#include <ankerl/unordered_dense.h>
+#include <flecs/addons/meta.h>
+#include <glm/geometric.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <shared_mutex>
+#include <sol/state.hpp>
+
+#include "Core/Option.hpp"
+#include "Core/UUID.hpp"
+#include "Utils/Log.hpp"
+
+namespace ox {
+namespace {
+// Kept in the world's binding context so layouts die with the world and never outlive the ids they're for.
+struct LayoutCache {
+  ankerl::unordered_dense::map<flecs::entity_t, std::unique_ptr<LuaComponentLayout>> layouts = {};
+  // Invalidated ones, views and queries may still point at them.
+  std::vector<std::unique_ptr<LuaComponentLayout>> retired = {};
+};
+
+// Parallel Lua systems look layouts up from workers, see `Scene::update_parallel_lua_systems`.
+std::shared_mutex layout_mutex = {};
+
+auto layout_cache(flecs::world& world) -> LayoutCache& {
+  auto* cache = static_cast<LayoutCache*>(ecs_get_binding_ctx(world.world_));
+  if (!cache) {
+    cache = new LayoutCache();
+    ecs_set_binding_ctx(world.world_, cache, [](void* ctx) { delete static_cast<LayoutCache*>(ctx); });
+  }
+
+  return *cache;
+}
+
+auto primitive_kind(ecs_meta_op_kind_t kind) -> option<LuaFieldKind> {
+  switch (kind) {
+    case EcsOpBool: return LuaFieldKind::Bool;
+    case EcsOpChar: return LuaFieldKind::Char;
+    case EcsOpU8  :
+    case EcsOpByte: return LuaFieldKind::U8;
+    case EcsOpU16 : return LuaFieldKind::U16;
+    case EcsOpU32 : return LuaFieldKind::U32;
+    case EcsOpUPtr:
+    case EcsOpU64 : return LuaFieldKind::U64;
+    case EcsOpI8  : return LuaFieldKind::I8;
+    case EcsOpI16 : return LuaFieldKind::I16;
+    case EcsOpI32 : return LuaFieldKind::I32;
+    case EcsOpIPtr:
+    case EcsOpI64 : return LuaFieldKind::I64;
+    case EcsOpF32 : return LuaFieldKind::F32;
+    case EcsOpF64 : return LuaFieldKind::F64;
+    default       : return nullopt;
+  }
+}
+
+// Same walk as `IEntitySerializer::serialize_ops`, but done once per type and with offsets instead of pointers.
+auto build_fields(
+  flecs::world& world, LuaComponentLayout& layout, flecs::meta::op_t* ops, i32 op_count, u32 base_offset
+) -> void {
+  ZoneScoped;
+
+  for (auto i = 0_i32; i < op_count; i++) {
+    const auto& op = ops[i];
+    auto field = LuaComponentField{
+      .name = op.name ? op.name : "",
+      .kind = LuaFieldKind::F32,
+      .offset = base_offset + static_cast<u32>(op.offset),
+      .type = op.type,
+    };
+
+    auto kind = primitive_kind(op.kind);
+    switch (op.kind) {
+      case EcsOpEntity: {
+        kind = LuaFieldKind::Entity;
+      } break;
+      case EcsOpId: {
+        kind = LuaFieldKind::Id;
+      } break;
+      case EcsOpString: {
+        kind = LuaFieldKind::String;
+      } break;
+      case EcsOpEnum: {
+        kind = LuaFieldKind::Enum;
+        field.underlying_kind = op.underlying_kind;
+      } break;
+
+      case EcsOpForward: {
+        auto forward = flecs::entity(world, op.type);
+        if (forward.has<flecs::TypeSerializer>()) {
+          const auto& ts = forward.get<flecs::TypeSerializer>();
+          build_fields(
+            world, layout, ecs_vec_first_t(&ts.ops, flecs::meta::op_t), ecs_vec_count(&ts.ops), field.offset
+          );
+        }
+      } break;
+
+      case EcsOpPushStruct: {
+        if (field.name.empty()) {
+          build_fields(world, layout, ops + i + 1, op.op_count - 2, field.offset);
+        } else if (op.type_info == world.type_info<glm::vec2>()) {
+          kind = LuaFieldKind::Vec2;
+        } else if (op.type_info == world.type_info<glm::vec3>()) {
+          kind = LuaFieldKind::Vec3;
+        } else if (op.type_info == world.type_info<glm::vec4>()) {
+          kind = LuaFieldKind::Vec4;
+        } else if (op.type_info == world.type_info<glm::quat>()) {
+          kind = LuaFieldKind::Quat;
+        } else {
+          auto nested = std::make_unique<LuaComponentLayout>();
+          nested->world = world.world_;
+          nested->type = op.type;
+          build_fields(world, *nested, ops + i + 1, op.op_count - 2, 0);
+
+          kind = LuaFieldKind::Struct;
+          field.layout = nested.get();
+          layout.nested.push_back(std::move(nested));
+        }
+      } break;
+
+      case EcsOpOpaqueValue: {
+        kind = op.type == world.entity<UUID>() ? LuaFieldKind::UUID : LuaFieldKind::Opaque;
+      } break;
+
+      default: break;
+    }
+
+    if (kind.has_value() && !field.name.empty()) {
+      field.kind = *kind;
+      layout.fields.push_back(std::move(field));
+    }
+
+    i += op.op_count - 1;
+  }
+}
+
+auto read_enum(ecs_meta_op_kind_t underlying_kind, const void* ptr) -> i64 {
+  switch (underlying_kind) {
+    case EcsOpU8 : return static_cast<i64>(*static_cast<const u8*>(ptr));
+    case EcsOpU16: return static_cast<i64>(*static_cast<const u16*>(ptr));
+    case EcsOpU32: return static_cast<i64>(*static_cast<const u32*>(ptr));
+    case EcsOpU64: return static_cast<i64>(*static_cast<const u64*>(ptr));
+    case EcsOpI8 : return static_cast<i64>(*static_cast<const i8*>(ptr));
+    case EcsOpI16: return static_cast<i64>(*static_cast<const i16*>(ptr));
+    case EcsOpI32: return static_cast<i64>(*static_cast<const i32*>(ptr));
+    case EcsOpI64: return *static_cast<const i64*>(ptr);
+    default      : return 0;
+  }
+}
+
+auto write_enum(ecs_meta_op_kind_t underlying_kind, void* ptr, i64 value) -> void {
+  switch (underlying_kind) {
+    case EcsOpU8 : *static_cast<u8*>(ptr) = static_cast<u8>(value); break;
+    case EcsOpU16: *static_cast<u16*>(ptr) = static_cast<u16>(value); break;
+    case EcsOpU32: *static_cast<u32*>(ptr) = static_cast<u32>(value); break;
+    case EcsOpU64: *static_cast<u64*>(ptr) = static_cast<u64>(value); break;
+    case EcsOpI8 : *static_cast<i8*>(ptr) = static_cast<i8>(value); break;
+    case EcsOpI16: *static_cast<i16*>(ptr) = static_cast<i16>(value); break;
+    case EcsOpI32: *static_cast<i32*>(ptr) = static_cast<i32>(value); break;
+    case EcsOpI64: *static_cast<i64*>(ptr) = value; break;
+    default      : break;
+  }
+}
+
+// Opaque types only hand out their value through a serializer.
+auto push_opaque(lua_State* L, ecs_world_t* world, const LuaComponentField& field, const void* ptr) -> i32 {
+  struct OpaqueRead {
+    lua_State* L = nullptr;
+    bool pushed = false;
+  };
+
+  auto read = OpaqueRead{.L = L};
+  auto serializer = flecs::serializer{};
+  serializer.world = world;
+  serializer.ctx = &read;
+  serializer.value_ = [](const struct ecs_serializer_t* ser, ecs_entity_t type, const void* value) -> i32 {
+    auto& [state, pushed] = *static_cast<OpaqueRead*>(ser->ctx);
+    if (pushed) {
+      return 0;
+    }
+
+    pushed = true;
+    if (type == flecs::Bool) {
+      sol::stack::push(state, *static_cast<const bool*>(value));
+    } else if (type == flecs::Char) {
+      sol::stack::push(state, *static_cast<const c8*>(value));
+    } else if (type == flecs::Byte || type == flecs::U8) {
+      sol::stack::push(state, *static_cast<const u8*>(value));
+    } else if (type == flecs::U16) {
+      sol::stack::push(state, *static_cast<const u16*>(value));
+    } else if (type == flecs::U32) {
+      sol::stack::push(state, *static_cast<const u32*>(value));
+    } else if (type == flecs::U64 || type == flecs::Uptr) {
+      sol::stack::push(state, *static_cast<const u64*>(value));
+    } else if (type == flecs::I8) {
+      sol::stack::push(state, *static_cast<const i8*>(value));
+    } else if (type == flecs::I16) {
+      sol::stack::push(state, *static_cast<const i16*>(value));
+    } else if (type == flecs::I32) {
+      sol::stack::push(state, *static_cast<const i32*>(value));
+    } else if (type == flecs::I64 || type == flecs::Iptr) {
+      sol::stack::push(state, *static_cast<const i64*>(value));
+    } else if (type == flecs::F32) {
+      sol::stack::push(state, *static_cast<const f32*>(value));
+    } else if (type == flecs::F64) {
+      sol::stack::push(state, *static_cast<const f64*>(value));
+    } else if (type == flecs::String) {
+      const auto* str = *static_cast<const c8* const*>(value);
+      sol::stack::push(state, str ? str : "");
+    } else {
+      pushed = false;
+    }
+
+    return 0;
+  };
+
+  const auto* opaque = ecs_get(world, field.type, EcsOpaque);
+  if (opaque && opaque->serialize) {
+    opaque->serialize(&serializer, ptr);
+  }
+
+  if (!read.pushed) {
+    lua_pushnil(L);
+  }
+
+  return 1;
+}
+
+auto push_field(lua_State* L, const LuaComponentView& view, const LuaComponentField& field) -> i32 {
+  auto* ptr = ECS_OFFSET(view.ptr, field.offset);
+  switch (field.kind) {
+    case LuaFieldKind::Bool: return sol::stack::push(L, *static_cast<const bool*>(ptr));
+    case LuaFieldKind::Char: return sol::stack::push(L, *static_cast<const c8*>(ptr));
+    case LuaFieldKind::U8  : return sol::stack::push(L, *static_cast<const u8*>(ptr));
+    case LuaFieldKind::U16 : return sol::stack::push(L, *static_cast<const u16*>(ptr));
+    case LuaFieldKind::U32 : return sol::stack::push(L, *static_cast<const u32*>(ptr));
+    case LuaFieldKind::U64 : return sol::stack::push(L, *static_cast<const u64*>(ptr));
+    case LuaFieldKind::I8  : return sol::stack::push(L, *static_cast<const i8*>(ptr));
+    case LuaFieldKind::I16 : return sol::stack::push(L, *static_cast<const i16*>(ptr));
+    case LuaFieldKind::I32 : return sol::stack::push(L, *static_cast<const i32*>(ptr));
+    case LuaFieldKind::I64 : return sol::stack::push(L, *static_cast<const i64*>(ptr));
+    case LuaFieldKind::F32 : return sol::stack::push(L, *static_cast<const f32*>(ptr));
+    case LuaFieldKind::F64 : return sol::stack::push(L, *static_cast<const f64*>(ptr));
+    case LuaFieldKind::Enum: return sol::stack::push(L, read_enum(field.underlying_kind, ptr));
+    case LuaFieldKind::Vec2: return sol::stack::push(L, *static_cast<const glm::vec2*>(ptr));
+    case LuaFieldKind::Vec3: return sol::stack::push(L, *static_cast<const glm::vec3*>(ptr));
+    case LuaFieldKind::Vec4: return sol::stack::push(L, *static_cast<const glm::vec4*>(ptr));
+    case LuaFieldKind::Quat: return sol::stack::push(L, *static_cast<const glm::quat*>(ptr));
+    case LuaFieldKind::UUID: return sol::stack::push(L, *static_cast<const UUID*>(ptr));
+    case LuaFieldKind::String: {
+      const auto* str = *static_cast<const c8* const*>(ptr);
+      if (!str) {
+        lua_pushnil(L);
+        return 1;
+      }
+      return sol::stack::push(L, str);
+    }
+    case LuaFieldKind::Entity:
+    case LuaFieldKind::Id    : {
+      const auto id = *static_cast<const flecs::entity_t*>(ptr);
+      if (!id) {
+        lua_pushnil(L);
+        return 1;
+      }
+      return sol::stack::push(L, flecs::entity(view.layout->world, id));
+    }
+    case LuaFieldKind::Struct: {
+      return sol::stack::push(
+        L,
+        LuaComponentView{
+          .ptr = ptr,
+          .layout = field.layout,
+          .is_mutable = view.is_mutable,
+          .world = view.world,
+          .entity = view.entity,
+          .component = view.component,
+        }
+      );
+    }
+    case LuaFieldKind::Opaque: return push_opaque(L, view.layout->world, field, ptr);
+  }
+
+  lua_pushnil(L);
+  return 1;
+}
+
+template <typename T>
+auto assign(lua_State* L, i32 index, void* ptr) -> bool {
+  if (!sol::stack::check<T>(L, index, sol::no_panic)) {
+    return false;
+  }
+
+  *static_cast<T*>(ptr) = sol::stack::get<T>(L, index);
+  return true;
+}
+
+auto write_field(lua_State* L, const LuaComponentView& view, const LuaComponentField& field, i32 index) -> bool;
+
+// A table assigned to a struct field sets the fields it has and leaves the rest alone.
+auto write_struct(lua_State* L, const LuaComponentView& view, i32 index) -> bool {
+  if (!lua_istable(L, index)) {
+    return false;
+  }
+
+  index = lua_absindex(L, index);
+  lua_pushnil(L);
+  while (lua_next(L, index) != 0) {
+    auto length = 0_sz;
+    const auto* key = lua_type(L, -2) == LUA_TSTRING ? lua_tolstring(L, -2, &length) : nullptr;
+    const auto* field = key ? view.layout->find(std::string_view(key, length)) : nullptr;
+    if (!field || !write_field(L, view, *field, lua_gettop(L))) {
+      lua_pop(L, 2);
+      return false;
+    }
+    lua_pop(L, 1);
+  }
+
+  return true;
+}
+
+auto write_opaque(lua_State* L, ecs_world_t* world, const LuaComponentField& field, void* ptr, i32 index) -> bool {
+  const auto* opaque = ecs_get(world, field.type, EcsOpaque);
+  if (!opaque) {
+    return false;
+  }
+
+  switch (lua_type(L, index)) {
+    case LUA_TBOOLEAN: {
+      if (!opaque->assign_bool) {
+        return false;
+      }
+      opaque->assign_bool(ptr, lua_toboolean(L, index));
+    } break;
+    case LUA_TNUMBER: {
+      if (lua_isinteger(L, index) && opaque->assign_int) {
+        opaque->assign_int(ptr, lua_tointeger(L, index));
+      } else if (lua_isinteger(L, index) && opaque->assign_uint) {
+        opaque->assign_uint(ptr, static_cast<u64>(lua_tointeger(L, index)));
+      } else if (opaque->assign_float) {
+        opaque->assign_float(ptr, lua_tonumber(L, index));
+      } else {
+        return false;
+      }
+    } break;
+    case LUA_TSTRING: {
+      if (!opaque->assign_string) {
+        return false;
+      }
+      opaque->assign_string(ptr, lua_tostring(L, index));
+    } break;
+    default: return false;
+  }
+
+  return true;
+}
+
+auto write_field(lua_State* L, const LuaComponentView& view, const LuaComponentField& field, i32 index) -> bool {
+  auto* ptr = ECS_OFFSET(view.ptr, field.offset);
+  switch (field.kind) {
+    case LuaFieldKind::Bool: return assign<bool>(L, index, ptr);
+    case LuaFieldKind::Char: return assign<c8>(L, index, ptr);
+    case LuaFieldKind::U8  : return assign<u8>(L, index, ptr);
+    case LuaFieldKind::U16 : return assign<u16>(L, index, ptr);
+    case LuaFieldKind::U32 : return assign<u32>(L, index, ptr);
+    case LuaFieldKind::U64 : return assign<u64>(L, index, ptr);
+    case LuaFieldKind::I8  : return assign<i8>(L, index, ptr);
+    case LuaFieldKind::I16 : return assign<i16>(L, index, ptr);
+    case LuaFieldKind::I32 : return assign<i32>(L, index, ptr);
+    case LuaFieldKind::I64 : return assign<i64>(L, index, ptr);
+    case LuaFieldKind::F32 : return assign<f32>(L, index, ptr);
+    case LuaFieldKind::F64 : return assign<f64>(L, index, ptr);
+    case LuaFieldKind::Vec2: return assign<glm::vec2>(L, index, ptr);
+    case LuaFieldKind::Vec3: return assign<glm::vec3>(L, index, ptr);
+    case LuaFieldKind::Vec4: return assign<glm::vec4>(L, index, ptr);
+    case LuaFieldKind::Quat: return assign<glm::quat>(L, index, ptr);
+    case LuaFieldKind::UUID: return assign<UUID>(L, index, ptr);
+    case LuaFieldKind::Enum: {
+      if (!lua_isinteger(L, index)) {
+        return false;
+      }
+      write_enum(field.underlying_kind, ptr, lua_tointeger(L, index));
+      return true;
+    }
+    case LuaFieldKind::String: {
+      if (!lua_isstring(L, index)) {
+        return false;
+      }
+      auto** str = static_cast<c8**>(ptr);
+      ecs_os_free(*str);
+      *str = ecs_os_strdup(lua_tostring(L, index));
+      return true;
+    }
+    case LuaFieldKind::Entity:
+    case LuaFieldKind::Id    : {
+      auto* id = static_cast<flecs::entity_t*>(ptr);
+      if (lua_isnil(L, index)) {
+        *id = 0;
+      } else if (lua_isinteger(L, index)) {
+        *id = static_cast<flecs::entity_t>(lua_tointeger(L, index));
+      } else if (sol::stack::check<flecs::entity>(L, index, sol::no_panic)) {
+        *id = sol::stack::get<flecs::entity>(L, index).id();
+      } else {
+        return false;
+      }
+      return true;
+    }
+    case LuaFieldKind::Struct: {
+      return write_struct(L, LuaComponentView{.ptr = ptr, .layout = field.layout, .is_mutable = true}, index);
+    }
+    case LuaFieldKind::Opaque: return write_opaque(L, view.layout->world, field, ptr, index);
+  }
+
+  return false;
+}
+
+auto field_key(lua_State* L, i32 index) -> std::string_view {
+  if (lua_type(L, index) != LUA_TSTRING) {
+    return {};
+  }
+
+  auto length = 0_sz;
+  const auto* key = lua_tolstring(L, index, &length);
+  return std::string_view(key, length);
+}
+
+// Closures over a field are made once and kept in a registry table per function, so looking up
+// `view:set_<field>` and friends allocates only the first time. A closure only holds the field's address,
+// reusing one for whatever field lives there later is the same as making a new one.
+auto push_field_closure(lua_State* L, const LuaComponentField* field, lua_CFunction fn, const void* cache) -> i32 {
+  if (lua_rawgetp(L, LUA_REGISTRYINDEX, cache) != LUA_TTABLE) {
+    lua_pop(L, 1);
+    lua_newtable(L);
+    lua_pushvalue(L, -1);
+    lua_rawsetp(L, LUA_REGISTRYINDEX, cache);
+  }
+
+  if (lua_rawgetp(L, -1, field) != LUA_TFUNCTION) {
+    lua_pop(L, 1);
+    lua_pushlightuserdata(L, const_cast<LuaComponentField*>(field));
+    lua_pushcclosure(L, fn, 1);
+    lua_pushvalue(L, -1);
+    lua_rawsetp(L, -3, field);
+  }
+
+  lua_remove(L, -2);
+  return 1;
+}
+
+auto upvalue_field(lua_State* L) -> const LuaComponentField* {
+  return static_cast<const LuaComponentField*>(lua_touserdata(L, lua_upvalueindex(1)));
+}
+
+auto mark_modified(const LuaComponentView& view) -> void {
+  if (view.world && view.entity) {
+    ecs_modified_id(view.world, view.entity, view.component);
+  }
+}
+
+// Entity the element `index` of a column or field array belongs to, 0 when nothing owns it.
+template <typename Array>
+auto owner_of(const Array& array, u32 index) -> flecs::entity_t {
+  if (array.stride == 0) {
+    return array.source;
+  }
+
+  return array.entities ? array.entities[index] : 0;
+}
+
+// Once per element, or once for a shared component, after a helper wrote to the whole array.
+auto mark_modified(const LuaFieldArray& array) -> void {
+  if (!array.world) {
+    return;
+  }
+
+  const auto count = array.stride == 0 ? std::min(array.count, 1_u32) : array.count;
+  for (auto i = 0_u32; i < count; i++) {
+    if (const auto entity = owner_of(array, i)) {
+      ecs_modified_id(array.world, entity, array.component);
+    }
+  }
+}
+
+auto mutable_view(lua_State* L) -> const LuaComponentView& {
+  const auto& view = sol::stack::get<LuaComponentView&>(L, 1);
+  if (!view.is_mutable) {
+    luaL_error(L, "Component view is read only, use get_mut or ensure to write to it");
+  }
+
+  return view;
+}
+
+auto vector_width(LuaFieldKind kind) -> i32 {
+  switch (kind) {
+    case LuaFieldKind::Vec2: return 2;
+    case LuaFieldKind::Vec3: return 3;
+    case LuaFieldKind::Vec4:
+    case LuaFieldKind::Quat: return 4;
+    default                : return 0;
+  }
+}
+
+// `position_xyz` names the vec3 field `position` unpacked, the suffix has to match the vector's width.
+auto find_unpacked(const LuaComponentLayout& layout, std::string_view key) -> const LuaComponentField* {
+  constexpr auto COMPONENTS = std::string_view("_xyzw");
+  const auto separator = key.rfind('_');
+  if (separator == std::string_view::npos) {
+    return nullptr;
+  }
+
+  const auto suffix = key.substr(separator);
+  if (suffix.size() < 3 || !COMPONENTS.starts_with(suffix)) {
+    return nullptr;
+  }
+
+  const auto* field = layout.find(key.substr(0, separator));
+  if (!field || vector_width(field->kind) != static_cast<i32>(suffix.size() - 1)) {
+    return nullptr;
+  }
+
+  return field;
+}
+
+// `view:set_<field>(value)`, for scripts written against the old component tables.
+auto view_setter(lua_State* L) -> i32 {
+  const auto& view = mutable_view(L);
+  const auto* field = upvalue_field(L);
+  if (!write_field(L, view, *field, 2)) {
+    return luaL_error(L, "Wrong value type for component field '%s'", field->name.c_str());
+  }
+
+  mark_modified(view);
+  return 0;
+}
+
+// `x, y, z = view:<field>_xyz()`, a vector field as plain numbers without a userdata for the vector.
+auto view_unpack(lua_State* L) -> i32 {
+  const auto& view = sol::stack::get<LuaComponentView&>(L, 1);
+  const auto* field = upvalue_field(L);
+  const auto* values = static_cast<const f32*>(ECS_OFFSET(view.ptr, field->offset));
+  const auto width = vector_width(field->kind);
+  for (auto i = 0; i < width; i++) {
+    lua_pushnumber(L, values[i]);
+  }
+
+  return width;
+}
+
+// `view:set_<field>_xyz(x, y, z)`.
+auto view_pack(lua_State* L) -> i32 {
+  const auto& view = mutable_view(L);
+  const auto* field = upvalue_field(L);
+  auto* values = static_cast<f32*>(ECS_OFFSET(view.ptr, field->offset));
+  const auto width = vector_width(field->kind);
+  for (auto i = 0; i < width; i++) {
+    values[i] = static_cast<f32>(luaL_checknumber(L, i + 2));
+  }
+
+  mark_modified(view);
+  return 0;
+}
+
+// Only their addresses are used, as registry keys.
+char SETTER_CACHE = 0;
+char UNPACK_CACHE = 0;
+char PACK_CACHE = 0;
+
+auto view_index(lua_State* L) -> i32 {
+  const auto& view = sol::stack::get<LuaComponentView&>(L, 1);
+  const auto key = field_key(L, 2);
+  if (const auto* field = view.layout->find(key)) {
+    return push_field(L, view, *field);
+  }
+
+  if (key == "component_id") {
+    return sol::stack::push(L, view.layout->type);
+  }
+
+  if (const auto* field = find_unpacked(*view.layout, key)) {
+    return push_field_closure(L, field, &view_unpack, &UNPACK_CACHE);
+  }
+
+  if (view.is_mutable && key.starts_with("set_")) {
+    if (const auto* field = view.layout->find(key.substr(4))) {
+      return push_field_closure(L, field, &view_setter, &SETTER_CACHE);
+    }
+
+    if (const auto* field = find_unpacked(*view.layout, key.substr(4))) {
+      return push_field_closure(L, field, &view_pack, &PACK_CACHE);
+    }
+  }
+
+  lua_pushnil(L);
+  return 1;
+}
+
+auto view_new_index(lua_State* L) -> i32 {
+  const auto& view = sol::stack::get<LuaComponentView&>(L, 1);
+  if (!view.is_mutable) {
+    return luaL_error(L, "Component view is read only, use get_mut or ensure to write to it");
+  }
+
+  const auto* field = view.layout->find(field_key(L, 2));
+  if (!field) {
+    return luaL_error(L, "Component has no field '%s'", lua_tostring(L, 2));
+  }
+
+  if (!write_field(L, view, *field, 3)) {
+    return luaL_error(L, "Wrong value type for component field '%s'", field->name.c_str());
+  }
+
+  mark_modified(view);
+  return 0;
+}
+
+auto column_at(lua_State* L) -> i32 {
+  const auto& column = sol::stack::get<LuaComponentColumn&>(L, 1);
+  const auto index = luaL_checkinteger(L, 2);
+  if (index < 0 || index >= column.count) {
+    return luaL_error(L, "Index %I is out of range, column has %d components", index, static_cast<i32>(column.count));
+  }
+
+  return sol::stack::push(
+    L,
+    LuaComponentView{
+      .ptr = column.data + index * column.stride,
+      .layout = column.layout,
+      .is_mutable = true,
+      .world = column.world,
+      .entity = owner_of(column, static_cast<u32>(index)),
+      .component = column.component,
+    }
+  );
+}
+
+auto column_field(lua_State* L) -> i32 {
+  const auto& column = sol::stack::get<LuaComponentColumn&>(L, 1);
+  const auto* field = column.layout->find(field_key(L, 2));
+  if (!field) {
+    return luaL_error(L, "Component has no field '%s'", lua_tostring(L, 2));
+  }
+
+  return sol::stack::push(
+    L,
+    LuaFieldArray{
+      .data = column.data,
+      .stride = column.stride,
+      .count = column.count,
+      .layout = column.layout,
+      .field = field,
+      .world = column.world,
+      .entities = column.entities,
+      .source = column.source,
+      .component = column.component,
+    }
+  );
+}
+
+auto column_len(lua_State* L) -> i32 {
+  lua_pushinteger(L, sol::stack::get<LuaComponentColumn&>(L, 1).count);
+  return 1;
+}
+
+// The element `index` as a view, nullopt when the key isn't an index in range.
+auto array_element(lua_State* L, const LuaFieldArray& array, i32 arg) -> option<LuaComponentView> {
+  auto is_integer = 0;
+  const auto index = lua_tointegerx(L, arg, &is_integer);
+  if (!is_integer || index < 0 || index >= array.count) {
+    return nullopt;
+  }
+
+  return LuaComponentView{
+    .ptr = array.data + index * array.stride,
+    .layout = array.layout,
+    .is_mutable = true,
+    .world = array.world,
+    .entity = owner_of(array, static_cast<u32>(index)),
+    .component = array.component,
+  };
+}
+
+auto array_index(lua_State* L) -> i32 {
+  const auto& array = sol::stack::get<LuaFieldArray&>(L, 1);
+  const auto element = array_element(L, array, 2);
+  if (!element) {
+    lua_pushnil(L);
+    return 1;
+  }
+
+  return push_field(L, *element, *array.field);
+}
+
+auto array_new_index(lua_State* L) -> i32 {
+  const auto& array = sol::stack::get<LuaFieldArray&>(L, 1);
+  const auto element = array_element(L, array, 2);
+  if (!element) {
+    return luaL_error(L, "Field array of %d elements can't be indexed with that", static_cast<i32>(array.count));
+  }
+
+  if (!write_field(L, *element, *array.field, 3)) {
+    return luaL_error(L, "Wrong value type for component field '%s'", array.field->name.c_str());
+  }
+
+  mark_modified(*element);
+  return 0;
+}
+
+auto array_len(lua_State* L) -> i32 {
+  lua_pushinteger(L, sol::stack::get<LuaFieldArray&>(L, 1).count);
+  return 1;
+}
+
+// Calls `fn` with the field's type for the kinds the array helpers do math on.
+template <typename Fn>
+auto visit_math(LuaFieldKind kind, Fn&& fn) -> bool {
+  switch (kind) {
+    case LuaFieldKind::F32 : fn(std::type_identity<f32>{}); return true;
+    case LuaFieldKind::F64 : fn(std::type_identity<f64>{}); return true;
+    case LuaFieldKind::Vec2: fn(std::type_identity<glm::vec2>{}); return true;
+    case LuaFieldKind::Vec3: fn(std::type_identity<glm::vec3>{}); return true;
+    case LuaFieldKind::Vec4: fn(std::type_identity<glm::vec4>{}); return true;
+    case LuaFieldKind::Quat: fn(std::type_identity<glm::quat>{}); return true;
+    default                : return false;
+  }
+}
+
+template <typename T>
+using scalar_of = std::conditional_t<std::is_same_v<T, f64>, f64, f32>;
+
+// A shared component is one element repeated `count` times, a loop over it would apply a change that often.
+auto is_writable(const LuaFieldArray& array) -> bool {
+  return array.stride != 0 || array.count <= 1;
+}
+
+auto check_other(lua_State* L, const LuaFieldArray& array, i32 arg, LuaFieldKind kind) -> const LuaFieldArray* {
+  if (!sol::stack::check<LuaFieldArray>(L, arg, sol::no_panic)) {
+    return nullptr;
+  }
+
+  const auto& other = sol::stack::get<LuaFieldArray&>(L, arg);
+  if (other.field->kind != kind || other.count != array.count) {
+    return nullptr;
+  }
+
+  return &other;
+}
+
+// `array:fill(value)`, sets every element.
+auto array_fill(lua_State* L) -> i32 {
+  const auto& array = sol::stack::get<LuaFieldArray&>(L, 1);
+  auto is_valid = is_writable(array);
+  const auto is_math = is_valid && visit_math(array.field->kind, [&]<typename T>(std::type_identity<T>) {
+    if (!sol::stack::check<T>(L, 2, sol::no_panic)) {
+      is_valid = false;
+      return;
+    }
+
+    const auto value = sol::stack::get<T>(L, 2);
+    for (auto i = 0_u32; i < array.count; i++) {
+      array.at<T>(i) = value;
+    }
+  });
+  if (!is_math || !is_valid) {
+    return luaL_error(L, "fill takes a value of the field's type on a number, vector or quat field");
+  }
+
+  mark_modified(array);
+  return 0;
+}
+
+// `array:add(value)`, adds the same value to every element.
+auto array_add(lua_State* L) -> i32 {
+  const auto& array = sol::stack::get<LuaFieldArray&>(L, 1);
+  auto is_valid = is_writable(array);
+  const auto is_math = is_valid && visit_math(array.field->kind, [&]<typename T>(std::type_identity<T>) {
+    if (!sol::stack::check<T>(L, 2, sol::no_panic)) {
+      is_valid = false;
+      return;
+    }
+
+    const auto value = sol::stack::get<T>(L, 2);
+    for (auto i = 0_u32; i < array.count; i++) {
+      array.at<T>(i) += value;
+    }
+  });
+  if (!is_math || !is_valid) {
+    return luaL_error(L, "add takes a value of the field's type on a number, vector or quat field");
+  }
+
+  mark_modified(array);
+  return 0;
+}
+
+// `array:scale(s)`, multiplies every element by a number.
+auto array_scale(lua_State* L) -> i32 {
+  const auto& array = sol::stack::get<LuaFieldArray&>(L, 1);
+  const auto scale = luaL_checknumber(L, 2);
+  const auto is_math = is_writable(array) &&
+                       visit_math(array.field->kind, [&]<typename T>(std::type_identity<T>) {
+                         const auto s = static_cast<scalar_of<T>>(scale);
+                         for (auto i = 0_u32; i < array.count; i++) {
+                           array.at<T>(i) *= s;
+                         }
+                       });
+  if (!is_math) {
+    return luaL_error(L, "scale works on number, vector or quat fields");
+  }
+
+  mark_modified(array);
+  return 0;
+}
+
+// `array:add_scaled(other, s)`, `array[i] += other[i] * s`. Integrates a position with a velocity and dt.
+auto array_add_scaled(lua_State* L) -> i32 {
+  const auto& array = sol::stack::get<LuaFieldArray&>(L, 1);
+  const auto* other = check_other(L, array, 2, array.field->kind);
+  const auto scale = luaL_optnumber(L, 3, 1.0);
+  const auto is_math = other && is_writable(array) &&
+                       visit_math(array.field->kind, [&]<typename T>(std::type_identity<T>) {
+                         const auto s = static_cast<scalar_of<T>>(scale);
+                         for (auto i = 0_u32; i < array.count; i++) {
+                           array.at<T>(i) += other->at<T>(i) * s;
+                         }
+                       });
+  if (!is_math) {
+    return luaL_error(L, "add_scaled takes a field array of the same type and length");
+  }
+
+  mark_modified(array);
+  return 0;
+}
+
+// `array:copy(other)`, `array[i] = other[i]`.
+auto array_copy(lua_State* L) -> i32 {
+  const auto& array = sol::stack::get<LuaFieldArray&>(L, 1);
+  const auto* other = check_other(L, array, 2, array.field->kind);
+  const auto is_math = other && is_writable(array) &&
+                       visit_math(array.field->kind, [&]<typename T>(std::type_identity<T>) {
+                         for (auto i = 0_u32; i < array.count; i++) {
+                           array.at<T>(i) = other->at<T>(i);
+                         }
+                       });
+  if (!is_math) {
+    return luaL_error(L, "copy takes a field array of the same type and length");
+  }
+
+  mark_modified(array);
+  return 0;
+}
+
+// `array:normalize()`, on vector and quat fields.
+auto array_normalize(lua_State* L) -> i32 {
+  const auto& array = sol::stack::get<LuaFieldArray&>(L, 1);
+  auto is_valid = is_writable(array);
+  const auto is_math = is_valid && visit_math(array.field->kind, [&]<typename T>(std::type_identity<T>) {
+    if constexpr (std::is_floating_point_v<T>) {
+      is_valid = false;
+    } else {
+      for (auto i = 0_u32; i < array.count; i++) {
+        array.at<T>(i) = glm::normalize(array.at<T>(i));
+      }
+    }
+  });
+  if (!is_math || !is_valid) {
+    return luaL_error(L, "normalize works on vector or quat fields");
+  }
+
+  mark_modified(array);
+  return 0;
+}
+
+// `rotations:integrate(angular_velocities, dt)`, turns quats by vec3 angular velocities in radians per second.
+auto array_integrate(lua_State* L) -> i32 {
+  const auto& array = sol::stack::get<LuaFieldArray&>(L, 1);
+  const auto* other = check_other(L, array, 2, LuaFieldKind::Vec3);
+  const auto dt = static_cast<f32>(luaL_checknumber(L, 3));
+  if (array.field->kind != LuaFieldKind::Quat || !other || !is_writable(array)) {
+    return luaL_error(L, "integrate takes a vec3 field array of the same length on a quat field");
+  }
+
+  for (auto i = 0_u32; i < array.count; i++) {
+    auto& rotation = array.at<glm::quat>(i);
+    const auto& angular = other->at<glm::vec3>(i);
+    const auto spin = glm::quat(0.0f, angular.x, angular.y, angular.z) * rotation;
+    rotation = glm::normalize(rotation + spin * (0.5f * dt));
+  }
+
+  mark_modified(array);
+  return 0;
+}
+
+// `array:sum()`, total of a number or vector field.
+auto array_sum(lua_State* L) -> i32 {
+  const auto& array = sol::stack::get<LuaFieldArray&>(L, 1);
+  auto pushed = 0;
+  visit_math(array.field->kind, [&]<typename T>(std::type_identity<T>) {
+    if constexpr (!std::is_same_v<T, glm::quat>) {
+      auto total = T(0);
+      for (auto i = 0_u32; i < array.count; i++) {
+        total += array.at<T>(i);
+      }
+      pushed = sol::stack::push(L, total);
+    }
+  });
+  if (pushed == 0) {
+    return luaL_error(L, "sum works on number or vector fields");
+  }
+
+  return pushed;
+}
+} // namespace
+
+auto LuaComponentLayout::find(this const LuaComponentLayout& self, std::string_view name) -> const LuaComponentField* {
+  if (name.empty()) {
+    return nullptr;
+  }
+
+  for (const auto& field : self.fields) {
+    if (field.name == name) {
+      return &field;
+    }
+  }
+
+  return nullptr;
+}
+
+auto LuaComponentLayout::get(flecs::world& stage, flecs::entity_t type) -> const LuaComponentLayout* {
+  ZoneScoped;
+
+  // Stages share the layouts of their world.
+  auto* real_world = const_cast<ecs_world_t*>(ecs_get_world(stage.c_ptr()));
+  {
+    auto read_lock = std::shared_lock(layout_mutex);
+    const auto* cache = static_cast<const LayoutCache*>(ecs_get_binding_ctx(real_world));
+    if (cache) {
+      if (auto it = cache->layouts.find(type); it != cache->layouts.end()) {
+        return it->second.get();
+      }
+    }
+  }
+
+  auto write_lock = std::unique_lock(layout_mutex);
+  auto world = flecs::world(real_world);
+  auto& cache = layout_cache(world);
+  if (auto it = cache.layouts.find(type); it != cache.layouts.end()) {
+    return it->second.get();
+  }
+
+  auto layout = std::make_unique<LuaComponentLayout>();
+  layout->world = world.world_;
+  layout->type = type;
+
+  auto component = flecs::entity(world, type);
+  if (component.has<flecs::TypeSerializer>()) {
+    const auto& ts = component.get<flecs::TypeSerializer>();
+    build_fields(world, *layout, ecs_vec_first_t(&ts.ops, flecs::meta::op_t), ecs_vec_count(&ts.ops), 0);
+  }
+
+  return cache.layouts.emplace(type, std::move(layout)).first->second.get();
+}
+
+auto LuaComponentLayout::invalidate(flecs::world& stage, flecs::entity_t type) -> void {
+  ZoneScoped;
+
+  auto* real_world = const_cast<ecs_world_t*>(ecs_get_world(stage.c_ptr()));
+  auto write_lock = std::unique_lock(layout_mutex);
+  auto* cache = static_cast<LayoutCache*>(ecs_get_binding_ctx(real_world));
+  if (!cache) {
+    return;
+  }
+
+  // Components with a field of this type have its old layout nested in theirs.
+  const auto uses_type = [type](this const auto& uses, const LuaComponentLayout& layout) -> bool {
+    return layout.type == type
+        || std::ranges::any_of(layout.nested, [&](const auto& nested) { return uses(*nested); });
+  };
+
+  for (auto it = cache->layouts.begin(); it != cache->layouts.end();) {
+    if (uses_type(*it->second)) {
+      cache->retired.push_back(std::move(it->second));
+      it = cache->layouts.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+auto LuaComponentView::bind(sol::state* state) -> void {
+  ZoneScoped;
+
+  // One metatable for every view, `__index`/`__newindex` dispatch on the view's layout.
+  state->new_usertype<LuaComponentView>(
+    "ComponentView",
+    sol::no_constructor,
+    sol::meta_function::index,
+    &view_index,
+    sol::meta_function::new_index,
+    &view_new_index
+  );
+}
+
+auto LuaComponentColumn::from_iter(ecs_iter_t* it, i8 index, flecs::entity_t type) -> LuaComponentColumn {
+  ZoneScoped;
+
+  const auto* type_info = ecs_get_type_info(it->real_world, type);
+  OX_CHECK_NULL(type_info);
+  const auto size = static_cast<usize>(type_info->size);
+
+  auto world = flecs::world(it->real_world);
+  auto* data = static_cast<u8*>(ecs_field_w_size(it, size, index));
+  const auto is_self = ecs_field_is_self(it, index);
+  return LuaComponentColumn{
+    .data = data,
+    .stride = is_self ? size : 0,
+    // Optional terms the table doesn't have come back without data.
+    .count = data ? static_cast<u32>(it->count) : 0,
+    .layout = LuaComponentLayout::get(world, type),
+    // The iterator's stage, writes from a system running on a worker are deferred like the rest of its commands.
+    .world = it->world,
+    .entities = is_self ? it->entities : nullptr,
+    .source = is_self ? 0 : ecs_field_src(it, index),
+    .component = type,
+  };
+}
+
+auto LuaComponentColumn::bind(sol::state* state) -> void {
+  ZoneScoped;
+
+  state->new_usertype<LuaComponentColumn>(
+    "ComponentColumn",
+    sol::no_constructor,
+    "count",
+    &column_len,
+    "at",
+    &column_at,
+    "field",
+    &column_field,
+    sol::meta_function::length,
+    &column_len
+  );
+
+  state->new_usertype<LuaFieldArray>(
+    "FieldArray",
+    sol::no_constructor,
+    "count",
+    &array_len,
+    "fill",
+    &array_fill,
+    "add",
+    &array_add,
+    "scale",
+    &array_scale,
+    "add_scaled",
+    &array_add_scaled,
+    "copy",
+    &array_copy,
+    "normalize",
+    &array_normalize,
+    "integrate",
+    &array_integrate,
+    "sum",
+    &array_sum,
+    sol::meta_function::length,
+    &array_len,
+    sol::meta_function::index,
+    &array_index,
+    sol::meta_function::new_index,
+    &array_new_index
+  );
+}
+} // namespace ox
@@ -0,0 +1,72 @@
+#include "Scripting/LuaGC.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <lua.hpp>
+
+namespace ox {
+namespace {
+auto heap_bytes(lua_State* L) -> usize {
+  return static_cast<usize>(lua_gc(L, LUA_GCCOUNT)) * 1024 + static_cast<usize>(lua_gc(L, LUA_GCCOUNTB));
+}
+} // namespace
+
+auto LuaGC::init(this LuaGC& self, lua_State* L, const LuaGCConfig& config) -> void {
+  ZoneScoped;
+
+  self.config = config;
+  // Step size is given as log2 of bytes.
+  const auto step_size = std::bit_width(static_cast<u32>(std::max(config.step_kb, 1)) * 1024_u32) - 1;
+  lua_gc(L, LUA_GCINC, config.backstop_pause, config.step_multiplier, step_size);
+
+  self.stats.heap_bytes = heap_bytes(L);
+  self.heap_after_cycle = self.stats.heap_bytes;
+  self.in_cycle = false;
+}
+
+auto LuaGC::step(this LuaGC& self, lua_State* L) -> void {
+  ZoneScoped;
+
+  self.stats.heap_bytes = heap_bytes(L);
+  self.stats.steps = 0;
+  self.stats.step_us = 0.0;
+
+  const auto threshold = self.heap_after_cycle / 100 * static_cast<usize>(self.config.pause);
+  if (!self.in_cycle && self.stats.heap_bytes < threshold) {
+    return;
+  }
+
+  // A step out of pause starts a new cycle, `LUA_GCSTEP` returns 1 once a cycle is finished.
+  using Clock = std::chrono::steady_clock;
+  const auto start = Clock::now();
+  const auto budget = std::chrono::duration<f64, std::micro>(self.config.budget_us);
+  self.in_cycle = true;
+  do {
+    self.stats.steps += 1;
+    if (lua_gc(L, LUA_GCSTEP, 0) != 0) {
+      self.in_cycle = false;
+      self.stats.completed_cycles += 1;
+      break;
+    }
+  } while (Clock::now() - start < budget);
+
+  self.stats.step_us = std::chrono::duration<f64, std::micro>(Clock::now() - start).count();
+  self.stats.heap_bytes = heap_bytes(L);
+  if (!self.in_cycle) {
+    self.heap_after_cycle = self.stats.heap_bytes;
+  }
+}
+
+auto LuaGC::full_collect(this LuaGC& self, lua_State* L) -> void {
+  ZoneScoped;
+
+  lua_gc(L, LUA_GCCOLLECT);
+
+  self.in_cycle = false;
+  self.stats.completed_cycles += 1;
+  self.stats.full_collections += 1;
+  self.stats.heap_bytes = heap_bytes(L);
+  self.heap_after_cycle = self.stats.heap_bytes;
+}
+} // namespace ox
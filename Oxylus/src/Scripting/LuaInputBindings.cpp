@@ -17,10 +17,55 @@ auto InputBinding::bind(sol::state* state) -> void {
   SET_TYPE_FUNCTION(input, Input, pop_context);
   SET_TYPE_FUNCTION(input, Input, get_active_context);
 
-  SET_TYPE_FUNCTION(input, Input, get_action_pressed);
-  SET_TYPE_FUNCTION(input, Input, get_action_released);
-  SET_TYPE_FUNCTION(input, Input, get_action_held);
-  SET_TYPE_FUNCTION(input, Input, get_action_axis);
+  // Scripts should resolve actions once and query through the handle, the string versions hash the name
+  // on every call.
+  SET_TYPE_FUNCTION(input, Input, resolve_action);
+  SET_TYPE_FUNCTION(input, Input, find_action);
+
+  input.set_function(
+    "get_action_pressed",
+    sol::overload(
+      [](const Input& self, ActionID action, sol::optional<u32> instance_id) {
+        return self.get_action_pressed(action, instance_id.value_or(0));
+      },
+      [](const Input& self, std::string_view action_id, sol::optional<u32> instance_id) {
+        return self.get_action_pressed(action_id, instance_id.value_or(0));
+      }
+    )
+  );
+  input.set_function(
+    "get_action_released",
+    sol::overload(
+      [](const Input& self, ActionID action, sol::optional<u32> instance_id) {
+        return self.get_action_released(action, instance_id.value_or(0));
+      },
+      [](const Input& self, std::string_view action_id, sol::optional<u32> instance_id) {
+        return self.get_action_released(action_id, instance_id.value_or(0));
+      }
+    )
+  );
+  input.set_function(
+    "get_action_held",
+    sol::overload(
+      [](const Input& self, ActionID action, sol::optional<u32> instance_id) {
+        return self.get_action_held(action, instance_id.value_or(0));
+      },
+      [](const Input& self, std::string_view action_id, sol::optional<u32> instance_id) {
+        return self.get_action_held(action_id, instance_id.value_or(0));
+      }
+    )
+  );
+  input.set_function(
+    "get_action_axis",
+    sol::overload(
+      [](const Input& self, ActionID action, sol::optional<u32> instance_id) {
+        return self.get_action_axis(action, instance_id.value_or(0));
+      },
+      [](const Input& self, std::string_view action_id, sol::optional<u32> instance_id) {
+        return self.get_action_axis(action_id, instance_id.value_or(0));
+      }
+    )
+  );
 
   SET_TYPE_FUNCTION(input, Input, get_key_pressed);
   SET_TYPE_FUNCTION(input, Input, get_key_released);
@@ -5,6 +5,7 @@
 #include "Core/App.hpp"
 #include "OS/File.hpp"
 #include "Scripting/LuaNetworkBindings.hpp"
+#include "Utils/FrameProfiler.hpp"
 
 #ifdef OX_LUA_BINDINGS
   #include "Scripting/LuaApplicationBindings.hpp"  // IWYU pragma: export
@@ -23,10 +24,65 @@
 #endif
 
 namespace ox {
+#ifdef OX_LUA_BINDINGS
+  #define OX_LUA_BINDING_TYPES(X) \
+    X(AppBinding)                 \
+    X(AssetManagerBinding)        \
+    X(AudioBinding)               \
+    X(DebugBinding)               \
+    X(FlecsBinding)               \
+    X(InputBinding)               \
+    X(MathBinding)                \
+    X(PhysicsBinding)             \
+    X(RendererBinding)            \
+    X(SceneBinding)               \
+    X(UIBinding)                  \
+    X(VFSBinding)                 \
+    X(RMLBinding)                 \
+    X(NetworkBinding)
+#endif
+
 auto LuaManager::init(this LuaManager& self) -> std::expected<void, std::string> {
   ZoneScoped;
   self.state = std::make_unique<sol::state>();
-  self.state->open_libraries(
+  open_state(self.state.get());
+
+#define BIND(type) self.bind<type>(#type, self.state.get());
+
+#ifdef OX_LUA_BINDINGS
+  OX_LUA_BINDING_TYPES(BIND)
+#endif
+
+#undef BIND
+
+  self.gc.init(self.state->lua_state());
+  self.profiler = std::make_unique<LuaProfiler>();
+  self.profiler->attach(self.state->lua_state());
+
+  return {};
+}
+
+auto LuaManager::create_state(this const LuaManager&) -> std::unique_ptr<sol::state> {
+  ZoneScoped;
+
+  auto state = std::make_unique<sol::state>();
+  open_state(state.get());
+
+#define BIND(type) type().bind(state.get());
+
+#ifdef OX_LUA_BINDINGS
+  OX_LUA_BINDING_TYPES(BIND)
+#endif
+
+#undef BIND
+
+  return state;
+}
+
+auto LuaManager::open_state(sol::state* state) -> void {
+  ZoneScoped;
+
+  state->open_libraries(
     sol::lib::base,
     sol::lib::package,
     sol::lib::math,
@@ -35,48 +91,56 @@ auto LuaManager::init(this LuaManager& self) -> std::expected<void, std::string>
     sol::lib::string
   );
 
-  self.state->set_function(
+  state->set_function(
     "require_script",
-    [s = self.state.get()](const std::string& virtual_dir, const std::string& path) -> sol::object {
+    [state](const std::string& virtual_dir, const std::string& path) -> sol::object {
       ZoneScopedN("LuaRequire");
       auto& vfs = App::get_vfs();
       auto physical_path = vfs.resolve_physical_dir(virtual_dir, path);
       auto script = File::to_string(physical_path);
-      return s->require_script(path, script);
+      return state->require_script(path, script);
     }
   );
 
-#define BIND(type) self.bind<type>(#type, self.state.get())
-
 #ifdef OX_LUA_BINDINGS
-  self.bind_log();
-  self.bind_vector();
-  BIND(AppBinding);
-  BIND(AssetManagerBinding);
-  BIND(AudioBinding);
-  BIND(DebugBinding);
-  BIND(FlecsBinding);
-  BIND(InputBinding);
-  BIND(MathBinding);
-  BIND(PhysicsBinding);
-  BIND(RendererBinding);
-  BIND(SceneBinding);
-  BIND(UIBinding);
-  BIND(VFSBinding);
-  BIND(RMLBinding);
-  BIND(NetworkBinding);
+  bind_log(state);
+  bind_vector(state);
 #endif
-
-  return {};
 }
 
 auto LuaManager::deinit(this LuaManager& self) -> std::expected<void, std::string> {
   self.state->collect_gc();
+  self.profiler->detach();
   self.state.reset();
 
   return {};
 }
 
+auto LuaManager::configure_gc(this LuaManager& self, const LuaGCConfig& config) -> void {
+  ZoneScoped;
+
+  self.gc.init(self.state->lua_state(), config);
+}
+
+auto LuaManager::step_gc(this LuaManager& self) -> void {
+  ZoneScoped;
+
+  const auto cycles = self.gc.stats.completed_cycles;
+  self.gc.step(self.state->lua_state());
+
+  const auto& stats = self.gc.stats;
+  OX_GAUGE_SET("lua.heap_kb", static_cast<f64>(stats.heap_bytes) / 1024.0);
+  OX_GAUGE_SET("lua.gc_full_collections", stats.full_collections);
+  OX_COUNTER_ADD("lua.gc_step_us", stats.step_us);
+  OX_COUNTER_ADD("lua.gc_cycles", stats.completed_cycles - cycles);
+}
+
+auto LuaManager::collect_gc(this LuaManager& self) -> void {
+  ZoneScoped;
+
+  self.gc.full_collect(self.state->lua_state());
+}
+
 #define SET_LOG_FUNCTIONS(table, name, log_func)                                                                       \
   table.set_function(                                                                                                  \
     name,                                                                                                              \
@@ -89,19 +153,19 @@ auto LuaManager::deinit(this LuaManager& self) -> std::expected<void, std::strin
     )                                                                                                                  \
   );
 
-auto LuaManager::bind_log(this const LuaManager& self) -> void {
+auto LuaManager::bind_log(sol::state* state) -> void {
   ZoneScoped;
-  sol::table log = self.state->create_named_table("Oxlog");
+  sol::table log = state->create_named_table("Oxlog");
 
   SET_LOG_FUNCTIONS(log, "info", OX_LOG_INFO)
   SET_LOG_FUNCTIONS(log, "warn", OX_LOG_WARN)
   SET_LOG_FUNCTIONS(log, "error", OX_LOG_ERROR)
 }
 
-auto LuaManager::bind_vector(this const LuaManager& self) -> void {
+auto LuaManager::bind_vector(sol::state* state) -> void {
   ZoneScoped;
 
-  self.state->set_function("new_number_vector", []() { return std::vector<f64>{}; });
-  self.state->set_function("new_string_vector", []() { return std::vector<std::string>{}; });
+  state->set_function("new_number_vector", []() { return std::vector<f64>{}; });
+  state->set_function("new_string_vector", []() { return std::vector<std::string>{}; });
 }
 } // namespace ox
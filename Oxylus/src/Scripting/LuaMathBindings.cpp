@@ -40,6 +40,34 @@ namespace ox {
     )                                                                                                                  \
   );
 
+// In-place versions of the operators, `a:add_(b)` writes into `a` where `a + b` would allocate a new
+// userdata for the result. They return nothing for the same reason.
+#define SET_IN_PLACE_FUNCTIONS(var, type, number)                                                                      \
+  (var).set_function(                                                                                                  \
+    "add_",                                                                                                            \
+    sol::overload([](type& a, const type& b) { a += b; }, [](type& a, const number b) { a += b; })                     \
+  );                                                                                                                   \
+  (var).set_function(                                                                                                  \
+    "sub_",                                                                                                            \
+    sol::overload([](type& a, const type& b) { a -= b; }, [](type& a, const number b) { a -= b; })                     \
+  );                                                                                                                   \
+  (var).set_function(                                                                                                  \
+    "mul_",                                                                                                            \
+    sol::overload([](type& a, const type& b) { a *= b; }, [](type& a, const number b) { a *= b; })                     \
+  );                                                                                                                   \
+  (var).set_function(                                                                                                  \
+    "div_",                                                                                                            \
+    sol::overload([](type& a, const type& b) { a /= b; }, [](type& a, const number b) { a /= b; })                     \
+  );                                                                                                                   \
+  (var).set_function("copy_", [](type& a, const type& b) { a = b; });
+
+#define SET_FLOAT_IN_PLACE_FUNCTIONS(var, type)                                                                        \
+  (var).set_function("add_scaled_", [](type& a, const type& b, const f32 s) { a += b * s; });                          \
+  (var).set_function("lerp_", [](type& a, const type& b, const f32 t) { a = glm::mix(a, b, t); });                     \
+  (var).set_function("normalize_", [](type& a) { a = glm::normalize(a); });                                            \
+  (var).set_function("length", [](const type& a) { return glm::length(a); });                                          \
+  (var).set_function("dot", [](const type& a, const type& b) { return glm::dot(a, b); });
+
 auto MathBinding::bind(sol::state* state) -> void {
   ZoneScoped;
 
@@ -49,6 +77,10 @@ auto MathBinding::bind(sol::state* state) -> void {
   SET_TYPE_FIELD(vec2, glm::vec2, x);
   SET_TYPE_FIELD(vec2, glm::vec2, y);
   SET_MATH_FUNCTIONS(vec2, glm::vec2, float)
+  SET_IN_PLACE_FUNCTIONS(vec2, glm::vec2, float)
+  SET_FLOAT_IN_PLACE_FUNCTIONS(vec2, glm::vec2)
+  vec2.set_function("set", [](glm::vec2& v, f32 x, f32 y) { v = {x, y}; });
+  vec2.set_function("unpack", [](const glm::vec2& v) { return std::make_tuple(v.x, v.y); });
 
   auto uvec2 = state->new_usertype<glm::uvec2>(
     "uvec2",
@@ -71,6 +103,11 @@ auto MathBinding::bind(sol::state* state) -> void {
   SET_TYPE_FIELD(vec3, glm::vec3, y);
   SET_TYPE_FIELD(vec3, glm::vec3, z);
   SET_MATH_FUNCTIONS(vec3, glm::vec3, float)
+  SET_IN_PLACE_FUNCTIONS(vec3, glm::vec3, float)
+  SET_FLOAT_IN_PLACE_FUNCTIONS(vec3, glm::vec3)
+  vec3.set_function("set", [](glm::vec3& v, f32 x, f32 y, f32 z) { v = {x, y, z}; });
+  vec3.set_function("unpack", [](const glm::vec3& v) { return std::make_tuple(v.x, v.y, v.z); });
+  vec3.set_function("cross_", [](glm::vec3& a, const glm::vec3& b) { a = glm::cross(a, b); });
 
   auto ivec3 = state->new_usertype<glm::ivec3>(
     "ivec3",
@@ -99,6 +136,10 @@ auto MathBinding::bind(sol::state* state) -> void {
   SET_TYPE_FIELD(vec4, glm::vec4, z);
   SET_TYPE_FIELD(vec4, glm::vec4, w);
   SET_MATH_FUNCTIONS(vec4, glm::vec4, float)
+  SET_IN_PLACE_FUNCTIONS(vec4, glm::vec4, float)
+  SET_FLOAT_IN_PLACE_FUNCTIONS(vec4, glm::vec4)
+  vec4.set_function("set", [](glm::vec4& v, f32 x, f32 y, f32 z, f32 w) { v = {x, y, z, w}; });
+  vec4.set_function("unpack", [](const glm::vec4& v) { return std::make_tuple(v.x, v.y, v.z, v.w); });
 
   auto ivec4 = state->new_usertype<glm::ivec4>(
     "ivec4",
@@ -146,6 +187,12 @@ auto MathBinding::bind(sol::state* state) -> void {
   SET_TYPE_FIELD(quat, glm::quat, y);
   SET_TYPE_FIELD(quat, glm::quat, z);
   SET_TYPE_FIELD(quat, glm::quat, w);
+  quat.set_function("unpack", [](const glm::quat& q) { return std::make_tuple(q.x, q.y, q.z, q.w); });
+  quat.set_function("copy_", [](glm::quat& a, const glm::quat& b) { a = b; });
+  quat.set_function("mul_", [](glm::quat& a, const glm::quat& b) { a = a * b; });
+  quat.set_function("normalize_", [](glm::quat& q) { q = glm::normalize(q); });
+  // Rotates `v` in place, `q * v` without the new vec3.
+  quat.set_function("rotate_", [](const glm::quat& q, glm::vec3& v) { v = q * v; });
 
   state->new_enum<Intersection>("Intersection", {{"Outside", Outside}, {"Intersects", Intersects}, {"Inside", Inside}});
 
@@ -3,6 +3,7 @@
 #include <sol/state.hpp>
 
 #include "Networking/NetworkManager.hpp"
+#include "Scene/Scene.hpp"
 
 namespace ox {
 auto NetworkBinding::bind(sol::state* state) -> void {
@@ -39,6 +40,28 @@ auto NetworkBinding::bind(sol::state* state) -> void {
     &NetStats::last_sent_packets
   );
 
+  state->new_usertype<NetIOStats>(
+    "NetIOStats",
+
+    "dispatched_events",
+    &NetIOStats::dispatched_events,
+
+    "inbound_depth",
+    &NetIOStats::inbound_depth,
+
+    "outbound_depth",
+    &NetIOStats::outbound_depth,
+
+    "dropped_sends",
+    &NetIOStats::dropped_sends,
+
+    "latency_avg_ms",
+    &NetIOStats::latency_avg_ms,
+
+    "latency_max_ms",
+    &NetIOStats::latency_max_ms
+  );
+
   state->new_usertype<NetworkManager>(
     "NetworkManager",
 
@@ -60,6 +83,9 @@ auto NetworkBinding::bind(sol::state* state) -> void {
   state->new_usertype<NetServer>(
     "NetServer",
 
+    "io_stats",
+    &NetServer::io_stats,
+
     "set_tick_rate",
     &NetServer::set_tick_rate,
 
@@ -70,7 +96,10 @@ auto NetworkBinding::bind(sol::state* state) -> void {
     &NetServer::handle_packet,
 
     "register_proc",
-    &NetServer::register_proc
+    &NetServer::register_proc,
+
+    "flush_rpcs",
+    &NetServer::flush_rpcs
   );
 
   state->new_usertype<NetClient>(
@@ -79,9 +108,15 @@ auto NetworkBinding::bind(sol::state* state) -> void {
     "stats",
     &NetClient::stats,
 
+    "io_stats",
+    &NetClient::io_stats,
+
     "set_tick_rate",
     &NetClient::set_tick_rate,
 
+    "set_scene",
+    [](NetClient* self, Scene* scene) { self->set_world(scene->world); },
+
     "connect",
     &NetClient::connect,
 
@@ -100,6 +135,9 @@ auto NetworkBinding::bind(sol::state* state) -> void {
     "register_proc",
     &NetClient::register_proc,
 
+    "flush_rpcs",
+    &NetClient::flush_rpcs,
+
     "send_reliable",
     &NetClient::send_reliable,
 
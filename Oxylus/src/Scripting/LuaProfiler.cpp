@@ -0,0 +1,434 @@
+#include "Scripting/LuaProfiler.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <lua.hpp>
+#include <mutex>
+
+#include "OS/File.hpp"
+#include "Utils/Log.hpp"
+
+namespace ox {
+namespace {
+// Its address keys the profiler in the registry.
+char PROFILER_KEY = 0;
+
+// Stands for the stack of a call that ended before its first sample.
+constexpr auto UNSAMPLED_STACK = 0_u64;
+
+struct FunctionCosts {
+  LuaCost self = {};
+  LuaCost total = {};
+};
+
+struct PendingFrame {
+  LuaCost total = {};
+  ankerl::unordered_dense::map<std::string, LuaCost> stacks = {};
+  ankerl::unordered_dense::map<std::string, FunctionCosts> functions = {};
+  ankerl::unordered_dense::map<std::string, LuaCost> scripts = {};
+  ankerl::unordered_dense::map<std::string, LuaCost> lines = {};
+};
+
+struct Profiles {
+#ifdef OX_DEBUG
+  std::atomic<bool> enabled = true;
+#else
+  std::atomic<bool> enabled = false;
+#endif
+
+  // Taken by every call that ends and by `end_frame`.
+  std::mutex mutex = {};
+  PendingFrame pending = {};
+
+  // Main thread only.
+  std::array<LuaProfileFrame, LuaProfiler::HISTORY_SIZE> history = {};
+  u64 frame_count = 0;
+  // Merged on the first `summary` after a frame closed, viewers ask for it every frame.
+  LuaProfileSummary summary = {};
+  bool summary_stale = false;
+};
+
+Profiles profiles = {};
+
+auto now_ns() -> u64 {
+  return static_cast<u64>(
+    std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count()
+  );
+}
+
+auto mix(u64 hash, u64 value) -> u64 {
+  return ankerl::unordered_dense::detail::wyhash::mix(hash ^ value, 0x9e3779b97f4a7c15_u64);
+}
+
+auto add(LuaCost& to, const LuaCost& cost) -> void {
+  to.ms += cost.ms;
+  to.samples += cost.samples;
+  to.alloc_bytes += cost.alloc_bytes;
+}
+
+// `;` separates frames in the folded format.
+auto folded_frame(std::string frame) -> std::string {
+  std::ranges::replace(frame, ';', ',');
+  std::ranges::replace(frame, '\n', ' ');
+  return frame;
+}
+
+auto sorted_costs(const ankerl::unordered_dense::map<std::string, LuaCost>& costs) -> std::vector<LuaNamedCost> {
+  auto sorted = std::vector<LuaNamedCost>();
+  sorted.reserve(costs.size());
+  for (const auto& [name, cost] : costs) {
+    sorted.push_back({.name = name, .cost = cost});
+  }
+  std::ranges::sort(sorted, std::greater{}, [](const LuaNamedCost& named) { return named.cost.ms; });
+
+  return sorted;
+}
+
+auto fill_frame(const PendingFrame& pending, LuaProfileFrame& frame) -> void {
+  frame.total = pending.total;
+  frame.stacks = sorted_costs(pending.stacks);
+  frame.scripts = sorted_costs(pending.scripts);
+  frame.lines = sorted_costs(pending.lines);
+
+  frame.functions.clear();
+  frame.functions.reserve(pending.functions.size());
+  for (const auto& [name, costs] : pending.functions) {
+    frame.functions.push_back({.name = name, .self = costs.self, .total = costs.total});
+  }
+  std::ranges::sort(frame.functions, std::greater{}, [](const LuaFunctionCost& function) { return function.self.ms; });
+}
+
+auto merge_frame(PendingFrame& pending, const LuaProfileFrame& frame) -> void {
+  add(pending.total, frame.total);
+  for (const auto& stack : frame.stacks) {
+    add(pending.stacks[stack.name], stack.cost);
+  }
+  for (const auto& function : frame.functions) {
+    auto& costs = pending.functions[function.name];
+    add(costs.self, function.self);
+    add(costs.total, function.total);
+  }
+  for (const auto& script : frame.scripts) {
+    add(pending.scripts[script.name], script.cost);
+  }
+  for (const auto& line : frame.lines) {
+    add(pending.lines[line.name], line.cost);
+  }
+}
+
+auto is_c_frame(const lua_Debug& ar) -> bool { return std::strcmp(ar.what, "C") == 0; }
+} // namespace
+
+auto LuaProfiler::attach(this LuaProfiler& self, lua_State* L, const LuaProfilerConfig& config) -> void {
+  ZoneScoped;
+
+  if (self.state) {
+    self.detach();
+  }
+
+  self.state = L;
+  self.config = config;
+  self.alloc_fn = lua_getallocf(L, &self.alloc_ud);
+  lua_setallocf(L, &LuaProfiler::alloc, &self);
+
+  lua_pushlightuserdata(L, &self);
+  lua_rawsetp(L, LUA_REGISTRYINDEX, &PROFILER_KEY);
+}
+
+auto LuaProfiler::detach(this LuaProfiler& self) -> void {
+  ZoneScoped;
+
+  if (!self.state) {
+    return;
+  }
+
+  lua_sethook(self.state, nullptr, 0, 0);
+  lua_setallocf(self.state, self.alloc_fn, self.alloc_ud);
+  lua_pushnil(self.state);
+  lua_rawsetp(self.state, LUA_REGISTRYINDEX, &PROFILER_KEY);
+
+  self.state = nullptr;
+  self.recording = false;
+  self.open_calls = 0;
+  self.stacks.clear();
+}
+
+auto LuaProfiler::from_state(lua_State* L) -> LuaProfiler* {
+  lua_rawgetp(L, LUA_REGISTRYINDEX, &PROFILER_KEY);
+  auto* profiler = static_cast<LuaProfiler*>(lua_touserdata(L, -1));
+  lua_pop(L, 1);
+
+  return profiler;
+}
+
+auto LuaProfiler::begin_call(this LuaProfiler& self, std::string_view script, std::string_view function) -> void {
+  if (self.open_calls++ > 0 || !self.state || !is_enabled()) {
+    return;
+  }
+
+  self.script = script;
+  self.function = function;
+  self.pending_alloc_bytes = 0;
+  self.sampled = false;
+  self.recording = true;
+  self.last_sample_ns = now_ns();
+
+  // Coroutines made during the call inherit it.
+  lua_sethook(self.state, &LuaProfiler::hook, LUA_MASKCOUNT, self.config.sample_interval);
+}
+
+auto LuaProfiler::end_call(this LuaProfiler& self) -> void {
+  if (self.open_calls == 0 || --self.open_calls > 0 || !self.recording) {
+    return;
+  }
+
+  const auto end = now_ns();
+  lua_sethook(self.state, nullptr, 0, 0);
+  self.recording = false;
+
+  ZoneScoped;
+
+  // The rest of the call goes to the last stack seen, a call too short to be sampled only has its root.
+  if (!self.sampled) {
+    auto root = folded_frame(fmt::format("{} ({})", self.function, self.script));
+    self.stacks[UNSAMPLED_STACK] = Stack{
+      .folded = fmt::format("{};{}", folded_frame(self.script), root),
+      .functions = {root},
+      .leaf_function = root,
+    };
+    self.last_stack = UNSAMPLED_STACK;
+  }
+  self.charge(self.last_stack, end);
+
+  {
+    auto lock = std::unique_lock(profiles.mutex);
+    auto& frame = profiles.pending;
+    for (const auto& [key, stack] : self.stacks) {
+      add(frame.total, stack.cost);
+      add(frame.stacks[stack.folded], stack.cost);
+      add(frame.scripts[self.script], stack.cost);
+      add(frame.functions[stack.leaf_function].self, stack.cost);
+      for (const auto& function : stack.functions) {
+        add(frame.functions[function].total, stack.cost);
+      }
+      if (!stack.line.empty()) {
+        add(frame.lines[stack.line], stack.cost);
+      }
+    }
+  }
+
+  // Function names point into the state, a reloaded script may reuse them for something else.
+  self.stacks.clear();
+}
+
+auto LuaProfiler::sample(this LuaProfiler& self, lua_State* L) -> void {
+  if (!self.recording) {
+    return;
+  }
+
+  // Sources are interned strings, a function is its source and the line it starts at.
+  auto key = 0x5a17ed_u64;
+  auto depth = 0_u32;
+  auto ar = lua_Debug{};
+  for (auto level = 0; depth < self.config.max_depth && lua_getstack(L, level, &ar) != 0; level++) {
+    lua_getinfo(L, "Sl", &ar);
+    if (is_c_frame(ar)) {
+      continue;
+    }
+
+    if (depth == 0) {
+      key = mix(key, static_cast<u64>(ar.currentline));
+    }
+    key = mix(key, static_cast<u64>(reinterpret_cast<uptr>(ar.source)));
+    key = mix(key, static_cast<u64>(ar.linedefined));
+    depth += 1;
+  }
+
+  if (key == UNSAMPLED_STACK) {
+    key += 1;
+  }
+
+  if (!self.stacks.contains(key)) {
+    self.stacks.emplace(key, self.make_stack(L));
+  }
+
+  self.stacks[key].cost.samples += 1;
+  self.charge(key, now_ns());
+  self.sampled = true;
+}
+
+auto LuaProfiler::make_stack(this const LuaProfiler& self, lua_State* L) -> Stack {
+  ZoneScoped;
+
+  auto stack = Stack{};
+  // Innermost first.
+  auto frames = std::vector<std::string>();
+  auto outermost_anonymous = false;
+  auto ar = lua_Debug{};
+  for (auto level = 0; frames.size() < self.config.max_depth && lua_getstack(L, level, &ar) != 0; level++) {
+    lua_getinfo(L, "Sln", &ar);
+    if (is_c_frame(ar)) {
+      continue;
+    }
+
+    if (frames.empty()) {
+      stack.line = folded_frame(fmt::format("{}:{}", ar.short_src, ar.currentline));
+    }
+
+    const auto is_main = std::strcmp(ar.what, "main") == 0;
+    auto name = std::string_view(is_main ? "main chunk" : "anonymous");
+    if (ar.name) {
+      name = ar.name;
+    }
+    outermost_anonymous = !ar.name && !is_main;
+    frames.push_back(folded_frame(fmt::format("{} ({}:{})", name, ar.short_src, ar.linedefined)));
+  }
+
+  // Functions called from C++ have no name in Lua, it is the one the call was made with.
+  if (outermost_anonymous && frames.size() < self.config.max_depth) {
+    frames.back().replace(0, std::strlen("anonymous"), self.function);
+  }
+
+  stack.folded = folded_frame(self.script);
+  for (auto it = frames.rbegin(); it != frames.rend(); ++it) {
+    stack.folded += ';';
+    stack.folded += *it;
+    if (std::ranges::find(stack.functions, *it) == stack.functions.end()) {
+      stack.functions.push_back(*it);
+    }
+  }
+  if (!stack.line.empty()) {
+    stack.folded += ';';
+    stack.folded += stack.line;
+  }
+  if (!frames.empty()) {
+    stack.leaf_function = frames.front();
+  }
+
+  return stack;
+}
+
+auto LuaProfiler::charge(this LuaProfiler& self, u64 key, u64 now) -> void {
+  auto& cost = self.stacks[key].cost;
+  cost.ms += static_cast<f64>(now - self.last_sample_ns) / 1'000'000.0;
+  cost.alloc_bytes += self.pending_alloc_bytes;
+  self.pending_alloc_bytes = 0;
+  self.last_sample_ns = now;
+  self.last_stack = key;
+}
+
+auto LuaProfiler::hook(lua_State* L, lua_Debug*) -> void {
+  if (auto* profiler = from_state(L)) {
+    profiler->sample(L);
+  }
+}
+
+auto LuaProfiler::alloc(void* ud, void* ptr, usize old_size, usize new_size) -> void* {
+  auto* self = static_cast<LuaProfiler*>(ud);
+  // Without a block `old_size` is the type of the object being made.
+  const auto old_bytes = ptr ? old_size : 0_sz;
+  if (self->recording && new_size > old_bytes) {
+    self->pending_alloc_bytes += new_size - old_bytes;
+  }
+
+  return self->alloc_fn(self->alloc_ud, ptr, old_size, new_size);
+}
+
+auto LuaProfiler::set_enabled(bool enabled) -> void { profiles.enabled.store(enabled, std::memory_order_relaxed); }
+
+auto LuaProfiler::is_enabled() -> bool { return profiles.enabled.load(std::memory_order_relaxed); }
+
+auto LuaProfiler::end_frame() -> void {
+  ZoneScoped;
+
+  auto pending = PendingFrame{};
+  {
+    auto lock = std::unique_lock(profiles.mutex);
+    std::swap(pending, profiles.pending);
+  }
+
+  if (!is_enabled() && pending.stacks.empty()) {
+    return;
+  }
+
+  auto& frame = profiles.history[profiles.frame_count % HISTORY_SIZE];
+  fill_frame(pending, frame);
+  frame.index = profiles.frame_count++;
+  profiles.summary_stale = true;
+}
+
+auto LuaProfiler::history() -> std::vector<const LuaProfileFrame*> {
+  const auto count = std::min<u64>(profiles.frame_count, HISTORY_SIZE);
+  auto frames = std::vector<const LuaProfileFrame*>();
+  frames.reserve(count);
+  for (auto i = profiles.frame_count - count; i < profiles.frame_count; i++) {
+    frames.push_back(&profiles.history[i % HISTORY_SIZE]);
+  }
+
+  return frames;
+}
+
+auto LuaProfiler::last_frame() -> const LuaProfileFrame* {
+  if (profiles.frame_count == 0) {
+    return nullptr;
+  }
+
+  return &profiles.history[(profiles.frame_count - 1) % HISTORY_SIZE];
+}
+
+auto LuaProfiler::summary() -> const LuaProfileSummary& {
+  ZoneScoped;
+
+  if (!profiles.summary_stale) {
+    return profiles.summary;
+  }
+
+  auto merged = PendingFrame{};
+  profiles.summary.frames = 0;
+  for (const auto* frame : history()) {
+    merge_frame(merged, *frame);
+    profiles.summary.frames += 1;
+  }
+  fill_frame(merged, profiles.summary.totals);
+  profiles.summary_stale = false;
+
+  return profiles.summary;
+}
+
+auto LuaProfiler::reset() -> void {
+  {
+    auto lock = std::unique_lock(profiles.mutex);
+    profiles.pending = {};
+  }
+
+  profiles.history = {};
+  profiles.frame_count = 0;
+  profiles.summary = {};
+  profiles.summary_stale = false;
+}
+
+auto LuaProfiler::export_folded(const std::filesystem::path& path, bool allocations)
+  -> std::expected<void, std::string> {
+  ZoneScoped;
+
+  auto folded = std::string();
+  for (const auto& stack : summary().totals.stacks) {
+    const auto& cost = stack.cost;
+    const auto weight = allocations ? cost.alloc_bytes : static_cast<u64>(std::llround(cost.ms * 1000.0));
+    if (weight != 0) {
+      folded += fmt::format("{} {}\n", stack.name, weight);
+    }
+  }
+
+  auto file = File(path, FileAccess::Write);
+  if (!file || file.write(folded) != folded.size()) {
+    return std::unexpected(fmt::format("Failed to write Lua profile {}.", path));
+  }
+
+  return {};
+}
+} // namespace ox
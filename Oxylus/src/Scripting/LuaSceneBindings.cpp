@@ -13,7 +13,7 @@ auto SceneBinding::bind(sol::state* state) -> void {
   ZoneScoped;
   sol::usertype<Scene> scene_type = state->new_usertype<Scene>("Scene");
 
-  scene_type.set_function("world", [](Scene* scene) -> ecs_world_t* { return scene->world.world_; });
+  scene_type.set_function("world", [](Scene* scene) -> ecs_world_t* { return scene->get_script_world(); });
 
   SET_TYPE_FUNCTION(scene_type, Scene, runtime_start);
   SET_TYPE_FUNCTION(scene_type, Scene, runtime_stop);
@@ -6,8 +6,11 @@
 #include <sol/state.hpp>
 
 #include "Core/App.hpp"
+#include "OS/File.hpp"
 #include "Scene/Scene.hpp"
+#include "Scripting/LuaBytecode.hpp"
 #include "Scripting/LuaManager.hpp"
+#include "Utils/FrameProfiler.hpp"
 
 namespace ox {
 LuaSystem::LuaSystem(std::string path) : file_path(std::move(path)) {
@@ -26,42 +29,95 @@ auto LuaSystem::check_result(const sol::protected_function_result& result, const
 }
 
 auto LuaSystem::init_script(
-  this LuaSystem& self, const std::filesystem::path& path, const ox::option<std::string> script
-) -> void {
+  this LuaSystem& self,
+  const std::filesystem::path& path,
+  const ox::option<std::string> script,
+  std::span<const u8> bytecode,
+  bool bytecode_parallel
+) -> ScriptLoadResult {
   ZoneScoped;
 
   self.file_path = path;
   self.script_ = script;
 
-  const auto state = App::mod<LuaManager>().get_state();
+  auto file_path_str = self.file_path.string();
+  auto source = std::string();
+  auto parallel = bytecode_parallel;
+  if (bytecode.empty()) {
+    if (!script.has_value() && !std::filesystem::exists(self.file_path)) {
+      OX_LOG_ERROR("Lua script {} doesn't exist", self.file_path);
+      return ScriptLoadResult::LoadFailed;
+    }
 
-  if (self.environment)
-    self.environment.reset();
-  self.environment = std::make_unique<sol::environment>(*state, sol::create, state->globals());
+    source = script.has_value() ? script.value() : File::to_string(self.file_path);
+    parallel = is_parallel_script(source);
+  }
 
-  auto file_path_str = self.file_path.string();
-  const auto load_file_result = script.has_value()
-                                  ? state->script(self.script_.value(), *self.environment, sol::script_pass_on_error)
-                                  : state->script_file(file_path_str, *self.environment, sol::script_pass_on_error);
+  // Everything that lives in the old state has to go before it can.
+  self.reset_functions();
+  self.environment.reset();
+
+  auto& lua_manager = App::mod<LuaManager>();
+  if (parallel && !self.own_state) {
+    self.own_state = lua_manager.create_state();
+    self.own_gc.init(self.own_state->lua_state());
+    self.own_profiler = std::make_unique<LuaProfiler>();
+    self.own_profiler->attach(self.own_state->lua_state());
+  } else if (!parallel && self.own_state) {
+    self.own_profiler->detach();
+    self.own_state.reset();
+    self.own_profiler.reset();
+  }
+  self.profiler = self.own_state ? self.own_profiler.get() : lua_manager.get_profiler();
+  self.profile_name = file_path_str;
+
+  auto* state = self.own_state ? self.own_state.get() : lua_manager.get_state();
+  self.environment = std::make_unique<sol::environment>(*state, sol::create, state->globals());
 
-  if (!load_file_result.valid()) {
-    const sol::error err = load_file_result;
+  const auto report_error = [&](const sol::error& err) {
     OX_LOG_ERROR("Failed to Execute Lua script {0}", self.file_path);
     OX_LOG_ERROR("Error : {0}", err.what());
     std::string error = std::string(err.what());
 
+    // Stripped bytecode and inline scripts have no `file.lua:line:` prefix to pick apart.
     const auto linepos = error.find(".lua:");
-    std::string error_line = error.substr(linepos + 5); //+4 .lua: + 1
-    const auto linepos_end = error_line.find(':');
-    error_line = error_line.substr(0, linepos_end);
-    const int line = std::stoi(error_line);
-    error = error.substr(linepos + error_line.size() + linepos_end + 4); //+4 .lua:
+    if (linepos != std::string::npos) {
+      std::string error_line = error.substr(linepos + 5); //+4 .lua: + 1
+      const auto linepos_end = error_line.find(':');
+      error_line = error_line.substr(0, linepos_end);
+      const int line = std::atoi(error_line.c_str());
+      error = error.substr(linepos + error_line.size() + linepos_end + 4); //+4 .lua:
+
+      self.errors[line] = error;
+    }
+
+    for (auto [l, e] : self.errors) {
+      OX_LOG_ERROR("{} {}", l, e);
+    }
+  };
 
-    self.errors[line] = error;
+  // Loaded and run apart, a chunk that doesn't load never ran and can be retried from source. One that
+  // errors at the top level already ran up to there, running it again would do that twice.
+  const auto chunk_name = "@" + file_path_str;
+  auto load_result = [&] {
+    if (!bytecode.empty()) {
+      const auto chunk = std::string_view(reinterpret_cast<const char*>(bytecode.data()), bytecode.size());
+      return state->load(chunk, chunk_name, sol::load_mode::binary);
+    }
+
+    return script.has_value() ? state->load(source) : state->load(source, chunk_name);
+  }();
+
+  if (!load_result.valid()) {
+    report_error(load_result.get<sol::error>());
+    return ScriptLoadResult::LoadFailed;
   }
 
-  for (auto [l, e] : self.errors) {
-    OX_LOG_ERROR("{} {}", l, e);
+  auto chunk = load_result.get<sol::protected_function>();
+  sol::set_environment(*self.environment, chunk);
+  const auto run_result = chunk();
+  if (!run_result.valid()) {
+    report_error(run_result.get<sol::error>());
   }
 
   constexpr auto reset_unused = [](std::unique_ptr<sol::protected_function>& func) {
@@ -110,7 +166,8 @@ auto LuaSystem::init_script(
   self.on_body_deactivated_func = std::make_unique<sol::protected_function>((*self.environment)["on_body_deactivated"]);
   reset_unused(self.on_body_deactivated_func);
 
-  state->collect_gc();
+  // Garbage from loading is left to the per-frame steps in `LuaManager::step_gc`.
+  return run_result.valid() ? ScriptLoadResult::Loaded : ScriptLoadResult::RunFailed;
 }
 
 auto LuaSystem::load(this LuaSystem& self, const std::filesystem::path& path, const ox::option<std::string> script)
@@ -120,6 +177,14 @@ auto LuaSystem::load(this LuaSystem& self, const std::filesystem::path& path, co
   self.init_script(path, script);
 }
 
+auto LuaSystem::load_bytecode(
+  this LuaSystem& self, const std::filesystem::path& path, std::span<const u8> bytecode, bool parallel
+) -> ScriptLoadResult {
+  ZoneScoped;
+
+  return self.init_script(path, nullopt, bytecode, parallel);
+}
+
 auto LuaSystem::reload(this LuaSystem& self) -> void {
   ZoneScoped;
 
@@ -128,6 +193,18 @@ auto LuaSystem::reload(this LuaSystem& self) -> void {
   self.init_script(self.file_path);
 }
 
+auto LuaSystem::step_gc(this LuaSystem& self) -> void {
+  ZoneScoped;
+
+  if (!self.own_state) {
+    return;
+  }
+
+  self.own_gc.step(self.own_state->lua_state());
+  OX_COUNTER_ADD("lua.gc_step_us", self.own_gc.stats.step_us);
+  OX_COUNTER_ADD("lua.parallel_heap_kb", static_cast<f64>(self.own_gc.stats.heap_bytes) / 1024.0);
+}
+
 auto LuaSystem::reset_functions(this LuaSystem& self) -> void {
   ZoneScoped;
 
@@ -153,6 +230,7 @@ auto LuaSystem::on_add(this const LuaSystem& self, Scene* scene) -> void {
   if (!self.on_add_func)
     return;
 
+  const auto profile_call = LuaProfileCall(self.profiler, self.profile_name, "on_add");
   const auto result = self.on_add_func->call(scene);
   check_result(result, "on_add");
 }
@@ -163,6 +241,7 @@ auto LuaSystem::on_remove(this const LuaSystem& self, Scene* scene) -> void {
   if (!self.on_remove_func)
     return;
 
+  const auto profile_call = LuaProfileCall(self.profiler, self.profile_name, "on_remove");
   const auto result = self.on_remove_func->call(scene);
   check_result(result, "on_remove");
 }
@@ -173,6 +252,7 @@ auto LuaSystem::on_scene_start(this const LuaSystem& self, Scene* scene) -> void
   if (!self.on_scene_start_func)
     return;
 
+  const auto profile_call = LuaProfileCall(self.profiler, self.profile_name, "on_scene_start");
   const auto result = self.on_scene_start_func->call(scene);
   check_result(result, "on_scene_start");
 }
@@ -183,6 +263,7 @@ auto LuaSystem::on_scene_update(this const LuaSystem& self, Scene* scene, f32 de
   if (!self.on_scene_update_func)
     return;
 
+  const auto profile_call = LuaProfileCall(self.profiler, self.profile_name, "on_scene_update");
   const auto result = self.on_scene_update_func->call(scene, delta_time);
   check_result(result, "on_scene_update");
 }
@@ -193,6 +274,7 @@ auto LuaSystem::on_scene_fixed_update(this const LuaSystem& self, Scene* scene,
   if (!self.on_scene_fixed_update_func)
     return;
 
+  const auto profile_call = LuaProfileCall(self.profiler, self.profile_name, "on_scene_fixed_update");
   const auto result = self.on_scene_fixed_update_func->call(scene, delta_time);
   check_result(result, "on_scene_fixed_update");
 }
@@ -203,6 +285,7 @@ auto LuaSystem::on_scene_render(this const LuaSystem& self, Scene* scene, vuk::E
   if (!self.on_scene_render_func)
     return;
 
+  const auto profile_call = LuaProfileCall(self.profiler, self.profile_name, "on_scene_render");
   const auto result = self.on_scene_render_func->call(scene, glm::vec3(extent.width, extent.height, extent.depth));
   check_result(result, "on_scene_render");
 }
@@ -213,6 +296,7 @@ auto LuaSystem::on_scene_stop(this const LuaSystem& self, Scene* scene) -> void
   if (!self.on_scene_stop_func)
     return;
 
+  const auto profile_call = LuaProfileCall(self.profiler, self.profile_name, "on_scene_stop");
   const auto result = self.on_scene_stop_func->call(scene);
   check_result(result, "on_scene_stop");
 }
@@ -230,6 +314,7 @@ auto LuaSystem::on_contact_added(
   if (!self.on_contact_added_func)
     return;
 
+  const auto profile_call = LuaProfileCall(self.profiler, self.profile_name, "on_contact_added");
   const auto result = self.on_contact_added_func->call(scene, &body1, &body2, manifold, settings);
   check_result(result, "on_contact_added");
 }
@@ -247,6 +332,7 @@ auto LuaSystem::on_contact_persisted(
   if (!self.on_contact_persisted_func)
     return;
 
+  const auto profile_call = LuaProfileCall(self.profiler, self.profile_name, "on_contact_persisted");
   const auto result = self.on_contact_persisted_func->call(scene, &body1, &body2, manifold, settings);
   check_result(result, "on_contact_persisted");
 }
@@ -258,6 +344,7 @@ auto LuaSystem::on_contact_removed(this const LuaSystem& self, Scene* scene, con
   if (!self.on_contact_removed_func)
     return;
 
+  const auto profile_call = LuaProfileCall(self.profiler, self.profile_name, "on_contact_removed");
   const auto result = self.on_contact_removed_func->call(scene, sub_shape_pair);
   check_result(result, "on_contact_removed");
 }
@@ -270,6 +357,7 @@ auto LuaSystem::on_body_activated(
   if (!self.on_body_activated_func)
     return;
 
+  const auto profile_call = LuaProfileCall(self.profiler, self.profile_name, "on_body_activated");
   const auto result = self.on_body_activated_func->call(scene, body_id, body_user_data);
   check_result(result, "on_body_activated");
 }
@@ -282,6 +370,7 @@ auto LuaSystem::on_body_deactivated(
   if (!self.on_body_deactivated_func)
     return;
 
+  const auto profile_call = LuaProfileCall(self.profiler, self.profile_name, "on_body_deactivated");
   const auto result = self.on_body_deactivated_func->call(scene, body_id, body_user_data);
   check_result(result, "on_body_deactivated");
 }
@@ -14,5 +14,6 @@ auto UIBinding::bind(sol::state* state) -> void {
   ui.set_function("center_next_window", &UI::center_next_window);
 
   ui.set_function("draw_network_stats", &NetStatsViewer::draw_network_stats);
+  ui.set_function("draw_server_network_stats", &NetStatsViewer::draw_server_network_stats);
 }
 } // namespace ox
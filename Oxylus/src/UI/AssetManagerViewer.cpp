@@ -146,6 +146,7 @@ auto AssetManagerViewer::render(const char* id, bool* visible, AssetType default
           script_assets.emplace_back(asset);
           break;
         }
+        case AssetType::PhysicsShape: break;
       }
     }
   }
@@ -21,7 +21,32 @@ auto NetStatsViewer::draw_network_stats(const NetClient& client) -> void {
     ImGui::TextUnformatted(stack.format_char("last_sent_bytes: {}", client.stats.last_sent_bytes));
     ImGui::TextUnformatted(stack.format_char("last_received_bytes: {}", client.stats.last_received_bytes));
     ImGui::TextUnformatted(stack.format_char("last_sent_packets: {}", client.stats.last_sent_packets));
+    draw_io_stats(client.io_stats);
   }
   ImGui::End();
 }
+
+auto NetStatsViewer::draw_server_network_stats(const NetServer& server) -> void {
+  ZoneScoped;
+
+  memory::ScopedStack stack;
+
+  if (ImGui::Begin("NetServerStats")) {
+    ImGui::TextUnformatted(stack.format_char("clients: {}", server.remote_clients.size()));
+    draw_io_stats(server.io_stats);
+  }
+  ImGui::End();
+}
+
+auto NetStatsViewer::draw_io_stats(const NetIOStats& io_stats) -> void {
+  memory::ScopedStack stack;
+
+  ImGui::SeparatorText("I/O thread");
+  ImGui::TextUnformatted(stack.format_char("dispatched_events: {}", io_stats.dispatched_events));
+  ImGui::TextUnformatted(stack.format_char("inbound_depth: {}", io_stats.inbound_depth));
+  ImGui::TextUnformatted(stack.format_char("outbound_depth: {}", io_stats.outbound_depth));
+  ImGui::TextUnformatted(stack.format_char("dropped_sends: {}", io_stats.dropped_sends));
+  ImGui::TextUnformatted(stack.format_char("latency_avg: {:.3f}ms", io_stats.latency_avg_ms));
+  ImGui::TextUnformatted(stack.format_char("latency_max: {:.3f}ms", io_stats.latency_max_ms));
+}
 } // namespace ox
@@ -0,0 +1,320 @@
+#include "UI/ProfilerViewer.hpp"
+
+#include <imgui.h>
+
+#include "Memory/Stack.hpp"
+
+namespace ox {
+namespace {
+auto scope_key(const ProfileScopeStats& scope) -> u64 { return (static_cast<u64>(scope.thread) << 32) | scope.node; }
+} // namespace
+
+auto ProfilerViewer::render(this ProfilerViewer& self, const char* id, bool* visible) -> void {
+  ZoneScoped;
+  memory::ScopedStack stack;
+
+  if (!ImGui::Begin(id, visible, ImGuiWindowFlags_NoCollapse)) {
+    ImGui::End();
+    return;
+  }
+
+  auto enabled = FrameProfiler::is_enabled();
+  if (ImGui::Checkbox("Record scopes", &enabled)) {
+    FrameProfiler::set_enabled(enabled);
+  }
+
+  ImGui::SameLine();
+  if (ImGui::Button("Export JSON")) {
+    const auto path = self.export_stem + ".json";
+    const auto result = FrameProfiler::export_json(path);
+    self.export_status = result ? fmt::format("Written to {}", path) : result.error();
+  }
+
+  ImGui::SameLine();
+  if (ImGui::Button("Export CSV")) {
+    const auto path = self.export_stem + ".csv";
+    const auto result = FrameProfiler::export_csv(path);
+    self.export_status = result ? fmt::format("Written to {}", path) : result.error();
+  }
+
+  ImGui::SameLine();
+  if (ImGui::Button("Export Lua flame graph")) {
+    const auto path = self.export_stem + "_lua.folded";
+    const auto result = LuaProfiler::export_folded(path);
+    self.export_status = result ? fmt::format("Written to {}", path) : result.error();
+  }
+
+  ImGui::SameLine();
+  if (ImGui::Button("Reset")) {
+    FrameProfiler::reset();
+    LuaProfiler::reset();
+  }
+
+  if (!self.export_status.empty()) {
+    ImGui::TextUnformatted(self.export_status.c_str());
+  }
+
+  const auto* last = FrameProfiler::last_frame();
+  if (!last) {
+    ImGui::TextUnformatted("No frames recorded yet.");
+    ImGui::End();
+    return;
+  }
+
+  const auto history = FrameProfiler::history();
+  self.frame_ms.clear();
+  self.history_ms.clear();
+  self.scope_sums.clear();
+  for (const auto* frame : history) {
+    self.frame_ms.push_back(static_cast<f32>(frame->cpu_ms));
+    self.history_ms.push_back(frame->cpu_ms);
+    for (const auto& scope : frame->scopes) {
+      self.scope_sums[scope_key(scope)] += scope.total_ms;
+    }
+  }
+
+  const auto recent = summarize_frame_times(self.history_ms);
+  const auto run = FrameProfiler::summary();
+  ImGui::TextUnformatted(stack.format_char(
+    "Last {} frames: mean {:.2f}ms, p50 {:.2f}ms, p95 {:.2f}ms, p99 {:.2f}ms, max {:.2f}ms",
+    recent.frames,
+    recent.mean_ms,
+    recent.p50_ms,
+    recent.p95_ms,
+    recent.p99_ms,
+    recent.max_ms
+  ));
+  ImGui::TextUnformatted(
+    stack.format_char("Whole run ({} frames): p50 {:.2f}ms, p99 {:.2f}ms", run.frames, run.p50_ms, run.p99_ms)
+  );
+
+  ImGui::PlotLines("##frame_ms",
+                   self.frame_ms.data(),
+                   static_cast<i32>(self.frame_ms.size()),
+                   0,
+                   stack.format_char("{:.2f}ms", last->cpu_ms),
+                   0.0f,
+                   static_cast<f32>(recent.max_ms * 1.1),
+                   ImVec2(ImGui::GetContentRegionAvail().x, 80.0f));
+
+  const auto frames = static_cast<f64>(history.size());
+  self.mean_scope_ms.clear();
+  for (const auto& scope : last->scopes) {
+    self.mean_scope_ms.push_back(self.scope_sums[scope_key(scope)] / frames);
+  }
+
+  if (ImGui::CollapsingHeader("Scopes", ImGuiTreeNodeFlags_DefaultOpen)) {
+    self.draw_scopes(*last);
+  }
+
+  if (ImGui::CollapsingHeader("Metrics", ImGuiTreeNodeFlags_DefaultOpen)) {
+    self.draw_metrics(*last);
+  }
+
+  if (ImGui::CollapsingHeader("Lua scripts")) {
+    self.draw_lua();
+  }
+
+  ImGui::End();
+}
+
+auto ProfilerViewer::draw_scope(this ProfilerViewer& self, const ProfileFrame& frame, u32 index) -> void {
+  memory::ScopedStack stack;
+
+  const auto& scope = frame.scopes[index];
+  const auto& scope_children = self.children[index];
+
+  ImGui::TableNextRow();
+  ImGui::TableSetColumnIndex(0);
+  auto flags = ImGuiTreeNodeFlags_SpanAllColumns | ImGuiTreeNodeFlags_DefaultOpen;
+  if (scope_children.empty()) {
+    flags |= ImGuiTreeNodeFlags_Leaf | ImGuiTreeNodeFlags_NoTreePushOnOpen;
+  }
+
+  ImGui::PushID(static_cast<i32>(index));
+  const auto open = ImGui::TreeNodeEx(scope.name, flags);
+  ImGui::PopID();
+
+  ImGui::TableSetColumnIndex(1);
+  ImGui::TextUnformatted(stack.format_char("{:.3f}", scope.total_ms));
+  ImGui::TableSetColumnIndex(2);
+  ImGui::TextUnformatted(stack.format_char("{:.3f}", self.mean_scope_ms[index]));
+  ImGui::TableSetColumnIndex(3);
+  ImGui::TextUnformatted(stack.format_char("{}", scope.calls));
+
+  if (open && !scope_children.empty()) {
+    for (const auto child : scope_children) {
+      self.draw_scope(frame, child);
+    }
+    ImGui::TreePop();
+  }
+}
+
+auto ProfilerViewer::draw_scopes(this ProfilerViewer& self, const ProfileFrame& frame) -> void {
+  ZoneScoped;
+
+  if (frame.scopes.empty()) {
+    ImGui::TextUnformatted("No scopes in the last frame.");
+    return;
+  }
+
+  self.children.resize(frame.scopes.size());
+  for (auto& scope_children : self.children) {
+    scope_children.clear();
+  }
+
+  for (auto i = 0_u32; i < frame.scopes.size(); i++) {
+    const auto parent = frame.scopes[i].parent;
+    if (parent != ProfileScopeStats::NO_PARENT) {
+      self.children[parent].push_back(i);
+    }
+  }
+
+  constexpr auto table_flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_Resizable;
+  if (!ImGui::BeginTable("scopes", 4, table_flags)) {
+    return;
+  }
+
+  ImGui::TableSetupColumn("Scope", ImGuiTableColumnFlags_WidthStretch);
+  ImGui::TableSetupColumn("Last ms", ImGuiTableColumnFlags_WidthFixed, 70.0f);
+  ImGui::TableSetupColumn("Mean ms", ImGuiTableColumnFlags_WidthFixed, 70.0f);
+  ImGui::TableSetupColumn("Calls", ImGuiTableColumnFlags_WidthFixed, 50.0f);
+  ImGui::TableHeadersRow();
+
+  // Roots are the threads, timed by the scopes directly under them.
+  for (auto i = 0_u32; i < frame.scopes.size(); i++) {
+    if (frame.scopes[i].parent == ProfileScopeStats::NO_PARENT) {
+      self.draw_scope(frame, i);
+    }
+  }
+
+  ImGui::EndTable();
+}
+
+auto ProfilerViewer::draw_metrics(this ProfilerViewer& self, const ProfileFrame& frame) -> void {
+  ZoneScoped;
+  memory::ScopedStack stack;
+
+  const auto infos = FrameProfiler::metrics();
+  if (infos.empty()) {
+    ImGui::TextUnformatted("No metrics registered.");
+    return;
+  }
+
+  constexpr auto table_flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_Resizable;
+  if (!ImGui::BeginTable("metrics", 3, table_flags)) {
+    return;
+  }
+
+  ImGui::TableSetupColumn("Metric", ImGuiTableColumnFlags_WidthStretch);
+  ImGui::TableSetupColumn("Last frame", ImGuiTableColumnFlags_WidthFixed, 90.0f);
+  ImGui::TableSetupColumn("Mean", ImGuiTableColumnFlags_WidthFixed, 90.0f);
+  ImGui::TableHeadersRow();
+
+  const auto history = FrameProfiler::history();
+  for (auto i = 0_sz; i < infos.size() && i < frame.metrics.size(); i++) {
+    auto sum = 0.0;
+    auto frames = 0_sz;
+    for (const auto* past : history) {
+      if (i < past->metrics.size()) {
+        sum += past->metrics[i];
+        frames += 1;
+      }
+    }
+
+    ImGui::TableNextRow();
+    ImGui::TableSetColumnIndex(0);
+    ImGui::TextUnformatted(infos[i].name.c_str());
+    if (infos[i].kind == MetricKind::Gauge) {
+      ImGui::SameLine();
+      ImGui::TextDisabled("(gauge)");
+    }
+    ImGui::TableSetColumnIndex(1);
+    ImGui::TextUnformatted(stack.format_char("{:.0f}", frame.metrics[i]));
+    ImGui::TableSetColumnIndex(2);
+    ImGui::TextUnformatted(stack.format_char("{:.1f}", frames != 0 ? sum / static_cast<f64>(frames) : 0.0));
+  }
+
+  ImGui::EndTable();
+}
+
+auto ProfilerViewer::draw_lua(this ProfilerViewer&) -> void {
+  ZoneScoped;
+  memory::ScopedStack stack;
+
+  auto enabled = LuaProfiler::is_enabled();
+  if (ImGui::Checkbox("Sample scripts", &enabled)) {
+    LuaProfiler::set_enabled(enabled);
+  }
+
+  const auto& summary = LuaProfiler::summary();
+  if (summary.frames == 0 || summary.totals.total.samples == 0) {
+    ImGui::TextUnformatted("No script samples recorded.");
+    return;
+  }
+
+  const auto frames = static_cast<f64>(summary.frames);
+  const auto& totals = summary.totals;
+  ImGui::TextUnformatted(stack.format_char(
+    "Last {} frames: {:.3f}ms, {:.1f} samples, {:.1f}KB allocated per frame",
+    summary.frames,
+    totals.total.ms / frames,
+    static_cast<f64>(totals.total.samples) / frames,
+    static_cast<f64>(totals.total.alloc_bytes) / 1024.0 / frames
+  ));
+
+  constexpr auto table_flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_Resizable |
+                               ImGuiTableFlags_ScrollY;
+  constexpr auto max_rows = 32_sz;
+  const auto table_size = ImVec2(0.0f, ImGui::GetTextLineHeightWithSpacing() * 10.0f);
+
+  const auto draw_costs = [&](const char* id, const char* column, const std::vector<LuaNamedCost>& costs) {
+    if (!ImGui::BeginTable(id, 3, table_flags, table_size)) {
+      return;
+    }
+
+    ImGui::TableSetupColumn(column, ImGuiTableColumnFlags_WidthStretch);
+    ImGui::TableSetupColumn("ms/frame", ImGuiTableColumnFlags_WidthFixed, 70.0f);
+    ImGui::TableSetupColumn("KB/frame", ImGuiTableColumnFlags_WidthFixed, 70.0f);
+    ImGui::TableHeadersRow();
+    for (auto i = 0_sz; i < costs.size() && i < max_rows; i++) {
+      ImGui::TableNextRow();
+      ImGui::TableSetColumnIndex(0);
+      ImGui::TextUnformatted(costs[i].name.c_str());
+      ImGui::TableSetColumnIndex(1);
+      ImGui::TextUnformatted(stack.format_char("{:.3f}", costs[i].cost.ms / frames));
+      ImGui::TableSetColumnIndex(2);
+      const auto alloc_kb = static_cast<f64>(costs[i].cost.alloc_bytes) / 1024.0;
+      ImGui::TextUnformatted(stack.format_char("{:.1f}", alloc_kb / frames));
+    }
+    ImGui::EndTable();
+  };
+
+  draw_costs("lua_scripts", "Script", totals.scripts);
+
+  if (ImGui::BeginTable("lua_functions", 4, table_flags, table_size)) {
+    ImGui::TableSetupColumn("Function", ImGuiTableColumnFlags_WidthStretch);
+    ImGui::TableSetupColumn("Self ms", ImGuiTableColumnFlags_WidthFixed, 70.0f);
+    ImGui::TableSetupColumn("Total ms", ImGuiTableColumnFlags_WidthFixed, 70.0f);
+    ImGui::TableSetupColumn("Self KB", ImGuiTableColumnFlags_WidthFixed, 70.0f);
+    ImGui::TableHeadersRow();
+    for (auto i = 0_sz; i < totals.functions.size() && i < max_rows; i++) {
+      const auto& function = totals.functions[i];
+      ImGui::TableNextRow();
+      ImGui::TableSetColumnIndex(0);
+      ImGui::TextUnformatted(function.name.c_str());
+      ImGui::TableSetColumnIndex(1);
+      ImGui::TextUnformatted(stack.format_char("{:.3f}", function.self.ms / frames));
+      ImGui::TableSetColumnIndex(2);
+      ImGui::TextUnformatted(stack.format_char("{:.3f}", function.total.ms / frames));
+      ImGui::TableSetColumnIndex(3);
+      ImGui::TextUnformatted(
+        stack.format_char("{:.1f}", static_cast<f64>(function.self.alloc_bytes) / 1024.0 / frames)
+      );
+    }
+    ImGui::EndTable();
+  }
+
+  draw_costs("lua_lines", "Line", totals.lines);
+}
+} // namespace ox
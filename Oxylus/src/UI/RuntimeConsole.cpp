@@ -4,6 +4,7 @@
 
 #include "Core/App.hpp"
 #include "Core/Input.hpp"
+#include "Scripting/LuaProfiler.hpp"
 #include "Utils/CVars.hpp"
 
 namespace ox {
@@ -45,6 +46,43 @@ RuntimeConsole::RuntimeConsole() : id(fmt::format("runtime_console_{}", ++consol
   register_command("clear", "", [this](const ParsedCommandValue&) { clear_log(); });
   register_command("help", "", [this](const ParsedCommandValue& value) { help_command(value); });
 
+  // Lua profiler, `lua_profiler 0/1` or no value to toggle.
+  register_command("lua_profiler", "", [](const ParsedCommandValue& value) {
+    const auto enabled = value.as<i32>().transform([](i32 v) { return v != 0; });
+    LuaProfiler::set_enabled(enabled.value_or(!LuaProfiler::is_enabled()));
+    OX_LOG_INFO("Lua profiler {}.", LuaProfiler::is_enabled() ? "enabled" : "disabled");
+  });
+  register_command("lua_profile", "", [](const ParsedCommandValue&) {
+    const auto& summary = LuaProfiler::summary();
+    if (summary.frames == 0 || summary.totals.total.samples == 0) {
+      OX_LOG_INFO("No script samples recorded.");
+      return;
+    }
+
+    const auto frames = static_cast<f64>(summary.frames);
+    const auto frame_ms = summary.totals.total.ms / frames;
+    OX_LOG_INFO("Scripts over the last {} frames, {:.3f}ms per frame:", summary.frames, frame_ms);
+    for (auto i = 0_sz; i < summary.totals.functions.size() && i < 10; i++) {
+      const auto& function = summary.totals.functions[i];
+      OX_LOG_INFO(
+        "  {:.3f}ms self, {:.3f}ms total, {:.1f}KB  {}",
+        function.self.ms / frames,
+        function.total.ms / frames,
+        static_cast<f64>(function.self.alloc_bytes) / 1024.0 / frames,
+        function.name
+      );
+    }
+  });
+  register_command("lua_flamegraph", "", [](const ParsedCommandValue& value) {
+    const auto path = value.as_string().empty() ? std::string("logs/lua_profile.folded") : value.as_string();
+    const auto result = LuaProfiler::export_folded(path);
+    if (result) {
+      OX_LOG_INFO("Lua flame graph written to {}.", path);
+    } else {
+      OX_LOG_ERROR("{}", result.error());
+    }
+  });
+
   request_scroll_to_bottom = true;
 }
 
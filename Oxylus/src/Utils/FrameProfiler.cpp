@@ -0,0 +1,549 @@
+#include "Utils/FrameProfiler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+#include <ankerl/unordered_dense.h>
+
+#include "OS/File.hpp"
+#include "Utils/JsonWriter.hpp"
+#include "Utils/Log.hpp"
+
+namespace ox {
+namespace {
+constexpr auto NO_NODE = ~0_u32;
+
+struct ScopeNode {
+  const char* name = nullptr;
+  u32 parent = NO_NODE;
+  u32 first_child = NO_NODE;
+  u32 next_sibling = NO_NODE;
+  u32 depth = 0;
+  u32 calls = 0;
+  u64 total_ns = 0;
+};
+
+struct OpenScope {
+  u32 node = 0;
+  u64 start_ns = 0;
+};
+
+// Only ever contended by `end_frame` collecting it, once a frame.
+struct ThreadProfile {
+  std::mutex mutex = {};
+  u32 index = 0;
+  // `nodes[0]` is the thread itself. Nodes are never removed, so a scope keeps its index across frames.
+  std::vector<ScopeNode> nodes = {};
+  std::vector<OpenScope> open = {};
+  u32 current = 0;
+  std::atomic<bool> retired = false;
+};
+
+struct Profiler {
+  std::atomic<bool> enabled = true;
+
+  std::mutex threads_mutex = {};
+  std::vector<std::shared_ptr<ThreadProfile>> threads = {};
+  // Indexed by ProfileThread::index, outlives the threads so the history can still name them.
+  std::deque<std::string> thread_names = {};
+
+  std::mutex metrics_mutex = {};
+  std::vector<MetricInfo> metric_infos = {};
+  ankerl::unordered_dense::map<std::string, MetricID> metric_ids = {};
+  std::array<std::atomic<f64>, FrameProfiler::MAX_METRICS> metric_values = {};
+  std::array<std::atomic<u8>, FrameProfiler::MAX_METRICS> metric_kinds = {};
+  std::atomic<u32> metric_count = 0;
+
+  // Main thread only.
+  std::array<ProfileFrame, FrameProfiler::HISTORY_SIZE> history = {};
+  u64 frame_count = 0;
+  u64 frame_start_ns = 0;
+  FrameTimeHistogram frame_times = {};
+  std::vector<f64> metric_totals = {};
+  std::vector<bool> active_nodes = {};
+  std::vector<u32> node_remap = {};
+};
+
+Profiler profiler = {};
+
+struct ThreadProfileRef {
+  std::shared_ptr<ThreadProfile> profile = nullptr;
+
+  ~ThreadProfileRef() {
+    if (profile) {
+      profile->retired.store(true, std::memory_order_release);
+    }
+  }
+};
+
+thread_local ThreadProfileRef thread_profile = {};
+
+auto now_ns() -> u64 {
+  return static_cast<u64>(
+    std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count()
+  );
+}
+
+auto current_thread() -> ThreadProfile& {
+  if (thread_profile.profile) {
+    return *thread_profile.profile;
+  }
+
+  auto profile = std::make_shared<ThreadProfile>();
+  auto name = std::array<char, 32>{};
+  loguru::get_thread_name(name.data(), name.size(), false);
+
+  {
+    auto lock = std::unique_lock(profiler.threads_mutex);
+    profile->index = static_cast<u32>(profiler.thread_names.size());
+    profiler.thread_names.emplace_back(name.data());
+    profile->nodes.push_back({.name = profiler.thread_names.back().c_str()});
+    profiler.threads.push_back(profile);
+  }
+
+  thread_profile.profile = std::move(profile);
+  return *thread_profile.profile;
+}
+
+auto find_or_add_child(ThreadProfile& thread, u32 parent, const char* name) -> u32 {
+  auto child = thread.nodes[parent].first_child;
+  while (child != NO_NODE) {
+    const auto* child_name = thread.nodes[child].name;
+    if (child_name == name || std::strcmp(child_name, name) == 0) {
+      return child;
+    }
+    child = thread.nodes[child].next_sibling;
+  }
+
+  const auto index = static_cast<u32>(thread.nodes.size());
+  thread.nodes.push_back({
+    .name = name,
+    .parent = parent,
+    .next_sibling = thread.nodes[parent].first_child,
+    .depth = thread.nodes[parent].depth + 1,
+  });
+  thread.nodes[parent].first_child = index;
+  return index;
+}
+
+// Scopes that ran this frame, their parents and their thread go into the frame. Resets the counts.
+auto collect_thread(ThreadProfile& thread, std::vector<ProfileScopeStats>& out) -> void {
+  auto lock = std::unique_lock(thread.mutex);
+
+  auto& active = profiler.active_nodes;
+  auto& remap = profiler.node_remap;
+  active.assign(thread.nodes.size(), false);
+  remap.assign(thread.nodes.size(), ProfileScopeStats::NO_PARENT);
+
+  // Children always come after their parent.
+  for (auto i = thread.nodes.size(); i-- > 0;) {
+    const auto& node = thread.nodes[i];
+    if (node.calls != 0 || active[i]) {
+      active[i] = true;
+      if (node.parent != NO_NODE) {
+        active[node.parent] = true;
+      }
+    }
+  }
+
+  const auto root = out.size();
+  for (auto i = 0_sz; i < thread.nodes.size(); i++) {
+    if (!active[i]) {
+      continue;
+    }
+
+    auto& node = thread.nodes[i];
+    remap[i] = static_cast<u32>(out.size());
+    out.push_back({
+      .name = node.name,
+      .parent = node.parent == NO_NODE ? ProfileScopeStats::NO_PARENT : remap[node.parent],
+      .depth = node.depth,
+      .thread = thread.index,
+      .node = static_cast<u32>(i),
+      .calls = node.calls,
+      .total_ms = static_cast<f64>(node.total_ns) / 1'000'000.0,
+    });
+
+    if (node.depth == 1) {
+      out[root].total_ms += out.back().total_ms;
+    }
+
+    node.calls = 0;
+    node.total_ns = 0;
+  }
+}
+
+auto percentile(std::span<const f64> sorted, f64 p) -> f64 {
+  if (sorted.empty()) {
+    return 0.0;
+  }
+
+  const auto rank = static_cast<usize>(std::ceil(p * static_cast<f64>(sorted.size())));
+  return sorted[std::clamp(rank, 1_sz, sorted.size()) - 1];
+}
+
+auto write_file(const std::filesystem::path& path, std::string_view contents) -> std::expected<void, std::string> {
+  auto file = File(path, FileAccess::Write);
+  if (!file || file.write(contents) != contents.size()) {
+    return std::unexpected(fmt::format("Failed to write profile {}.", path));
+  }
+
+  return {};
+}
+} // namespace
+
+auto summarize_frame_times(std::vector<f64> frame_ms) -> FrameTimeSummary {
+  auto summary = FrameTimeSummary{.frames = frame_ms.size()};
+  if (frame_ms.empty()) {
+    return summary;
+  }
+
+  std::ranges::sort(frame_ms);
+  auto total = 0.0;
+  for (const auto ms : frame_ms) {
+    total += ms;
+  }
+
+  summary.mean_ms = total / static_cast<f64>(frame_ms.size());
+  summary.p50_ms = percentile(frame_ms, 0.50);
+  summary.p90_ms = percentile(frame_ms, 0.90);
+  summary.p95_ms = percentile(frame_ms, 0.95);
+  summary.p99_ms = percentile(frame_ms, 0.99);
+  summary.max_ms = frame_ms.back();
+  return summary;
+}
+
+auto FrameTimeHistogram::add(this FrameTimeHistogram& self, f64 frame_ms) -> void {
+  if (self.buckets.empty()) {
+    self.buckets.resize(BUCKET_COUNT, 0);
+  }
+
+  const auto bucket = std::min(static_cast<usize>(std::max(frame_ms, 0.0) / BUCKET_MS), BUCKET_COUNT - 1);
+  self.buckets[bucket] += 1;
+  self.frames += 1;
+  self.total_ms += frame_ms;
+  self.max_ms = std::max(self.max_ms, frame_ms);
+}
+
+auto FrameTimeHistogram::clear(this FrameTimeHistogram& self) -> void {
+  std::ranges::fill(self.buckets, 0);
+  self.frames = 0;
+  self.total_ms = 0.0;
+  self.max_ms = 0.0;
+}
+
+auto FrameTimeHistogram::summary(this const FrameTimeHistogram& self) -> FrameTimeSummary {
+  ZoneScoped;
+
+  auto summary = FrameTimeSummary{.frames = self.frames};
+  if (self.frames == 0) {
+    return summary;
+  }
+
+  summary.mean_ms = self.total_ms / static_cast<f64>(self.frames);
+  summary.max_ms = self.max_ms;
+
+  // Same nearest ranks as `summarize_frame_times`, all found in one walk. A bucket reports its upper
+  // edge, never more than the slowest frame.
+  const auto targets = std::array{
+    std::pair(0.50, &summary.p50_ms),
+    std::pair(0.90, &summary.p90_ms),
+    std::pair(0.95, &summary.p95_ms),
+    std::pair(0.99, &summary.p99_ms),
+  };
+  auto target = 0_sz;
+  auto seen = 0_sz;
+  for (auto i = 0_sz; i < self.buckets.size() && target < targets.size(); i++) {
+    seen += self.buckets[i];
+    while (target < targets.size()) {
+      const auto [p, out] = targets[target];
+      const auto rank = std::max(static_cast<usize>(std::ceil(p * static_cast<f64>(self.frames))), 1_sz);
+      if (seen < rank) {
+        break;
+      }
+
+      *out = std::min(static_cast<f64>(i + 1) * BUCKET_MS, self.max_ms);
+      target += 1;
+    }
+  }
+
+  return summary;
+}
+
+void FrameProfiler::set_enabled(bool enabled) { profiler.enabled.store(enabled, std::memory_order_relaxed); }
+
+bool FrameProfiler::is_enabled() { return profiler.enabled.load(std::memory_order_relaxed); }
+
+void FrameProfiler::begin_scope(const char* name) {
+  auto& thread = current_thread();
+  const auto start = now_ns();
+
+  auto lock = std::unique_lock(thread.mutex);
+  const auto node = find_or_add_child(thread, thread.current, name);
+  thread.open.push_back({.node = node, .start_ns = start});
+  thread.current = node;
+}
+
+void FrameProfiler::end_scope() {
+  const auto end = now_ns();
+  auto& thread = current_thread();
+
+  auto lock = std::unique_lock(thread.mutex);
+  if (thread.open.empty()) {
+    return;
+  }
+
+  const auto scope = thread.open.back();
+  thread.open.pop_back();
+
+  auto& node = thread.nodes[scope.node];
+  node.calls += 1;
+  node.total_ns += end - scope.start_ns;
+  thread.current = node.parent;
+}
+
+auto FrameProfiler::register_metric(std::string_view name, MetricKind kind) -> MetricID {
+  auto lock = std::unique_lock(profiler.metrics_mutex);
+  if (auto it = profiler.metric_ids.find(std::string(name)); it != profiler.metric_ids.end()) {
+    return it->second;
+  }
+
+  const auto index = profiler.metric_infos.size();
+  if (index >= MAX_METRICS) {
+    OX_LOG_ERROR("Too many metrics, {} is not recorded.", name);
+    return MetricID::Invalid;
+  }
+
+  const auto id = static_cast<MetricID>(index);
+  profiler.metric_infos.push_back({.name = std::string(name), .kind = kind});
+  profiler.metric_ids.emplace(std::string(name), id);
+  profiler.metric_values[index].store(0.0, std::memory_order_relaxed);
+  profiler.metric_kinds[index].store(static_cast<u8>(kind), std::memory_order_relaxed);
+  profiler.metric_count.store(static_cast<u32>(index + 1), std::memory_order_release);
+
+  return id;
+}
+
+void FrameProfiler::add(MetricID id, f64 value) {
+  if (id == MetricID::Invalid) {
+    return;
+  }
+
+  profiler.metric_values[std::to_underlying(id)].fetch_add(value, std::memory_order_relaxed);
+}
+
+void FrameProfiler::set(MetricID id, f64 value) {
+  if (id == MetricID::Invalid) {
+    return;
+  }
+
+  profiler.metric_values[std::to_underlying(id)].store(value, std::memory_order_relaxed);
+}
+
+auto FrameProfiler::metrics() -> std::vector<MetricInfo> {
+  auto lock = std::unique_lock(profiler.metrics_mutex);
+  return profiler.metric_infos;
+}
+
+void FrameProfiler::begin_frame() { profiler.frame_start_ns = now_ns(); }
+
+void FrameProfiler::end_frame(f64 delta_ms) {
+  ZoneScoped;
+
+  const auto end = now_ns();
+  auto& frame = profiler.history[profiler.frame_count % HISTORY_SIZE];
+  frame.index = profiler.frame_count++;
+  frame.cpu_ms = profiler.frame_start_ns != 0 ? static_cast<f64>(end - profiler.frame_start_ns) / 1'000'000.0 : 0.0;
+  frame.delta_ms = delta_ms;
+  profiler.frame_start_ns = end;
+  profiler.frame_times.add(frame.cpu_ms);
+
+  frame.scopes.clear();
+  {
+    auto lock = std::unique_lock(profiler.threads_mutex);
+    for (const auto& thread : profiler.threads) {
+      collect_thread(*thread, frame.scopes);
+    }
+
+    std::erase_if(profiler.threads, [](const auto& thread) { return thread->retired.load(std::memory_order_acquire); });
+  }
+
+  const auto metric_count = profiler.metric_count.load(std::memory_order_acquire);
+  frame.metrics.resize(metric_count);
+  profiler.metric_totals.resize(metric_count, 0.0);
+  for (auto i = 0_u32; i < metric_count; i++) {
+    const auto kind = static_cast<MetricKind>(profiler.metric_kinds[i].load(std::memory_order_relaxed));
+    if (kind == MetricKind::Counter) {
+      frame.metrics[i] = profiler.metric_values[i].exchange(0.0, std::memory_order_relaxed);
+      profiler.metric_totals[i] += frame.metrics[i];
+    } else {
+      frame.metrics[i] = profiler.metric_values[i].load(std::memory_order_relaxed);
+      profiler.metric_totals[i] = frame.metrics[i];
+    }
+  }
+}
+
+auto FrameProfiler::history() -> std::vector<const ProfileFrame*> {
+  const auto count = std::min<u64>(profiler.frame_count, HISTORY_SIZE);
+  auto frames = std::vector<const ProfileFrame*>();
+  frames.reserve(count);
+  for (auto i = profiler.frame_count - count; i < profiler.frame_count; i++) {
+    frames.push_back(&profiler.history[i % HISTORY_SIZE]);
+  }
+
+  return frames;
+}
+
+auto FrameProfiler::last_frame() -> const ProfileFrame* {
+  if (profiler.frame_count == 0) {
+    return nullptr;
+  }
+
+  return &profiler.history[(profiler.frame_count - 1) % HISTORY_SIZE];
+}
+
+auto FrameProfiler::thread_name(u32 thread) -> std::string {
+  auto lock = std::unique_lock(profiler.threads_mutex);
+  return thread < profiler.thread_names.size() ? profiler.thread_names[thread] : std::string();
+}
+
+auto FrameProfiler::summary() -> FrameTimeSummary { return profiler.frame_times.summary(); }
+
+void FrameProfiler::reset() {
+  for (auto& frame : profiler.history) {
+    frame = {};
+  }
+  profiler.frame_count = 0;
+  profiler.frame_start_ns = 0;
+  profiler.frame_times.clear();
+  profiler.metric_totals.clear();
+
+  const auto metric_count = profiler.metric_count.load(std::memory_order_acquire);
+  for (auto i = 0_u32; i < metric_count; i++) {
+    if (static_cast<MetricKind>(profiler.metric_kinds[i].load(std::memory_order_relaxed)) == MetricKind::Counter) {
+      profiler.metric_values[i].store(0.0, std::memory_order_relaxed);
+    }
+  }
+}
+
+auto FrameProfiler::export_json(const std::filesystem::path& path) -> std::expected<void, std::string> {
+  ZoneScoped;
+
+  const auto summary = FrameProfiler::summary();
+  const auto infos = metrics();
+  const auto frames = history();
+
+  auto writer = JsonWriter{};
+  writer.begin_obj();
+
+  writer["frame_ms"].begin_obj();
+  writer["frames"] = summary.frames;
+  writer["mean"] = summary.mean_ms;
+  writer["p50"] = summary.p50_ms;
+  writer["p90"] = summary.p90_ms;
+  writer["p95"] = summary.p95_ms;
+  writer["p99"] = summary.p99_ms;
+  writer["max"] = summary.max_ms;
+  writer.end_obj();
+
+  writer["metrics"].begin_obj();
+  for (auto i = 0_sz; i < infos.size() && i < profiler.metric_totals.size(); i++) {
+    writer[infos[i].name].begin_obj();
+    writer["kind"] = infos[i].kind == MetricKind::Counter ? "counter" : "gauge";
+    // Counters over the whole run, gauges at the end of it.
+    writer["value"] = profiler.metric_totals[i];
+    writer.end_obj();
+  }
+  writer.end_obj();
+
+  // Scopes over the frames in the history, same thread and node is the same scope.
+  struct ScopeTotals {
+    const ProfileScopeStats* first = nullptr;
+    u64 calls = 0;
+    f64 total_ms = 0.0;
+    f64 max_ms = 0.0;
+  };
+  auto scope_totals = ankerl::unordered_dense::map<u64, ScopeTotals>{};
+  auto scope_order = std::vector<u64>{};
+  for (const auto* frame : frames) {
+    for (const auto& scope : frame->scopes) {
+      const auto key = (static_cast<u64>(scope.thread) << 32) | scope.node;
+      auto [it, inserted] = scope_totals.try_emplace(key, ScopeTotals{.first = &scope});
+      if (inserted) {
+        scope_order.push_back(key);
+      }
+      it->second.calls += scope.calls;
+      it->second.total_ms += scope.total_ms;
+      it->second.max_ms = std::max(it->second.max_ms, scope.total_ms);
+    }
+  }
+
+  const auto frame_count = static_cast<f64>(std::max(frames.size(), 1_sz));
+  writer["scopes"].begin_array();
+  for (const auto key : scope_order) {
+    const auto& totals = scope_totals[key];
+    writer.begin_obj();
+    writer["name"] = std::string_view(totals.first->name);
+    writer["thread"] = std::string_view(thread_name(totals.first->thread));
+    writer["depth"] = totals.first->depth;
+    writer["mean_ms"] = totals.total_ms / frame_count;
+    writer["max_ms"] = totals.max_ms;
+    writer["calls_per_frame"] = static_cast<f64>(totals.calls) / frame_count;
+    writer.end_obj();
+  }
+  writer.end_array();
+
+  writer["history"].begin_array();
+  for (const auto* frame : frames) {
+    writer.begin_obj();
+    writer["frame"] = frame->index;
+    writer["cpu_ms"] = frame->cpu_ms;
+    writer["delta_ms"] = frame->delta_ms;
+    for (auto i = 0_sz; i < frame->metrics.size() && i < infos.size(); i++) {
+      writer[infos[i].name] = frame->metrics[i];
+    }
+    writer.end_obj();
+  }
+  writer.end_array();
+
+  writer.end_obj();
+
+  return write_file(path, writer.stream.view());
+}
+
+auto FrameProfiler::export_csv(const std::filesystem::path& path) -> std::expected<void, std::string> {
+  ZoneScoped;
+
+  const auto infos = metrics();
+  auto csv = std::string("frame,cpu_ms,delta_ms");
+  for (const auto& info : infos) {
+    csv += fmt::format(",{}", info.name);
+  }
+  csv += '\n';
+
+  for (const auto* frame : history()) {
+    csv += fmt::format("{},{:.4f},{:.4f}", frame->index, frame->cpu_ms, frame->delta_ms);
+    for (auto i = 0_sz; i < infos.size(); i++) {
+      // Metrics registered after this frame have no value in it.
+      csv += i < frame->metrics.size() ? fmt::format(",{}", frame->metrics[i]) : std::string(",");
+    }
+    csv += '\n';
+  }
+
+  return write_file(path, csv);
+}
+
+auto FrameProfiler::export_to(const std::filesystem::path& path) -> std::expected<void, std::string> {
+  if (path.extension() == ".csv") {
+    return export_csv(path);
+  }
+
+  return export_json(path);
+}
+} // namespace ox
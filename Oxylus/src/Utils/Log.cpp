@@ -1,8 +1,217 @@
 #include "Utils/Log.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
 #include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Memory/LockFreeQueue.hpp"
+#include "OS/OS.hpp"
 
 namespace ox {
+namespace {
+// Per thread, a full ring makes the logging thread wait for the log thread instead of dropping.
+constexpr auto RING_CAPACITY = 1024_sz;
+constexpr auto FLUSH_INTERVAL = std::chrono::milliseconds(5);
+
+struct ThreadRing {
+  SPSCQueue<LogRecord, RING_CAPACITY> queue = {};
+  std::array<char, 32> thread_name = {};
+  // Its thread exited, goes away once drained.
+  std::atomic<bool> retired = false;
+  bool drained = false;
+};
+
+struct Backend {
+  std::mutex rings_mutex = {};
+  std::vector<std::shared_ptr<ThreadRing>> rings = {};
+  // Bumped every start, threads holding a ring of an older one register again.
+  std::atomic<u64> generation = 0;
+  std::atomic<bool> running = false;
+  std::thread thread = {};
+  std::atomic<std::thread::id> thread_id = {};
+
+  std::mutex wake_mutex = {};
+  std::condition_variable wake = {};
+  std::condition_variable flushed = {};
+  bool wake_requested = false;
+  u64 flush_requested = 0;
+  u64 flush_done = 0;
+
+  // Log thread only.
+  std::vector<std::pair<const ThreadRing*, LogRecord>> batch = {};
+  fmt::memory_buffer message;
+
+  ~Backend() { Log::stop_backend(); }
+};
+
+Backend backend;
+std::atomic<u32> rate_limit_messages = 100;
+std::atomic<u64> rate_limit_window_ns = 1'000'000'000;
+
+struct ThreadRingRef {
+  std::shared_ptr<ThreadRing> ring = nullptr;
+  u64 generation = 0;
+
+  ~ThreadRingRef() {
+    if (ring) {
+      ring->retired.store(true, std::memory_order_release);
+    }
+  }
+};
+
+thread_local ThreadRingRef thread_ring = {};
+
+auto to_verbosity(LogLevel level) -> loguru::Verbosity {
+  switch (level) {
+    case LogLevel::Debug:
+    case LogLevel::Trace: return loguru::Verbosity_MAX;
+    case LogLevel::Info : return loguru::Verbosity_INFO;
+    case LogLevel::Warn : return loguru::Verbosity_WARNING;
+    case LogLevel::Error: return loguru::Verbosity_ERROR;
+  }
+
+  return loguru::Verbosity_INFO;
+}
+
+auto now_ns() -> u64 {
+  return static_cast<u64>(
+    std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count()
+  );
+}
+
+auto current_ring() -> ThreadRing* {
+  if (!backend.running.load(std::memory_order_acquire)) {
+    return nullptr;
+  }
+
+  const auto generation = backend.generation.load(std::memory_order_acquire);
+  if (thread_ring.ring && thread_ring.generation == generation) {
+    return thread_ring.ring.get();
+  }
+
+  // The log thread would end up waiting on itself with a full ring.
+  if (std::this_thread::get_id() == backend.thread_id.load(std::memory_order_relaxed)) {
+    return nullptr;
+  }
+
+  auto ring = std::make_shared<ThreadRing>();
+  loguru::get_thread_name(ring->thread_name.data(), ring->thread_name.size(), false);
+  {
+    auto lock = std::unique_lock(backend.rings_mutex);
+    backend.rings.push_back(ring);
+  }
+
+  if (thread_ring.ring) {
+    thread_ring.ring->retired.store(true, std::memory_order_release);
+  }
+  thread_ring.ring = std::move(ring);
+  thread_ring.generation = generation;
+
+  return thread_ring.ring.get();
+}
+
+auto write_message(const LogSite& site, u32 suppressed, fmt::memory_buffer& message) -> void {
+  if (suppressed != 0) {
+    fmt::format_to(fmt::appender(message), " ({} more from here were rate limited)", suppressed);
+  }
+
+  loguru::log(to_verbosity(site.level), site.file, site.line, "{}", std::string_view(message.data(), message.size()));
+}
+
+auto drain() -> void {
+  ZoneScoped;
+
+  auto lock = std::unique_lock(backend.rings_mutex);
+  backend.batch.clear();
+  auto retired_rings = 0_sz;
+  for (auto& ring : backend.rings) {
+    // Checked first, a ring retired by now can't get anything past what's drained below.
+    const auto retired = ring->retired.load(std::memory_order_acquire);
+    auto record = LogRecord{};
+    while (ring->queue.try_pop(record)) {
+      backend.batch.emplace_back(ring.get(), std::move(record));
+    }
+
+    if (retired) {
+      ring->drained = true;
+      retired_rings += 1;
+    }
+  }
+
+  // Rings are drained one after another, put the threads' messages back in the order they were logged.
+  std::ranges::stable_sort(backend.batch, {}, [](const auto& entry) { return entry.second.time_ns; });
+
+  for (const auto& [ring, record] : backend.batch) {
+    auto& message = backend.message;
+    message.clear();
+    fmt::format_to(fmt::appender(message), "[{}] ", ring->thread_name.data());
+    const auto prefix_size = message.size();
+    if (record.format_fn) {
+      try {
+        record.format_fn(record, message);
+      } catch (const fmt::format_error& error) {
+        message.resize(prefix_size);
+        fmt::format_to(fmt::appender(message), "Failed to format \"{}\": {}", record.format, error.what());
+      }
+    } else {
+      message.append(record.text);
+    }
+
+    write_message(*record.site, record.suppressed, message);
+  }
+  backend.batch.clear();
+
+  if (retired_rings != 0) {
+    std::erase_if(backend.rings, [](const auto& ring) { return ring->drained; });
+  }
+}
+
+auto run_backend() -> void {
+  backend.thread_id.store(std::this_thread::get_id(), std::memory_order_relaxed);
+  os::set_thread_name("Log");
+  loguru::set_thread_name("Log");
+
+  while (true) {
+    auto flush_target = 0_u64;
+    {
+      auto lock = std::unique_lock(backend.wake_mutex);
+      backend.wake.wait_for(lock, FLUSH_INTERVAL, [] {
+        return backend.wake_requested || !backend.running.load(std::memory_order_acquire);
+      });
+      backend.wake_requested = false;
+      flush_target = backend.flush_requested;
+    }
+
+    const auto stopping = !backend.running.load(std::memory_order_acquire);
+    drain();
+    loguru::flush();
+
+    {
+      auto lock = std::unique_lock(backend.wake_mutex);
+      backend.flush_done = flush_target;
+    }
+    backend.flushed.notify_all();
+
+    if (stopping) {
+      break;
+    }
+  }
+}
+
+auto wake_backend() -> void {
+  {
+    auto lock = std::unique_lock(backend.wake_mutex);
+    backend.wake_requested = true;
+  }
+  backend.wake.notify_one();
+}
+} // namespace
+
 void Log::init(int argc, char** argv) {
   ZoneScoped;
   if (!std::filesystem::exists("logs"))
@@ -11,6 +220,8 @@ void Log::init(int argc, char** argv) {
   loguru::g_stderr_verbosity = loguru::Verbosity_INFO;
 
   loguru::g_preamble_date = false;
+  // Everything is written from the log thread, messages carry their own thread's name instead.
+  loguru::g_preamble_thread = false;
 
   loguru::init(argc, argv, {.verbosity_flag = nullptr});
 
@@ -19,8 +230,66 @@ void Log::init(int argc, char** argv) {
 
   // Only log INFO, WARNING, ERROR and FATAL to "latest_readable.log":
   loguru::add_file("logs/latest.log", loguru::Truncate, loguru::Verbosity_INFO);
+
+  // Failed checks abort right after, get out what's still queued first.
+  loguru::set_fatal_handler([](const loguru::Message&) { Log::flush(); });
+
+  start_backend();
+}
+
+void Log::shutdown() {
+  stop_backend();
+  loguru::shutdown();
+}
+
+void Log::start_backend() {
+  ZoneScoped;
+
+  if (backend.running.load(std::memory_order_acquire)) {
+    return;
+  }
+
+  backend.generation.fetch_add(1, std::memory_order_release);
+  backend.running.store(true, std::memory_order_release);
+  backend.thread = std::thread(run_backend);
+}
+
+void Log::stop_backend() {
+  ZoneScoped;
+
+  if (!backend.running.exchange(false, std::memory_order_acq_rel)) {
+    return;
+  }
+
+  wake_backend();
+  backend.thread.join();
+  backend.thread_id.store({}, std::memory_order_relaxed);
+
+  auto lock = std::unique_lock(backend.rings_mutex);
+  backend.rings.clear();
+}
+
+bool Log::is_async() { return backend.running.load(std::memory_order_acquire); }
+
+void Log::flush() {
+  if (!backend.running.load(std::memory_order_acquire) ||
+      std::this_thread::get_id() == backend.thread_id.load(std::memory_order_relaxed)) {
+    return;
+  }
+
+  auto lock = std::unique_lock(backend.wake_mutex);
+  const auto target = ++backend.flush_requested;
+  backend.wake_requested = true;
+  backend.wake.notify_one();
+  backend.flushed.wait(lock, [target] {
+    return backend.flush_done >= target || !backend.running.load(std::memory_order_acquire);
+  });
+}
+
+void Log::set_rate_limit(u32 max_messages, u32 window_ms) {
+  rate_limit_messages.store(max_messages, std::memory_order_relaxed);
+  rate_limit_window_ns.store(static_cast<u64>(window_ms) * 1'000'000, std::memory_order_relaxed);
 }
-void Log::shutdown() { loguru::shutdown(); }
 
 void Log::add_callback(
   const char* id,
@@ -36,4 +305,66 @@ void Log::add_callback(
 void Log::remove_callback(const char* id) { loguru::remove_callback(id); }
 
 void Log::set_verbose() { loguru::g_stderr_verbosity = loguru::Verbosity_MAX; }
+
+auto Log::admit(LogSite& site) -> option<Stamp> {
+  if (to_verbosity(site.level) > loguru::current_verbosity_cutoff()) {
+    return nullopt;
+  }
+
+  auto stamp = Stamp{.time_ns = now_ns()};
+  const auto limit = rate_limit_messages.load(std::memory_order_relaxed);
+  if (limit == 0) {
+    return stamp;
+  }
+
+  // Racy on purpose, a few messages more or less around a window switch don't matter.
+  auto window_start = site.window_start_ns.load(std::memory_order_relaxed);
+  if (stamp.time_ns - window_start >= rate_limit_window_ns.load(std::memory_order_relaxed) &&
+      site.window_start_ns.compare_exchange_strong(window_start, stamp.time_ns, std::memory_order_relaxed)) {
+    site.window_count.store(0, std::memory_order_relaxed);
+  }
+
+  if (site.window_count.fetch_add(1, std::memory_order_relaxed) >= limit) {
+    site.suppressed.fetch_add(1, std::memory_order_relaxed);
+    return nullopt;
+  }
+
+  if (site.suppressed.load(std::memory_order_relaxed) != 0) {
+    stamp.suppressed = site.suppressed.exchange(0, std::memory_order_relaxed);
+  }
+
+  return stamp;
+}
+
+auto Log::begin_record() -> LogRecord* {
+  auto* ring = current_ring();
+  if (!ring) {
+    return nullptr;
+  }
+
+  auto* record = ring->queue.try_reserve();
+  while (!record) {
+    ZoneScopedN("Log ring full");
+    if (!backend.running.load(std::memory_order_acquire)) {
+      return nullptr;
+    }
+
+    wake_backend();
+    std::this_thread::yield();
+    record = ring->queue.try_reserve();
+  }
+
+  return record;
+}
+
+void Log::end_record() { thread_ring.ring->queue.commit(); }
+
+void Log::write_now(const LogSite& site, u32 suppressed, std::string_view message) {
+  auto thread_name = std::array<char, 32>{};
+  loguru::get_thread_name(thread_name.data(), thread_name.size(), false);
+
+  auto buffer = fmt::memory_buffer{};
+  fmt::format_to(fmt::appender(buffer), "[{}] {}", thread_name.data(), message);
+  write_message(site, suppressed, buffer);
+}
 } // namespace ox
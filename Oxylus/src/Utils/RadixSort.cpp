@@ -0,0 +1,169 @@
+#include "Utils/RadixSort.hpp"
+
+#include <algorithm>
+#include <array>
+#include <tracy/Tracy.hpp>
+#include <vector>
+
+#include "Core/JobManager.hpp"
+#include "Utils/Log.hpp"
+
+namespace ox {
+namespace {
+constexpr auto RADIX_BITS = 8_u32;
+constexpr auto RADIX = 1_u32 << RADIX_BITS;
+constexpr auto PASSES = 32_u32 / RADIX_BITS;
+// Below this a chunk isn't worth a job.
+constexpr auto MIN_CHUNK_SIZE = 1_sz << 14;
+
+using Histogram = std::array<u32, RADIX>;
+
+auto digit(u32 key, u32 pass) -> u32 { return (key >> (pass * RADIX_BITS)) & (RADIX - 1); }
+
+struct Buffers {
+  u32* keys = nullptr;
+  u32* values = nullptr;
+};
+
+// `fn(chunk)` for every chunk, the first one on the calling thread.
+template <typename Fn>
+auto run_chunks(JobManager& job_manager, usize chunk_count, const Fn& fn) -> void {
+  auto barrier = Barrier::create();
+  barrier->acquire(static_cast<u32>(chunk_count - 1));
+  for (auto chunk = 1_sz; chunk < chunk_count; chunk++) {
+    job_manager.submit(Job::create([&fn, chunk] { fn(chunk); })->signal(barrier));
+  }
+
+  fn(0);
+  barrier->wait();
+}
+
+// Every pass's histogram comes from one read of the keys, the order a pass leaves behind doesn't change counts.
+auto sort_serial(usize count, Buffers src, Buffers dst) -> Buffers {
+  ZoneScoped;
+
+  auto histograms = std::array<Histogram, PASSES>{};
+  for (auto i = 0_sz; i < count; i++) {
+    for (auto pass = 0_u32; pass < PASSES; pass++) {
+      histograms[pass][digit(src.keys[i], pass)] += 1;
+    }
+  }
+
+  for (auto pass = 0_u32; pass < PASSES; pass++) {
+    auto& offsets = histograms[pass];
+    if (offsets[digit(src.keys[0], pass)] == count) {
+      continue;
+    }
+
+    auto sum = 0_u32;
+    for (auto& offset : offsets) {
+      const auto bucket = offset;
+      offset = sum;
+      sum += bucket;
+    }
+
+    for (auto i = 0_sz; i < count; i++) {
+      const auto key = src.keys[i];
+      const auto position = offsets[digit(key, pass)]++;
+      dst.keys[position] = key;
+      dst.values[position] = src.values[i];
+    }
+
+    std::swap(src, dst);
+  }
+
+  return src;
+}
+
+auto sort_parallel(JobManager& job_manager, usize count, usize chunk_count, Buffers src, Buffers dst) -> Buffers {
+  ZoneScoped;
+
+  const auto chunk_size = (count + chunk_count - 1) / chunk_count;
+  const auto chunk_range = [&](usize chunk) {
+    const auto begin = chunk * chunk_size;
+    return std::pair(begin, std::min(begin + chunk_size, count));
+  };
+
+  auto histograms = std::vector<Histogram>(chunk_count);
+  for (auto pass = 0_u32; pass < PASSES; pass++) {
+    run_chunks(job_manager, chunk_count, [&](usize chunk) {
+      ZoneScopedN("RadixHistogram");
+      auto& histogram = histograms[chunk];
+      histogram.fill(0);
+      const auto [begin, end] = chunk_range(chunk);
+      for (auto i = begin; i < end; i++) {
+        histogram[digit(src.keys[i], pass)] += 1;
+      }
+    });
+
+    const auto first_digit = digit(src.keys[0], pass);
+    auto first_digit_count = 0_sz;
+    for (const auto& histogram : histograms) {
+      first_digit_count += histogram[first_digit];
+    }
+    if (first_digit_count == count) {
+      continue;
+    }
+
+    // Digit major, chunk minor, a chunk writes each bucket right after the chunks before it.
+    auto sum = 0_u32;
+    for (auto d = 0_u32; d < RADIX; d++) {
+      for (auto& histogram : histograms) {
+        const auto bucket = histogram[d];
+        histogram[d] = sum;
+        sum += bucket;
+      }
+    }
+
+    run_chunks(job_manager, chunk_count, [&](usize chunk) {
+      ZoneScopedN("RadixScatter");
+      auto& offsets = histograms[chunk];
+      const auto [begin, end] = chunk_range(chunk);
+      for (auto i = begin; i < end; i++) {
+        const auto key = src.keys[i];
+        const auto position = offsets[digit(key, pass)]++;
+        dst.keys[position] = key;
+        dst.values[position] = src.values[i];
+      }
+    });
+
+    std::swap(src, dst);
+  }
+
+  return src;
+}
+} // namespace
+
+auto radix_sort_pairs(
+  std::span<u32> keys,
+  std::span<u32> values,
+  std::span<u32> scratch_keys,
+  std::span<u32> scratch_values,
+  JobManager* job_manager
+) -> void {
+  ZoneScoped;
+
+  const auto count = keys.size();
+  OX_CHECK_EQ(values.size(), count);
+  OX_CHECK_GE(scratch_keys.size(), count);
+  OX_CHECK_GE(scratch_values.size(), count);
+  if (count < 2) {
+    return;
+  }
+
+  const auto src = Buffers{.keys = keys.data(), .values = values.data()};
+  const auto dst = Buffers{.keys = scratch_keys.data(), .values = scratch_values.data()};
+
+  auto chunk_count = 1_sz;
+  if (job_manager && count >= RADIX_SORT_PARALLEL_MIN) {
+    chunk_count = std::min<usize>(job_manager->get_thread_count() + 1, count / MIN_CHUNK_SIZE);
+  }
+
+  const auto sorted = chunk_count > 1 ? sort_parallel(*job_manager, count, chunk_count, src, dst)
+                                      : sort_serial(count, src, dst);
+  if (sorted.keys != keys.data()) {
+    std::copy_n(sorted.keys, count, keys.data());
+    std::copy_n(sorted.values, count, values.data());
+  }
+}
+} // namespace ox
@@ -9,9 +9,25 @@ Timestep::Timestep() : timestep(0.0), last_time(0.0), elapsed(0.0) { timer = new
 
 Timestep::~Timestep() { delete timer; }
 
+auto Timestep::set_fixed_step(this Timestep& self, f64 value) -> void {
+  self.fixed_step = value;
+  self.next_deadline = 0.0;
+}
+
 void Timestep::on_update(this Timestep& self) {
   ZoneScoped;
 
+  if (self.simulated_step > 0.0) {
+    self.timestep = self.simulated_step;
+    self.elapsed += self.timestep;
+    return;
+  }
+
+  if (self.fixed_step > 0.0) {
+    self.update_fixed();
+    return;
+  }
+
   f64 current_time = self.timer->get_elapsed_msd();
   if (self.last_time == 0.0f) {
     self.last_time = current_time;
@@ -39,4 +55,35 @@ void Timestep::on_update(this Timestep& self) {
   self.last_time = current_time;
   self.elapsed += self.timestep;
 }
+
+auto Timestep::update_fixed(this Timestep& self) -> void {
+  ZoneScoped;
+
+  // Further behind than this and the ticks are dropped, catching up on all of them would only make
+  // every one after it late too.
+  constexpr f64 max_catch_up_steps = 8.0;
+
+  f64 current_time = self.timer->get_elapsed_msd();
+  if (self.next_deadline == 0.0) {
+    self.next_deadline = current_time;
+  } else {
+    self.next_deadline += self.fixed_step;
+  }
+
+  if (current_time - self.next_deadline > self.fixed_step * max_catch_up_steps) {
+    self.next_deadline = current_time;
+  }
+
+  {
+    ZoneNamedN(z, "Sleep TimeStep to fixed step", true);
+    while (current_time < self.next_deadline) {
+      std::this_thread::sleep_for(std::chrono::duration<f64, std::milli>(self.next_deadline - current_time));
+      current_time = self.timer->get_elapsed_msd();
+    }
+  }
+
+  self.timestep = self.fixed_step;
+  self.last_time = current_time;
+  self.elapsed += self.timestep;
+}
 } // namespace ox
@@ -148,3 +148,66 @@ TEST_F(EventSystemTest, ConcurrentSubscribeEmitUnsubscribe) {
 
   EXPECT_GT(total_received.load(), 0);
 }
+
+namespace {
+struct EventA {
+  int value;
+};
+struct EventB {
+  int value;
+};
+} // namespace
+
+static_assert(ox::event_type_id<EventA> != ox::event_type_id<EventB>);
+static_assert(ox::event_type_id<EventA> == ox::event_type_id<EventA>);
+
+TEST_F(EventSystemTest, UnsubscribeFromInsideHandler) {
+  struct TestEvent {
+    int value;
+  };
+
+  auto calls = 0;
+  auto self_id = ox::HandlerId{};
+  auto sub = event_system->subscribe<TestEvent>([&](const TestEvent&) {
+    calls += 1;
+    EXPECT_TRUE(event_system->unsubscribe<TestEvent>(self_id).has_value());
+  });
+  ASSERT_TRUE(sub.has_value());
+  self_id = sub.value();
+
+  EXPECT_TRUE(event_system->emit(TestEvent{1}).has_value());
+  EXPECT_EQ(event_system->handler_count<TestEvent>(), 0);
+
+  auto second = event_system->emit(TestEvent{2});
+  EXPECT_FALSE(second.has_value());
+  EXPECT_EQ(calls, 1);
+}
+
+TEST_F(EventSystemTest, QueuedEventsWaitForDispatch) {
+  struct TestEvent {
+    int value;
+  };
+
+  auto received = std::vector<int>{};
+  auto sub = event_system->subscribe<TestEvent>([&](const TestEvent& e) {
+    received.push_back(e.value);
+    if (e.value == 2) {
+      std::ignore = event_system->enqueue(TestEvent{3});
+    }
+  });
+  ASSERT_TRUE(sub.has_value());
+
+  EXPECT_TRUE(event_system->enqueue(TestEvent{1}).has_value());
+  EXPECT_TRUE(event_system->enqueue(TestEvent{2}).has_value());
+  EXPECT_TRUE(received.empty());
+
+  event_system->dispatch_queued();
+  EXPECT_THAT(received, ::testing::ElementsAre(1, 2));
+
+  // Queued by the handler while dispatching, goes out next frame.
+  event_system->dispatch_queued();
+  EXPECT_THAT(received, ::testing::ElementsAre(1, 2, 3));
+
+  event_system->dispatch_queued();
+  EXPECT_EQ(received.size(), 3);
+}
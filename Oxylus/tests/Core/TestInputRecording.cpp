@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+
+#include "Core/Input.hpp"
+#include "Core/InputRecording.hpp"
+
+namespace {
+auto make_recording() -> ox::InputRecording {
+  auto input = ox::Input{};
+  input.start_recording();
+
+  input.push_event({.type = ox::InputEventType::Key, .down = true, .code = static_cast<u32>(ox::ScanCode::W)});
+  input.push_event({.type = ox::InputEventType::MouseMotion, .value = {10.0f, 20.0f}, .relative = {1.0f, -2.0f}});
+  input.end_recorded_frame(16.6);
+
+  input.end_recorded_frame(16.6);
+
+  input.push_event({.type = ox::InputEventType::Key, .down = false, .code = static_cast<u32>(ox::ScanCode::W)});
+  input.push_event({
+    .type = ox::InputEventType::GamepadAxis,
+    .code = static_cast<u32>(ox::GamepadAxisCode::AxisLeftX),
+    .instance_id = 7,
+    .value = {0.5f, 0.0f},
+  });
+  input.end_recorded_frame(33.3);
+
+  // Never got a frame, dropped.
+  input.push_event({.type = ox::InputEventType::MouseScroll, .value = {0.0f, 1.0f}});
+
+  return input.stop_recording();
+}
+} // namespace
+
+TEST(InputRecordingTest, RecordsFramesAndEvents) {
+  const auto recording = make_recording();
+
+  ASSERT_EQ(recording.frames.size(), 3_sz);
+  EXPECT_EQ(recording.frames[0].event_count, 2_u32);
+  EXPECT_EQ(recording.frames[1].event_count, 0_u32);
+  EXPECT_EQ(recording.frames[2].event_count, 2_u32);
+  EXPECT_DOUBLE_EQ(recording.frames[2].delta_ms, 33.3);
+  EXPECT_EQ(recording.events.size(), 4_sz);
+}
+
+TEST(InputRecordingTest, EncodeDecodeRoundTrip) {
+  const auto recording = make_recording();
+  const auto bytes = recording.encode();
+
+  auto decoded = ox::InputRecording::decode(bytes);
+  ASSERT_TRUE(decoded.has_value()) << decoded.error();
+  EXPECT_EQ(decoded->frames, recording.frames);
+  EXPECT_EQ(decoded->events, recording.events);
+}
+
+TEST(InputRecordingTest, DecodeRejectsBadData) {
+  const auto bytes = make_recording().encode();
+
+  EXPECT_FALSE(ox::InputRecording::decode(std::span(bytes).first(bytes.size() - 3)).has_value());
+
+  auto wrong_magic = bytes;
+  wrong_magic[0] ^= 0xff;
+  EXPECT_FALSE(ox::InputRecording::decode(wrong_magic).has_value());
+
+  EXPECT_FALSE(ox::InputRecording::decode({}).has_value());
+}
+
+TEST(InputRecordingTest, ReplayReproducesInputState) {
+  auto replay = ox::InputReplay{.recording = make_recording()};
+  auto input = ox::Input{};
+  input.set_replaying(true);
+
+  ASSERT_FALSE(replay.done());
+  EXPECT_DOUBLE_EQ(replay.next_delta_ms(), 16.6);
+  input.replay_frame(replay.advance());
+  EXPECT_TRUE(input.get_key_pressed(ox::ScanCode::W));
+  EXPECT_TRUE(input.get_key_held(ox::ScanCode::W));
+  EXPECT_EQ(input.get_mouse_position(), glm::vec2(10.0f, 20.0f));
+
+  // Live events don't get through while replaying.
+  input.push_event({.type = ox::InputEventType::Key, .down = false, .code = static_cast<u32>(ox::ScanCode::W)});
+  EXPECT_TRUE(input.get_key_held(ox::ScanCode::W));
+
+  input.reset_pressed();
+  input.replay_frame(replay.advance());
+  EXPECT_FALSE(input.get_key_pressed(ox::ScanCode::W));
+  EXPECT_TRUE(input.get_key_held(ox::ScanCode::W));
+
+  input.reset_pressed();
+  input.replay_frame(replay.advance());
+  EXPECT_TRUE(input.get_key_released(ox::ScanCode::W));
+  EXPECT_FALSE(input.get_key_held(ox::ScanCode::W));
+  EXPECT_FLOAT_EQ(input.get_gamepad_axis(7, ox::GamepadAxisCode::AxisLeftX), 0.5f);
+
+  EXPECT_TRUE(replay.done());
+}
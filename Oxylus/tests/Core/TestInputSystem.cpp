@@ -180,6 +180,41 @@ TEST_F(InputManagerTest, KeyboardTestHeld) {
   EXPECT_TRUE(held_callback_mod);
 }
 
+TEST_F(InputManagerTest, ActionHandles) {
+  app->step();
+
+  auto& input = app->mod<ox::Input>();
+
+  // Resolving before binding is fine, the handle starts answering once the action is bound.
+  const auto jump = input.resolve_action("handle_jump");
+  EXPECT_NE(jump, ox::ActionID::Invalid);
+  EXPECT_EQ(input.resolve_action("handle_jump"), jump);
+  EXPECT_EQ(input.find_action("handle_missing"), ox::ActionID::Invalid);
+
+  std::ignore = input.bind_action(
+    ox::ActionBinding{.action_id = "handle_jump", .primary_inputs = {ox::InputCode(ox::ScanCode::Space)}}
+  );
+  EXPECT_EQ(input.find_action("handle_jump"), jump);
+
+  v_keyboard->press(ox::ScanCode::Space);
+  app->get_window().update(app->get_timestep());
+
+  EXPECT_TRUE(input.get_action_pressed(jump));
+  EXPECT_TRUE(input.get_action_held(jump));
+  EXPECT_TRUE(input.get_action_pressed("handle_jump"));
+  EXPECT_FALSE(input.get_action_pressed(ox::ActionID::Invalid));
+
+  // Bound in another context only.
+  input.push_context("menu");
+  EXPECT_FALSE(input.get_action_held(jump));
+  input.pop_context();
+  EXPECT_TRUE(input.get_action_held(jump));
+
+  input.reset_pressed();
+  EXPECT_FALSE(input.get_action_pressed(jump));
+  EXPECT_TRUE(input.get_action_held(jump));
+}
+
 TEST_F(InputManagerTest, MouseTestPressed) {
   bool pressed = false;
   bool pressed_callback = false;
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "Memory/LockFreeQueue.hpp"
+
+TEST(LockFreeQueueTest, SPSCKeepsOrderAndRejectsWhenFull) {
+  auto queue = std::make_unique<ox::SPSCQueue<u32, 4>>();
+  for (auto i = 0_u32; i < 4; i++) {
+    EXPECT_TRUE(queue->try_push(i));
+  }
+  EXPECT_FALSE(queue->try_push(4));
+  EXPECT_EQ(queue->size(), 4);
+  EXPECT_EQ(queue->free_space(), 0);
+
+  auto value = 0_u32;
+  for (auto i = 0_u32; i < 4; i++) {
+    ASSERT_TRUE(queue->try_pop(value));
+    EXPECT_EQ(value, i);
+  }
+  EXPECT_FALSE(queue->try_pop(value));
+  EXPECT_TRUE(queue->try_push(5));
+}
+
+TEST(LockFreeQueueTest, SPSCAcrossThreads) {
+  constexpr auto COUNT = 100'000_u32;
+  auto queue = std::make_unique<ox::SPSCQueue<u32, 256>>();
+
+  auto producer = std::jthread([&] {
+    for (auto i = 0_u32; i < COUNT; i++) {
+      while (!queue->try_push(i)) {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  auto expected = 0_u32;
+  auto value = 0_u32;
+  while (expected < COUNT) {
+    if (queue->try_pop(value)) {
+      ASSERT_EQ(value, expected);
+      expected += 1;
+    }
+  }
+}
+
+TEST(LockFreeQueueTest, MPSCReceivesEveryItemOnce) {
+  constexpr auto PRODUCERS = 4_u32;
+  constexpr auto PER_PRODUCER = 25'000_u32;
+  auto queue = std::make_unique<ox::MPSCQueue<u32, 1024>>();
+
+  auto producers = std::vector<std::jthread>{};
+  for (auto producer = 0_u32; producer < PRODUCERS; producer++) {
+    producers.emplace_back([&, producer] {
+      for (auto i = 0_u32; i < PER_PRODUCER; i++) {
+        while (!queue->try_push(producer * PER_PRODUCER + i)) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+
+  // Items of one producer have to come out in the order it pushed them.
+  auto seen = std::vector<bool>(PRODUCERS * PER_PRODUCER, false);
+  auto last = std::vector<i64>(PRODUCERS, -1);
+  auto received = 0_u32;
+  auto value = 0_u32;
+  while (received < PRODUCERS * PER_PRODUCER) {
+    if (!queue->try_pop(value)) {
+      continue;
+    }
+
+    ASSERT_FALSE(seen[value]);
+    seen[value] = true;
+    const auto producer = value / PER_PRODUCER;
+    EXPECT_GT(static_cast<i64>(value), last[producer]);
+    last[producer] = value;
+    received += 1;
+  }
+
+  EXPECT_FALSE(queue->try_pop(value));
+  EXPECT_EQ(queue->size_approx(), 0);
+}
+
+TEST(LockFreeQueueTest, MPSCRejectsWhenFull) {
+  auto queue = ox::MPSCQueue<u32, 2>{};
+  EXPECT_TRUE(queue.try_push(1));
+  EXPECT_TRUE(queue.try_push(2));
+  EXPECT_FALSE(queue.try_push(3));
+
+  auto value = 0_u32;
+  ASSERT_TRUE(queue.try_pop(value));
+  EXPECT_EQ(value, 1_u32);
+  EXPECT_TRUE(queue.try_push(3));
+}
@@ -45,7 +45,7 @@ protected:
 };
 
 TEST_F(NetPacketTest, HandshakeRoundTrip) {
-  auto sent = ox::NetPacket::handshake({.version = 7, .net_id = 0xdeadbeefcafe_u64});
+  auto sent = ox::NetPacket::handshake({.version = 7, .net_id = 0xdeadbeefcafe_u64, .tick_interval_ms = 50.0});
   ASSERT_TRUE(sent.has_value());
   OX_DEFER(&) { sent->destroy(); };
 
@@ -59,6 +59,7 @@ TEST_F(NetPacketTest, HandshakeRoundTrip) {
   ASSERT_TRUE(info.has_value());
   EXPECT_EQ(info->version, 7_u32);
   EXPECT_EQ(info->net_id, 0xdeadbeefcafe_u64);
+  EXPECT_EQ(info->tick_interval_ms, 50.0);
 }
 
 TEST_F(NetPacketTest, ClientAckRoundTrip) {
@@ -105,6 +106,8 @@ TEST_F(NetPacketTest, SceneSnapshotRoundTrip) {
   auto snapshot = received->get_scene_snapshot();
   ASSERT_TRUE(snapshot.has_value());
   EXPECT_EQ(snapshot->sequence, 3_u8);
+  EXPECT_FALSE(snapshot->baseline.has_value());
+  EXPECT_FALSE(snapshot->upsert);
 
   const auto& result = snapshot->state;
   ASSERT_EQ(result.entities.size(), 2_sz);
@@ -119,7 +122,9 @@ TEST_F(NetPacketTest, SceneSnapshotRoundTrip) {
 
   const auto& component = entity.components.at(7);
   EXPECT_EQ(component.id, 7_u64);
-  EXPECT_EQ(component.hash, 0xabcdef_u64);
+  // Hashes stay on the sending side, the receiver recomputes them from the data.
+  const auto expected_hash = ankerl::unordered_dense::detail::wyhash::hash(component.buffer.data(), component.buffer.size());
+  EXPECT_EQ(component.hash, expected_hash);
   EXPECT_THAT(component.buffer, testing::ElementsAre(1, 2, 3, 4, 5));
 
   const auto& tag = entity.components.at(9);
@@ -150,6 +155,23 @@ TEST_F(NetPacketTest, SceneSnapshotRoundTripsEmptyState) {
   EXPECT_TRUE(snapshot->state.removed_entities.empty());
 }
 
+TEST_F(NetPacketTest, SceneSnapshotCarriesUpsertFlag) {
+  for (const auto upsert : {false, true}) {
+    auto sent = ox::NetPacket::scene_snapshot(make_test_state(), 4, ox::nullopt, nullptr, upsert);
+    ASSERT_TRUE(sent.has_value());
+    OX_DEFER(&) { sent->destroy(); };
+
+    auto received = receive(sent.value());
+    ASSERT_TRUE(received.has_value());
+
+    auto snapshot = received->get_scene_snapshot();
+    ASSERT_TRUE(snapshot.has_value());
+    EXPECT_EQ(snapshot->upsert, upsert);
+    EXPECT_FALSE(snapshot->baseline.has_value());
+    EXPECT_EQ(snapshot->state.entities.size(), 2_sz);
+  }
+}
+
 TEST_F(NetPacketTest, SceneSnapshotRoundTripsEverySequence) {
   // Same sentinel trap as the client ack, the sequence wraps around all 8 bits.
   for (auto sequence = 0_u32; sequence <= 255_u32; sequence++) {
@@ -217,7 +239,9 @@ TEST_F(NetPacketTest, RPCRoundTripsEveryParameterType) {
     ox::RPCParameter{.value = payload_bytes},
   };
 
-  auto sent = ox::NetPacket::rpc("test_proc"sv, params);
+  auto batch = ox::NetRPCBatch{};
+  ASSERT_TRUE(batch.add(3, params));
+  auto sent = ox::NetPacket::rpc(batch);
   ASSERT_TRUE(sent.has_value());
   OX_DEFER(&) { sent->destroy(); };
 
@@ -226,11 +250,15 @@ TEST_F(NetPacketTest, RPCRoundTripsEveryParameterType) {
   auto received = receive(sent.value());
   ASSERT_TRUE(received.has_value());
 
-  auto rpc = received->get_rpc();
-  ASSERT_TRUE(rpc.has_value());
-  ASSERT_EQ(rpc->parameters.size(), params.size());
+  auto reader = received->get_rpcs();
+  ASSERT_TRUE(reader.has_value());
+
+  auto call = ox::NetRPCReader::Call{};
+  ASSERT_TRUE(reader->next(call));
+  EXPECT_EQ(call.proc_id, 3);
+  ASSERT_EQ(call.args.size(), params.size());
 
-  const auto& result = rpc->parameters;
+  const auto& result = call.args;
   EXPECT_TRUE(std::holds_alternative<std::monostate>(result[0].value));
   EXPECT_EQ(std::get<u8>(result[1].value), 200_u8);
   EXPECT_EQ(std::get<u16>(result[2].value), 40000_u16);
@@ -252,49 +280,139 @@ TEST_F(NetPacketTest, RPCRoundTripsEveryParameterType) {
   EXPECT_TRUE(*as_uuid == uuid);
 
   EXPECT_THAT(result[9].as_span<u32>(), testing::ElementsAreArray(payload));
+
+  EXPECT_FALSE(reader->next(call));
+  EXPECT_FALSE(reader->failed);
 }
 
-TEST_F(NetPacketTest, RPCRoundTripsWithoutParameters) {
-  auto sent = ox::NetPacket::rpc("no_params"sv, {});
+TEST_F(NetPacketTest, RPCDecodingPointsIntoThePacket) {
+  const auto params = std::array{
+    ox::RPCParameter{.value = 1_u8},
+    ox::RPCParameter{.value = std::string("view")},
+    ox::RPCParameter{.value = std::vector<u8>(24, 7)},
+  };
+
+  auto batch = ox::NetRPCBatch{};
+  ASSERT_TRUE(batch.add(0, params));
+  auto sent = ox::NetPacket::rpc(batch);
   ASSERT_TRUE(sent.has_value());
   OX_DEFER(&) { sent->destroy(); };
 
   auto received = receive(sent.value());
   ASSERT_TRUE(received.has_value());
-
-  auto rpc = received->get_rpc();
-  ASSERT_TRUE(rpc.has_value());
-  EXPECT_TRUE(rpc->parameters.empty());
+  auto reader = received->get_rpcs();
+  ASSERT_TRUE(reader.has_value());
+
+  auto call = ox::NetRPCReader::Call{};
+  ASSERT_TRUE(reader->next(call));
+
+  const auto* begin = reinterpret_cast<const char*>(sent->inner->data);
+  const auto* end = begin + sent->inner->dataLength;
+  const auto str = call.args[1].as_str();
+  EXPECT_GE(str.data(), begin);
+  EXPECT_LE(str.data() + str.size(), end);
+
+  // Odd sized data in front of it, the byte array is still aligned for wide element types.
+  const auto wide = call.args[2].as_span<u64>();
+  ASSERT_EQ(wide.size(), 3);
+  EXPECT_GE(reinterpret_cast<const char*>(wide.data()), begin);
+  EXPECT_EQ(reinterpret_cast<uptr>(wide.data()) % alignof(u64), 0);
 }
 
-TEST_F(NetPacketTest, RPCProcHashMatchesIdentifierHash) {
-  constexpr auto identifier = "spawn_player"sv;
+TEST_F(NetPacketTest, RPCBatchCarriesEveryCallInOrder) {
+  auto batch = ox::NetRPCBatch{};
+  for (auto i = 0_u16; i < 5; i++) {
+    const auto params = std::array{ox::RPCParameter{.value = static_cast<i32>(i * 10)}};
+    ASSERT_TRUE(batch.add(i, params));
+  }
+  ASSERT_TRUE(batch.add(9, {}));
+  EXPECT_EQ(batch.call_count, 6);
 
-  auto sent = ox::NetPacket::rpc(identifier, {});
+  auto sent = ox::NetPacket::rpc(batch);
   ASSERT_TRUE(sent.has_value());
   OX_DEFER(&) { sent->destroy(); };
 
   auto received = receive(sent.value());
   ASSERT_TRUE(received.has_value());
+  auto reader = received->get_rpcs();
+  ASSERT_TRUE(reader.has_value());
+
+  auto call = ox::NetRPCReader::Call{};
+  for (auto i = 0_u16; i < 5; i++) {
+    ASSERT_TRUE(reader->next(call));
+    EXPECT_EQ(call.proc_id, i);
+    ASSERT_EQ(call.args.size(), 1);
+    EXPECT_EQ(std::get<i32>(call.args[0].value), i * 10);
+  }
 
-  auto rpc = received->get_rpc();
-  ASSERT_TRUE(rpc.has_value());
+  ASSERT_TRUE(reader->next(call));
+  EXPECT_EQ(call.proc_id, 9);
+  EXPECT_TRUE(call.args.empty());
+  EXPECT_FALSE(reader->next(call));
+  EXPECT_FALSE(reader->failed);
 
-  // This is how NetClient/NetServer::register_proc key their callbacks.
-  const auto expected = ankerl::unordered_dense::detail::wyhash::hash(identifier.data(), identifier.size());
-  EXPECT_EQ(rpc->proc_hash, expected);
+  batch.clear();
+  EXPECT_TRUE(batch.empty());
+  EXPECT_FALSE(ox::NetPacket::rpc(batch).has_value());
 }
 
-TEST_F(NetPacketTest, RPCParameterAccessorsRejectMismatchedTypes) {
-  const auto param = ox::RPCParameter{.value = std::string("not a number")};
+TEST_F(NetPacketTest, RPCProcIdsAreNegotiated) {
+  // The receiving side registers, the handshake carries its table to the calling side.
+  auto table = ox::NetProcTable{};
+  auto received_name = std::string{};
+  auto calls = 0;
+  EXPECT_EQ(table.add("ping", [&](ox::NetClientID, std::span<const ox::RPCArg>) { calls += 1; }), 0);
+  EXPECT_EQ(
+    table.add(
+      "spawn_player",
+      [&](ox::NetClientID, std::span<const ox::RPCArg> args) { received_name = args[0].as_str(); }
+    ),
+    1
+  );
+  // Registering again keeps the id.
+  EXPECT_EQ(table.add("ping", [&](ox::NetClientID, std::span<const ox::RPCArg>) { calls += 2; }), 0);
+
+  auto sent_handshake = ox::NetPacket::handshake({.version = 1, .procs = table.entries});
+  ASSERT_TRUE(sent_handshake.has_value());
+  OX_DEFER(&) { sent_handshake->destroy(); };
+  auto handshake = receive(sent_handshake.value())->get_handshake();
+  ASSERT_TRUE(handshake.has_value());
+  ASSERT_EQ(handshake->procs.size(), 2);
+
+  auto remote = ox::NetRemoteProcs{};
+  remote.assign(handshake->procs);
+  EXPECT_FALSE(remote.find("missing").has_value());
+  auto spawn_id = remote.find("spawn_player");
+  auto ping_id = remote.find("ping");
+  ASSERT_TRUE(spawn_id.has_value());
+  ASSERT_TRUE(ping_id.has_value());
+
+  auto batch = ox::NetRPCBatch{};
+  const auto params = std::array{ox::RPCParameter{.value = std::string("bob")}};
+  ASSERT_TRUE(batch.add(spawn_id.value(), params));
+  ASSERT_TRUE(batch.add(ping_id.value(), {}));
+  ASSERT_TRUE(batch.add(42, {})); // never registered, skipped
+  auto sent = ox::NetPacket::rpc(batch);
+  ASSERT_TRUE(sent.has_value());
+  OX_DEFER(&) { sent->destroy(); };
+
+  auto reader = receive(sent.value())->get_rpcs();
+  ASSERT_TRUE(reader.has_value());
+  EXPECT_TRUE(table.dispatch(ox::NetClientID::Invalid, reader.value()));
+  EXPECT_EQ(received_name, "bob");
+  EXPECT_EQ(calls, 2);
+}
+
+TEST_F(NetPacketTest, RPCArgAccessorsRejectMismatchedTypes) {
+  const auto arg = ox::RPCArg{.value = "not a number"sv};
 
-  EXPECT_FALSE(param.as_f32().has_value());
-  EXPECT_FALSE(param.as_int64().has_value());
-  EXPECT_FALSE(param.as_uuid().has_value());
-  EXPECT_TRUE(param.as_span<u32>().empty());
-  EXPECT_EQ(param.as_str(), "not a number"sv);
+  EXPECT_FALSE(arg.as_f32().has_value());
+  EXPECT_FALSE(arg.as_int64().has_value());
+  EXPECT_FALSE(arg.as_uuid().has_value());
+  EXPECT_TRUE(arg.as_span<u32>().empty());
+  EXPECT_EQ(arg.as_str(), "not a number"sv);
 
-  const auto none = ox::RPCParameter{};
+  const auto none = ox::RPCArg{};
   EXPECT_FALSE(none.as_f32().has_value());
   EXPECT_TRUE(none.as_str().empty());
 }
@@ -310,7 +428,7 @@ TEST_F(NetPacketTest, GettersRejectMismatchedPacketTypes) {
   EXPECT_TRUE(received->get_handshake().has_value());
   EXPECT_FALSE(received->get_scene_snapshot().has_value());
   EXPECT_FALSE(received->get_client_ack().has_value());
-  EXPECT_FALSE(received->get_rpc().has_value());
+  EXPECT_FALSE(received->get_rpcs().has_value());
 }
 
 TEST_F(NetPacketTest, FromPacketRejectsEmptyPayload) {
@@ -354,23 +472,55 @@ TEST_F(NetPacketTest, GarbagePayloadIsRejected) {
   auto packet = ox::NetPacket::from_packet(raw);
   ASSERT_TRUE(packet.has_value());
   EXPECT_EQ(packet->type, ox::NetPacketType::RPC);
-  EXPECT_FALSE(packet->get_rpc().has_value());
+
+  auto reader = packet->get_rpcs();
+  ASSERT_TRUE(reader.has_value());
+  auto call = ox::NetRPCReader::Call{};
+  EXPECT_FALSE(reader->next(call));
+  EXPECT_TRUE(reader->failed);
 }
 
 TEST_F(NetPacketTest, ImplausibleContainerSizeIsRejected) {
-  // A hand rolled RPC packet claiming a billion parameters. Without an allocation limit on the
-  // deserializer this would try to allocate tens of gigabytes before looking at a single parameter.
-  auto [data, ser] = zpp::bits::data_out(zpp::bits::options::size_varint{});
-  ASSERT_FALSE(zpp::bits::failure(ser(ox::NetPacketType::RPC, 0_u64, zpp::bits::vsize_t{1'000'000'000})));
+  // A hand rolled RPC call with a byte array claiming four gigabytes, it has to be rejected instead of
+  // viewing past the end of the packet.
+  const auto bytes = std::array<u8, 9>{static_cast<u8>(ox::NetPacketType::RPC), 0, 0, 1, 9, 0xff, 0xff, 0xff, 0xff};
 
-  auto* raw = enet_packet_create(data.data(), data.size(), 0);
+  auto* raw = enet_packet_create(bytes.data(), bytes.size(), 0);
   ASSERT_NE(raw, nullptr);
   OX_DEFER(&) { enet_packet_destroy(raw); };
 
   auto packet = ox::NetPacket::from_packet(raw);
   ASSERT_TRUE(packet.has_value());
-  EXPECT_EQ(packet->type, ox::NetPacketType::RPC);
-  EXPECT_FALSE(packet->get_rpc().has_value());
+  auto reader = packet->get_rpcs();
+  ASSERT_TRUE(reader.has_value());
+  auto call = ox::NetRPCReader::Call{};
+  EXPECT_FALSE(reader->next(call));
+  EXPECT_TRUE(reader->failed);
+}
+
+TEST_F(NetPacketTest, TruncatedRPCIsRejected) {
+  const auto params = std::array{
+    ox::RPCParameter{.value = -5_i64},
+    ox::RPCParameter{.value = std::string("truncated")},
+    ox::RPCParameter{.value = std::vector<u8>(16, 1)},
+  };
+  auto batch = ox::NetRPCBatch{};
+  ASSERT_TRUE(batch.add(1, params));
+
+  // Every cut of a valid call must be rejected instead of reading out of bounds.
+  for (auto size = 2_sz; size < batch.bytes.size(); size++) {
+    auto* raw = enet_packet_create(batch.bytes.data(), size, 0);
+    ASSERT_NE(raw, nullptr);
+    OX_DEFER(&) { enet_packet_destroy(raw); };
+
+    auto packet = ox::NetPacket::from_packet(raw);
+    ASSERT_TRUE(packet.has_value());
+    auto reader = packet->get_rpcs();
+    ASSERT_TRUE(reader.has_value());
+    auto call = ox::NetRPCReader::Call{};
+    EXPECT_FALSE(reader->next(call)) << "size = " << size;
+    EXPECT_TRUE(reader->failed) << "size = " << size;
+  }
 }
 
 TEST_F(NetPacketTest, UnknownPacketTypeIsNotClaimedByAnyGetter) {
@@ -386,5 +536,5 @@ TEST_F(NetPacketTest, UnknownPacketTypeIsNotClaimedByAnyGetter) {
   EXPECT_FALSE(packet->get_handshake().has_value());
   EXPECT_FALSE(packet->get_scene_snapshot().has_value());
   EXPECT_FALSE(packet->get_client_ack().has_value());
-  EXPECT_FALSE(packet->get_rpc().has_value());
+  EXPECT_FALSE(packet->get_rpcs().has_value());
 }
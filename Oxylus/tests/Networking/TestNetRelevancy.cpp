@@ -0,0 +1,177 @@
+#include <algorithm>
+#include <cstring>
+#include <gtest/gtest.h>
+
+#include "Networking/NetRelevancy.hpp"
+#include "Scene/Components.hpp"
+
+namespace {
+constexpr auto CLIENT = static_cast<ox::NetClientID>(1);
+
+// What a client would end up with after applying every snapshot it received.
+struct SimulatedClient {
+  ankerl::unordered_dense::map<flecs::entity_t, ox::TransformComponent> entities = {};
+
+  auto apply(const ox::SceneState& state) -> void {
+    for (auto entity : state.removed_entities) {
+      entities.erase(entity);
+    }
+
+    for (const auto& [entity, entity_state] : state.entities) {
+      auto& transform = entities[entity];
+      for (const auto& [id, component] : entity_state.components) {
+        std::memcpy(&transform, component.buffer.data(), std::min(component.buffer.size(), sizeof(transform)));
+      }
+    }
+  }
+};
+} // namespace
+
+class NetRelevancyTest : public ::testing::Test {
+protected:
+  void SetUp() override { world.component<ox::TransformComponent>().add<ox::Networked>(); }
+
+  auto spawn(glm::vec3 position) -> flecs::entity {
+    return world.entity().set<ox::TransformComponent>({.position = position});
+  }
+
+  // One server tick for a single client, `lost` drops the packet and its ack.
+  auto tick(SimulatedClient& client, bool lost = false) -> ox::SceneState {
+    builder.capture(world);
+    relevancy.update(world, builder);
+    auto state = ox::SceneState{};
+    relevancy.build(builder, CLIENT).to_state(state);
+    if (!lost) {
+      client.apply(state);
+      relevancy.ack(builder, CLIENT, builder.current_sequence);
+    }
+    builder.advance();
+    return state;
+  }
+
+  flecs::world world = {};
+  ox::SceneSnapshotBuilder builder = {};
+  ox::NetRelevancy relevancy = {};
+};
+
+TEST_F(NetRelevancyTest, OutsideInterestIsNotSent) {
+  auto near = spawn({10.0f, 0.0f, 0.0f});
+  auto far = spawn({500.0f, 0.0f, 0.0f});
+  relevancy.set_interest(CLIENT, {.center = {}, .radius = 100.0f});
+
+  auto client = SimulatedClient{};
+  auto state = tick(client);
+  EXPECT_TRUE(state.entities.contains(near.id()));
+  EXPECT_FALSE(state.entities.contains(far.id()));
+  EXPECT_EQ(client.entities.size(), 1);
+}
+
+TEST_F(NetRelevancyTest, FarEntitiesUpdateLessOften) {
+  auto near = spawn({1.0f, 0.0f, 0.0f});
+  auto far = spawn({95.0f, 0.0f, 0.0f});
+  relevancy.set_interest(CLIENT, {.center = {}, .radius = 100.0f});
+
+  auto client = SimulatedClient{};
+  auto near_updates = 0;
+  auto far_updates = 0;
+  for (auto i = 0; i < 30; i++) {
+    near.get_mut<ox::TransformComponent>().position.y += 0.5f;
+    far.get_mut<ox::TransformComponent>().position.y += 0.01f;
+    auto state = tick(client);
+    near_updates += state.entities.contains(near.id());
+    far_updates += state.entities.contains(far.id());
+  }
+
+  EXPECT_EQ(near_updates, 30);
+  EXPECT_GT(far_updates, 0);
+  EXPECT_LT(far_updates, 10);
+  EXPECT_FLOAT_EQ(client.entities[near.id()].position.y, 15.0f);
+}
+
+TEST_F(NetRelevancyTest, BudgetCapsEachPacket) {
+  for (auto i = 0; i < 50; i++) {
+    spawn({static_cast<f32>(i) * 0.1f, 0.0f, 0.0f});
+  }
+
+  const auto entity_bytes = 2 * sizeof(u64) + sizeof(ox::TransformComponent);
+  relevancy.set_interest(CLIENT, {.center = {}, .radius = 100.0f, .budget_bytes = static_cast<u32>(entity_bytes * 8)});
+
+  auto client = SimulatedClient{};
+  for (auto i = 0; i < 7; i++) {
+    auto state = tick(client);
+    EXPECT_LE(state.entities.size(), 8);
+  }
+
+  EXPECT_EQ(client.entities.size(), 50);
+}
+
+TEST_F(NetRelevancyTest, LeavingTheAreaRemovesTheEntity) {
+  auto entity = spawn({});
+  relevancy.set_interest(CLIENT, {.center = {}, .radius = 100.0f});
+
+  auto client = SimulatedClient{};
+  tick(client);
+  ASSERT_TRUE(client.entities.contains(entity.id()));
+
+  entity.get_mut<ox::TransformComponent>().position.x = 200.0f;
+  auto state = tick(client);
+  EXPECT_TRUE(state.removed_entities.contains(entity.id()));
+  EXPECT_FALSE(client.entities.contains(entity.id()));
+
+  // Removal got acked, nothing left to say about it.
+  state = tick(client);
+  EXPECT_TRUE(state.removed_entities.empty());
+  EXPECT_TRUE(state.entities.empty());
+
+  // Coming back sends everything again.
+  entity.get_mut<ox::TransformComponent>().position.x = 5.0f;
+  state = tick(client);
+  ASSERT_TRUE(state.entities.contains(entity.id()));
+  EXPECT_EQ(state.entities.at(entity.id()).components.size(), 1);
+  EXPECT_FLOAT_EQ(client.entities[entity.id()].position.x, 5.0f);
+
+  // Destroyed entities are removed the same way.
+  entity.destruct();
+  state = tick(client);
+  EXPECT_TRUE(state.removed_entities.contains(entity.id()));
+  EXPECT_TRUE(client.entities.empty());
+}
+
+TEST_F(NetRelevancyTest, ComingBackBeforeTheRemovalIsAckedSendsRightAway) {
+  // Far enough to otherwise wait a few ticks for its turn.
+  auto entity = spawn({95.0f, 0.0f, 0.0f});
+  relevancy.set_interest(CLIENT, {.center = {}, .radius = 100.0f});
+
+  auto client = SimulatedClient{};
+  tick(client);
+  ASSERT_TRUE(client.entities.contains(entity.id()));
+
+  entity.get_mut<ox::TransformComponent>().position.x = 200.0f;
+  auto state = tick(client, true);
+  ASSERT_TRUE(state.removed_entities.contains(entity.id()));
+
+  entity.get_mut<ox::TransformComponent>().position.x = 95.0f;
+  state = tick(client);
+  ASSERT_TRUE(state.entities.contains(entity.id()));
+  EXPECT_FLOAT_EQ(client.entities[entity.id()].position.x, 95.0f);
+}
+
+TEST_F(NetRelevancyTest, LostPacketsAreRecovered) {
+  auto entity = spawn({});
+  relevancy.set_interest(CLIENT, {.center = {}, .radius = 100.0f});
+
+  auto client = SimulatedClient{};
+  tick(client);
+
+  entity.get_mut<ox::TransformComponent>().position.z = 3.0f;
+  tick(client, true);
+  EXPECT_FLOAT_EQ(client.entities[entity.id()].position.z, 0.0f);
+
+  // Nothing changed since, but the client never acked the move.
+  auto state = tick(client);
+  EXPECT_TRUE(state.entities.contains(entity.id()));
+  EXPECT_FLOAT_EQ(client.entities[entity.id()].position.z, 3.0f);
+
+  state = tick(client);
+  EXPECT_TRUE(state.entities.empty());
+}
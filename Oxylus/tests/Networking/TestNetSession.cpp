@@ -0,0 +1,170 @@
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <thread>
+
+#include "Core/App.hpp"
+#include "Networking/NetworkManager.hpp"
+#include "Scene/Components.hpp"
+#include "Utils/Timestep.hpp"
+
+namespace {
+constexpr auto PORT = 47'611_u16;
+constexpr auto PRECISION = 1.0f / 1024.0f;
+
+struct NetBody {
+  glm::vec3 position = {};
+  glm::quat rotation = glm::quat::wxyz(1.0f, 0.0f, 0.0f, 0.0f);
+  u32 flags = 0;
+};
+
+auto register_components(flecs::world& world) -> flecs::entity_t {
+  world.component<glm::vec3>().member<f32>("x").member<f32>("y").member<f32>("z");
+  world.component<glm::quat>().member<f32>("x").member<f32>("y").member<f32>("z").member<f32>("w");
+
+  auto body = world.component<NetBody>()
+                .member("position", &NetBody::position)
+                .member("rotation", &NetBody::rotation)
+                .member("flags", &NetBody::flags)
+                .add<ox::Networked>();
+  body.lookup("position").set<ox::NetQuantize>({.precision = PRECISION});
+  return body.id();
+}
+
+struct RecordingClient : ox::NetClient {
+  using NetClient::NetClient;
+
+  auto on_scene_snapshot(f64, const ox::SceneState& state) -> void override {
+    snapshots += 1;
+    last_state = state;
+  }
+
+  auto flags_of(flecs::entity_t entity, flecs::entity_t body_id) const -> ox::option<u32> {
+    const auto it = last_state.entities.find(entity);
+    if (it == last_state.entities.end() || !it->second.components.contains(body_id)) {
+      return ox::nullopt;
+    }
+
+    auto body = NetBody{};
+    std::memcpy(&body, it->second.components.at(body_id).buffer.data(), sizeof(NetBody));
+    return body.flags;
+  }
+
+  u32 snapshots = 0;
+  ox::SceneState last_state = {};
+};
+} // namespace
+
+class NetSessionTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    static char arg0[] = "testarg";
+    static char* test_argv[] = {arg0, nullptr};
+    app = std::make_unique<ox::App>(1, test_argv);
+
+    // The client's frames go by about as fast as the pump sleeps.
+    timestep.set_simulated_step(1.0);
+
+    network.threaded = false;
+    network.snapshot_config = {.compress = true};
+    ASSERT_TRUE(network.init().has_value());
+
+    body_id = register_components(server_world);
+    ASSERT_EQ(register_components(client_world), body_id);
+  }
+
+  void TearDown() override {
+    if (client) {
+      network.destroy_client(client);
+    }
+    if (server) {
+      network.destroy_server(server);
+    }
+    std::ignore = network.deinit();
+    app.reset();
+  }
+
+  // Services both ends and runs client frames until `done` or a couple of seconds went by.
+  template <typename Fn>
+  auto pump(Fn&& done) -> bool {
+    for (auto i = 0; i < 2000; i++) {
+      network.dispatch();
+      if (client) {
+        timestep.on_update();
+        std::ignore = client->tick(timestep);
+      }
+      if (done()) {
+        return true;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    return false;
+  }
+
+  std::unique_ptr<ox::App> app = nullptr;
+  ox::Timestep timestep = {};
+  ox::NetworkManager network = {};
+  flecs::world server_world = {};
+  flecs::world client_world = {};
+  flecs::entity_t body_id = 0;
+  ox::NetServer* server = nullptr;
+  RecordingClient* client = nullptr;
+};
+
+TEST_F(NetSessionTest, SnapshotReachesClient) {
+  server = network.create_server(PORT, 4);
+  ASSERT_NE(server, nullptr);
+  client = network.create_client<RecordingClient>();
+  ASSERT_NE(client, nullptr);
+  EXPECT_TRUE(server->snapshot_codec.compress);
+  EXPECT_TRUE(client->snapshot_codec.compress);
+
+  client->set_world(client_world);
+  ASSERT_TRUE(client->connect("127.0.0.1", PORT, 2000.0));
+  // The handshake is what builds the client's schemas.
+  ASSERT_TRUE(pump([&] { return client->snapshot_codec.schema.find(body_id) != nullptr; }));
+  EXPECT_FALSE(client->timeline.schema.find(body_id).empty());
+
+  auto client_id = ox::NetClientID::Invalid;
+  server->remote_clients.for_each_active([&](usize, ox::NetClient& remote) {
+    client_id = static_cast<ox::NetClientID>(reinterpret_cast<uptr>(remote.remote_peer->data));
+  });
+  ASSERT_NE(client_id, ox::NetClientID::Invalid);
+
+  const auto rotation = glm::normalize(glm::angleAxis(0.7f, glm::vec3(0.0f, 1.0f, 0.0f)));
+  auto entity = server_world.entity().set<NetBody>({
+    .position = {1.5f, -2.25f, 300.0f},
+    .rotation = rotation,
+    .flags = 42,
+  });
+
+  server->send_snapshots(server_world);
+  ASSERT_NE(server->snapshot_codec.schema.find(body_id), nullptr);
+  ASSERT_TRUE(pump([&] { return client->snapshots > 0; }));
+
+  ASSERT_TRUE(client->last_state.entities.contains(entity.id()));
+  const auto& components = client->last_state.entities.at(entity.id()).components;
+  ASSERT_TRUE(components.contains(body_id));
+  const auto& buffer = components.at(body_id).buffer;
+  ASSERT_EQ(buffer.size(), sizeof(NetBody));
+
+  auto body = NetBody{};
+  std::memcpy(&body, buffer.data(), sizeof(NetBody));
+  EXPECT_NEAR(body.position.x, 1.5f, PRECISION);
+  EXPECT_NEAR(body.position.y, -2.25f, PRECISION);
+  EXPECT_NEAR(body.position.z, 300.0f, PRECISION);
+  EXPECT_GT(std::abs(glm::dot(body.rotation, rotation)), 0.9999f);
+  EXPECT_EQ(body.flags, 42_u32);
+
+  // The client acks what it got, the next snapshot is a delta against it and plays back once the
+  // timeline gets there.
+  ASSERT_TRUE(pump([&] { return server->snapshots.baseline(client_id).has_value(); }));
+  entity.get_mut<NetBody>().flags = 43;
+  server->send_snapshots(server_world);
+  ASSERT_TRUE(pump([&] { return client->flags_of(entity.id(), body_id) == 43_u32; }));
+
+  EXPECT_EQ(client->timeline.stats.unresolved, 0_u32);
+  EXPECT_EQ(client->timeline.stats.late, 0_u32);
+}
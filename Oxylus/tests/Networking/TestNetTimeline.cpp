@@ -0,0 +1,443 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <limits>
+#include <random>
+
+#include "Networking/NetPrediction.hpp"
+#include "Networking/NetTimeline.hpp"
+#include "Scene/Components.hpp"
+
+namespace {
+struct NetBody {
+  glm::vec3 position = {};
+  glm::quat rotation = glm::quat::wxyz(1.0f, 0.0f, 0.0f, 0.0f);
+  u32 flags = 0;
+};
+
+// Delivers whatever is sent after a fixed latency plus seeded jitter, which reorders things, and drops
+// every `drop_every`th send. Same seed, same run.
+template <typename T>
+struct SimulatedLink {
+  struct InFlight {
+    f64 deliver_at_ms = 0.0;
+    u64 order = 0;
+    T payload = {};
+  };
+
+  f64 latency_ms = 0.0;
+  f64 jitter_ms = 0.0;
+  u32 drop_every = 0;
+  std::mt19937 rng{1234};
+  std::vector<InFlight> in_flight = {};
+  u64 sent = 0;
+
+  auto send(f64 now_ms, T payload) -> void {
+    sent += 1;
+    if (drop_every != 0 && sent % drop_every == 0) {
+      return;
+    }
+
+    const auto jitter = jitter_ms * static_cast<f64>(rng()) / static_cast<f64>(std::mt19937::max());
+    in_flight.push_back({.deliver_at_ms = now_ms + latency_ms + jitter, .order = sent, .payload = std::move(payload)});
+  }
+
+  template <typename Fn>
+  auto deliver(f64 now_ms, Fn&& fn) -> void {
+    std::ranges::sort(in_flight, {}, [](const InFlight& v) { return std::pair(v.deliver_at_ms, v.order); });
+
+    auto delivered = 0_sz;
+    for (; delivered < in_flight.size() && in_flight[delivered].deliver_at_ms <= now_ms; delivered++) {
+      fn(in_flight[delivered].payload);
+    }
+
+    in_flight.erase(in_flight.begin(), in_flight.begin() + static_cast<std::ptrdiff_t>(delivered));
+  }
+};
+
+struct Snapshot {
+  u8 sequence = 0;
+  ox::option<u8> baseline = ox::nullopt;
+  ox::SceneState state = {};
+};
+
+struct PlaybackResult {
+  u32 samples = 0;
+  u32 starved = 0;
+  f32 min_step = std::numeric_limits<f32>::max();
+  f32 max_step = 0.0f;
+  f32 max_error = 0.0f;
+};
+} // namespace
+
+class NetTimelineTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    world.component<glm::vec3>().member<f32>("x").member<f32>("y").member<f32>("z");
+    world.component<glm::quat>().member<f32>("x").member<f32>("y").member<f32>("z").member<f32>("w");
+
+    body_id = world.component<NetBody>()
+                .member("position", &NetBody::position)
+                .member("rotation", &NetBody::rotation)
+                .member("flags", &NetBody::flags)
+                .add<ox::Networked>()
+                .id();
+  }
+
+  auto make_timeline() -> ox::NetTimeline {
+    auto timeline = ox::NetTimeline{};
+    timeline.schema.build(world);
+    timeline.tick_interval_ms = TICK_MS;
+    return timeline;
+  }
+
+  auto add_body(ox::SceneState& state, flecs::entity_t entity, const NetBody& body) -> void {
+    auto buffer = std::vector<u8>(sizeof(NetBody));
+    std::memcpy(buffer.data(), &body, sizeof(NetBody));
+
+    auto entity_state = ox::EntityState{.entity_id = entity};
+    entity_state.components.emplace(body_id, ox::ComponentState{.id = body_id, .hash = 1, .buffer = std::move(buffer)});
+    state.entities.emplace(entity, std::move(entity_state));
+  }
+
+  auto body_of(const ox::SceneState& state, flecs::entity_t entity) -> NetBody {
+    const auto& buffer = state.entities.at(entity).components.at(body_id).buffer;
+    auto body = NetBody{};
+    std::memcpy(&body, buffer.data(), std::min(buffer.size(), sizeof(NetBody)));
+    return body;
+  }
+
+  static auto body_at(i64 tick) -> NetBody {
+    return {
+      .position = {static_cast<f32>(tick) * SPEED, 0.0f, 0.0f},
+      .rotation = glm::angleAxis(static_cast<f32>(tick) * 0.1f, glm::vec3(0.0f, 1.0f, 0.0f)),
+      .flags = static_cast<u32>(tick),
+    };
+  }
+
+  // Server sends one full state per tick of an entity moving at a constant speed, the client samples
+  // at 60 fps. Steps and errors are only measured after `warmup_ms`, when the delay has settled.
+  auto play(ox::NetTimeline& timeline, SimulatedLink<Snapshot>& link, f64 duration_ms, f64 warmup_ms)
+    -> PlaybackResult {
+    auto result = PlaybackResult{};
+    auto next_tick = 0_i64;
+    auto sampled = ox::SceneState{};
+    auto previous_x = 0.0f;
+    auto has_previous = false;
+    auto starved_before = 0_u32;
+
+    while (timeline.local_ms() < duration_ms) {
+      timeline.advance(FRAME_MS);
+      const auto now = timeline.local_ms();
+
+      for (; static_cast<f64>(next_tick) * TICK_MS <= now; next_tick++) {
+        auto snapshot = Snapshot{.sequence = static_cast<u8>(next_tick % ox::NetTimeline::MAX_FRAMES)};
+        add_body(snapshot.state, ENTITY, body_at(next_tick));
+        link.send(static_cast<f64>(next_tick) * TICK_MS, std::move(snapshot));
+      }
+
+      link.deliver(now, [&](Snapshot& snapshot) {
+        std::ignore = timeline.push(snapshot.sequence, snapshot.baseline, snapshot.state);
+      });
+
+      if (!timeline.sample(sampled) || now < warmup_ms) {
+        starved_before = timeline.stats.starved;
+        continue;
+      }
+
+      const auto x = body_of(sampled, ENTITY).position.x;
+      const auto expected_x = static_cast<f32>(timeline.playback_ms() / TICK_MS) * SPEED;
+      result.samples += 1;
+      result.max_error = std::max(result.max_error, std::abs(x - expected_x));
+      if (has_previous) {
+        result.min_step = std::min(result.min_step, x - previous_x);
+        result.max_step = std::max(result.max_step, x - previous_x);
+      }
+
+      previous_x = x;
+      has_previous = true;
+    }
+
+    result.starved = timeline.stats.starved - starved_before;
+    return result;
+  }
+
+  constexpr static auto TICK_MS = 50.0;
+  constexpr static auto FRAME_MS = 1000.0 / 60.0;
+  constexpr static auto SPEED = 1.0f; // per tick
+  constexpr static auto ENTITY = flecs::entity_t{1000};
+
+  flecs::world world = {};
+  flecs::entity_t body_id = 0;
+};
+
+TEST_F(NetTimelineTest, SchemaFindsVec3AndQuatThroughMeta) {
+  auto schema = ox::NetInterpolationSchema{};
+  schema.build(world);
+
+  const auto fields = schema.find(body_id);
+  ASSERT_EQ(fields.size(), 2_sz);
+  EXPECT_EQ(fields[0].kind, ox::NetLerpKind::Vec3);
+  EXPECT_EQ(fields[0].offset, offsetof(NetBody, position));
+  EXPECT_EQ(fields[1].kind, ox::NetLerpKind::Quat);
+  EXPECT_EQ(fields[1].offset, offsetof(NetBody, rotation));
+}
+
+TEST_F(NetTimelineTest, BlendInterpolatesFieldsAndTakesTheRestFromNewer) {
+  auto schema = ox::NetInterpolationSchema{};
+  schema.build(world);
+
+  const auto up = glm::vec3(0.0f, 1.0f, 0.0f);
+  const auto from = NetBody{.position = {0.0f, 0.0f, 0.0f}, .rotation = glm::angleAxis(0.0f, up), .flags = 1};
+  const auto to = NetBody{
+    .position = {10.0f, -4.0f, 2.0f},
+    .rotation = glm::angleAxis(glm::half_pi<f32>(), up),
+    .flags = 2,
+  };
+
+  auto out = to;
+  ox::NetInterpolationSchema::blend(
+    schema.find(body_id),
+    {reinterpret_cast<const u8*>(&from), sizeof(NetBody)},
+    {reinterpret_cast<const u8*>(&to), sizeof(NetBody)},
+    0.5f,
+    {reinterpret_cast<u8*>(&out), sizeof(NetBody)}
+  );
+
+  EXPECT_FLOAT_EQ(out.position.x, 5.0f);
+  EXPECT_FLOAT_EQ(out.position.y, -2.0f);
+  EXPECT_FLOAT_EQ(out.position.z, 1.0f);
+  EXPECT_NEAR(glm::angle(out.rotation), glm::quarter_pi<f32>(), 1e-4f);
+  EXPECT_EQ(out.flags, 2_u32);
+}
+
+TEST_F(NetTimelineTest, DeltasResolveAgainstTheirBaseline) {
+  auto timeline = make_timeline();
+
+  auto full = ox::SceneState{};
+  add_body(full, 1, body_at(0));
+  add_body(full, 2, body_at(0));
+  ASSERT_TRUE(timeline.push(0, ox::nullopt, full));
+
+  // Entity 1 moved, 3 is new, 2 didn't change so it's not mentioned.
+  auto moved = ox::SceneState{};
+  add_body(moved, 1, body_at(1));
+  add_body(moved, 3, body_at(1));
+  ASSERT_TRUE(timeline.push(1, 0_u8, moved));
+
+  // Against the same baseline again, 2 is gone now.
+  auto removed = ox::SceneState{};
+  add_body(removed, 1, body_at(2));
+  add_body(removed, 3, body_at(1));
+  removed.removed_entities.emplace(2);
+  ASSERT_TRUE(timeline.push(2, 0_u8, removed));
+
+  const auto* first = timeline.find_frame(1);
+  ASSERT_NE(first, nullptr);
+  EXPECT_EQ(first->state.entities.size(), 3_sz);
+  EXPECT_FLOAT_EQ(body_of(first->state, 1).position.x, SPEED);
+  EXPECT_FLOAT_EQ(body_of(first->state, 2).position.x, 0.0f);
+
+  const auto* second = timeline.find_frame(2);
+  ASSERT_NE(second, nullptr);
+  EXPECT_EQ(second->state.entities.size(), 2_sz);
+  EXPECT_TRUE(second->state.entities.contains(1));
+  EXPECT_TRUE(second->state.entities.contains(3));
+
+  // Baseline this side never got.
+  EXPECT_FALSE(timeline.push(3, 30_u8, moved));
+  EXPECT_EQ(timeline.stats.unresolved, 1_u32);
+}
+
+TEST_F(NetTimelineTest, FullSnapshotsReplaceUpsertsMerge) {
+  auto timeline = make_timeline();
+
+  auto first = ox::SceneState{};
+  add_body(first, 1, body_at(0));
+  add_body(first, 2, body_at(0));
+  ASSERT_TRUE(timeline.push(0, ox::nullopt, first));
+
+  // Only what's around the client, 1 is still there.
+  auto around = ox::SceneState{};
+  add_body(around, 2, body_at(1));
+  ASSERT_TRUE(timeline.push(1, ox::nullopt, around, true));
+
+  const auto* merged = timeline.find_frame(1);
+  ASSERT_NE(merged, nullptr);
+  EXPECT_EQ(merged->state.entities.size(), 2_sz);
+  EXPECT_FLOAT_EQ(body_of(merged->state, 1).position.x, 0.0f);
+  EXPECT_FLOAT_EQ(body_of(merged->state, 2).position.x, SPEED);
+
+  // A full state is all there is, 1 is gone without being removed.
+  ASSERT_TRUE(timeline.push(2, ox::nullopt, around));
+
+  const auto* replaced = timeline.find_frame(2);
+  ASSERT_NE(replaced, nullptr);
+  EXPECT_EQ(replaced->state.entities.size(), 1_sz);
+  EXPECT_TRUE(replaced->state.entities.contains(2));
+}
+
+TEST_F(NetTimelineTest, ReusedSampleMatchesAFreshOne) {
+  auto timeline = make_timeline();
+  auto reused = ox::SceneState{};
+  auto next_tick = 0_i64;
+  auto blended = 0_u32;
+
+  while (timeline.local_ms() < 2'000.0) {
+    timeline.advance(FRAME_MS);
+    for (; static_cast<f64>(next_tick) * TICK_MS <= timeline.local_ms(); next_tick++) {
+      auto state = ox::SceneState{};
+      add_body(state, ENTITY, body_at(next_tick));
+      ASSERT_TRUE(timeline.push(static_cast<u8>(next_tick % ox::NetTimeline::MAX_FRAMES), ox::nullopt, state));
+    }
+
+    if (!timeline.sample(reused)) {
+      continue;
+    }
+
+    // A state it didn't sample into last time gets the whole copy.
+    auto fresh = ox::SceneState{};
+    ASSERT_TRUE(timeline.sample(fresh));
+    const auto lhs = body_of(reused, ENTITY);
+    const auto rhs = body_of(fresh, ENTITY);
+    EXPECT_EQ(lhs.position, rhs.position);
+    EXPECT_EQ(lhs.flags, rhs.flags);
+    blended += lhs.position.x != std::floor(lhs.position.x);
+
+    // Copied into again after the fresh one, the next frame then updates it in place.
+    ASSERT_TRUE(timeline.sample(reused));
+    EXPECT_EQ(body_of(reused, ENTITY).position, lhs.position);
+  }
+
+  EXPECT_GT(blended, 0_u32);
+}
+
+TEST_F(NetTimelineTest, SmoothPlaybackOverLossyJitteryLink) {
+  auto timeline = make_timeline();
+  auto link = SimulatedLink<Snapshot>{.latency_ms = 80.0, .jitter_ms = 60.0, .drop_every = 5};
+
+  const auto result = play(timeline, link, 10'000.0, 3'000.0);
+  ASSERT_GT(result.samples, 300_u32);
+
+  // Every frame moves forward about as far as the entity does in a frame, with no holds or jumps.
+  const auto frame_step = static_cast<f32>(FRAME_MS / TICK_MS) * SPEED;
+  EXPECT_EQ(result.starved, 0_u32);
+  EXPECT_GE(result.min_step, frame_step * (1.0f - static_cast<f32>(timeline.max_time_scale)) - 1e-3f);
+  EXPECT_LE(result.max_step, frame_step * (1.0f + static_cast<f32>(timeline.max_time_scale)) + 1e-3f);
+  EXPECT_LT(result.max_error, 1e-3f);
+  EXPECT_EQ(timeline.stats.late, 0_u32);
+}
+
+TEST_F(NetTimelineTest, DelayFollowsJitter) {
+  auto calm = make_timeline();
+  auto calm_link = SimulatedLink<Snapshot>{.latency_ms = 80.0, .jitter_ms = 5.0};
+  std::ignore = play(calm, calm_link, 8'000.0, 8'000.0);
+
+  auto jittery = make_timeline();
+  auto jittery_link = SimulatedLink<Snapshot>{.latency_ms = 80.0, .jitter_ms = 100.0};
+  std::ignore = play(jittery, jittery_link, 8'000.0, 8'000.0);
+
+  const auto floor = calm.min_delay_ticks * TICK_MS;
+  EXPECT_GE(calm.stats.delay_ms, floor - 5.0);
+  EXPECT_LT(calm.stats.delay_ms, floor + 20.0);
+  EXPECT_GT(jittery.stats.delay_ms, calm.stats.delay_ms + 80.0);
+  EXPECT_LE(jittery.stats.delay_ms, jittery.max_delay_ms);
+}
+
+namespace {
+struct MoveInput {
+  f32 dx = 0.0f;
+};
+
+struct MoveState {
+  f32 x = 0.0f;
+};
+
+// The server stops the player at a wall the client doesn't know about, so predictions past it are wrong.
+constexpr auto WALL_X = 30.0f;
+auto step_client(MoveState& state, const MoveInput& input) -> void { state.x += input.dx; }
+auto step_server(MoveState& state, const MoveInput& input) -> void { state.x = std::min(state.x + input.dx, WALL_X); }
+
+struct InputMessage {
+  u32 sequence = 0;
+  MoveInput input = {};
+};
+
+struct AckMessage {
+  u32 acked = 0;
+  MoveState state = {};
+};
+} // namespace
+
+TEST(NetPredictionTest, ReplaysUnackedInputsOnTopOfServerState) {
+  auto prediction = ox::NetPrediction<MoveInput, MoveState>{};
+  auto inputs = SimulatedLink<InputMessage>{.latency_ms = 60.0};
+  auto acks = SimulatedLink<AckMessage>{.latency_ms = 60.0, .jitter_ms = 40.0, .drop_every = 3};
+  auto server_state = MoveState{};
+  auto server_acked = ox::option<u32>{};
+
+  constexpr auto TICK_MS = 50.0;
+  auto max_pending = 0_sz;
+  for (auto tick = 0; tick < 100; tick++) {
+    const auto now = static_cast<f64>(tick) * TICK_MS;
+
+    // Client keeps moving right for 60 ticks, then stands still.
+    const auto input = MoveInput{.dx = tick < 60 ? 1.0f : 0.0f};
+    const auto sequence = prediction.predict(input, step_client);
+    inputs.send(now, {.sequence = sequence, .input = input});
+
+    inputs.deliver(now, [&](const InputMessage& message) {
+      step_server(server_state, message.input);
+      server_acked = message.sequence;
+    });
+    if (server_acked.has_value()) {
+      acks.send(now, {.acked = server_acked.value(), .state = server_state});
+    }
+
+    acks.deliver(now, [&](const AckMessage& message) {
+      std::ignore = prediction.reconcile(message.acked, message.state, step_client);
+    });
+
+    max_pending = std::max(max_pending, prediction.pending.size());
+
+    // Until the wall, prediction and server agree on everything.
+    if (tick < WALL_X - 5) {
+      EXPECT_FLOAT_EQ(prediction.state.x, static_cast<f32>(tick + 1));
+    }
+  }
+
+  // Only about a round trip worth of inputs is ever waiting.
+  EXPECT_LE(max_pending, 8_sz);
+
+  // Let everything land, the misprediction at the wall is corrected.
+  for (auto tick = 100; tick < 110; tick++) {
+    const auto now = static_cast<f64>(tick) * TICK_MS;
+    inputs.deliver(now, [&](const InputMessage& message) {
+      step_server(server_state, message.input);
+      server_acked = message.sequence;
+    });
+    acks.send(now, {.acked = server_acked.value(), .state = server_state});
+    acks.deliver(now, [&](const AckMessage& message) {
+      std::ignore = prediction.reconcile(message.acked, message.state, step_client);
+    });
+  }
+
+  EXPECT_TRUE(prediction.pending.empty());
+  EXPECT_FLOAT_EQ(prediction.state.x, WALL_X);
+  EXPECT_FLOAT_EQ(server_state.x, WALL_X);
+}
+
+TEST(NetPredictionTest, IgnoresStaleAcks) {
+  auto prediction = ox::NetPrediction<MoveInput, MoveState>{};
+  for (auto i = 0; i < 4; i++) {
+    std::ignore = prediction.predict({.dx = 1.0f}, step_client);
+  }
+
+  EXPECT_EQ(prediction.reconcile(2, {.x = 3.0f}, step_client), 1_sz);
+  EXPECT_FLOAT_EQ(prediction.state.x, 4.0f);
+
+  EXPECT_EQ(prediction.reconcile(1, {.x = 100.0f}, step_client), 0_sz);
+  EXPECT_FLOAT_EQ(prediction.state.x, 4.0f);
+  EXPECT_EQ(prediction.pending.size(), 1_sz);
+}
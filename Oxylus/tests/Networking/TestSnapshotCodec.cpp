@@ -0,0 +1,232 @@
+#include <cstring>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "Networking/SnapshotCodec.hpp"
+#include "Scene/Components.hpp"
+
+namespace {
+struct NetBody {
+  glm::vec3 position = {};
+  glm::quat rotation = glm::quat::wxyz(1.0f, 0.0f, 0.0f, 0.0f);
+  bool sleeping = false;
+  u32 flags = 0;
+};
+
+struct Marker {};
+} // namespace
+
+class SnapshotCodecTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    world.component<glm::vec3>().member<f32>("x").member<f32>("y").member<f32>("z");
+    world.component<glm::quat>().member<f32>("x").member<f32>("y").member<f32>("z").member<f32>("w");
+
+    auto body = world.component<NetBody>()
+                  .member("position", &NetBody::position)
+                  .member("rotation", &NetBody::rotation)
+                  .member("sleeping", &NetBody::sleeping)
+                  .member("flags", &NetBody::flags)
+                  .add<ox::Networked>();
+    body.lookup("position").set<ox::NetQuantize>({.precision = PRECISION});
+    body_id = body.id();
+
+    codec.schema.build(world);
+  }
+
+  auto make_state(const NetBody& body) -> ox::SceneState {
+    auto buffer = std::vector<u8>(sizeof(NetBody));
+    std::memcpy(buffer.data(), &body, sizeof(NetBody));
+
+    auto state = ox::SceneState{};
+    auto entity = ox::EntityState{.entity_id = 1000};
+    entity.components.emplace(body_id, ox::ComponentState{.id = body_id, .hash = 1, .buffer = std::move(buffer)});
+    state.entities.emplace(1000, std::move(entity));
+    return state;
+  }
+
+  static auto body_of(const ox::SceneState& state) -> NetBody {
+    const auto& buffer = state.entities.begin()->second.components.begin()->second.buffer;
+    auto body = NetBody{};
+    std::memcpy(&body, buffer.data(), std::min(buffer.size(), sizeof(NetBody)));
+    return body;
+  }
+
+  constexpr static auto PRECISION = 1.0f / 1024.0f;
+
+  flecs::world world = {};
+  flecs::entity_t body_id = 0;
+  ox::SnapshotCodec codec = {};
+};
+
+TEST_F(SnapshotCodecTest, SchemaFollowsMetaAndHints) {
+  const auto* layout = codec.schema.find(body_id);
+  ASSERT_NE(layout, nullptr);
+  EXPECT_EQ(layout->size, sizeof(NetBody));
+
+  auto kinds = std::vector<ox::SnapshotFieldKind>{};
+  for (const auto& field : layout->fields) {
+    kinds.push_back(field.kind);
+  }
+
+  using enum ox::SnapshotFieldKind;
+  EXPECT_THAT(kinds, testing::ElementsAre(Fixed, Fixed, Fixed, Quat, Bool, Raw));
+}
+
+TEST_F(SnapshotCodecTest, QuantizedRoundTrip) {
+  const auto body = NetBody{
+    .position = {12.3456f, -7.25f, 1000.001f},
+    .rotation = glm::normalize(glm::angleAxis(1.2f, glm::normalize(glm::vec3(1.0f, 2.0f, -0.5f)))),
+    .sleeping = true,
+    .flags = 0xdeadbeef,
+  };
+
+  auto encoded = std::vector<u8>{};
+  ASSERT_TRUE(codec.encode(make_state(body), 5, 3_u8, encoded));
+
+  auto sequence = 0_u8;
+  auto baseline = ox::option<u8>{};
+  auto decoded = ox::SceneState{};
+  ASSERT_TRUE(codec.decode(encoded, sequence, baseline, decoded));
+  EXPECT_EQ(sequence, 5_u8);
+  ASSERT_TRUE(baseline.has_value());
+  EXPECT_EQ(baseline.value(), 3_u8);
+
+  const auto result = body_of(decoded);
+  EXPECT_NEAR(result.position.x, body.position.x, PRECISION);
+  EXPECT_NEAR(result.position.y, body.position.y, PRECISION);
+  EXPECT_NEAR(result.position.z, body.position.z, PRECISION);
+  EXPECT_GT(std::abs(glm::dot(result.rotation, body.rotation)), 0.9999f);
+  EXPECT_TRUE(result.sleeping);
+  EXPECT_EQ(result.flags, 0xdeadbeef);
+
+  // Same state without a schema goes out as raw bytes.
+  auto raw_codec = ox::SnapshotCodec{};
+  auto raw = std::vector<u8>{};
+  ASSERT_TRUE(raw_codec.encode(make_state(body), 5, 3_u8, raw));
+  EXPECT_LT(encoded.size(), raw.size());
+}
+
+TEST_F(SnapshotCodecTest, CompressedRoundTrip) {
+  auto state = ox::SceneState{};
+  for (auto i = 0_u64; i < 256; i++) {
+    auto entity = make_state(NetBody{.position = {static_cast<f32>(i), 0.0f, 0.0f}}).entities.begin()->second;
+    entity.entity_id = i + 1;
+    state.entities.emplace(i + 1, std::move(entity));
+  }
+
+  auto plain = std::vector<u8>{};
+  ASSERT_TRUE(codec.encode(state, 1, ox::nullopt, plain));
+
+  codec.compress = true;
+  auto compressed = std::vector<u8>{};
+  ASSERT_TRUE(codec.encode(state, 1, ox::nullopt, compressed));
+  EXPECT_LT(compressed.size(), plain.size());
+
+  auto sequence = 0_u8;
+  auto baseline = ox::option<u8>{};
+  auto decoded = ox::SceneState{};
+  ASSERT_TRUE(codec.decode(compressed, sequence, baseline, decoded));
+  EXPECT_FALSE(baseline.has_value());
+  EXPECT_EQ(decoded.entities.size(), state.entities.size());
+}
+
+TEST_F(SnapshotCodecTest, DictionaryRoundTrip) {
+  auto sample = std::vector<u8>{};
+  ASSERT_TRUE(codec.encode(make_state(NetBody{.flags = 7}), 0, ox::nullopt, sample));
+
+  codec.compress = true;
+  codec.set_dictionary(sample);
+
+  auto encoded = std::vector<u8>{};
+  ASSERT_TRUE(codec.encode(make_state(NetBody{.flags = 9}), 1, ox::nullopt, encoded));
+
+  auto sequence = 0_u8;
+  auto baseline = ox::option<u8>{};
+  auto decoded = ox::SceneState{};
+  ASSERT_TRUE(codec.decode(encoded, sequence, baseline, decoded));
+  EXPECT_EQ(body_of(decoded).flags, 9_u32);
+}
+
+TEST_F(SnapshotCodecTest, PackedComponentWithoutSchemaIsRejected) {
+  auto encoded = std::vector<u8>{};
+  ASSERT_TRUE(codec.encode(make_state(NetBody{}), 0, ox::nullopt, encoded));
+
+  auto other = ox::SnapshotCodec{};
+  auto sequence = 0_u8;
+  auto baseline = ox::option<u8>{};
+  auto decoded = ox::SceneState{};
+  EXPECT_FALSE(other.decode(encoded, sequence, baseline, decoded));
+}
+
+TEST_F(SnapshotCodecTest, FlatDeltaMatchesSceneState) {
+  const auto marker_id = world.component<Marker>().add<ox::Networked>().id();
+
+  auto builder = ox::SceneSnapshotBuilder{};
+  auto entities = std::vector<flecs::entity>{};
+  for (auto i = 0; i < 8; i++) {
+    entities.push_back(world.entity().set<NetBody>({.flags = static_cast<u32>(i)}).add<Marker>());
+  }
+  builder.capture(world);
+  builder.ack(static_cast<ox::NetClientID>(1), builder.current_sequence);
+  builder.advance();
+
+  entities[2].set<NetBody>({.flags = 100});
+  entities[4].remove<Marker>();
+  entities[6].destruct();
+  builder.capture(world);
+
+  // Raw, so both paths have to agree byte for byte.
+  auto raw_codec = ox::SnapshotCodec{};
+  const auto baseline = builder.baseline(static_cast<ox::NetClientID>(1));
+  const auto& delta = builder.flat_delta(baseline);
+  auto from_delta = std::vector<u8>{};
+  ASSERT_TRUE(raw_codec.encode(delta, builder.current_sequence, baseline, from_delta));
+
+  auto expected = ox::SceneState{};
+  delta.to_state(expected);
+
+  auto sequence = 0_u8;
+  auto decoded_baseline = ox::option<u8>{};
+  auto decoded = ox::SceneState{};
+  ASSERT_TRUE(raw_codec.decode(from_delta, sequence, decoded_baseline, decoded));
+  EXPECT_EQ(decoded_baseline, baseline);
+  EXPECT_EQ(decoded.removed_entities, expected.removed_entities);
+  ASSERT_EQ(decoded.entities.size(), expected.entities.size());
+  for (const auto& [entity, entity_state] : expected.entities) {
+    ASSERT_TRUE(decoded.entities.contains(entity));
+    const auto& decoded_entity = decoded.entities.at(entity);
+    EXPECT_EQ(decoded_entity.removed_components, entity_state.removed_components);
+    ASSERT_EQ(decoded_entity.components.size(), entity_state.components.size());
+    for (const auto& [id, component] : entity_state.components) {
+      ASSERT_TRUE(decoded_entity.components.contains(id));
+      EXPECT_EQ(decoded_entity.components.at(id).buffer, component.buffer);
+    }
+  }
+
+  EXPECT_TRUE(decoded.removed_entities.contains(entities[6].id()));
+  EXPECT_TRUE(decoded.entities.at(entities[4].id()).removed_components.contains(marker_id));
+}
+
+TEST(BitStreamTest, MixedWidthsRoundTrip) {
+  auto writer = ox::BitWriter{};
+  writer.write_bits(5, 3);
+  writer.write_bool(true);
+  writer.write_varint(300);
+  writer.write_zigzag(-123456789);
+  writer.write_bits(0xabcd, 16);
+  const auto flushed = writer.flush();
+  const auto bytes = std::vector<u8>(flushed.begin(), flushed.end());
+
+  auto reader = ox::BitReader{.bytes = bytes};
+  EXPECT_EQ(reader.read_bits(3), 5_u64);
+  EXPECT_TRUE(reader.read_bool());
+  EXPECT_EQ(reader.read_varint(), 300_u64);
+  EXPECT_EQ(reader.read_zigzag(), -123456789_i64);
+  EXPECT_EQ(reader.read_bits(16), 0xabcd_u64);
+  EXPECT_FALSE(reader.failed);
+
+  std::ignore = reader.read_bits(16);
+  EXPECT_TRUE(reader.failed);
+}
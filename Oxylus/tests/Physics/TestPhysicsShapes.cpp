@@ -0,0 +1,43 @@
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+
+#include "Physics/Physics.hpp"
+#include "Physics/PhysicsShapes.hpp"
+
+namespace {
+auto write_file(const std::filesystem::path& path, std::string_view contents) -> void {
+  auto stream = std::ofstream(path, std::ios::binary | std::ios::trunc);
+  stream.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+}
+} // namespace
+
+TEST(PhysicsShapesTest, SourceHashCoversExternalBuffers) {
+  const auto dir = std::filesystem::temp_directory_path() / "ox_physics_shapes_test";
+  std::filesystem::create_directories(dir);
+  const auto model_path = dir / "model.gltf";
+  write_file(model_path, R"({"asset":{"version":"2.0"},"buffers":[{"uri":"model.bin","byteLength":4}]})");
+  write_file(dir / "model.bin", "abcd");
+
+  const auto first = ox::hash_shape_source(model_path);
+  EXPECT_EQ(ox::hash_shape_source(model_path), first);
+
+  // Only the buffer changes, the bake is stale all the same.
+  write_file(dir / "model.bin", "abce");
+  EXPECT_NE(ox::hash_shape_source(model_path), first);
+
+  EXPECT_EQ(ox::baked_shapes_path(model_path), dir / "model.gltf.oxshapes");
+  std::filesystem::remove_all(dir);
+}
+
+TEST(PhysicsShapesTest, EqualShapeKeysHashTheSame) {
+  auto positive = ox::ShapeKey{.dimensions = {1.0f, 2.0f, 3.0f}, .offset = {0.0f, 0.0f, 0.0f}};
+  auto negative = positive;
+  negative.offset = {-0.0f, 0.0f, -0.0f};
+
+  ASSERT_EQ(positive, negative);
+  EXPECT_EQ(ox::ShapeKeyHash{}(positive), ox::ShapeKeyHash{}(negative));
+
+  negative.offset.y = 0.5f;
+  EXPECT_NE(ox::ShapeKeyHash{}(positive), ox::ShapeKeyHash{}(negative));
+}
@@ -0,0 +1,91 @@
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+#include "Core/JobManager.hpp"
+#include "Scene/SceneGPU.hpp"
+#include "Utils/RadixSort.hpp"
+
+namespace {
+struct Pair {
+  u32 key = 0;
+  u32 value = 0;
+};
+
+// Few distinct keys, so stability shows.
+auto random_pairs(usize count, u32 seed) -> std::vector<Pair> {
+  auto rng = std::mt19937(seed);
+  auto dist = std::uniform_int_distribution<u32>(0, 4096);
+  auto pairs = std::vector<Pair>(count);
+  for (auto i = 0_sz; i < count; i++) {
+    pairs[i] = {.key = dist(rng) * 0x10001_u32, .value = static_cast<u32>(i)};
+  }
+
+  return pairs;
+}
+
+auto expect_radix_sorts(const std::vector<Pair>& pairs, ox::JobManager* job_manager) -> void {
+  auto keys = std::vector<u32>();
+  auto values = std::vector<u32>();
+  for (const auto& pair : pairs) {
+    keys.push_back(pair.key);
+    values.push_back(pair.value);
+  }
+  auto scratch_keys = std::vector<u32>(pairs.size());
+  auto scratch_values = std::vector<u32>(pairs.size());
+  ox::radix_sort_pairs(keys, values, scratch_keys, scratch_values, job_manager);
+
+  auto expected = pairs;
+  std::ranges::stable_sort(expected, std::less{}, &Pair::key);
+  for (auto i = 0_sz; i < pairs.size(); i++) {
+    ASSERT_EQ(keys[i], expected[i].key) << i;
+    ASSERT_EQ(values[i], expected[i].value) << i;
+  }
+}
+} // namespace
+
+TEST(RadixSortTest, MatchesStableSort) {
+  expect_radix_sorts({}, nullptr);
+  expect_radix_sorts(random_pairs(1, 1), nullptr);
+  expect_radix_sorts(random_pairs(1'000, 2), nullptr);
+  // Every digit the same, all passes are skipped.
+  expect_radix_sorts(std::vector<Pair>(100, Pair{.key = 7}), nullptr);
+}
+
+TEST(RadixSortTest, ParallelMatchesStableSort) {
+  auto job_manager = ox::JobManager();
+  job_manager.set_thread_count(3);
+  ASSERT_TRUE(job_manager.init().has_value());
+
+  expect_radix_sorts(random_pairs(ox::RADIX_SORT_PARALLEL_MIN * 4 + 17, 3), &job_manager);
+
+  ASSERT_TRUE(job_manager.deinit().has_value());
+}
+
+TEST(RenderQueue2DTest, SortsBackToFrontAndKeepsInsertionOrderOfTies) {
+  auto rng = std::mt19937(4);
+  auto distance = std::uniform_int_distribution<i32>(0, 8);
+  auto y = std::uniform_real_distribution<f32>(-10.0f, 10.0f);
+
+  auto queue = ox::GPU::RenderQueue2D();
+  for (auto frame = 0; frame < 2; frame++) {
+    queue.init();
+    for (auto i = 0_u32; i < 5'000; i++) {
+      const auto flags = static_cast<u16>(i % 3 == 0 ? ox::GPU::RENDER_FLAGS_2D_SORT_Y : 0);
+      queue.add(flags, y(rng), i, i % 16, static_cast<f32>(distance(rng)));
+    }
+    queue.update();
+    queue.sort();
+
+    ASSERT_EQ(queue.sprite_data.size(), 5'000_sz);
+    EXPECT_TRUE(std::ranges::is_sorted(queue.sprite_data, std::greater<ox::GPU::SpriteGPUData>()));
+    for (auto i = 1_sz; i < queue.sprite_data.size(); i++) {
+      const auto& previous = queue.sprite_data[i - 1];
+      const auto& sprite = queue.sprite_data[i];
+      if (previous.sort_key() == sprite.sort_key()) {
+        EXPECT_LT(previous.transform_id, sprite.transform_id);
+      }
+    }
+  }
+}
@@ -1,28 +1,37 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include "Asset/AssetManager.hpp"
 #include "Core/App.hpp"
+#include "Physics/Physics.hpp"
 #include "Scene/Scene.hpp"
+#include "TestHelpers.hpp"
 
 class SceneTest : public ::testing::Test {
 protected:
-  void SetUp() override {
+  // Headless, so the whole thing runs without a window or a GPU.
+  static void SetUpTestSuite() {
+    static char name[] = "TestScene";
+    static char* argv[] = {name};
+    app = std::make_unique<ox::App>(1, argv);
     loguru::g_stderr_verbosity = loguru::Verbosity_WARNING; // only stdout errors from oxylus
 
-    // app = create_test_app();
-    // scene = create_test_scene();
+    app->with_headless(60.0).with<ox::AssetManager>().with<ox::Physics>().init();
   }
 
-  void TearDown() override {
-    // scene.reset();
-    // app.reset();
+  static void TearDownTestSuite() {
+    app->stop();
+    app.reset();
   }
 
-  std::unique_ptr<ox::App> app = nullptr;
+  void SetUp() override { scene = create_test_scene(); }
+
+  void TearDown() override { scene.reset(); }
+
+  static inline std::unique_ptr<ox::App> app = nullptr;
   std::unique_ptr<ox::Scene> scene = nullptr;
 };
 
-#if 0
 TEST_F(SceneTest, DidRun) {
   bool did_run = false;
   scene->runtime_start();
@@ -31,5 +40,24 @@ TEST_F(SceneTest, DidRun) {
 
   EXPECT_TRUE(did_run);
 }
-#endif
 
+TEST_F(SceneTest, HeadlessAppHasNoRenderContext) {
+  EXPECT_TRUE(app->is_headless());
+  EXPECT_FALSE(ox::App::has_rendercontext());
+  EXPECT_EQ(scene->get_renderer_instance(), nullptr);
+}
+
+TEST_F(SceneTest, RuntimeUpdateRunsHeadless) {
+  auto entity = scene->create_entity("Moved");
+  scene->runtime_start();
+
+  for (auto i = 0; i < 3; i++) {
+    entity.get_mut<ox::TransformComponent>().position.x += 1.0f;
+    app->step();
+    scene->runtime_update(ox::App::get_timestep());
+  }
+
+  EXPECT_FLOAT_EQ(entity.get<ox::TransformComponent>().position.x, 3.0f);
+  EXPECT_DOUBLE_EQ(ox::App::get_timestep().get_millis(), 1000.0 / 60.0);
+  scene->runtime_stop();
+}
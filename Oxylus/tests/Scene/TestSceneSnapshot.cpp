@@ -0,0 +1,252 @@
+#include <cstring>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "Scene/Components.hpp"
+#include "Scene/SceneSnapshot.hpp"
+
+namespace {
+struct Position {
+  f32 x = 0.0f;
+  f32 y = 0.0f;
+};
+
+struct Health {
+  i32 value = 0;
+};
+
+struct Player {};
+
+struct NotNetworked {
+  u32 value = 0;
+};
+} // namespace
+
+class SceneSnapshotTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    world.component<Position>().add<ox::Networked>();
+    world.component<Health>().add<ox::Networked>();
+    world.component<Player>().add<ox::Networked>();
+    world.component<NotNetworked>();
+  }
+
+  // Captures the current world and returns its delta against the client's baseline, then acks it.
+  auto send(ox::NetClientID client_id = CLIENT) -> ox::SceneState {
+    builder.capture(world);
+    auto state = builder.delta(client_id);
+    builder.ack(client_id, builder.current_sequence);
+    builder.advance();
+    return state;
+  }
+
+  constexpr static auto CLIENT = static_cast<ox::NetClientID>(1);
+  constexpr static auto OTHER_CLIENT = static_cast<ox::NetClientID>(2);
+
+  template <typename T>
+  auto id_of() -> flecs::id_t {
+    return world.component<T>().id();
+  }
+
+  flecs::world world = {};
+  ox::SceneSnapshotBuilder builder = {};
+};
+
+TEST_F(SceneSnapshotTest, FirstSnapshotContainsEveryNetworkedComponent) {
+  auto a = world.entity().set<Position>({1.0f, 2.0f}).set<Health>({10}).add<Player>();
+  auto b = world.entity().set<Position>({3.0f, 4.0f}).set<NotNetworked>({5});
+
+  const auto state = send();
+  ASSERT_EQ(state.entities.size(), 2_sz);
+  EXPECT_TRUE(state.removed_entities.empty());
+
+  const auto& a_state = state.entities.at(a.id());
+  EXPECT_EQ(a_state.components.size(), 3_sz);
+  EXPECT_EQ(a_state.components.at(id_of<Player>()).hash, ~0_u64);
+  EXPECT_TRUE(a_state.components.at(id_of<Player>()).buffer.empty());
+
+  const auto& position = a_state.components.at(id_of<Position>()).buffer;
+  ASSERT_EQ(position.size(), sizeof(Position));
+  auto a_position = Position{};
+  std::memcpy(&a_position, position.data(), sizeof(Position));
+  EXPECT_EQ(a_position.y, 2.0f);
+
+  const auto& b_state = state.entities.at(b.id());
+  EXPECT_EQ(b_state.components.size(), 1_sz);
+  EXPECT_FALSE(b_state.components.contains(id_of<NotNetworked>()));
+}
+
+TEST_F(SceneSnapshotTest, UnchangedWorldProducesEmptyDelta) {
+  for (auto i = 0; i < 200; i++) {
+    world.entity().set<Position>({static_cast<f32>(i), 0.0f}).set<Health>({i});
+  }
+
+  std::ignore = send();
+  const auto state = send();
+  EXPECT_TRUE(state.entities.empty());
+  EXPECT_TRUE(state.removed_entities.empty());
+}
+
+TEST_F(SceneSnapshotTest, OnlyChangedComponentsAreSent) {
+  auto entities = std::vector<flecs::entity>{};
+  for (auto i = 0; i < 200; i++) {
+    entities.push_back(world.entity().set<Position>({static_cast<f32>(i), 0.0f}).set<Health>({i}));
+  }
+
+  std::ignore = send();
+
+  // Rows in different chunks of the same column.
+  entities[3].set<Position>({-1.0f, -1.0f});
+  entities[150].set<Health>({-150});
+
+  const auto state = send();
+  ASSERT_EQ(state.entities.size(), 2_sz);
+  EXPECT_THAT(state.entities.at(entities[3].id()).components, testing::SizeIs(1));
+  EXPECT_TRUE(state.entities.at(entities[3].id()).components.contains(id_of<Position>()));
+  EXPECT_TRUE(state.entities.at(entities[150].id()).components.contains(id_of<Health>()));
+}
+
+TEST_F(SceneSnapshotTest, CreatedAndDestroyedEntitiesAreTracked) {
+  auto kept = world.entity().set<Position>({1.0f, 1.0f});
+  auto destroyed = world.entity().set<Position>({2.0f, 2.0f});
+
+  std::ignore = send();
+
+  destroyed.destruct();
+  auto created = world.entity().set<Position>({3.0f, 3.0f});
+
+  const auto state = send();
+  EXPECT_THAT(state.removed_entities, testing::UnorderedElementsAre(destroyed.id()));
+  ASSERT_EQ(state.entities.size(), 1_sz);
+  EXPECT_TRUE(state.entities.contains(created.id()));
+  EXPECT_FALSE(state.entities.contains(kept.id()));
+}
+
+TEST_F(SceneSnapshotTest, TableMovesOnlySendDifferences) {
+  auto entity = world.entity().set<Position>({1.0f, 1.0f}).set<Health>({5});
+
+  std::ignore = send();
+
+  // Moves the entity to another table without touching the networked data.
+  entity.set<NotNetworked>({1});
+  auto state = send();
+  EXPECT_TRUE(state.entities.empty());
+
+  entity.remove<Health>().add<Player>();
+  state = send();
+  ASSERT_EQ(state.entities.size(), 1_sz);
+
+  const auto& entity_state = state.entities.at(entity.id());
+  EXPECT_THAT(entity_state.removed_components, testing::UnorderedElementsAre(id_of<Health>()));
+  ASSERT_EQ(entity_state.components.size(), 1_sz);
+  EXPECT_TRUE(entity_state.components.contains(id_of<Player>()));
+}
+
+TEST_F(SceneSnapshotTest, DeltaIsAgainstLastAckedFrame) {
+  auto entity = world.entity().set<Health>({1});
+
+  std::ignore = send();
+
+  // Never acked, the next delta still has to carry this change.
+  entity.set<Health>({2});
+  builder.capture(world);
+  builder.advance();
+
+  builder.capture(world);
+  const auto state = builder.delta(CLIENT);
+  ASSERT_TRUE(state.entities.contains(entity.id()));
+  EXPECT_TRUE(state.entities.at(entity.id()).components.contains(id_of<Health>()));
+}
+
+TEST_F(SceneSnapshotTest, ClientsHaveIndependentBaselines) {
+  auto entity = world.entity().set<Health>({1});
+
+  std::ignore = send(CLIENT);
+  EXPECT_TRUE(builder.baseline(CLIENT).has_value());
+  EXPECT_FALSE(builder.baseline(OTHER_CLIENT).has_value());
+
+  builder.capture(world);
+  EXPECT_TRUE(builder.delta(CLIENT).entities.empty());
+  // A client that never acked anything gets everything, without affecting the other one.
+  EXPECT_TRUE(builder.delta(OTHER_CLIENT).entities.contains(entity.id()));
+
+  builder.remove_client(CLIENT);
+  EXPECT_FALSE(builder.baseline(CLIENT).has_value());
+}
+
+TEST_F(SceneSnapshotTest, StaleAcksDontMoveBaselineBackwards) {
+  world.entity().set<Health>({1});
+
+  builder.capture(world);
+  const auto first = builder.current_sequence;
+  builder.advance();
+  builder.capture(world);
+  const auto second = builder.current_sequence;
+  builder.advance();
+
+  builder.ack(CLIENT, second);
+  builder.ack(CLIENT, first); // arrived late
+  ASSERT_TRUE(builder.baseline(CLIENT).has_value());
+  EXPECT_EQ(builder.baseline(CLIENT).value(), second);
+}
+
+TEST_F(SceneSnapshotTest, BaselineExpiresWhenRingWrapsAround) {
+  world.entity().set<Health>({1});
+
+  std::ignore = send();
+  ASSERT_TRUE(builder.baseline(CLIENT).has_value());
+
+  for (auto i = 0_u32; i < ox::SceneSnapshotBuilder::MAX_SEQUENCES; i++) {
+    builder.capture(world);
+    builder.advance();
+  }
+
+  EXPECT_FALSE(builder.baseline(CLIENT).has_value());
+}
+
+TEST_F(SceneSnapshotTest, FlatDeltaPointsIntoTheFrame) {
+  auto entities = std::vector<flecs::entity>{};
+  for (auto i = 0; i < 16; i++) {
+    entities.push_back(world.entity().set<Position>({static_cast<f32>(i), 0.0f}).add<Player>());
+  }
+
+  builder.capture(world);
+  const auto& delta = builder.flat_delta(ox::nullopt);
+  ASSERT_EQ(delta.frame, &builder.current());
+  ASSERT_EQ(delta.records.size(), 32_sz);
+  for (const auto& record : delta.records) {
+    EXPECT_FALSE(record.removed);
+    if (record.component_id == id_of<Player>()) {
+      EXPECT_EQ(record.size, 0_u32);
+      continue;
+    }
+
+    auto position = Position{};
+    ASSERT_EQ(delta.bytes(record).size(), sizeof(Position));
+    std::memcpy(&position, delta.bytes(record).data(), sizeof(Position));
+    EXPECT_EQ(position.x, world.entity(record.entity).get<Position>().x);
+  }
+
+  builder.ack(CLIENT, builder.current_sequence);
+  builder.advance();
+
+  // Steady state deltas reuse the same storage.
+  const auto* records = delta.records.data();
+  entities[3].set<Position>({100.0f, 0.0f});
+  entities[9].destruct();
+  builder.capture(world);
+  const auto& next = builder.flat_delta(builder.baseline(CLIENT));
+  EXPECT_EQ(&next, &delta);
+  EXPECT_EQ(next.records.data(), records);
+  ASSERT_EQ(next.records.size(), 1_sz);
+  EXPECT_EQ(next.records[0].entity, entities[3].id());
+  EXPECT_EQ(next.removed_entities, (std::vector<flecs::entity_t>{entities[9].id()}));
+
+  // The per entity view is only built on request.
+  auto state = ox::SceneState{};
+  next.to_state(state);
+  ASSERT_TRUE(state.entities.contains(entities[3].id()));
+  EXPECT_TRUE(state.entities.at(entities[3].id()).components.contains(id_of<Position>()));
+  EXPECT_TRUE(state.removed_entities.contains(entities[9].id()));
+}
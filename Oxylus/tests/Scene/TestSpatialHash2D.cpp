@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+#include "Scene/SpatialHash2D.hpp"
+
+namespace {
+auto box(glm::vec2 center, glm::vec2 size, f32 z = 0.0f) -> ox::AABB {
+  return ox::AABB(glm::vec3(center - size * 0.5f, z), glm::vec3(center + size * 0.5f, z));
+}
+
+auto query(const ox::SpatialHash2D& grid, glm::vec2 min, glm::vec2 max) -> std::vector<u64> {
+  auto ids = std::vector<u64>();
+  grid.query(min, max, ids);
+  std::ranges::sort(ids);
+  return ids;
+}
+} // namespace
+
+TEST(SpatialHash2DTest, FindsWhatOverlapsTheRect) {
+  auto grid = ox::SpatialHash2D(4.0f);
+  grid.insert_or_update(1, box({0.0f, 0.0f}, {1.0f, 1.0f}));
+  grid.insert_or_update(2, box({10.0f, 0.0f}, {1.0f, 1.0f}));
+  // Centered in one cell, reaching well into the next.
+  grid.insert_or_update(3, box({3.9f, -20.0f}, {7.0f, 1.0f}));
+
+  EXPECT_EQ(grid.size(), 3_sz);
+  EXPECT_EQ(query(grid, {-1.0f, -1.0f}, {1.0f, 1.0f}), (std::vector<u64>{1}));
+  EXPECT_EQ(query(grid, {-1.0f, -1.0f}, {12.0f, 1.0f}), (std::vector<u64>{1, 2}));
+  EXPECT_EQ(query(grid, {0.0f, -21.0f}, {0.5f, -19.0f}), (std::vector<u64>{3}));
+  EXPECT_TRUE(query(grid, {100.0f, 100.0f}, {101.0f, 101.0f}).empty());
+}
+
+TEST(SpatialHash2DTest, MovesAndRemovesItems) {
+  auto grid = ox::SpatialHash2D(4.0f);
+  grid.insert_or_update(1, box({0.0f, 0.0f}, {1.0f, 1.0f}));
+  grid.insert_or_update(2, box({0.5f, 0.5f}, {1.0f, 1.0f}));
+
+  // Inside its cell, then into another one.
+  grid.insert_or_update(1, box({1.0f, 1.0f}, {1.0f, 1.0f}));
+  EXPECT_EQ(query(grid, {0.6f, 0.6f}, {0.9f, 0.9f}), (std::vector<u64>{1, 2}));
+  grid.insert_or_update(1, box({50.0f, 50.0f}, {1.0f, 1.0f}));
+  EXPECT_EQ(query(grid, {-1.0f, -1.0f}, {1.0f, 1.0f}), (std::vector<u64>{2}));
+  EXPECT_EQ(query(grid, {49.0f, 49.0f}, {51.0f, 51.0f}), (std::vector<u64>{1}));
+
+  // Growing past what a cell holds.
+  grid.insert_or_update(2, box({0.0f, 0.0f}, {100.0f, 100.0f}));
+  EXPECT_EQ(query(grid, {49.0f, 49.0f}, {51.0f, 51.0f}), (std::vector<u64>{1, 2}));
+
+  grid.remove(2);
+  grid.remove(3);
+  EXPECT_FALSE(grid.contains(2));
+  EXPECT_EQ(query(grid, {-100.0f, -100.0f}, {100.0f, 100.0f}), (std::vector<u64>{1}));
+
+  grid.clear();
+  EXPECT_EQ(grid.size(), 0_sz);
+  EXPECT_GT(grid.get_min_z(), grid.get_max_z());
+}
+
+TEST(SpatialHash2DTest, TracksDepth) {
+  auto grid = ox::SpatialHash2D();
+  grid.insert_or_update(1, box({0.0f, 0.0f}, {1.0f, 1.0f}, -2.0f));
+  grid.insert_or_update(2, box({0.0f, 0.0f}, {1.0f, 1.0f}, 3.0f));
+  EXPECT_FLOAT_EQ(grid.get_min_z(), -2.0f);
+  EXPECT_FLOAT_EQ(grid.get_max_z(), 3.0f);
+}
+
+TEST(SpatialHash2DTest, MatchesBruteForce) {
+  auto rng = std::mt19937(5);
+  auto position = std::uniform_real_distribution<f32>(-200.0f, 200.0f);
+  auto size = std::uniform_real_distribution<f32>(0.1f, 12.0f);
+
+  auto grid = ox::SpatialHash2D(8.0f);
+  auto boxes = std::vector<ox::AABB>(2'000);
+  for (auto round = 0; round < 3; round++) {
+    for (auto i = 0_sz; i < boxes.size(); i++) {
+      boxes[i] = box({position(rng), position(rng)}, {size(rng), size(rng)});
+      grid.insert_or_update(i, boxes[i]);
+    }
+
+    for (auto q = 0; q < 50; q++) {
+      const auto min = glm::vec2(position(rng), position(rng));
+      const auto max = min + glm::vec2(size(rng), size(rng)) * static_cast<f32>(q);
+
+      auto expected = std::vector<u64>();
+      for (auto i = 0_sz; i < boxes.size(); i++) {
+        if (boxes[i].min.x <= max.x && boxes[i].max.x >= min.x && boxes[i].min.y <= max.y && boxes[i].max.y >= min.y) {
+          expected.push_back(i);
+        }
+      }
+
+      ASSERT_EQ(query(grid, min, max), expected) << round << " " << q;
+    }
+  }
+}
@@ -0,0 +1,111 @@
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <sol/state.hpp>
+
+#include "Asset/AssetFile.hpp"
+#include "Scripting/LuaBytecode.hpp"
+
+namespace {
+constexpr auto SOURCE = std::string_view("local function twice(x) return x * 2 end\nreturn twice(21)\n");
+
+auto source_bytes(std::string_view source) -> std::span<const u8> {
+  return {reinterpret_cast<const u8*>(source.data()), source.size()};
+}
+
+auto write_text(const std::filesystem::path& path, std::string_view text) -> void {
+  auto stream = std::ofstream(path, std::ios::binary | std::ios::trunc);
+  stream.write(text.data(), static_cast<std::streamsize>(text.size()));
+}
+} // namespace
+
+TEST(LuaBytecodeTest, CompiledChunksRunInBinaryMode) {
+  auto bytecode = ox::compile_script_bytecode(source_bytes(SOURCE), "@twice.lua", true);
+  ASSERT_TRUE(bytecode.has_value()) << bytecode.error();
+  ASSERT_FALSE(bytecode->empty());
+
+  auto state = sol::state();
+  const auto chunk = std::string_view(reinterpret_cast<const char*>(bytecode->data()), bytecode->size());
+  auto result = state.safe_script(chunk, sol::script_pass_on_error, "@twice.lua", sol::load_mode::binary);
+  ASSERT_TRUE(result.valid());
+  EXPECT_EQ(result.get<i32>(), 42);
+
+  // Source must not sneak through the binary path.
+  EXPECT_FALSE(state.safe_script(SOURCE, sol::script_pass_on_error, "@twice.lua", sol::load_mode::binary).valid());
+
+  auto unstripped = ox::compile_script_bytecode(source_bytes(SOURCE), "@twice.lua", false);
+  ASSERT_TRUE(unstripped.has_value());
+  EXPECT_LT(bytecode->size(), unstripped->size());
+}
+
+TEST(LuaBytecodeTest, SyntaxErrorsAreReported) {
+  auto bytecode = ox::compile_script_bytecode(source_bytes("return ("), "@broken.lua", true);
+  ASSERT_FALSE(bytecode.has_value());
+  EXPECT_NE(bytecode.error().find("broken.lua"), std::string::npos);
+}
+
+TEST(LuaBytecodeTest, StaleBytecodeIsRejected) {
+  const auto directory = std::filesystem::temp_directory_path() / "ox_lua_bytecode_test";
+  std::filesystem::create_directories(directory);
+  const auto script_path = directory / "twice.lua";
+  write_text(script_path, SOURCE);
+
+  auto bytecode = ox::compile_script_bytecode(source_bytes(SOURCE), "@twice.lua", true);
+  ASSERT_TRUE(bytecode.has_value());
+  auto file = ox::AssetFile{};
+  file.add_entry(
+    ox::ScriptBytecodeData{
+      .source_hash = ox::hash_script_source(source_bytes(SOURCE)),
+      .bytecode = bytecode.value(),
+    }
+  );
+  ASSERT_TRUE(file.pack(ox::script_bytecode_path(script_path)));
+
+  auto loaded = ox::load_script_bytecode(script_path);
+  ASSERT_TRUE(loaded.has_value());
+  EXPECT_EQ(loaded->bytecode, bytecode.value());
+
+  write_text(script_path, "return 0\n");
+  EXPECT_FALSE(ox::load_script_bytecode(script_path).has_value());
+
+  // Shipped without the source, the chunk is all there is.
+  std::filesystem::remove(script_path);
+  EXPECT_TRUE(ox::load_script_bytecode(script_path).has_value());
+
+  std::filesystem::remove_all(directory);
+}
+
+TEST(LuaBytecodeTest, ParallelDirectiveOnlyCountsInLeadingComments) {
+  EXPECT_TRUE(ox::is_parallel_script("--!parallel\nfunction on_scene_update() end\n"));
+  EXPECT_TRUE(ox::is_parallel_script("-- Moves boids.\n\n  --!parallel  \r\nlocal x = 1\n"));
+  EXPECT_FALSE(ox::is_parallel_script("local x = 1\n--!parallel\n"));
+  EXPECT_FALSE(ox::is_parallel_script("--!parallelize\n"));
+  EXPECT_FALSE(ox::is_parallel_script(""));
+}
+
+TEST(LuaBytecodeTest, PacksOfAnotherVersionAreRejected) {
+  const auto directory = std::filesystem::temp_directory_path() / "ox_lua_bytecode_version_test";
+  std::filesystem::create_directories(directory);
+  const auto script_path = directory / "twice.lua";
+  write_text(script_path, SOURCE);
+
+  auto bytecode = ox::compile_script_bytecode(source_bytes(SOURCE), "@twice.lua", true);
+  ASSERT_TRUE(bytecode.has_value());
+  auto entries = std::vector<ox::AssetFileEntry>();
+  entries.push_back({
+    .type = ox::AssetType::Script,
+    .data = ox::ScriptBytecodeData{.source_hash = ox::hash_script_source(source_bytes(SOURCE)), .bytecode = *bytecode},
+  });
+
+  // Written like `AssetFile::pack` did before entries changed.
+  auto [data, out] = zpp::bits::data_out();
+  ASSERT_FALSE(zpp::bits::failure(out(ox::AssetFileHeader{.version = 1}, entries)));
+  write_text(
+    ox::script_bytecode_path(script_path), std::string_view(reinterpret_cast<const char*>(data.data()), data.size())
+  );
+
+  // The source is used instead.
+  EXPECT_FALSE(ox::load_script_bytecode(script_path).has_value());
+
+  std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,245 @@
+#include <glm/vec3.hpp>
+#include <gtest/gtest.h>
+#include <sol/state.hpp>
+#include <tuple>
+#include <vector>
+
+#include "Scripting/LuaComponentView.hpp"
+
+namespace {
+struct TestVelocity {
+  f32 x = 0.0f;
+  f32 y = 0.0f;
+};
+
+struct TestBody {
+  i32 steps = 0;
+  TestVelocity velocity = {};
+  f64 mass = 0.0;
+};
+
+struct TestTransform {
+  glm::vec3 position = {};
+};
+
+auto register_components(flecs::world& world) -> void {
+  world.component<TestVelocity>("TestVelocity").member("x", &TestVelocity::x).member("y", &TestVelocity::y);
+  world.component<TestBody>("TestBody")
+    .member("steps", &TestBody::steps)
+    .member("velocity", &TestBody::velocity)
+    .member("mass", &TestBody::mass);
+  world.component<glm::vec3>("glm::vec3")
+    .member("x", &glm::vec3::x)
+    .member("y", &glm::vec3::y)
+    .member("z", &glm::vec3::z);
+  world.component<TestTransform>("TestTransform").member("position", &TestTransform::position);
+}
+} // namespace
+
+TEST(LuaComponentViewTest, LayoutIsBuiltOncePerComponent) {
+  auto world = flecs::world();
+  register_components(world);
+
+  const auto* layout = ox::LuaComponentLayout::get(world, world.component<TestBody>());
+  ASSERT_NE(layout, nullptr);
+  EXPECT_EQ(layout, ox::LuaComponentLayout::get(world, world.component<TestBody>()));
+  ASSERT_EQ(layout->fields.size(), 3_sz);
+
+  const auto* steps = layout->find("steps");
+  const auto* velocity = layout->find("velocity");
+  const auto* mass = layout->find("mass");
+  ASSERT_NE(steps, nullptr);
+  ASSERT_NE(velocity, nullptr);
+  ASSERT_NE(mass, nullptr);
+  EXPECT_EQ(steps->kind, ox::LuaFieldKind::I32);
+  EXPECT_EQ(steps->offset, offsetof(TestBody, steps));
+  EXPECT_EQ(mass->kind, ox::LuaFieldKind::F64);
+  EXPECT_EQ(mass->offset, offsetof(TestBody, mass));
+
+  EXPECT_EQ(velocity->kind, ox::LuaFieldKind::Struct);
+  EXPECT_EQ(velocity->offset, offsetof(TestBody, velocity));
+  ASSERT_NE(velocity->layout, nullptr);
+  const auto* y = velocity->layout->find("y");
+  ASSERT_NE(y, nullptr);
+  EXPECT_EQ(y->offset, offsetof(TestVelocity, y));
+
+  EXPECT_EQ(layout->find("missing"), nullptr);
+}
+
+TEST(LuaComponentViewTest, RedefinedComponentsGetANewLayout) {
+  auto world = flecs::world();
+  register_components(world);
+
+  // What `Component.define` does, run twice with a member more the second time.
+  auto scripted = world.component("Scripted");
+  scripted.member<f32>("speed");
+  const auto* before = ox::LuaComponentLayout::get(world, scripted);
+  ASSERT_EQ(before->fields.size(), 1_sz);
+
+  scripted.member<f64>("mass");
+  ox::LuaComponentLayout::invalidate(world, scripted);
+  const auto* after = ox::LuaComponentLayout::get(world, scripted);
+  ASSERT_EQ(after->fields.size(), 2_sz);
+  EXPECT_NE(after->find("mass"), nullptr);
+  // Still readable by whoever held on to it.
+  EXPECT_EQ(before->fields.size(), 1_sz);
+
+  // Layouts with the type nested in them go too, the rest stay.
+  const auto* body = ox::LuaComponentLayout::get(world, world.component<TestBody>());
+  const auto* transform = ox::LuaComponentLayout::get(world, world.component<TestTransform>());
+  ox::LuaComponentLayout::invalidate(world, world.component<TestVelocity>());
+  EXPECT_NE(ox::LuaComponentLayout::get(world, world.component<TestBody>()), body);
+  EXPECT_EQ(ox::LuaComponentLayout::get(world, world.component<TestTransform>()), transform);
+}
+
+TEST(LuaComponentViewTest, ScriptsReadAndWriteComponentMemory) {
+  auto world = flecs::world();
+  register_components(world);
+
+  auto state = sol::state();
+  ox::LuaComponentView::bind(&state);
+
+  auto body = TestBody{.steps = 2, .velocity = {.x = 1.0f, .y = 2.0f}, .mass = 10.0};
+  const auto* layout = ox::LuaComponentLayout::get(world, world.component<TestBody>());
+  state["body"] = ox::LuaComponentView{.ptr = &body, .layout = layout, .is_mutable = true};
+
+  auto result = state.safe_script(R"(
+    body.steps = body.steps + 1
+    body.velocity.y = body.velocity.x * 4
+    body:set_mass(body.mass * 2)
+    return body.component_id
+  )");
+  ASSERT_TRUE(result.valid());
+  EXPECT_EQ(result.get<flecs::entity_t>(), world.component<TestBody>().id());
+  EXPECT_EQ(body.steps, 3);
+  EXPECT_EQ(body.velocity.y, 4.0f);
+  EXPECT_EQ(body.mass, 20.0);
+
+  state["read_only"] = ox::LuaComponentView{.ptr = &body, .layout = layout, .is_mutable = false};
+  EXPECT_FALSE(state.safe_script("read_only.steps = 0", sol::script_pass_on_error).valid());
+  EXPECT_FALSE(state.safe_script("body.missing = 0", sol::script_pass_on_error).valid());
+  EXPECT_EQ(body.steps, 3);
+}
+
+TEST(LuaComponentViewTest, FieldArraysWorkOnTheWholeColumn) {
+  auto world = flecs::world();
+  register_components(world);
+
+  auto state = sol::state();
+  ox::LuaComponentView::bind(&state);
+  ox::LuaComponentColumn::bind(&state);
+
+  auto bodies = std::vector<TestBody>(8);
+  for (auto i = 0_sz; i < bodies.size(); i++) {
+    bodies[i].mass = static_cast<f64>(i);
+  }
+
+  state["bodies"] = ox::LuaComponentColumn{
+    .data = reinterpret_cast<u8*>(bodies.data()),
+    .stride = sizeof(TestBody),
+    .count = static_cast<u32>(bodies.size()),
+    .layout = ox::LuaComponentLayout::get(world, world.component<TestBody>()),
+  };
+
+  auto result = state.safe_script(R"(
+    local mass = bodies:field("mass")
+    mass:add_scaled(mass, 1.0)
+    mass:add(1.0)
+    bodies:at(2).steps = 5
+    return mass:sum(), #mass, mass[3]
+  )");
+  ASSERT_TRUE(result.valid());
+  const auto [sum, count, third] = result.get<std::tuple<f64, i32, f64>>();
+  EXPECT_EQ(sum, 64.0);
+  EXPECT_EQ(count, 8);
+  EXPECT_EQ(third, 7.0);
+  EXPECT_EQ(bodies[2].steps, 5);
+  EXPECT_EQ(bodies[7].mass, 15.0);
+
+  EXPECT_FALSE(state.safe_script("bodies:field('steps'):normalize()", sol::script_pass_on_error).valid());
+  EXPECT_FALSE(state.safe_script("bodies:at(8)", sol::script_pass_on_error).valid());
+}
+
+TEST(LuaComponentViewTest, VectorFieldsUnpackToNumbers) {
+  auto world = flecs::world();
+  register_components(world);
+
+  auto state = sol::state();
+  ox::LuaComponentView::bind(&state);
+
+  auto transform = TestTransform{.position = {1.0f, 2.0f, 3.0f}};
+  const auto* layout = ox::LuaComponentLayout::get(world, world.component<TestTransform>());
+  state["t"] = ox::LuaComponentView{.ptr = &transform, .layout = layout, .is_mutable = true};
+
+  auto result = state.safe_script(R"(
+    local x, y, z = t:position_xyz()
+    t:set_position_xyz(x + 1, y * 2, z - 3)
+    return x + y + z, rawequal(t.set_position_xyz, t.set_position_xyz)
+  )");
+  ASSERT_TRUE(result.valid());
+  const auto [sum, same_closure] = result.get<std::tuple<f64, bool>>();
+  EXPECT_EQ(sum, 6.0);
+  EXPECT_TRUE(same_closure);
+  EXPECT_EQ(transform.position, glm::vec3(2.0f, 4.0f, 0.0f));
+
+  // Suffix has to match the width of the vector.
+  EXPECT_FALSE(state.safe_script("t:position_xy()", sol::script_pass_on_error).valid());
+
+  state["read_only"] = ox::LuaComponentView{.ptr = &transform, .layout = layout, .is_mutable = false};
+  EXPECT_FALSE(state.safe_script("read_only:set_position_xyz(0, 0, 0)", sol::script_pass_on_error).valid());
+  EXPECT_FALSE(state.safe_script("t.set_position_xyz(read_only, 0, 0, 0)", sol::script_pass_on_error).valid());
+  EXPECT_EQ(transform.position.x, 2.0f);
+}
+
+TEST(LuaComponentViewTest, WritesMarkTheComponentModified) {
+  auto world = flecs::world();
+  register_components(world);
+
+  auto state = sol::state();
+  ox::LuaComponentView::bind(&state);
+  ox::LuaComponentColumn::bind(&state);
+
+  auto sets = 0;
+  world.observer<TestBody>().event(flecs::OnSet).each([&](TestBody&) { sets++; });
+  auto first = world.entity().set(TestBody{});
+  auto second = world.entity().set(TestBody{});
+  sets = 0;
+
+  const auto component = world.component<TestBody>().id();
+  const auto* layout = ox::LuaComponentLayout::get(world, component);
+  state["body"] = ox::LuaComponentView{
+    .ptr = &first.get_mut<TestBody>(),
+    .layout = layout,
+    .is_mutable = true,
+    .world = world.c_ptr(),
+    .entity = first.id(),
+    .component = component,
+  };
+  ASSERT_TRUE(state.safe_script(R"(
+    body.steps = 1
+    body.velocity.x = 2
+    body:set_mass(3)
+  )").valid());
+  EXPECT_EQ(sets, 3);
+
+  const auto entities = std::vector<flecs::entity_t>{first.id(), second.id()};
+  auto bodies = std::vector<TestBody>(entities.size());
+  state["bodies"] = ox::LuaComponentColumn{
+    .data = reinterpret_cast<u8*>(bodies.data()),
+    .stride = sizeof(TestBody),
+    .count = static_cast<u32>(bodies.size()),
+    .layout = layout,
+    .world = world.c_ptr(),
+    .entities = entities.data(),
+    .component = component,
+  };
+  sets = 0;
+  ASSERT_TRUE(state.safe_script(R"(
+    bodies:at(1).steps = 4
+    local mass = bodies:field("mass")
+    mass[0] = 1
+    mass:add(1)
+  )").valid());
+  // One for each element write, one per entity for the helper.
+  EXPECT_EQ(sets, 4);
+}
@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+#include <sol/state.hpp>
+
+#include "Scripting/LuaGC.hpp"
+
+namespace {
+auto make_garbage(sol::state& state) -> void {
+  auto result = state.safe_script(R"(
+    for i = 1, 20000 do
+      local t = { i, tostring(i), { i } }
+    end
+  )");
+  ASSERT_TRUE(result.valid());
+}
+} // namespace
+
+TEST(LuaGCTest, StepsFinishCyclesWithinTheirBudget) {
+  auto state = sol::state();
+  state.open_libraries(sol::lib::base);
+
+  auto gc = ox::LuaGC();
+  gc.init(state.lua_state(), {.budget_us = 200.0, .step_kb = 4, .pause = 100});
+  // Keep Lua's own collector out of it, only the frame steps collect.
+  lua_gc(state.lua_state(), LUA_GCSTOP);
+  make_garbage(state);
+  const auto heap_with_garbage = state.memory_used();
+
+  for (auto frame = 0; frame < 10'000 && gc.stats.completed_cycles == 0; frame++) {
+    gc.step(state.lua_state());
+    EXPECT_GT(gc.stats.steps, 0_u32);
+    // One step may run over, but not by a whole extra frame's worth.
+    EXPECT_LT(gc.stats.step_us, 200.0 * 20.0);
+  }
+
+  EXPECT_EQ(gc.stats.completed_cycles, 1_u64);
+  EXPECT_EQ(gc.stats.full_collections, 0_u64);
+  EXPECT_LT(gc.stats.heap_bytes, heap_with_garbage);
+  EXPECT_FALSE(gc.in_cycle);
+}
+
+TEST(LuaGCTest, IdleHeapIsLeftAlone) {
+  auto state = sol::state();
+  state.open_libraries(sol::lib::base);
+
+  auto gc = ox::LuaGC();
+  gc.init(state.lua_state(), {.pause = 200});
+  gc.full_collect(state.lua_state());
+  EXPECT_EQ(gc.stats.full_collections, 1_u64);
+
+  // Nothing allocated since the collection, the heap is nowhere near twice its size.
+  gc.step(state.lua_state());
+  EXPECT_EQ(gc.stats.steps, 0_u32);
+  EXPECT_EQ(gc.stats.completed_cycles, 1_u64);
+}
@@ -0,0 +1,149 @@
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <gtest/gtest.h>
+#include <sol/state.hpp>
+
+#include "Scripting/LuaComponentView.hpp"
+#include "Scripting/LuaMathBindings.hpp"
+
+namespace {
+struct TestTransform {
+  glm::vec3 position = {};
+};
+
+auto bind_math(sol::state& state) -> void {
+  state.open_libraries(sol::lib::base, sol::lib::math);
+  ox::MathBinding().bind(&state);
+}
+
+// Heap growth of calling `fn` with the collector stopped, nothing it allocates can be freed meanwhile.
+auto allocated_bytes(sol::state& state, const sol::protected_function& fn) -> usize {
+  state.collect_garbage();
+  state.stop_gc();
+  const auto before = state.memory_used();
+  const auto result = fn();
+  const auto after = state.memory_used();
+  state.restart_gc();
+  EXPECT_TRUE(result.valid());
+
+  return after - before;
+}
+} // namespace
+
+TEST(LuaMathBindingsTest, InPlaceOperatorsWriteIntoTheReceiver) {
+  auto state = sol::state();
+  bind_math(state);
+
+  auto result = state.safe_script(R"(
+    local a = vec3.new(1, 2, 3)
+    -- Same userdata, not a copy of it.
+    local alias = a
+    local returned = a:add_(vec3.new(1, 1, 1))
+    a:add_(1)
+    a:sub_(vec3.new(0, 1, 2))
+    a:sub_(0.5)
+    a:mul_(vec3.new(2, 1, 0.5))
+    a:mul_(2)
+    a:div_(vec3.new(1, 2, 4))
+    a:div_(0.5)
+    return alias, returned == nil
+  )");
+  ASSERT_TRUE(result.valid());
+  const auto [alias, returned_nothing] = result.get<std::tuple<glm::vec3, bool>>();
+  EXPECT_TRUE(returned_nothing);
+  // ((1, 2, 3) + 1 + 1 - (0, 1, 2) - 0.5) * (2, 1, 0.5) * 2 / (1, 2, 4) / 0.5
+  EXPECT_EQ(alias, glm::vec3(20.0f, 5.0f, 1.25f));
+
+  result = state.safe_script(R"(
+    local a = vec2.new(1, 2)
+    local b = vec2.new(5, 6)
+    a:copy_(b)
+    b:set(0, 0)
+    local c = vec4.new(1, 1, 1, 1)
+    c:mul_(vec4.new(1, 2, 3, 4))
+    return a, c
+  )");
+  ASSERT_TRUE(result.valid());
+  const auto [copied, multiplied] = result.get<std::tuple<glm::vec2, glm::vec4>>();
+  EXPECT_EQ(copied, glm::vec2(5.0f, 6.0f));
+  EXPECT_EQ(multiplied, glm::vec4(1.0f, 2.0f, 3.0f, 4.0f));
+}
+
+TEST(LuaMathBindingsTest, FloatHelpers) {
+  auto state = sol::state();
+  bind_math(state);
+
+  auto result = state.safe_script(R"(
+    local velocity = vec3.new(1, 0, 0)
+    velocity:add_scaled_(vec3.new(0, -10, 0), 0.5)
+
+    local blend = vec3.new(0, 0, 0)
+    blend:lerp_(vec3.new(4, 8, 2), 0.25)
+
+    local direction = vec3.new(3, 0, 4)
+    local length = direction:length()
+    direction:normalize_()
+
+    local axis = vec3.new(1, 0, 0)
+    axis:cross_(vec3.new(0, 1, 0))
+
+    local x, y, z = velocity:unpack()
+    return velocity, blend, direction, axis, length, vec3.new(1, 2, 3):dot(vec3.new(4, 5, 6)), x + y + z
+  )");
+  ASSERT_TRUE(result.valid());
+  const auto [velocity, blend, direction, axis, length, dot, sum] =
+    result.get<std::tuple<glm::vec3, glm::vec3, glm::vec3, glm::vec3, f32, f32, f32>>();
+  EXPECT_EQ(velocity, glm::vec3(1.0f, -5.0f, 0.0f));
+  EXPECT_EQ(blend, glm::vec3(1.0f, 2.0f, 0.5f));
+  EXPECT_FLOAT_EQ(length, 5.0f);
+  EXPECT_FLOAT_EQ(direction.x, 0.6f);
+  EXPECT_FLOAT_EQ(direction.z, 0.8f);
+  EXPECT_EQ(axis, glm::vec3(0.0f, 0.0f, 1.0f));
+  EXPECT_FLOAT_EQ(dot, 32.0f);
+  EXPECT_FLOAT_EQ(sum, -4.0f);
+}
+
+TEST(LuaMathBindingsTest, InPlaceAndUnpackedFormsDontAllocate) {
+  auto state = sol::state();
+  bind_math(state);
+  ox::LuaComponentView::bind(&state);
+
+  auto world = flecs::world();
+  world.component<glm::vec3>("glm::vec3")
+    .member("x", &glm::vec3::x)
+    .member("y", &glm::vec3::y)
+    .member("z", &glm::vec3::z);
+  world.component<TestTransform>("TestTransform").member("position", &TestTransform::position);
+  auto transform = TestTransform{};
+  const auto* layout = ox::LuaComponentLayout::get(world, world.component<TestTransform>());
+  state["t"] = ox::LuaComponentView{.ptr = &transform, .layout = layout, .is_mutable = true};
+
+  ASSERT_TRUE(state.safe_script(R"(
+    position = vec3.new(0, 0, 0)
+    velocity = vec3.new(1, 2, 3)
+
+    function in_place()
+      for i = 1, 1000 do
+        position:add_scaled_(velocity, 0.5)
+        position:mul_(0.5)
+        local x, y, z = t:position_xyz()
+        t:set_position_xyz(x + 1, y, z)
+      end
+    end
+
+    function operators()
+      for i = 1, 1000 do
+        position = position + velocity * 0.5
+      end
+    end
+  )").valid());
+
+  // The first call caches method lookups and closures.
+  std::ignore = allocated_bytes(state, state["in_place"]);
+  EXPECT_EQ(allocated_bytes(state, state["in_place"]), 0_sz);
+  EXPECT_EQ(transform.position.x, 2000.0f);
+
+  // The operators make a userdata per result, which is what the in-place forms are for.
+  EXPECT_GT(allocated_bytes(state, state["operators"]), 1000_sz);
+}
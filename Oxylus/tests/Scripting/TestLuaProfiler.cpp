@@ -0,0 +1,202 @@
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <sol/state.hpp>
+
+#include "Scripting/LuaProfiler.hpp"
+
+namespace {
+constexpr auto SCRIPT = R"(local function spin(n)
+  local x = 0
+  for i = 1, n do
+    x = x + i % 7
+  end
+  return x
+end
+
+function busy()
+  local x = spin(200000)
+  return x
+end
+
+function allocate()
+  local t = {}
+  for i = 1, 2000 do
+    t[i] = { i }
+  end
+  return #t
+end
+
+function tiny()
+  return 1
+end
+)";
+
+auto load(sol::state& state) -> void {
+  state.open_libraries(sol::lib::base);
+  auto result = state.safe_script(SCRIPT, sol::script_pass_on_error, "@busy.lua");
+  ASSERT_TRUE(result.valid());
+}
+
+auto call(ox::LuaProfiler& profiler, sol::state& state, const char* function) -> void {
+  const auto profile_call = ox::LuaProfileCall(&profiler, "busy.lua", function);
+  sol::protected_function fn = state[function];
+  ASSERT_TRUE(fn().valid());
+}
+
+auto find_function(const ox::LuaProfileFrame& frame, std::string_view prefix) -> const ox::LuaFunctionCost* {
+  for (const auto& function : frame.functions) {
+    if (function.name.starts_with(prefix)) {
+      return &function;
+    }
+  }
+
+  return nullptr;
+}
+
+class LuaProfilerTest : public testing::Test {
+protected:
+  void SetUp() override {
+    ox::LuaProfiler::reset();
+    ox::LuaProfiler::set_enabled(true);
+  }
+
+  void TearDown() override { ox::LuaProfiler::reset(); }
+};
+} // namespace
+
+TEST_F(LuaProfilerTest, AttributesTimeToFunctionsAndLines) {
+  // Outlives the state, closing it goes through the profiler's allocator.
+  auto profiler = ox::LuaProfiler();
+  auto state = sol::state();
+  load(state);
+  profiler.attach(state.lua_state(), {.sample_interval = 100});
+
+  call(profiler, state, "busy");
+  ox::LuaProfiler::end_frame();
+
+  const auto* frame = ox::LuaProfiler::last_frame();
+  ASSERT_NE(frame, nullptr);
+  EXPECT_GT(frame->total.samples, 0_u64);
+  EXPECT_GT(frame->total.ms, 0.0);
+
+  ASSERT_FALSE(frame->functions.empty());
+  EXPECT_TRUE(frame->functions.front().name.starts_with("spin (busy.lua:1)"));
+
+  // Called from C++, it is named after the call.
+  const auto* busy = find_function(*frame, "busy (busy.lua:9)");
+  ASSERT_NE(busy, nullptr);
+  EXPECT_GE(busy->total.ms, frame->functions.front().self.ms);
+
+  ASSERT_EQ(frame->scripts.size(), 1_sz);
+  EXPECT_EQ(frame->scripts.front().name, "busy.lua");
+  EXPECT_DOUBLE_EQ(frame->scripts.front().cost.ms, frame->total.ms);
+
+  ASSERT_FALSE(frame->stacks.empty());
+  EXPECT_TRUE(frame->stacks.front().name.starts_with("busy.lua;busy (busy.lua:9);spin (busy.lua:1);busy.lua:"));
+  ASSERT_FALSE(frame->lines.empty());
+  EXPECT_TRUE(frame->lines.front().name.starts_with("busy.lua:"));
+}
+
+TEST_F(LuaProfilerTest, ChargesAllocationsToTheCallingFunction) {
+  auto profiler = ox::LuaProfiler();
+  auto state = sol::state();
+  load(state);
+  profiler.attach(state.lua_state(), {.sample_interval = 100});
+
+  // Nothing outside a call is the scripts' cost.
+  ASSERT_TRUE(state.safe_script("garbage = {} for i = 1, 1000 do garbage[i] = { i } end").valid());
+  call(profiler, state, "allocate");
+  ox::LuaProfiler::end_frame();
+
+  const auto* frame = ox::LuaProfiler::last_frame();
+  ASSERT_NE(frame, nullptr);
+  // 2000 tables and the array holding them.
+  EXPECT_GT(frame->total.alloc_bytes, 2000_u64 * 32);
+
+  const auto* allocate = find_function(*frame, "allocate (busy.lua:14)");
+  ASSERT_NE(allocate, nullptr);
+  EXPECT_EQ(allocate->total.alloc_bytes, frame->total.alloc_bytes);
+
+  profiler.detach();
+  EXPECT_EQ(ox::LuaProfiler::from_state(state.lua_state()), nullptr);
+}
+
+TEST_F(LuaProfilerTest, ShortCallsKeepTheirRootAndDisabledFramesAreSkipped) {
+  auto profiler = ox::LuaProfiler();
+  auto state = sol::state();
+  load(state);
+  profiler.attach(state.lua_state(), {.sample_interval = 1'000'000});
+
+  call(profiler, state, "tiny");
+  ox::LuaProfiler::end_frame();
+
+  const auto* frame = ox::LuaProfiler::last_frame();
+  ASSERT_NE(frame, nullptr);
+  EXPECT_EQ(frame->total.samples, 0_u64);
+  ASSERT_EQ(frame->stacks.size(), 1_sz);
+  EXPECT_EQ(frame->stacks.front().name, "busy.lua;tiny (busy.lua)");
+
+  ox::LuaProfiler::set_enabled(false);
+  call(profiler, state, "busy");
+  ox::LuaProfiler::end_frame();
+  EXPECT_EQ(ox::LuaProfiler::history().size(), 1_sz);
+}
+
+TEST_F(LuaProfilerTest, ExportsFoldedStacks) {
+  auto profiler = ox::LuaProfiler();
+  auto state = sol::state();
+  load(state);
+  profiler.attach(state.lua_state(), {.sample_interval = 100});
+
+  for (auto i = 0; i < 3; i++) {
+    call(profiler, state, "busy");
+    ox::LuaProfiler::end_frame();
+  }
+
+  const auto path = std::filesystem::temp_directory_path() / "ox_lua_profile_test.folded";
+  ASSERT_TRUE(ox::LuaProfiler::export_folded(path).has_value());
+
+  auto stream = std::ifstream(path);
+  auto line = std::string();
+  auto lines = 0;
+  auto found_spin = false;
+  while (std::getline(stream, line)) {
+    lines += 1;
+    const auto weight_start = line.rfind(' ');
+    ASSERT_NE(weight_start, std::string::npos);
+    EXPECT_GT(std::stoull(line.substr(weight_start + 1)), 0_u64);
+    found_spin |= line.find(";spin (busy.lua:1);") != std::string::npos;
+  }
+  stream.close();
+
+  EXPECT_GT(lines, 0);
+  EXPECT_TRUE(found_spin);
+  std::filesystem::remove(path);
+}
+
+TEST_F(LuaProfilerTest, SummaryIsMergedOncePerFrame) {
+  auto profiler = ox::LuaProfiler();
+  auto state = sol::state();
+  load(state);
+  profiler.attach(state.lua_state(), {.sample_interval = 100});
+
+  call(profiler, state, "busy");
+  ox::LuaProfiler::end_frame();
+
+  const auto& first = ox::LuaProfiler::summary();
+  EXPECT_EQ(first.frames, 1_sz);
+  const auto first_ms = first.totals.total.ms;
+  EXPECT_GT(first_ms, 0.0);
+  // Calls that haven't closed a frame yet aren't in it.
+  call(profiler, state, "busy");
+  EXPECT_EQ(&ox::LuaProfiler::summary(), &first);
+  EXPECT_EQ(ox::LuaProfiler::summary().totals.total.ms, first_ms);
+
+  ox::LuaProfiler::end_frame();
+  EXPECT_EQ(ox::LuaProfiler::summary().frames, 2_sz);
+  EXPECT_GT(ox::LuaProfiler::summary().totals.total.ms, first_ms);
+
+  ox::LuaProfiler::reset();
+  EXPECT_EQ(ox::LuaProfiler::summary().frames, 0_sz);
+}
@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include <string_view>
+
+#include "Utils/FrameProfiler.hpp"
+
+namespace {
+auto find_scope(const ox::ProfileFrame& frame, std::string_view name) -> const ox::ProfileScopeStats* {
+  for (const auto& scope : frame.scopes) {
+    if (std::string_view(scope.name) == name) {
+      return &scope;
+    }
+  }
+
+  return nullptr;
+}
+} // namespace
+
+TEST(FrameProfilerTest, NestedScopesFormATreePerFrame) {
+  ox::FrameProfiler::reset();
+
+  ox::FrameProfiler::begin_frame();
+  {
+    auto outer = ox::ProfileScope("test.outer");
+    for (auto i = 0; i < 3; i++) {
+      auto inner = ox::ProfileScope("test.inner");
+    }
+  }
+  ox::FrameProfiler::end_frame(16.0);
+
+  const auto* frame = ox::FrameProfiler::last_frame();
+  ASSERT_NE(frame, nullptr);
+  const auto* outer = find_scope(*frame, "test.outer");
+  const auto* inner = find_scope(*frame, "test.inner");
+  ASSERT_NE(outer, nullptr);
+  ASSERT_NE(inner, nullptr);
+  EXPECT_EQ(outer->calls, 1_u32);
+  EXPECT_EQ(inner->calls, 3_u32);
+  EXPECT_EQ(&frame->scopes[inner->parent], outer);
+  EXPECT_EQ(inner->depth, outer->depth + 1);
+  EXPECT_GE(outer->total_ms, inner->total_ms);
+  EXPECT_EQ(frame->delta_ms, 16.0);
+
+  // Nothing ran, nothing is reported, the node keeps its index for the next time it runs.
+  ox::FrameProfiler::begin_frame();
+  ox::FrameProfiler::end_frame(16.0);
+  EXPECT_EQ(find_scope(*ox::FrameProfiler::last_frame(), "test.outer"), nullptr);
+
+  ox::FrameProfiler::begin_frame();
+  {
+    auto outer_again = ox::ProfileScope("test.outer");
+  }
+  ox::FrameProfiler::end_frame(16.0);
+  const auto* again = find_scope(*ox::FrameProfiler::last_frame(), "test.outer");
+  ASSERT_NE(again, nullptr);
+  EXPECT_EQ(again->node, outer->node);
+
+  EXPECT_EQ(ox::FrameProfiler::history().size(), 3_sz);
+}
+
+TEST(FrameProfilerTest, CountersResetEveryFrameGaugesDoNot) {
+  ox::FrameProfiler::reset();
+
+  ox::FrameProfiler::begin_frame();
+  OX_COUNTER_ADD("test.counter", 2);
+  OX_COUNTER_ADD("test.counter", 3);
+  OX_GAUGE_SET("test.gauge", 7);
+  ox::FrameProfiler::end_frame(16.0);
+
+  const auto counter = ox::FrameProfiler::register_metric("test.counter", ox::MetricKind::Counter);
+  const auto gauge = ox::FrameProfiler::register_metric("test.gauge", ox::MetricKind::Gauge);
+  ASSERT_NE(counter, ox::MetricID::Invalid);
+  ASSERT_NE(gauge, ox::MetricID::Invalid);
+
+  const auto* first = ox::FrameProfiler::last_frame();
+  EXPECT_EQ(first->metrics[std::to_underlying(counter)], 5.0);
+  EXPECT_EQ(first->metrics[std::to_underlying(gauge)], 7.0);
+
+  ox::FrameProfiler::begin_frame();
+  ox::FrameProfiler::end_frame(16.0);
+  const auto* second = ox::FrameProfiler::last_frame();
+  EXPECT_EQ(second->metrics[std::to_underlying(counter)], 0.0);
+  EXPECT_EQ(second->metrics[std::to_underlying(gauge)], 7.0);
+}
+
+TEST(FrameProfilerTest, SummaryUsesNearestRank) {
+  auto frame_ms = std::vector<f64>();
+  for (auto i = 100; i >= 1; i--) {
+    frame_ms.push_back(static_cast<f64>(i));
+  }
+
+  const auto summary = ox::summarize_frame_times(frame_ms);
+  EXPECT_EQ(summary.frames, 100_sz);
+  EXPECT_DOUBLE_EQ(summary.mean_ms, 50.5);
+  EXPECT_EQ(summary.p50_ms, 50.0);
+  EXPECT_EQ(summary.p90_ms, 90.0);
+  EXPECT_EQ(summary.p99_ms, 99.0);
+  EXPECT_EQ(summary.max_ms, 100.0);
+
+  EXPECT_EQ(ox::summarize_frame_times({}).frames, 0_sz);
+}
+
+TEST(FrameProfilerTest, HistogramMatchesSortedSummary) {
+  auto histogram = ox::FrameTimeHistogram{};
+  for (auto i = 100; i >= 1; i--) {
+    histogram.add(static_cast<f64>(i) * 0.5);
+  }
+  // Slower than the buckets go, only the max knows how slow.
+  histogram.add(1000.0);
+
+  const auto summary = histogram.summary();
+  // A bucket off at most, plus rounding on the bucket edges.
+  constexpr auto within = ox::FrameTimeHistogram::BUCKET_MS * 1.5;
+  EXPECT_EQ(summary.frames, 101_sz);
+  EXPECT_DOUBLE_EQ(summary.mean_ms, (2525.0 + 1000.0) / 101.0);
+  EXPECT_NEAR(summary.p50_ms, 25.5, within);
+  EXPECT_NEAR(summary.p90_ms, 45.5, within);
+  EXPECT_NEAR(summary.p99_ms, 50.0, within);
+  EXPECT_EQ(summary.max_ms, 1000.0);
+
+  histogram.clear();
+  EXPECT_EQ(histogram.summary().frames, 0_sz);
+  EXPECT_EQ(histogram.summary().p50_ms, 0.0);
+}
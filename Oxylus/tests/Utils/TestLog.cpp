@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Utils/Log.hpp"
+
+namespace {
+struct CapturedLog {
+  std::vector<std::string> messages = {};
+
+  CapturedLog() {
+    ox::Log::add_callback(
+      "test_log",
+      [](void* user_data, const loguru::Message& message) {
+        static_cast<CapturedLog*>(user_data)->messages.emplace_back(message.message);
+      },
+      this,
+      loguru::Verbosity_INFO
+    );
+  }
+
+  ~CapturedLog() { ox::Log::remove_callback("test_log"); }
+};
+
+auto spam(i32 i) -> void { OX_LOG_INFO("spam {}", i); }
+} // namespace
+
+TEST(LogTest, AsyncMessagesAreFormattedInOrder) {
+  auto captured = CapturedLog{};
+  ox::Log::start_backend();
+  ASSERT_TRUE(ox::Log::is_async());
+
+  const auto name = std::string("texture.png");
+  OX_LOG_INFO("Loaded {} in {:.2f}ms", name, 1.25);
+  std::thread([] { OX_LOG_WARN("From another thread {}", 7); }).join();
+  // Doesn't fit in a record, formatted by the caller.
+  OX_LOG_ERROR("Long {}", std::string(1000, 'x'));
+
+  ox::Log::flush();
+  ox::Log::stop_backend();
+
+  ASSERT_EQ(captured.messages.size(), 3_sz);
+  EXPECT_TRUE(captured.messages[0].ends_with("Loaded texture.png in 1.25ms"));
+  EXPECT_TRUE(captured.messages[1].ends_with("From another thread 7"));
+  EXPECT_TRUE(captured.messages[2].ends_with(std::string(1000, 'x')));
+}
+
+TEST(LogTest, RateLimitCountsSuppressedMessages) {
+  auto captured = CapturedLog{};
+  ox::Log::set_rate_limit(2, 60'000);
+  for (auto i = 0; i < 5; i++) {
+    spam(i);
+  }
+  EXPECT_EQ(captured.messages.size(), 2_sz);
+
+  // A window that is always over lets the next one through, along with the count.
+  ox::Log::set_rate_limit(2, 0);
+  spam(5);
+  ox::Log::set_rate_limit(100, 1000);
+
+  ASSERT_EQ(captured.messages.size(), 3_sz);
+  EXPECT_TRUE(captured.messages[2].ends_with("spam 5 (3 more from here were rate limited)"));
+}
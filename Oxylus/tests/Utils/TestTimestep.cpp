@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+#include <thread>
+
+#include "Utils/Timer.hpp"
+#include "Utils/Timestep.hpp"
+
+TEST(TimestepTest, FixedStepReportsTheStep) {
+  auto timestep = ox::Timestep{};
+  timestep.set_fixed_step(5.0);
+
+  for (auto i = 0; i < 4; i++) {
+    timestep.on_update();
+    EXPECT_DOUBLE_EQ(timestep.get_millis(), 5.0);
+  }
+
+  EXPECT_DOUBLE_EQ(timestep.get_elapsed_millis(), 20.0);
+}
+
+TEST(TimestepTest, FixedStepSleepsUntilTheNextTick) {
+  auto timestep = ox::Timestep{};
+  timestep.set_fixed_step(5.0);
+
+  // The first update only sets up the deadline.
+  timestep.on_update();
+  auto timer = ox::Timer{};
+  for (auto i = 0; i < 10; i++) {
+    timestep.on_update();
+  }
+
+  EXPECT_GE(timer.get_elapsed_msd(), 45.0);
+}
+
+TEST(TimestepTest, FixedStepCatchesUpThenGivesUp) {
+  auto timestep = ox::Timestep{};
+  timestep.set_fixed_step(10.0);
+  timestep.on_update();
+
+  // A couple of late ticks are made up for right away.
+  std::this_thread::sleep_for(std::chrono::milliseconds(25));
+  auto timer = ox::Timer{};
+  timestep.on_update();
+  timestep.on_update();
+  EXPECT_LT(timer.get_elapsed_msd(), 5.0);
+
+  // Too far behind and the schedule starts over from now.
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  timestep.on_update();
+  timer = ox::Timer{};
+  timestep.on_update();
+  EXPECT_GE(timer.get_elapsed_msd(), 9.0);
+}
+
+TEST(TimestepTest, SimulatedStepDoesNotWait) {
+  auto timestep = ox::Timestep{};
+  timestep.set_fixed_step(50.0);
+  timestep.set_simulated_step(50.0);
+
+  auto timer = ox::Timer{};
+  for (auto i = 0; i < 10; i++) {
+    timestep.on_update();
+    EXPECT_DOUBLE_EQ(timestep.get_millis(), 50.0);
+  }
+
+  EXPECT_DOUBLE_EQ(timestep.get_elapsed_millis(), 500.0);
+  EXPECT_LT(timer.get_elapsed_msd(), 50.0);
+}
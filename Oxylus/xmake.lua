@@ -84,6 +84,7 @@ target("Oxylus")
         "libsdl3",
         "ktx-ox",
         "zpp_bits",
+        "zstd",
         "enet-ox",
         "flecs",
         "imgui",
@@ -14,6 +14,7 @@
 #include "Panels/ContentPanel.hpp"
 #include "Panels/EditorSettingsPanel.hpp"
 #include "Panels/InspectorPanel.hpp"
+#include "Panels/ProfilerPanel.hpp"
 #include "Panels/ProjectPanel.hpp"
 #include "Panels/SceneHierarchyPanel.hpp"
 #include "Panels/TextEditorPanel.hpp"
@@ -101,6 +102,7 @@ auto Editor::init(this Editor& self) -> std::expected<void, std::string> {
   self.editor_panel_registry.add<EditorSettingsPanel>();
   self.editor_panel_registry.add<ProjectPanel>();
   self.editor_panel_registry.add<AssetManagerPanel>();
+  self.editor_panel_registry.add<ProfilerPanel>();
   auto text_editor_panel = self.editor_panel_registry.add<TextEditorPanel>();
 
   scene_hierarchy_panel->viewer.opened_script_callback = [text_editor_panel](const UUID& uuid) {
@@ -519,6 +521,7 @@ void Editor::draw_menubar(this Editor& self) {
       ImGui::MenuItem("Inspector", nullptr, &self.editor_panel_registry.get<InspectorPanel>().visible);
       ImGui::MenuItem("Scene hierarchy", nullptr, &self.editor_panel_registry.get<SceneHierarchyPanel>().visible);
       ImGui::MenuItem("Text Editor", nullptr, &self.editor_panel_registry.get<TextEditorPanel>().visible);
+      ImGui::MenuItem("Profiler", nullptr, &self.editor_panel_registry.get<ProfilerPanel>().visible);
       if (ImGui::BeginMenu("Layout")) {
         if (ImGui::MenuItem("Classic")) {
           self.set_docking_layout(EditorLayout::Classic);
@@ -133,7 +133,9 @@ struct EntityInspector : IEntitySerializer {
     auto field_names = std::vector<const char*>{};
     world.entity(type).children([&](flecs::entity e) { field_names.push_back(e.name()); });
     auto current = static_cast<i32*>(ptr);
-    ImGui::Combo("##enum_field", current, field_names.data(), static_cast<int>(field_names.size()));
+    if (ImGui::Combo("##enum_field", current, field_names.data(), static_cast<int>(field_names.size()))) {
+      modified = true;
+    }
     UI::end_property_grid();
   }
 
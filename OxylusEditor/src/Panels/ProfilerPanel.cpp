@@ -0,0 +1,16 @@
+#include "ProfilerPanel.hpp"
+
+#include <icons/IconsMaterialDesignIcons.h>
+#include <tracy/Tracy.hpp>
+
+namespace ox {
+ProfilerPanel::ProfilerPanel() : EditorPanelState("Profiler", ICON_MDI_CHART_LINE, false) {}
+
+void ProfilerPanel::on_update(this ProfilerPanel& self) {}
+
+void ProfilerPanel::on_render(this ProfilerPanel& self, vuk::ImageAttachment swapchain_attachment) {
+  ZoneScoped;
+
+  self.viewer.render(self.id.c_str(), &self.visible);
+}
+} // namespace ox
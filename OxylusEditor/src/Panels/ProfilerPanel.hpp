@@ -0,0 +1,17 @@
+#pragma once
+
+#include "Panels/EditorPanelState.hpp"
+#include "UI/ProfilerViewer.hpp"
+
+namespace ox {
+class ProfilerPanel : public EditorPanelState {
+public:
+  ProfilerPanel();
+
+  auto on_update(this ProfilerPanel& self) -> void;
+  auto on_render(this ProfilerPanel& self, vuk::ImageAttachment swapchain_attachment) -> void;
+
+private:
+  ProfilerViewer viewer = {};
+};
+} // namespace ox
@@ -0,0 +1,89 @@
+#include "DedicatedServer.hpp"
+
+#include "Core/App.hpp"
+#include "Networking/NetServer.hpp"
+#include "Utils/Log.hpp"
+
+namespace ox {
+auto DedicatedServer::init(this DedicatedServer& self) -> std::expected<void, std::string> {
+  ZoneScoped;
+
+  auto scene_path = self.info.scene_path;
+  if (!self.info.project_path.empty()) {
+    self.project = std::make_unique<Project>();
+    if (!self.project->load(self.info.project_path)) {
+      return std::unexpected(fmt::format("Failed to load project {}", self.info.project_path));
+    }
+
+    if (scene_path.empty()) {
+      scene_path = self.project->get_config().start_scene;
+    }
+    if (!scene_path.empty()) {
+      scene_path = App::get_vfs().resolve_physical_dir(VFS::PROJECT_DIR, scene_path);
+    }
+  }
+
+  if (scene_path.empty()) {
+    return std::unexpected("No scene to run, pass --scene or a project with a start scene.");
+  }
+
+  self.scene = std::make_unique<Scene>(scene_path.stem().string());
+  if (!self.scene->load_from_file(scene_path)) {
+    return std::unexpected(fmt::format("Failed to load scene {}", scene_path));
+  }
+
+  auto& network = App::mod<NetworkManager>();
+  network.snapshot_config = self.info.snapshot;
+  self.server = network.create_server(self.info.port, self.info.max_clients);
+  if (!self.server) {
+    return std::unexpected(fmt::format("Failed to listen on port {}", self.info.port));
+  }
+
+  // One snapshot per app tick, the app already sleeps until the next one is due.
+  self.server->set_tick_rate(self.info.tick_rate);
+
+  self.scene->runtime_start();
+
+  OX_LOG_INFO(
+    "Serving {} on port {} for up to {} clients at {} ticks per second.",
+    scene_path,
+    self.info.port,
+    self.info.max_clients,
+    self.info.tick_rate
+  );
+
+  return {};
+}
+
+auto DedicatedServer::deinit(this DedicatedServer& self) -> std::expected<void, std::string> {
+  ZoneScoped;
+
+  if (self.scene && self.scene->is_running()) {
+    self.scene->runtime_stop();
+  }
+
+  if (self.server) {
+    App::mod<NetworkManager>().destroy_server(self.server);
+    self.server = nullptr;
+  }
+
+  self.scene.reset();
+  self.project.reset();
+
+  return {};
+}
+
+auto DedicatedServer::update(this DedicatedServer& self, const Timestep& timestep) -> void {
+  ZoneScoped;
+
+  if (!self.scene) {
+    return;
+  }
+
+  self.scene->runtime_update(timestep);
+
+  if (self.server && self.server->tick(timestep)) {
+    self.server->send_snapshots(self.scene->world);
+  }
+}
+} // namespace ox
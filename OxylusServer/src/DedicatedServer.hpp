@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Asset/AssetManager.hpp"
+#include "Core/Project.hpp"
+#include "Networking/NetworkManager.hpp"
+#include "Physics/Physics.hpp"
+#include "Scene/Scene.hpp"
+
+namespace ox {
+struct DedicatedServerInfo {
+  // Optional, mounts the project's assets and provides the start scene.
+  std::filesystem::path project_path = {};
+  // Overrides the project's start scene, relative to the project's assets when one is loaded.
+  std::filesystem::path scene_path = {};
+  u16 port = 7777;
+  u32 max_clients = 64;
+  f64 tick_rate = 30.0;
+  // Clients have to load the same dictionary.
+  SnapshotCodecConfig snapshot = {};
+};
+
+// Loads one scene, runs it and sends snapshots of it to whoever connects. Snapshots go out once per app
+// tick, the app is expected to be headless and stepping at `tick_rate`.
+class DedicatedServer {
+public:
+  constexpr static auto MODULE_NAME = "DedicatedServer";
+  using module_dependencies = std::tuple<AssetManager, Physics, NetworkManager>;
+
+  explicit DedicatedServer(DedicatedServerInfo info_) : info(std::move(info_)) {}
+
+  auto init(this DedicatedServer& self) -> std::expected<void, std::string>;
+  auto deinit(this DedicatedServer& self) -> std::expected<void, std::string>;
+  auto update(this DedicatedServer& self, const Timestep& timestep) -> void;
+
+  auto get_scene(this DedicatedServer& self) -> Scene* { return self.scene.get(); }
+  auto get_server(this DedicatedServer& self) -> NetServer* { return self.server; }
+
+private:
+  DedicatedServerInfo info = {};
+  std::unique_ptr<Project> project = nullptr;
+  std::unique_ptr<Scene> scene = nullptr;
+  NetServer* server = nullptr;
+};
+} // namespace ox
@@ -0,0 +1,73 @@
+#include <charconv>
+
+#include "Core/App.hpp"
+#include "Core/DefaultModules.hpp"
+#include "DedicatedServer.hpp"
+
+namespace {
+auto arg_value(const ox::AppCommandLineArgs& args, std::string_view name) -> ox::option<std::string> {
+  auto index = args.get_index(name);
+  if (!index.has_value()) {
+    return ox::nullopt;
+  }
+
+  auto value = args.get(index.value() + 1);
+  if (!value.has_value()) {
+    return ox::nullopt;
+  }
+
+  return value->arg_str;
+}
+
+template <typename T>
+auto arg_number(const ox::AppCommandLineArgs& args, std::string_view name, T fallback) -> T {
+  auto value = arg_value(args, name);
+  if (!value.has_value()) {
+    return fallback;
+  }
+
+  auto result = fallback;
+  auto [_, ec] = std::from_chars(value->data(), value->data() + value->size(), result);
+  if (ec != std::errc{}) {
+    OX_LOG_WARN("Ignoring {} {}, not a number.", name, *value);
+    return fallback;
+  }
+
+  return result;
+}
+} // namespace
+
+// OxylusServer [--project <file.oxproj>] [--scene <file.oxscene>] [--port 7777] [--max-clients 64]
+//              [--tick-rate 30] [--snapshot-zstd <level>] [--snapshot-dictionary <file>]
+int main(int argc, char** argv) {
+  auto app = ox::App(argc, argv);
+
+  const auto& args = app.get_command_line_args();
+  auto info = ox::DedicatedServerInfo{};
+  info.project_path = arg_value(args, "--project").value_or("");
+  info.scene_path = arg_value(args, "--scene").value_or("");
+  info.port = arg_number<u16>(args, "--port", info.port);
+  info.max_clients = arg_number<u32>(args, "--max-clients", info.max_clients);
+  info.tick_rate = arg_number<f64>(args, "--tick-rate", info.tick_rate);
+  if (info.tick_rate <= 0.0) {
+    OX_LOG_WARN("Tick rate has to be positive, using 30.");
+    info.tick_rate = 30.0;
+  }
+
+  if (arg_value(args, "--snapshot-zstd").has_value()) {
+    info.snapshot.compress = true;
+    info.snapshot.compression_level = arg_number<i32>(args, "--snapshot-zstd", info.snapshot.compression_level);
+  }
+  info.snapshot.dictionary_path = arg_value(args, "--snapshot-dictionary").value_or("");
+  if (!info.snapshot.dictionary_path.empty() && !info.snapshot.compress) {
+    OX_LOG_WARN("--snapshot-dictionary only matters with --snapshot-zstd.");
+  }
+
+  app.with_name("Oxylus Engine - Server")
+    .with_headless(info.tick_rate)
+    .with(ox::ServerModules{})
+    .with<ox::DedicatedServer>(std::move(info))
+    .run();
+
+  return 0;
+}
@@ -0,0 +1,14 @@
+target("OxylusServer")
+    set_kind("binary")
+    set_languages("cxx23")
+
+    add_deps("Oxylus")
+
+    add_includedirs("./src")
+    add_files("./src/**.cpp")
+
+    if is_plat("windows") then
+        add_ldflags("/subsystem:console")
+    end
+
+target_end()
@@ -29,126 +29,128 @@ auto parse_resource_config(const std::filesystem::path& config_path) -> option<R
 
   // [[shader_sessions]]
   auto* sessions = root["shader_sessions"].as_array();
-  if (!sessions) {
-    fmt::println("Error: missing [[shader_sessions]] in '{}'.", config_path.string());
+  if (!sessions && !root["models"].as_array() && !root["scripts"].as_array()) {
+    fmt::println("Error: '{}' has none of [[shader_sessions]], [[models]] or [[scripts]].", config_path.string());
     return nullopt;
   }
 
-  for (const auto& session_elem : *sessions) {
-    auto* session_tbl = session_elem.as_table();
-    if (!session_tbl) {
-      continue;
-    }
-    const auto& st = *session_tbl;
-
-    auto session = ShaderSessionConfig{};
+  if (sessions) {
+    for (const auto& session_elem : *sessions) {
+      auto* session_tbl = session_elem.as_table();
+      if (!session_tbl) {
+        continue;
+      }
+      const auto& st = *session_tbl;
 
-    if (auto node = st["root_directory"].as_string()) {
-      session.root_directory = node->get();
-    } else {
-      fmt::println("Error: shader session missing 'root_directory'.");
-      return nullopt;
-    }
+      auto session = ShaderSessionConfig{};
 
-    if (auto node = st["session_name"].as_string()) {
-      session.session_name = node->get();
-    }
+      if (auto node = st["root_directory"].as_string()) {
+        session.root_directory = node->get();
+      } else {
+        fmt::println("Error: shader session missing 'root_directory'.");
+        return nullopt;
+      }
 
-    if (auto node = st["debug_symbols"].as_boolean()) {
-      session.debug_symbols = node->get();
-    }
+      if (auto node = st["session_name"].as_string()) {
+        session.session_name = node->get();
+      }
 
-    if (auto node = st["output"].as_string()) {
-      session.output = node->get();
-    }
+      if (auto node = st["debug_symbols"].as_boolean()) {
+        session.debug_symbols = node->get();
+      }
 
-    if (auto opt_str = st["optimization"].as_string()) {
-      auto val = std::string_view(opt_str->get());
-      if (val == "none") {
-        session.optimization_level = 0;
-      } else if (val == "default") {
-        session.optimization_level = 1;
-      } else if (val == "full" || val == "max") {
-        session.optimization_level = 3;
-      }
-    } else if (auto opt_int = st["optimization"].as_integer()) {
-      session.optimization_level = static_cast<i32>(opt_int->get());
-    }
+      if (auto node = st["output"].as_string()) {
+        session.output = node->get();
+      }
 
-    // [[shader_sessions.definitions]]
-    if (auto* defs = st["definitions"].as_array()) {
-      for (const auto& def_elem : *defs) {
-        auto* def_tbl = def_elem.as_table();
-        if (!def_tbl) {
-          continue;
+      if (auto opt_str = st["optimization"].as_string()) {
+        auto val = std::string_view(opt_str->get());
+        if (val == "none") {
+          session.optimization_level = 0;
+        } else if (val == "default") {
+          session.optimization_level = 1;
+        } else if (val == "full" || val == "max") {
+          session.optimization_level = 3;
         }
-        const auto& dt = *def_tbl;
+      } else if (auto opt_int = st["optimization"].as_integer()) {
+        session.optimization_level = static_cast<i32>(opt_int->get());
+      }
 
-        auto name = std::string{};
-        if (auto n = dt["name"].as_string()) {
-          name = n->get();
-        }
-        if (name.empty()) {
-          continue;
-        }
+      // [[shader_sessions.definitions]]
+      if (auto* defs = st["definitions"].as_array()) {
+        for (const auto& def_elem : *defs) {
+          auto* def_tbl = def_elem.as_table();
+          if (!def_tbl) {
+            continue;
+          }
+          const auto& dt = *def_tbl;
+
+          auto name = std::string{};
+          if (auto n = dt["name"].as_string()) {
+            name = n->get();
+          }
+          if (name.empty()) {
+            continue;
+          }
 
-        if (auto str_val = dt["value"].as_string()) {
-          session.definitions.emplace_back(name, str_val->get());
-        } else if (auto int_val = dt["value"].as_integer()) {
-          session.definitions.emplace_back(name, std::to_string(int_val->get()));
-        } else if (auto bool_val = dt["value"].as_boolean()) {
-          session.definitions.emplace_back(name, bool_val->get() ? "1" : "0");
-        } else {
-          session.definitions.emplace_back(name, "1");
+          if (auto str_val = dt["value"].as_string()) {
+            session.definitions.emplace_back(name, str_val->get());
+          } else if (auto int_val = dt["value"].as_integer()) {
+            session.definitions.emplace_back(name, std::to_string(int_val->get()));
+          } else if (auto bool_val = dt["value"].as_boolean()) {
+            session.definitions.emplace_back(name, bool_val->get() ? "1" : "0");
+          } else {
+            session.definitions.emplace_back(name, "1");
+          }
         }
       }
-    }
 
-    // [[shader_sessions.programs]]
-    auto* programs = st["programs"].as_array();
-    if (!programs || programs->empty()) {
-      fmt::println("Error: shader session '{}' has no [[programs]].", session.session_name);
-      return nullopt;
-    }
-
-    for (const auto& prog_elem : *programs) {
-      auto* prog_tbl = prog_elem.as_table();
-      if (!prog_tbl) {
-        continue;
+      // [[shader_sessions.programs]]
+      auto* programs = st["programs"].as_array();
+      if (!programs || programs->empty()) {
+        fmt::println("Error: shader session '{}' has no [[programs]].", session.session_name);
+        return nullopt;
       }
-      const auto& pt = *prog_tbl;
 
-      auto prog = ShaderProgramConfig{};
+      for (const auto& prog_elem : *programs) {
+        auto* prog_tbl = prog_elem.as_table();
+        if (!prog_tbl) {
+          continue;
+        }
+        const auto& pt = *prog_tbl;
 
-      if (auto node = pt["name"].as_string()) {
-        prog.name = node->get();
-      }
-      if (auto node = pt["path"].as_string()) {
-        prog.path = node->get();
-      }
-      if (prog.name.empty() && !prog.path.empty()) {
-        prog.name = prog.path.stem().string();
-      }
+        auto prog = ShaderProgramConfig{};
+
+        if (auto node = pt["name"].as_string()) {
+          prog.name = node->get();
+        }
+        if (auto node = pt["path"].as_string()) {
+          prog.path = node->get();
+        }
+        if (prog.name.empty() && !prog.path.empty()) {
+          prog.name = prog.path.stem().string();
+        }
 
-      if (auto* eps = pt["entry_points"].as_array()) {
-        for (const auto& ep : *eps) {
-          if (auto ep_str = ep.as_string()) {
-            prog.entry_points.push_back(ep_str->get());
+        if (auto* eps = pt["entry_points"].as_array()) {
+          for (const auto& ep : *eps) {
+            if (auto ep_str = ep.as_string()) {
+              prog.entry_points.push_back(ep_str->get());
+            }
           }
         }
-      }
 
-      if (auto node = pt["bindless"].as_boolean()) {
-        prog.bindless = node->get();
+        if (auto node = pt["bindless"].as_boolean()) {
+          prog.bindless = node->get();
+        }
+
+        session.programs.push_back(std::move(prog));
       }
 
-      session.programs.push_back(std::move(prog));
+      config.shader_sessions.push_back(std::move(session));
     }
-
-    config.shader_sessions.push_back(std::move(session));
   }
 
-  // [[models]] (optional, for future use)
+  // [[models]] (optional)
   if (auto* models = root["models"].as_array()) {
     for (const auto& model_elem : *models) {
       auto* model_tbl = model_elem.as_table();
@@ -164,10 +166,36 @@ auto parse_resource_config(const std::filesystem::path& config_path) -> option<R
       if (auto node = mt["is_foliage"].as_boolean()) {
         model.is_foliage = node->get();
       }
+      if (auto node = mt["mesh_colliders"].as_boolean()) {
+        model.mesh_colliders = node->get();
+      }
       config.models.push_back(std::move(model));
     }
   }
 
+  // [[scripts]] (optional)
+  if (auto* scripts = root["scripts"].as_array()) {
+    for (const auto& script_elem : *scripts) {
+      auto* script_tbl = script_elem.as_table();
+      if (!script_tbl) {
+        continue;
+      }
+      const auto& st = *script_tbl;
+
+      auto script = ScriptConfig{};
+      if (auto node = st["path"].as_string()) {
+        script.path = node->get();
+      } else {
+        fmt::println("Error: script entry missing 'path'.");
+        return nullopt;
+      }
+      if (auto node = st["strip"].as_boolean()) {
+        script.strip = node->get();
+      }
+      config.scripts.push_back(std::move(script));
+    }
+  }
+
   return config;
 }
 
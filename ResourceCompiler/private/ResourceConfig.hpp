@@ -28,12 +28,19 @@ struct ShaderSessionConfig {
 struct ModelConfig {
   std::filesystem::path path = {};
   bool is_foliage = false;
+  bool mesh_colliders = false;
+};
+
+struct ScriptConfig {
+  std::filesystem::path path = {};
+  bool strip = true;
 };
 
 struct ResourceConfig {
   i32 version = {};
   std::vector<ShaderSessionConfig> shader_sessions = {};
   std::vector<ModelConfig> models = {};
+  std::vector<ScriptConfig> scripts = {};
 };
 
 auto parse_resource_config(const std::filesystem::path& config_path) -> option<ResourceConfig>;
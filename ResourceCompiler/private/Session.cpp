@@ -1,7 +1,16 @@
 #include "Session.hpp"
 
+// clang-format off
+#include <Jolt/Jolt.h>
+#include <Jolt/Core/Factory.h>
+#include <Jolt/RegisterTypes.h>
+// clang-format on
+#include <ranges>
 #include <zpp_bits.h>
 
+#include "OS/File.hpp"
+#include "Physics/PhysicsShapes.hpp"
+#include "Scripting/LuaBytecode.hpp"
 #include "ShaderSession.hpp"
 
 namespace ox::rc {
@@ -95,6 +104,12 @@ auto Session::destroy() -> void {
 
 auto Session::add_request(const ShaderCompileRequest& request) -> void { impl->shader_requests.emplace_back(request); }
 
+auto Session::add_request(const MeshColliderBakeRequest& request) -> void {
+  impl->mesh_collider_requests.emplace_back(request);
+}
+
+auto Session::add_request(const ScriptCompileRequest& request) -> void { impl->script_requests.emplace_back(request); }
+
 auto Session::push_error(std::string msg) -> void {
   auto lock = std::unique_lock(impl->messages_mutex);
   impl->errors.push_back(std::move(msg));
@@ -147,6 +162,106 @@ auto Session::compile() -> bool {
     }
   }
 
+  if (!impl->mesh_collider_requests.empty()) {
+    // Jolt needs its factory to (de)serialize shapes. rcli never runs the Physics module.
+    auto owns_jolt = JPH::Factory::sInstance == nullptr;
+    if (owns_jolt) {
+      JPH::RegisterDefaultAllocator();
+      JPH::Factory::sInstance = new JPH::Factory();
+      JPH::RegisterTypes();
+    }
+
+    for (const auto& request : impl->mesh_collider_requests) {
+      auto shapes = cook_gltf_mesh_shapes(request.path);
+      if (shapes.empty()) {
+        push_error(fmt::format("Failed to cook mesh colliders for '{}'.", request.path.string()));
+        success = false;
+        continue;
+      }
+
+      // Each model gets its own file next to it, unlike shaders which share one pack.
+      auto shape_file = AssetFile{};
+      const auto source_hash = hash_shape_source(request.path);
+      for (const auto& [shape, mesh_index] : std::views::zip(shapes, std::views::iota(0_u32))) {
+        if (shape == nullptr) {
+          continue;
+        }
+
+        shape_file.add_entry(
+          PhysicsShapeData{
+            .mesh_index = mesh_index,
+            .source_hash = source_hash,
+            .shape_data = save_shape_binary(shape.GetPtr()),
+          }
+        );
+      }
+
+      const auto output = baked_shapes_path(request.path);
+      if (!shape_file.pack(output)) {
+        push_error(fmt::format("Failed to write mesh colliders to '{}'.", output.string()));
+        success = false;
+        continue;
+      }
+
+      push_message(fmt::format("Baked {} mesh collider(s) -> {}", shape_file.entries.size(), output.filename().string()));
+    }
+
+    if (owns_jolt) {
+      JPH::UnregisterTypes();
+      delete JPH::Factory::sInstance;
+      JPH::Factory::sInstance = nullptr;
+    }
+  }
+
+  for (const auto& request : impl->script_requests) {
+    auto scripts = std::vector<std::filesystem::path>();
+    if (std::filesystem::is_directory(request.path)) {
+      for (const auto& entry : std::filesystem::recursive_directory_iterator(request.path)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".lua") {
+          scripts.push_back(entry.path());
+        }
+      }
+    } else {
+      scripts.push_back(request.path);
+    }
+
+    for (const auto& script_path : scripts) {
+      const auto source = File::to_bytes(script_path);
+      if (source.empty()) {
+        push_error(fmt::format("Failed to read script '{}'.", script_path.string()));
+        success = false;
+        continue;
+      }
+
+      // Same chunk name `state->script_file` gives, so errors from unstripped chunks read the same.
+      auto bytecode = compile_script_bytecode(source, "@" + script_path.string(), request.strip);
+      if (!bytecode.has_value()) {
+        push_error(fmt::format("Failed to compile script: {}", bytecode.error()));
+        success = false;
+        continue;
+      }
+
+      const auto source_text = std::string_view(reinterpret_cast<const c8*>(source.data()), source.size());
+      auto script_file = AssetFile{};
+      script_file.add_entry(
+        ScriptBytecodeData{
+          .source_hash = hash_script_source(source),
+          .parallel = is_parallel_script(source_text),
+          .bytecode = std::move(bytecode.value()),
+        }
+      );
+
+      auto output = script_bytecode_path(script_path);
+      if (!script_file.pack(output)) {
+        push_error(fmt::format("Failed to write compiled script to '{}'.", output.string()));
+        success = false;
+        continue;
+      }
+
+      push_message(fmt::format("Compiled script -> {}", output.filename().string()));
+    }
+  }
+
   return success;
 }
 
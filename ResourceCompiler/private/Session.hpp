@@ -19,6 +19,8 @@ struct Handle<rc::Session>::Impl {
   Slang::ComPtr<slang::IGlobalSession> slang_global_session = {};
 
   std::vector<rc::ShaderCompileRequest> shader_requests = {};
+  std::vector<rc::MeshColliderBakeRequest> mesh_collider_requests = {};
+  std::vector<rc::ScriptCompileRequest> script_requests = {};
   AssetFile asset_file = {};
 };
 } // namespace ox
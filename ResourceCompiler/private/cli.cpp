@@ -90,6 +90,23 @@ auto main(i32 argc, c8** argv) -> i32 {
     session->add_request(request);
   }
 
+  for (const auto& model : config->models) {
+    if (!model.mesh_colliders) {
+      continue;
+    }
+
+    session->add_request(rc::MeshColliderBakeRequest{.path = (config_dir / model.path).lexically_normal()});
+  }
+
+  for (const auto& script : config->scripts) {
+    session->add_request(
+      rc::ScriptCompileRequest{
+        .path = (config_dir / script.path).lexically_normal(),
+        .strip = script.strip,
+      }
+    );
+  }
+
   auto compile_success = session->compile();
 
   // Print collected errors
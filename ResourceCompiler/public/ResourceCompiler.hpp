@@ -49,11 +49,26 @@ struct ShaderCompileRequest {
   std::vector<ShaderCompileInfo> shaders = {};
 };
 
+// Cooks every mesh of a glTF model into a collision shape and writes them to `<path>.oxshapes`,
+// which is where the runtime looks for them.
+struct MeshColliderBakeRequest {
+  std::filesystem::path path = {};
+};
+
+// Compiles Lua scripts to bytecode, each to `<script>.oxbc` next to it where `AssetManager::load_script`
+// picks it up. `path` is either a script or a directory searched recursively for `.lua` files.
+struct ScriptCompileRequest {
+  std::filesystem::path path = {};
+  bool strip = true;
+};
+
 struct OXRC_API Session : Handle<Session> {
   static auto create() -> option<Session>;
   auto destroy() -> void;
 
   auto add_request(const ShaderCompileRequest& request) -> void;
+  auto add_request(const MeshColliderBakeRequest& request) -> void;
+  auto add_request(const ScriptCompileRequest& request) -> void;
   auto compile() -> bool;
   auto write_to_file(const std::filesystem::path& output_path) -> bool;
 
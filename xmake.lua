@@ -41,6 +41,12 @@ includes("ResourceCompiler")
 if has_config("editor") then
   includes("OxylusEditor")
 end
+if has_config("server") then
+  includes("OxylusServer")
+end
 if has_config("tests") then
   includes("Oxylus/tests")
 end
+if has_config("benchmarks") then
+  includes("Oxylus/benchmarks")
+end
@@ -13,11 +13,21 @@ option("tests")
     set_showmenu(true)
     set_description("Enable tests")
 
+option("benchmarks")
+    set_default(false)
+    set_showmenu(true)
+    set_description("Enable benchmarks")
+
 option("editor")
     set_default(true)
     set_showmenu(true)
     set_description("Enable Oxylus Editor project")
 
+option("server")
+    set_default(false)
+    set_showmenu(true)
+    set_description("Enable the headless dedicated server")
+
 option("llvmpipe")
     set_default(false)
     set_showmenu(true)